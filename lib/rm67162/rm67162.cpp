@@ -2,6 +2,11 @@
 #include "SPI.h"
 #include "Arduino.h"
 #include "driver/spi_master.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
 
 const static lcd_cmd_t rm67162_spi_init[] = {
     {0xFE, {0x00}, 0x01}, // PAGE
@@ -33,6 +38,46 @@ const static lcd_cmd_t rm67162_qspi_init[] = {
 
 static spi_device_handle_t spi;
 
+#if LCD_USB_QSPI_DREVER == 1 && LCD_ASYNC_FLUSH
+// Asynchronous flush: a task on core 0 streams the queued windows through
+// internal DMA bounce buffers while the caller goes on with the next frame
+typedef struct
+{
+  uint16_t x;
+  uint16_t y;
+  uint16_t width;
+  uint16_t high;
+  const uint16_t *data;
+  uint16_t stride; // Pixels from one row of data to the next
+  lcd_flush_cb_t done;
+  void *arg;
+} lcd_flush_req_t;
+
+#define FLUSH_DONE_BIT BIT0 // Set after every window
+
+static TaskHandle_t flush_task = NULL;
+static QueueHandle_t flush_queue = NULL;
+static EventGroupHandle_t flush_events = NULL;
+static portMUX_TYPE flush_mux = portMUX_INITIALIZER_UNLOCKED;
+static volatile uint32_t flush_pending = 0; // Windows queued or being sent
+static uint16_t *bounce[LCD_BOUNCE_BUFFERS];
+static spi_transaction_ext_t bounce_trans[LCD_BOUNCE_BUFFERS];
+#endif
+
+static lcd_flush_stats_t flush_stats = {0};
+
+// Commands and polling transfers cannot run while queued transfers are in
+// flight: wait for the flush task, unless we are the flush task
+static void wait_bus()
+{
+#if LCD_USB_QSPI_DREVER == 1 && LCD_ASYNC_FLUSH
+  if (flush_task && xTaskGetCurrentTaskHandle() != flush_task)
+  {
+    lcd_wait_flush();
+  }
+#endif
+}
+
 static void WriteComm(uint8_t data)
 {
   TFT_CS_L;
@@ -67,6 +112,7 @@ static void WriteData16(uint16_t data)
 static void lcd_send_cmd(uint32_t cmd, uint8_t *dat, uint32_t len)
 {
 #if LCD_USB_QSPI_DREVER == 1
+  wait_bus();
   TFT_CS_L;
   spi_transaction_t t;
   memset(&t, 0, sizeof(t));
@@ -135,6 +181,10 @@ void rm67162_init(void)
   ret = spi_bus_add_device(TFT_SPI_HOST, &devcfg, &spi);
   ESP_ERROR_CHECK(ret);
 
+#if LCD_ASYNC_FLUSH
+  lcd_flush_start();
+#endif
+
 #else
   SPI.begin(TFT_SCK, -1, TFT_MOSI, TFT_CS);
   SPI.setFrequency(SPI_FREQUENCY);
@@ -234,6 +284,7 @@ void lcd_PushColors(uint16_t x,
   size_t len = width * high;
   uint16_t *p = (uint16_t *)data;
 
+  wait_bus();
   lcd_address_set(x, y, x + width - 1, y + high - 1);
   TFT_CS_L;
   do
@@ -287,6 +338,7 @@ void lcd_PushColors(uint16_t *data, uint32_t len)
 #if LCD_USB_QSPI_DREVER == 1
   bool first_send = 1;
   uint16_t *p = (uint16_t *)data;
+  wait_bus();
   TFT_CS_L;
   do
   {
@@ -333,6 +385,302 @@ void lcd_PushColors(uint16_t *data, uint32_t len)
 #endif
 }
 
+#if LCD_USB_QSPI_DREVER == 1 && LCD_ASYNC_FLUSH
+static void flush_send(const lcd_flush_req_t &req)
+{
+  size_t len = req.width * req.high;
+  const uint16_t *row = req.data;
+  uint16_t col = 0;
+  int queued = 0;
+  int next = 0;
+  bool first_send = 1;
+
+  lcd_address_set(req.x, req.y, req.x + req.width - 1, req.y + req.high - 1);
+  TFT_CS_L;
+  while (len > 0)
+  {
+    spi_transaction_t *done;
+    if (queued == LCD_BOUNCE_BUFFERS)
+    {
+      // Results come back in order: this frees bounce[next]
+      spi_device_get_trans_result(spi, &done, portMAX_DELAY);
+      queued--;
+    }
+
+    size_t chunk_size = len;
+    if (chunk_size > LCD_BOUNCE_PIXELS)
+    {
+      chunk_size = LCD_BOUNCE_PIXELS;
+    }
+
+    // Gather the next chunk_size pixels of the window, row by row
+    uint32_t copy_start = micros();
+    uint16_t *out = bounce[next];
+    size_t left = chunk_size;
+    while (left > 0)
+    {
+      size_t run = req.width - col;
+      if (run > left)
+      {
+        run = left;
+      }
+      memcpy(out, row + col, run * 2);
+      out += run;
+      left -= run;
+      col += run;
+      if (col == req.width)
+      {
+        col = 0;
+        row += req.stride;
+      }
+    }
+    uint32_t copy_us = micros() - copy_start;
+    portENTER_CRITICAL(&flush_mux);
+    flush_stats.copy_us += copy_us;
+    portEXIT_CRITICAL(&flush_mux);
+
+    spi_transaction_ext_t *t = &bounce_trans[next];
+    memset(t, 0, sizeof(*t));
+    if (first_send)
+    {
+      t->base.flags = SPI_TRANS_MODE_QIO;
+      t->base.cmd = 0x32;
+      t->base.addr = 0x002C00;
+      first_send = 0;
+    }
+    else
+    {
+      t->base.flags = SPI_TRANS_MODE_QIO | SPI_TRANS_VARIABLE_CMD |
+                      SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY;
+    }
+    t->base.tx_buffer = bounce[next];
+    t->base.length = chunk_size * 16;
+    spi_device_queue_trans(spi, (spi_transaction_t *)t, portMAX_DELAY);
+    queued++;
+    next = (next + 1) % LCD_BOUNCE_BUFFERS;
+    len -= chunk_size;
+  }
+  while (queued-- > 0)
+  {
+    spi_transaction_t *done;
+    spi_device_get_trans_result(spi, &done, portMAX_DELAY);
+  }
+  TFT_CS_H;
+}
+
+static void flush_task_fn(void *param)
+{
+  lcd_flush_req_t req;
+  for (;;)
+  {
+    xQueueReceive(flush_queue, &req, portMAX_DELAY);
+    uint32_t start = micros();
+    flush_send(req);
+    uint32_t elapsed = micros() - start;
+
+    if (req.done)
+    {
+      req.done(req.arg);
+    }
+    portENTER_CRITICAL(&flush_mux);
+    flush_stats.flushes++;
+    flush_stats.bus_us += elapsed;
+    flush_pending--;
+    portEXIT_CRITICAL(&flush_mux);
+    xEventGroupSetBits(flush_events, FLUSH_DONE_BIT);
+  }
+}
+
+bool lcd_flush_start(void)
+{
+  if (flush_task)
+  {
+    return true;
+  }
+  for (int i = 0; i < LCD_BOUNCE_BUFFERS; i++)
+  {
+    bounce[i] = (uint16_t *)heap_caps_malloc(LCD_BOUNCE_PIXELS * 2, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!bounce[i])
+    {
+      Serial.println("LCD: no DMA memory for the flush buffers, pushes stay synchronous");
+      while (i-- > 0)
+      {
+        heap_caps_free(bounce[i]);
+      }
+      return false;
+    }
+  }
+  flush_queue = xQueueCreate(LCD_FLUSH_QUEUE, sizeof(lcd_flush_req_t));
+  flush_events = xEventGroupCreate();
+  xTaskCreatePinnedToCore(
+      flush_task_fn,  // Task function
+      "LcdFlush",     // Task name
+      3072,           // Stack size (bytes)
+      NULL,           // Task parameter
+      2,              // Priority: above the render loop, so the bus never starves
+      &flush_task,    // Task handle
+      0               // Core ID (0: mining owns core 1)
+  );
+  return flush_task != NULL;
+}
+#else
+bool lcd_flush_start(void)
+{
+  return false;
+}
+#endif
+
+// Rows of a window one at a time, without a flush task
+static void push_rows(uint16_t x, uint16_t y, uint16_t width, uint16_t high, const uint16_t *src, uint16_t stride)
+{
+  lcd_address_set(x, y, x + width - 1, y + high - 1);
+  TFT_CS_L;
+#if LCD_USB_QSPI_DREVER == 1
+  bool first_send = 1;
+  for (uint16_t r = 0; r < high; r++)
+  {
+    const uint16_t *p = src + r * stride;
+    size_t len = width;
+    while (len > 0)
+    {
+      size_t chunk_size = len;
+      spi_transaction_ext_t t;
+      memset(&t, 0, sizeof(t));
+      if (first_send)
+      {
+        t.base.flags = SPI_TRANS_MODE_QIO;
+        t.base.cmd = 0x32;
+        t.base.addr = 0x002C00;
+        first_send = 0;
+      }
+      else
+      {
+        t.base.flags = SPI_TRANS_MODE_QIO | SPI_TRANS_VARIABLE_CMD |
+                       SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY;
+      }
+      if (chunk_size > SEND_BUF_SIZE)
+      {
+        chunk_size = SEND_BUF_SIZE;
+      }
+      t.base.tx_buffer = p;
+      t.base.length = chunk_size * 16;
+      spi_device_polling_transmit(spi, (spi_transaction_t *)&t);
+      len -= chunk_size;
+      p += chunk_size;
+    }
+  }
+#else
+  SPI.beginTransaction(SPISettings(SPI_FREQUENCY, MSBFIRST, TFT_SPI_MODE));
+  TFT_DC_H;
+  for (uint16_t r = 0; r < high; r++)
+  {
+    SPI.writeBytes((uint8_t *)(src + r * stride), width * 2);
+  }
+  SPI.endTransaction();
+#endif
+  TFT_CS_H;
+}
+
+bool lcd_PushRectAsync(uint16_t x,
+                       uint16_t y,
+                       uint16_t width,
+                       uint16_t high,
+                       const uint16_t *src,
+                       uint16_t stride,
+                       lcd_flush_cb_t done,
+                       void *arg)
+{
+#if LCD_USB_QSPI_DREVER == 1 && LCD_ASYNC_FLUSH
+  if (flush_task)
+  {
+    lcd_flush_req_t req = {x, y, width, high, src, stride, done, arg};
+    portENTER_CRITICAL(&flush_mux);
+    flush_pending++;
+    portEXIT_CRITICAL(&flush_mux);
+    xQueueSend(flush_queue, &req, portMAX_DELAY);
+    return true;
+  }
+#endif
+  // No flush task: send it now
+  wait_bus();
+  push_rows(x, y, width, high, src, stride);
+  if (done)
+  {
+    done(arg);
+  }
+  return false;
+}
+
+void lcd_PushRect(uint16_t x,
+                  uint16_t y,
+                  uint16_t width,
+                  uint16_t high,
+                  const uint16_t *src,
+                  uint16_t stride)
+{
+  // The flush task gathers the rows into its DMA buffers: wait for it
+  if (lcd_PushRectAsync(x, y, width, high, src, stride, NULL, NULL))
+  {
+    lcd_wait_flush();
+  }
+}
+
+bool lcd_PushColorsAsync(uint16_t x,
+                         uint16_t y,
+                         uint16_t width,
+                         uint16_t high,
+                         const uint16_t *data,
+                         lcd_flush_cb_t done,
+                         void *arg)
+{
+  return lcd_PushRectAsync(x, y, width, high, data, width, done, arg);
+}
+
+bool lcd_flush_busy(void)
+{
+#if LCD_USB_QSPI_DREVER == 1 && LCD_ASYNC_FLUSH
+  return flush_pending != 0;
+#else
+  return false;
+#endif
+}
+
+void lcd_wait_flush(void)
+{
+#if LCD_USB_QSPI_DREVER == 1 && LCD_ASYNC_FLUSH
+  if (!flush_task || xTaskGetCurrentTaskHandle() == flush_task)
+  {
+    return;
+  }
+  if (flush_pending == 0)
+  {
+    return;
+  }
+  // The bit may be left over from an earlier window: check the count again
+  // after every wake-up. The timeout covers a second waiter clearing the bit.
+  uint32_t start = micros();
+  while (flush_pending != 0)
+  {
+    xEventGroupWaitBits(flush_events, FLUSH_DONE_BIT, pdTRUE, pdTRUE, pdMS_TO_TICKS(10));
+  }
+  uint32_t waited = micros() - start;
+  portENTER_CRITICAL(&flush_mux);
+  flush_stats.wait_us += waited;
+  portEXIT_CRITICAL(&flush_mux);
+#endif
+}
+
+void lcd_get_flush_stats(lcd_flush_stats_t *out)
+{
+#if LCD_USB_QSPI_DREVER == 1 && LCD_ASYNC_FLUSH
+  portENTER_CRITICAL(&flush_mux);
+  *out = flush_stats;
+  portEXIT_CRITICAL(&flush_mux);
+#else
+  *out = flush_stats;
+#endif
+}
+
 void lcd_sleep()
 {
   lcd_send_cmd(0x10, NULL, 0);
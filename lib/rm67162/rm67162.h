@@ -27,6 +27,32 @@
 #define TFT_CS_H digitalWrite(TFT_CS, 1);
 #define TFT_CS_L digitalWrite(TFT_CS, 0);
 
+// Asynchronous pushes: a task streams the queued windows through DMA
+// bounce buffers in internal RAM (0 = lcd_PushColorsAsync() sends at once)
+#ifndef LCD_ASYNC_FLUSH
+#define LCD_ASYNC_FLUSH 1
+#endif
+#ifndef LCD_BOUNCE_PIXELS
+#define LCD_BOUNCE_PIXELS 8192 // Pixels per bounce buffer (16 KB)
+#endif
+#ifndef LCD_BOUNCE_BUFFERS
+#define LCD_BOUNCE_BUFFERS 2   // Transfers in flight
+#endif
+#ifndef LCD_FLUSH_QUEUE
+#define LCD_FLUSH_QUEUE 16     // Windows waiting to be sent
+#endif
+
+// Called by the flush task when a window has been sent
+typedef void (*lcd_flush_cb_t)(void *arg);
+
+typedef struct
+{
+  uint32_t flushes;  // Windows sent by the flush task
+  uint64_t bus_us;   // Flush task: from the window command to the last transfer
+  uint64_t copy_us;  // Flush task: copies into the bounce buffers
+  uint64_t wait_us;  // Callers blocked in lcd_wait_flush()
+} lcd_flush_stats_t;
+
 typedef struct
 {
   uint8_t cmd;
@@ -51,6 +77,40 @@ void lcd_PushColors(uint16_t x,
                     uint16_t high,
                     uint16_t *data);
 void lcd_PushColors(uint16_t *data, uint32_t len);
+
+// Start the flush task (rm67162_init() does it). false if there is no memory.
+bool lcd_flush_start(void);
+// Queue a window and return at once. data must not change until done is
+// called (from the flush task) or lcd_wait_flush() returns. Returns false if
+// it was sent synchronously instead.
+bool lcd_PushColorsAsync(uint16_t x,
+                         uint16_t y,
+                         uint16_t width,
+                         uint16_t high,
+                         const uint16_t *data,
+                         lcd_flush_cb_t done,
+                         void *arg);
+// Sub-rectangle of a larger buffer: row r of the window starts at
+// src + r * stride. The window is set once and the rows are gathered into the
+// DMA buffers as they go out, so there is no intermediate copy of the window.
+bool lcd_PushRectAsync(uint16_t x,
+                       uint16_t y,
+                       uint16_t width,
+                       uint16_t high,
+                       const uint16_t *src,
+                       uint16_t stride,
+                       lcd_flush_cb_t done,
+                       void *arg);
+void lcd_PushRect(uint16_t x,
+                  uint16_t y,
+                  uint16_t width,
+                  uint16_t high,
+                  const uint16_t *src,
+                  uint16_t stride);
+bool lcd_flush_busy(void);
+// Block until every queued window has been sent
+void lcd_wait_flush(void);
+void lcd_get_flush_stats(lcd_flush_stats_t *out);
 void lcd_sleep();
 
 void lcd_on();
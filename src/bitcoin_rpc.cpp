@@ -3,11 +3,80 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <base64.h>
+#include "tls_transport.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Risposte lette in streaming a blocchi di questa dimensione
+#define RPC_STREAM_CHUNK 1024
+#define RPC_TIMEOUT_MS 15000
+
+// Transazioni del template in PSRAM, per sottomettere il blocco completo
+// (un blocco serializzato sta entro 4 MB)
+#define RPC_TX_STORE_BYTES (4 * 1024 * 1024)
+
+// Merkle tree tenuto tra un template e l'altro, in PSRAM (circa 1 MB).
+// Oltre queste transazioni si ricalcola tutto con il branch builder.
+#define RPC_MERKLE_STORE_LEAVES 16384
+
+// Long-poll: bitcoind risponde solo quando il template cambia (nuovo blocco o
+// mempool aggiornato). Oltre questo tempo la richiesta si ripete (HTTPClient
+// accetta timeout fino a 65535 ms).
+#define RPC_LONGPOLL_TIMEOUT_MS 60000
+#define RPC_LONGPOLL_QUICK_MS 1000            // Risposta così rapida e stessa tip: long-poll ignorato?
+#define RPC_LONGPOLL_QUICK_MAX 3              // ...per tante volte di fila: si passa al controllo della tip
+#define RPC_TIP_POLL_MS 5000                  // Fallback: getbestblockhash ogni 5 s
 
 // Configurazione del nodo Bitcoin
 static BitcoinNodeConfig nodeConfig = {0};
 static bool isInitialized = false;
 
+// URL e header di autenticazione calcolati una volta in bitcoin_rpc_init()
+static char rpcUrl[256];
+static char rpcAuth[192];
+static bool rpcHttps = false;
+
+// Sessione RPC: un HTTPClient che resta in vita tra le chiamate, così la
+// connessione si riusa (HTTP/1.1 keep-alive) invece di rifare il TCP, o il
+// TLS, a ogni richiesta. Ogni task ha la sua: non vengono mai condivise.
+// Con https:// il socket è un TlsClient: anche quando la connessione va
+// riaperta, il nodo riprende la sessione TLS e si salta l'handshake completo.
+struct RpcSession {
+    HTTPClient http;
+    WiFiClient tcp;
+    TlsClient tls;
+    bool http10;                  // Il nodo ha risposto chunked: HTTP/1.0, una connessione per chiamata
+    bool reused;                  // La chiamata in corso viaggia su una connessione già aperta
+    unsigned long startMs;
+    BitcoinRpcStats stats;
+};
+static RpcSession minerSession;       // Task di mining (e configurazione, prima che parta)
+static RpcSession longpollSession;    // Task del long-poll
+static rpc_batch_reader_t batchReader;
+
+// Stato del parser getblocktemplate e buffer di lettura (statici: fuori dallo stack del task)
+static gbt_parser_t gbtParser;
+static char streamChunk[RPC_STREAM_CHUNK];
+static uint8_t* txStore = NULL;
+static merkle_store_t merkleStore;
+static bool merkleStoreReady = false;
+
+// Long-poll in background. Legge dalla risposta solo l'inizio (fino a
+// previousblockhash): il template completo lo scarica il miner, così lo store
+// delle transazioni lo scrive solo il task che poi sottomette il blocco.
+static TaskHandle_t longpollTaskHandle = NULL;
+static volatile bool longpollRunning = false;
+static gbt_parser_t longpollParser;
+static BitcoinBlockTemplate longpollTemplate;
+static char longpollChunk[RPC_STREAM_CHUNK];
+
+// Template in uso dal miner e contatore dei cambi (condivisi tra i due task)
+static portMUX_TYPE templateMux = portMUX_INITIALIZER_UNLOCKED;
+static char currentLongpollId[GBT_LONGPOLLID_MAX];
+static char currentPrevhash[65];
+static volatile uint32_t templateGeneration = 0;
+static volatile unsigned long templateChangedMs = 0;
+
 // Nodi pubblici Bitcoin (mainnet e testnet)
 // NOTA: Per mining reale serve un nodo locale completo!
 // Questi sono solo per demo/test
@@ -30,6 +99,25 @@ bool bitcoin_rpc_init(const char* host, uint16_t port, const char* user, const c
     if(user) strcpy(nodeConfig.username, user);
     if(pass) strcpy(nodeConfig.password, pass);
     
+    if(nodeConfig.port == 443 || strstr(nodeConfig.host, "https://")) {
+        snprintf(rpcUrl, sizeof(rpcUrl), "%s", nodeConfig.host);
+    } else {
+        snprintf(rpcUrl, sizeof(rpcUrl), "http://%s:%d", nodeConfig.host, nodeConfig.port);
+    }
+    rpcHttps = strncmp(rpcUrl, "https://", 8) == 0;
+    
+    // Header per autenticazione Basic, uguale per tutte le chiamate
+    rpcAuth[0] = '\0';
+    if(strlen(nodeConfig.username) > 0) {
+        String auth = String(nodeConfig.username) + ":" + String(nodeConfig.password);
+        snprintf(rpcAuth, sizeof(rpcAuth), "Basic %s", base64::encode(auth).c_str());
+    }
+    
+    // Nodo nuovo: le connessioni aperte verso il vecchio non servono più
+    minerSession.http.setReuse(false);
+    minerSession.http.end();
+    minerSession.http10 = false;
+    
     isInitialized = true;
     
     Serial.println("╔════════════════════════════════════════════════════════╗");
@@ -41,8 +129,9 @@ bool bitcoin_rpc_init(const char* host, uint16_t port, const char* user, const c
     return true;
 }
 
-// Esegue una chiamata RPC al nodo Bitcoin
-bool bitcoin_rpc_call(const char* method, const char* params, JsonDocument& response)
+// Prepara una richiesta HTTP verso il nodo (URL, timeout, autenticazione).
+// Se la sessione ha ancora una connessione aperta, la richiesta parte su quella.
+static bool rpc_begin(RpcSession* session, const char* method, uint32_t wait_ms, bool verbose)
 {
     if(!isInitialized) {
         Serial.println("❌ RPC non inizializzato!");
@@ -54,55 +143,151 @@ bool bitcoin_rpc_call(const char* method, const char* params, JsonDocument& resp
         return false;
     }
     
-    HTTPClient http;
-    
-    // Costruisci URL
-    char url[256];
-    if(nodeConfig.port == 443 || strstr(nodeConfig.host, "https://")) {
-        snprintf(url, sizeof(url), "%s", nodeConfig.host);
-    } else {
-        snprintf(url, sizeof(url), "http://%s:%d", nodeConfig.host, nodeConfig.port);
+    if(verbose) {
+        Serial.printf("📡 Chiamata RPC: %s\n", method);
     }
     
-    Serial.printf("📡 Chiamata RPC: %s\n", method);
-    
-    http.begin(url);
-    http.setTimeout(15000); // 15 secondi timeout
-    
-    // Header per autenticazione Basic
-    if(strlen(nodeConfig.username) > 0) {
-        String auth = String(nodeConfig.username) + ":" + String(nodeConfig.password);
-        String authEncoded = base64::encode(auth);
-        http.addHeader("Authorization", "Basic " + authEncoded);
+    HTTPClient& http = session->http;
+    http.setReuse(!session->http10);
+    http.useHTTP10(session->http10);
+    // Sempre begin(client, url): la connessione resta del client della sessione tra una chiamata e l'altra
+    WiFiClient& client = rpcHttps ? session->tls : session->tcp;
+    if(!http.begin(client, rpcUrl)) {
+        Serial.printf("❌ URL del nodo non valido: %s\n", rpcUrl);
+        return false;
+    }
+    http.setTimeout(wait_ms);
+    if(rpcAuth[0]) {
+        http.addHeader("Authorization", rpcAuth);
     }
-    
     http.addHeader("Content-Type", "application/json");
     
-    // Costruisci payload JSON-RPC
-    JsonDocument requestDoc;
-    requestDoc["jsonrpc"] = "1.0";
-    requestDoc["id"] = "esp32";
-    requestDoc["method"] = method;
-    
-    // Aggiungi parametri se presenti (come array vuoto se non ci sono parametri)
-    JsonArray paramsArray = requestDoc["params"].to<JsonArray>();
+    session->reused = http.connected();
+    if(!session->reused) {
+        session->stats.connections++;
+    }
+    return true;
+}
+
+// Chiude la connessione della sessione: la prossima richiesta ne apre una nuova
+static void rpc_close(RpcSession* session)
+{
+    session->http.setReuse(false);
+    session->http.end();
+}
+
+// Corpo di submitblock come Stream: HTTPClient lo legge a pezzi e li scrive
+// sul socket, l'hex del blocco viene generato man mano dal template in PSRAM
+class SubmitBodyStream : public Stream {
+public:
+    explicit SubmitBodyStream(solo_submit_body_t* body) : body(body) {}
+    int available() override { return (int)(body->body_len - body->pos); }
+    int read() override {
+        char c;
+        return solo_submit_body_read(body, &c, 1) == 1 ? (uint8_t)c : -1;
+    }
+    int peek() override {
+        solo_submit_body_t copy = *body;
+        char c;
+        return solo_submit_body_read(&copy, &c, 1) == 1 ? (uint8_t)c : -1;
+    }
+    size_t readBytes(char* buffer, size_t length) override { return solo_submit_body_read(body, buffer, length); }
+    size_t write(uint8_t) override { return 0; }
+    void flush() override {}
+    // Da capo, per ripetere la richiesta su un'altra connessione
+    void rewind() {
+        body->pos = 0;
+        body->segment = 0;
+        body->segment_pos = 0;
+    }
+private:
+    solo_submit_body_t* body;
+};
+
+// Invia la richiesta (corpo in memoria, o in streaming da stream). Se la
+// connessione riusata era già stata chiusa dal nodo (bitcoind chiude quelle
+// inattive dopo rpcservertimeout) si riprova una volta su una connessione nuova.
+static int rpc_post(RpcSession* session, const char* method, const char* body, size_t len, SubmitBodyStream* stream,
+                    uint32_t wait_ms, bool verbose)
+{
+    session->startMs = millis();
+    for(int attempt = 0; ; attempt++) {
+        if(!rpc_begin(session, method, wait_ms, verbose && attempt == 0)) {
+            return HTTPC_ERROR_NOT_CONNECTED;
+        }
+        int httpCode = stream ? session->http.sendRequest("POST", stream, len)
+                              : session->http.POST((uint8_t*)body, len);
+        bool closed = httpCode == HTTPC_ERROR_SEND_HEADER_FAILED || httpCode == HTTPC_ERROR_SEND_PAYLOAD_FAILED ||
+                      httpCode == HTTPC_ERROR_NOT_CONNECTED || httpCode == HTTPC_ERROR_CONNECTION_LOST;
+        if(!closed || !session->reused || attempt > 0) {
+            return httpCode;
+        }
+        session->stats.retries++;
+        rpc_close(session);
+        if(stream) {
+            stream->rewind();
+        }
+    }
+}
+
+// Fine della chiamata: tempi nelle statistiche. complete = corpo letto tutto,
+// altrimenti il resto resterebbe sulla connessione e va chiusa.
+static void rpc_done(RpcSession* session, const char* method, bool complete, bool verbose)
+{
+    if(!complete) {
+        session->http.setReuse(false);
+    }
+    session->http.end();
+    
+    uint32_t ms = millis() - session->startMs;
+    BitcoinRpcStats* stats = &session->stats;
+    stats->calls++;
+    stats->last_ms = ms;
+    stats->total_ms += ms;
+    if(ms > stats->max_ms) {
+        stats->max_ms = ms;
+    }
+    strncpy(stats->last_method, method, sizeof(stats->last_method) - 1);
+    if(verbose) {
+        Serial.printf("⏱️  %s: %u ms (%s, %u connessioni per %u chiamate)\n", method, (unsigned)ms,
+                      session->reused ? "connessione riusata" : "connessione nuova", (unsigned)stats->connections,
+                      (unsigned)stats->calls);
+    }
+}
+
+// Corpo di una singola chiamata JSON-RPC; false se non sta in out
+static bool rpc_body(char* out, size_t size, const char* method, const char* params)
+{
+    int len = snprintf(out, size, "{\"jsonrpc\":\"1.0\",\"id\":\"esp32\",\"method\":\"%s\",\"params\":%s}",
+                       method, params ? params : "[]");
+    return len > 0 && (size_t)len < size;
+}
+
+// Esegue una chiamata RPC al nodo Bitcoin
+bool bitcoin_rpc_call(const char* method, const char* params, JsonDocument& response)
+{
+    HTTPClient& http = minerSession.http;
     
-    String requestBody;
-    serializeJson(requestDoc, requestBody);
+    // Payload JSON-RPC: params è già JSON (un array), NULL = nessun parametro
+    char requestBody[512];
+    if(!rpc_body(requestBody, sizeof(requestBody), method, params)) {
+        Serial.printf("❌ Parametri troppo lunghi per %s\n", method);
+        return false;
+    }
     
     // Esegui richiesta POST
-    int httpCode = http.POST(requestBody);
+    int httpCode = rpc_post(&minerSession, method, requestBody, strlen(requestBody), NULL, RPC_TIMEOUT_MS, true);
     
     if(httpCode > 0) {
         if(httpCode == HTTP_CODE_OK) {
             String payload = http.getString();
+            rpc_done(&minerSession, method, true, true);
             
             // Parse risposta
             DeserializationError error = deserializeJson(response, payload);
             
             if(error) {
                 Serial.printf("❌ Errore parsing JSON: %s\n", error.c_str());
-                http.end();
                 return false;
             }
             
@@ -111,12 +296,10 @@ bool bitcoin_rpc_call(const char* method, const char* params, JsonDocument& resp
                 Serial.println("❌ Errore RPC:");
                 serializeJsonPretty(response["error"], Serial);
                 Serial.println();
-                http.end();
                 return false;
             }
             
             Serial.println("✅ Risposta ricevuta");
-            http.end();
             return true;
             
         } else {
@@ -126,10 +309,126 @@ bool bitcoin_rpc_call(const char* method, const char* params, JsonDocument& resp
         Serial.printf("❌ Errore connessione: %s\n", http.errorToString(httpCode).c_str());
     }
     
-    http.end();
+    rpc_done(&minerSession, method, false, false);
     return false;
 }
 
+// Chiamata RPC con risposta in streaming: il corpo passa a blocchi da
+// RPC_STREAM_CHUNK byte (in chunk) a sink() e non viene mai accumulato in RAM.
+// sink() ritorna false per interrompere la lettura. wait_ms: attesa massima
+// della risposta (il long-poll aspetta minuti, le altre chiamate no).
+// body: la richiesta JSON-RPC già pronta (una chiamata o un batch).
+static bool bitcoin_rpc_call_stream(RpcSession* session, const char* method, const char* body, uint32_t wait_ms,
+                                    char* chunk, bool (*sink)(const char* data, size_t len, void* arg), void* arg)
+{
+    HTTPClient& http = session->http;
+    int httpCode = rpc_post(session, method, body, strlen(body), NULL, wait_ms, true);
+    
+    // bitcoind risponde 500 con un JSON di errore: lo leggiamo comunque per il messaggio
+    if(httpCode != HTTP_CODE_OK && httpCode != HTTP_CODE_INTERNAL_SERVER_ERROR) {
+        if(httpCode > 0) {
+            Serial.printf("❌ HTTP error: %d\n", httpCode);
+        } else {
+            Serial.printf("❌ Errore connessione: %s\n", http.errorToString(httpCode).c_str());
+        }
+        rpc_done(session, method, false, false);
+        return false;
+    }
+    
+    WiFiClient* stream = http.getStreamPtr();
+    int remaining = http.getSize();    // -1: fino alla chiusura della connessione
+    
+    // Il parser vuole il corpo così com'è: con HTTP/1.1 un corpo senza lunghezza
+    // è chunked. Da qui la sessione resta su HTTP/1.0 (senza keep-alive).
+    if(remaining < 0 && !session->http10) {
+        Serial.println("⚠️  Risposta chunked: la sessione passa a HTTP/1.0");
+        session->http10 = true;
+        rpc_done(session, method, false, false);
+        return bitcoin_rpc_call_stream(session, method, body, wait_ms, chunk, sink, arg);
+    }
+    
+    size_t total = 0;
+    bool ok = true;
+    unsigned long lastData = millis();
+    
+    while(ok && remaining != 0 && (stream->connected() || stream->available())) {
+        size_t available = stream->available();
+        if(available == 0) {
+            if(millis() - lastData > RPC_TIMEOUT_MS) {
+                Serial.println("❌ Timeout lettura risposta");
+                ok = false;
+                break;
+            }
+            delay(1);
+            continue;
+        }
+        
+        size_t toRead = available < RPC_STREAM_CHUNK ? available : RPC_STREAM_CHUNK;
+        if(remaining > 0 && toRead > (size_t)remaining) {
+            toRead = remaining;
+        }
+        size_t got = stream->readBytes(chunk, toRead);
+        if(got == 0) {
+            continue;
+        }
+        lastData = millis();
+        total += got;
+        if(remaining > 0) {
+            remaining -= got;
+        }
+        ok = sink(chunk, got, arg);
+    }
+    
+    if(ok && remaining > 0) {
+        Serial.printf("❌ Risposta troncata (%d byte mancanti)\n", remaining);
+        ok = false;
+    }
+    
+    Serial.printf("📥 %s: %u byte letti in streaming\n", method, (unsigned)total);
+    rpc_done(session, method, remaining == 0, true);
+    return ok;
+}
+
+static bool batch_sink(const char* data, size_t len, void* arg)
+{
+    return rpc_batch_reader_feed((rpc_batch_reader_t*)arg, data, len);
+}
+
+// Più chiamate in una sola richiesta HTTP (un giro di rete): i valori dei
+// result arrivano a callback in streaming, con l'indice della chiamata
+bool bitcoin_rpc_batch(const rpc_call_t* calls, int count, rpc_batch_callback_t callback, void* arg)
+{
+    char body[512];
+    if(!rpc_batch_request(body, sizeof(body), calls, count)) {
+        Serial.printf("❌ Batch RPC troppo grande (%d chiamate)\n", count);
+        return false;
+    }
+    
+    rpc_batch_reader_init(&batchReader, count, callback, arg);
+    bool ok = bitcoin_rpc_call_stream(&minerSession, "batch", body, RPC_TIMEOUT_MS, streamChunk, batch_sink,
+                                      &batchReader) &&
+              rpc_batch_reader_finish(&batchReader);
+    if(!ok) {
+        Serial.printf("❌ Batch RPC fallito: %s\n", rpc_batch_reader_error(&batchReader));
+        return false;
+    }
+    minerSession.stats.batched_calls += count;
+    
+    for(int i = 0; i < count; i++) {
+        if(batchReader.replies[i].error) {
+            Serial.printf("❌ Errore RPC in %s: %s\n", calls[i].method,
+                          batchReader.replies[i].message[0] ? batchReader.replies[i].message : "errore RPC");
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static bool gbt_sink(const char* data, size_t len, void* arg)
+{
+    return gbt_parser_feed((gbt_parser_t*)arg, data, len);
+}
+
 // Ottiene il block template dal nodo Bitcoin
 bool bitcoin_rpc_get_block_template(BitcoinBlockTemplate* block_template)
 {
@@ -140,13 +439,39 @@ bool bitcoin_rpc_get_block_template(BitcoinBlockTemplate* block_template)
     Serial.println("📦 Recupero Block Template dalla blockchain...");
     Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     
-    JsonDocument response;
-    
     // Parametri per getblocktemplate
     const char* params = "[{\"rules\": [\"segwit\"]}]";
     
-    if(!bitcoin_rpc_call("getblocktemplate", params, response)) {
-        Serial.println("❌ Impossibile ottenere block template!");
+    gbt_parser_init(&gbtParser, block_template);
+    
+    // Store delle transazioni allocato una volta sola; senza PSRAM si mina il blocco con la sola coinbase
+    if(!txStore && psramFound()) {
+        txStore = (uint8_t*)ps_malloc(RPC_TX_STORE_BYTES);
+    }
+    if(txStore) {
+        gbt_parser_set_tx_store(&gbtParser, txStore, RPC_TX_STORE_BYTES);
+    }
+    
+    // Idem per il merkle tree: senza PSRAM ogni template lo ricalcola da zero
+    if(!merkleStoreReady && psramFound()) {
+        size_t bytes = merkle_store_bytes(RPC_MERKLE_STORE_LEAVES);
+        void* buffer = ps_malloc(bytes);
+        merkleStoreReady = merkle_store_init(&merkleStore, buffer, bytes, RPC_MERKLE_STORE_LEAVES);
+        if(!merkleStoreReady) {
+            free(buffer);
+        }
+    }
+    if(merkleStoreReady) {
+        gbt_parser_set_merkle_store(&gbtParser, &merkleStore);
+    }
+    unsigned long startMs = millis();
+    
+    char body[128];
+    rpc_body(body, sizeof(body), "getblocktemplate", params);
+    if(!bitcoin_rpc_call_stream(&minerSession, "getblocktemplate", body, RPC_TIMEOUT_MS, streamChunk, gbt_sink,
+                                &gbtParser) ||
+       !gbt_parser_finish(&gbtParser)) {
+        Serial.printf("❌ Impossibile ottenere block template! (%s)\n", gbt_parser_error(&gbtParser));
         Serial.println("💡 Suggerimenti:");
         Serial.println("   - Verifica che il nodo sia sincronizzato");
         Serial.println("   - Controlla credenziali RPC");
@@ -154,31 +479,11 @@ bool bitcoin_rpc_get_block_template(BitcoinBlockTemplate* block_template)
         return false;
     }
     
-    JsonObject result = response["result"];
-    
-    // Estrai dati dal template
-    block_template->version = result["version"] | 0;
-    
-    const char* prevhash = result["previousblockhash"] | "";
-    strncpy(block_template->previousblockhash, prevhash, 64);
-    block_template->previousblockhash[64] = '\0';
-    
-    block_template->curtime = result["curtime"] | 0;
-    block_template->height = result["height"] | 0;
-    
-    // Bits (difficulty target in compact format)
-    const char* bitsStr = result["bits"] | "1d00ffff";
-    block_template->bits = strtoul(bitsStr, NULL, 16);
-    
-    // Conta transazioni
-    JsonArray transactions = result["transactions"];
-    block_template->transactions_count = transactions.size();
-    
-    // Per ora usiamo un merkle root semplificato
-    // In un vero miner dovresti calcolare il merkle tree da tutte le transazioni
-    snprintf(block_template->merkleroot, 65, "0000000000000000000000000000000000000000000000000000000000000000");
-    
-    block_template->valid = true;
+    // Template del miner: il long-poll aspetta il prossimo cambio da qui
+    portENTER_CRITICAL(&templateMux);
+    strcpy(currentLongpollId, block_template->longpollid);
+    strcpy(currentPrevhash, block_template->previousblockhash);
+    portEXIT_CRITICAL(&templateMux);
     
     // Stampa info
     Serial.println();
@@ -188,8 +493,17 @@ bool bitcoin_rpc_get_block_template(BitcoinBlockTemplate* block_template)
     Serial.printf("🔢 Altezza blocco: %u\n", block_template->height);
     Serial.printf("📅 Timestamp: %u\n", block_template->curtime);
     Serial.printf("🎯 Difficulty bits: 0x%08x\n", block_template->bits);
-    Serial.printf("📝 Transazioni: %d\n", block_template->transactions_count);
+    Serial.printf("📝 Transazioni: %d (%u byte in PSRAM%s)\n", block_template->transactions_count,
+                  (unsigned)block_template->tx_data_len, block_template->tx_data_complete ? "" : ", incompleto");
+    Serial.printf("💰 Coinbase value: %llu sat (fee %llu)\n", (unsigned long long)block_template->coinbasevalue,
+                  (unsigned long long)block_template->fees);
+    Serial.printf("🌳 Merkle branch: %d livelli (letto in %lu ms)\n", block_template->merkle_branch_len,
+                  millis() - startMs);
+    if(gbtParser.merkle_store) {
+        Serial.printf("   Ricalcolati solo i percorsi cambiati: %u hash\n", (unsigned)merkleStore.hashes);
+    }
     Serial.printf("🔗 Hash precedente:\n   %s\n", block_template->previousblockhash);
+    Serial.printf("🔔 Aggiornamenti: %s\n", block_template->longpollid[0] ? "long-poll" : "controllo getbestblockhash");
     Serial.println();
     Serial.println("⚠️  NOTA IMPORTANTE:");
     Serial.println("   La difficoltà REALE di Bitcoin è ENORME!");
@@ -231,24 +545,50 @@ bool bitcoin_rpc_get_blockchain_info(uint32_t* block_height, char* chain)
     return true;
 }
 
-// Sottomette un blocco trovato
-bool bitcoin_rpc_submit_block(const char* block_hex)
+// Sottomette un blocco trovato. Il blocco (anche megabyte) non viene mai
+// serializzato in RAM: il corpo della richiesta esce in streaming.
+bool bitcoin_rpc_submit_block(const uint8_t header[80], const solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl)
 {
-    if(!block_hex) return false;
+    if(!header || !cb || !tmpl) return false;
+    
+    solo_submit_body_t body;
+    solo_submit_body_init(&body, header, cb, tmpl);
     
     Serial.println();
     Serial.println("╔════════════════════════════════════════════════════════╗");
     Serial.println("║           🚀 SOTTOMISSIONE BLOCCO                     ║");
     Serial.println("╚════════════════════════════════════════════════════════╝");
-    Serial.println("📤 Inviando blocco al nodo...");
+    Serial.printf("📤 Inviando blocco al nodo (%u byte)...\n", (unsigned)body.block_size);
     
-    JsonDocument response;
+    HTTPClient& http = minerSession.http;
     
-    char params[512];
-    snprintf(params, sizeof(params), "[\"%s\"]", block_hex);
+    // Corpo JSON-RPC costruito a mano: il blocco non passa per ArduinoJson
+    SubmitBodyStream stream(&body);
+    int httpCode = rpc_post(&minerSession, "submitblock", NULL, body.body_len, &stream, RPC_TIMEOUT_MS, true);
+    if(httpCode > 0 && body.pos != body.body_len) {
+        Serial.printf("⚠️  Inviati %u di %u byte\n", (unsigned)body.pos, (unsigned)body.body_len);
+    }
     
-    if(!bitcoin_rpc_call("submitblock", params, response)) {
-        Serial.println("❌ Errore sottomissione blocco!");
+    if(httpCode != HTTP_CODE_OK && httpCode != HTTP_CODE_INTERNAL_SERVER_ERROR) {
+        if(httpCode > 0) {
+            Serial.printf("❌ HTTP error: %d\n", httpCode);
+        } else {
+            Serial.printf("❌ Errore connessione: %s\n", http.errorToString(httpCode).c_str());
+        }
+        rpc_done(&minerSession, "submitblock", false, false);
+        return false;
+    }
+    
+    JsonDocument response;
+    DeserializationError error = deserializeJson(response, http.getString());
+    rpc_done(&minerSession, "submitblock", true, true);
+    if(error) {
+        Serial.printf("❌ Errore parsing JSON: %s\n", error.c_str());
+        return false;
+    }
+    if(!response["error"].isNull()) {
+        const char* message = response["error"]["message"] | "errore RPC";
+        Serial.printf("❌ Errore sottomissione blocco: %s\n", message);
         return false;
     }
     
@@ -263,26 +603,257 @@ bool bitcoin_rpc_submit_block(const char* block_hex)
         Serial.println();
         return true;
     } else {
-        Serial.println("❌ Blocco rifiutato:");
-        serializeJsonPretty(response["result"], Serial);
-        Serial.println();
+        // Motivo del rifiuto (BIP22), es. "high-hash", "bad-txnmrklroot"
+        const char* reason = response["result"] | "sconosciuto";
+        Serial.printf("❌ Blocco rifiutato: %s\n", reason);
         return false;
     }
 }
 
+// Segnala al miner un template nuovo: il lavoro corrente è superato
+static void template_changed(const char* reason)
+{
+    portENTER_CRITICAL(&templateMux);
+    templateChangedMs = millis();
+    templateGeneration++;
+    portEXIT_CRITICAL(&templateMux);
+    Serial.printf("🔔 %s: nuovo lavoro per il miner\n", reason);
+}
+
+// Basta previousblockhash (nei primi byte del corpo): poi si chiude la connessione
+static bool longpoll_sink(const char* data, size_t len, void* arg)
+{
+    gbt_parser_t* parser = (gbt_parser_t*)arg;
+    return gbt_parser_feed(parser, data, len) && parser->tmpl->previousblockhash[0] == 0;
+}
+
+// Un long-poll: true quando il nodo risponde con un template, con la sua tip
+static bool longpoll_wait(const char* id)
+{
+    char params[GBT_LONGPOLLID_MAX + 64];
+    snprintf(params, sizeof(params), "[{\"rules\":[\"segwit\"],\"longpollid\":\"%s\"}]", id);
+    
+    char body[GBT_LONGPOLLID_MAX + 160];
+    rpc_body(body, sizeof(body), "getblocktemplate", params);
+    
+    gbt_parser_init(&longpollParser, &longpollTemplate);
+    bitcoin_rpc_call_stream(&longpollSession, "getblocktemplate", body, RPC_LONGPOLL_TIMEOUT_MS, longpollChunk,
+                            longpoll_sink, &longpollParser);
+    return longpollTemplate.previousblockhash[0] != 0;
+}
+
+// Fallback senza long-poll: la tip del nodo è ancora quella del template?
+static void tip_poll(const char* prevhash)
+{
+    // Ogni 5 s sulla stessa connessione: niente handshake a ogni controllo
+    HTTPClient& http = longpollSession.http;
+    static const char body[] = "{\"jsonrpc\":\"1.0\",\"id\":\"esp32\",\"method\":\"getbestblockhash\",\"params\":[]}";
+    int httpCode = rpc_post(&longpollSession, "getbestblockhash", body, sizeof(body) - 1, NULL, RPC_TIMEOUT_MS, false);
+    if(httpCode != HTTP_CODE_OK) {
+        rpc_done(&longpollSession, "getbestblockhash", false, false);
+        return;
+    }
+    JsonDocument response;
+    DeserializationError error = deserializeJson(response, http.getString());
+    rpc_done(&longpollSession, "getbestblockhash", true, false);
+    
+    const char* best = response["result"] | "";
+    if(error || strlen(best) != 64 || strcmp(best, prevhash) == 0) {
+        return;
+    }
+    portENTER_CRITICAL(&templateMux);
+    strcpy(currentPrevhash, best);
+    portEXIT_CRITICAL(&templateMux);
+    template_changed("Nuovo blocco (getbestblockhash)");
+}
+
+static void longpollTask(void* parameter)
+{
+    bool supported = true;
+    int quickReturns = 0;
+    
+    for(;;) {
+        // Stop richiesto: si esce solo qui, tra una richiesta e l'altra. La
+        // connessione si chiude prima che un nuovo start possa riusare la sessione.
+        if(!longpollRunning) {
+            rpc_close(&longpollSession);
+        }
+        portENTER_CRITICAL(&templateMux);
+        bool running = longpollRunning;
+        if(!running) {
+            longpollTaskHandle = NULL;
+        }
+        portEXIT_CRITICAL(&templateMux);
+        if(!running) {
+            break;
+        }
+        
+        char id[GBT_LONGPOLLID_MAX];
+        char prevhash[65];
+        portENTER_CRITICAL(&templateMux);
+        strcpy(id, currentLongpollId);
+        strcpy(prevhash, currentPrevhash);
+        portEXIT_CRITICAL(&templateMux);
+        
+        if(WiFi.status() != WL_CONNECTED || prevhash[0] == 0) {
+            vTaskDelay(250 / portTICK_PERIOD_MS);
+            continue;
+        }
+        
+        if(supported && id[0]) {
+            unsigned long startMs = millis();
+            if(!longpoll_wait(id)) {
+                // Nodo irraggiungibile o timeout: un giro di fallback prima di riprovare
+                tip_poll(prevhash);
+                for(int waited = 0; waited < RPC_TIP_POLL_MS && longpollRunning; waited += 250) {
+                    vTaskDelay(250 / portTICK_PERIOD_MS);
+                }
+                continue;
+            }
+            
+            bool newBlock = strcmp(longpollTemplate.previousblockhash, prevhash) != 0;
+            if(!newBlock && millis() - startMs < RPC_LONGPOLL_QUICK_MS) {
+                // Risposte immediate con la stessa tip: il nodo ignora longpollid
+                if(++quickReturns >= RPC_LONGPOLL_QUICK_MAX) {
+                    supported = false;
+                    Serial.println("⚠️  Il nodo ignora il long-poll: controllo getbestblockhash ogni 5 s");
+                }
+            } else {
+                quickReturns = 0;
+            }
+            if(newBlock) {
+                // Tip nota al miner anche se il suo download del template fallisce
+                portENTER_CRITICAL(&templateMux);
+                strcpy(currentPrevhash, longpollTemplate.previousblockhash);
+                portEXIT_CRITICAL(&templateMux);
+            }
+            if(longpollRunning) {
+                template_changed(newBlock ? "Nuovo blocco (long-poll)" : "Template aggiornato (long-poll)");
+            }
+            
+            // Il prossimo long-poll parte dall'id del template che il miner scarica ora
+            while(longpollRunning) {
+                portENTER_CRITICAL(&templateMux);
+                bool same = strcmp(id, currentLongpollId) == 0;
+                portEXIT_CRITICAL(&templateMux);
+                if(!same) {
+                    break;
+                }
+                vTaskDelay(50 / portTICK_PERIOD_MS);
+            }
+        } else {
+            tip_poll(prevhash);
+            for(int waited = 0; waited < RPC_TIP_POLL_MS && longpollRunning; waited += 250) {
+                vTaskDelay(250 / portTICK_PERIOD_MS);
+            }
+        }
+    }
+    
+    Serial.printf("🔔 Long-poll fermo: %u chiamate su %u connessioni\n", (unsigned)longpollSession.stats.calls,
+                  (unsigned)longpollSession.stats.connections);
+    vTaskDelete(NULL);
+}
+
+void bitcoin_rpc_longpoll_start(void)
+{
+    portENTER_CRITICAL(&templateMux);
+    longpollRunning = true;
+    bool create = longpollTaskHandle == NULL;
+    portEXIT_CRITICAL(&templateMux);
+    if(!create) {
+        return;    // Ancora vivo (magari in attesa dopo uno stop): continua lui
+    }
+    
+    // Core 0 insieme al WiFi: il core del mining non aspetta mai il nodo
+    xTaskCreatePinnedToCore(
+        longpollTask,         // Task function
+        "LongPoll",           // Task name
+        6144,                 // Stack size (bytes)
+        NULL,                 // Task parameter
+        1,                    // Priority (1 = low)
+        &longpollTaskHandle,  // Task handle
+        0                     // Core ID
+    );
+}
+
+void bitcoin_rpc_longpoll_stop(void)
+{
+    // Non blocca: un long-poll in corso può durare minuti, il task esce quando torna
+    longpollRunning = false;
+}
+
+uint32_t bitcoin_rpc_template_generation(void)
+{
+    return templateGeneration;
+}
+
+unsigned long bitcoin_rpc_template_changed_ms(void)
+{
+    return templateChangedMs;
+}
+
+bool bitcoin_rpc_tip_changed(const char* prevhash)
+{
+    portENTER_CRITICAL(&templateMux);
+    bool changed = currentPrevhash[0] && strcmp(currentPrevhash, prevhash) != 0;
+    portEXIT_CRITICAL(&templateMux);
+    return changed;
+}
+
+void bitcoin_rpc_get_stats(BitcoinRpcStats* out)
+{
+    *out = minerSession.stats;
+}
+
+// Campi letti dal batch del test di connessione
+struct NodeInfo {
+    char chain[16];
+    uint32_t blocks;
+    bool initialBlockDownload;
+    char subversion[48];
+};
+
+static void node_info_value(int call, json_stream_t* js, json_event_t event, const char* value, size_t len, void* arg)
+{
+    NodeInfo* info = (NodeInfo*)arg;
+    if(js->depth != 3) {
+        return;
+    }
+    const char* key = json_stream_key(js, 2);
+    if(call == 0) {
+        if(event == JSON_EVENT_STRING && strcmp(key, "chain") == 0) {
+            strncpy(info->chain, value, sizeof(info->chain) - 1);
+        } else if(event == JSON_EVENT_NUMBER && strcmp(key, "blocks") == 0) {
+            info->blocks = strtoul(value, NULL, 10);
+        } else if(strcmp(key, "initialblockdownload") == 0) {
+            info->initialBlockDownload = event == JSON_EVENT_TRUE;
+        }
+    } else if(event == JSON_EVENT_STRING && strcmp(key, "subversion") == 0) {
+        strncpy(info->subversion, value, sizeof(info->subversion) - 1);
+    }
+}
+
 // Test connessione al nodo
 bool bitcoin_rpc_test_connection(void)
 {
     Serial.println();
     Serial.println("🔍 Test connessione al nodo Bitcoin...");
     
-    char chain[32] = {0};
-    uint32_t height = 0;
+    // Catena e versione del nodo in un solo batch: un giro di rete
+    static const rpc_call_t calls[] = {
+        {"getblockchaininfo", NULL},
+        {"getnetworkinfo", NULL}
+    };
+    NodeInfo info = {};
     
-    if(bitcoin_rpc_get_blockchain_info(&height, chain)) {
+    if(bitcoin_rpc_batch(calls, 2, node_info_value, &info)) {
         Serial.println("✅ Connessione al nodo Bitcoin riuscita!");
-        Serial.printf("   Network: %s\n", chain);
-        Serial.printf("   Altezza blockchain: %u\n", height);
+        Serial.printf("   Network: %s\n", info.chain);
+        Serial.printf("   Altezza blockchain: %u\n", info.blocks);
+        Serial.printf("   Nodo: %s\n", info.subversion[0] ? info.subversion : "versione sconosciuta");
+        if(info.initialBlockDownload) {
+            Serial.println("⚠️  Il nodo sta ancora sincronizzando: niente template fino alla fine");
+        }
         Serial.println();
         return true;
     } else {
@@ -2,18 +2,10 @@
 #define BITCOIN_RPC_H
 
 #include <Arduino.h>
-
-// Struttura per il block template ricevuto dal nodo Bitcoin
-struct BitcoinBlockTemplate {
-    uint32_t version;
-    char previousblockhash[65];
-    char merkleroot[65];
-    uint32_t curtime;
-    uint32_t bits;
-    uint32_t height;
-    int transactions_count;
-    bool valid;
-};
+#include <ArduinoJson.h>
+#include "gbt_parser.h"
+#include "rpc_batch.h"
+#include "solo_block.h"
 
 // Configurazione nodo Bitcoin
 struct BitcoinNodeConfig {
@@ -23,11 +15,51 @@ struct BitcoinNodeConfig {
     char password[64];
 };
 
+// Statistiche di una sessione RPC (connessione keep-alive riusata tra le chiamate)
+struct BitcoinRpcStats {
+    uint32_t calls;            // Richieste HTTP (un batch conta una volta)
+    uint32_t batched_calls;    // Chiamate viaggiate dentro un batch
+    uint32_t connections;      // Connessioni aperte: le altre chiamate hanno riusato quella aperta
+    uint32_t retries;          // Richieste ripetute perché il nodo aveva chiuso la connessione inattiva
+    uint32_t last_ms;          // Ultima chiamata, dall'invio alla risposta letta tutta
+    uint32_t max_ms;
+    uint32_t total_ms;
+    char last_method[24];
+};
+
 // Funzioni per comunicare con nodo Bitcoin
 bool bitcoin_rpc_init(const char* host, uint16_t port, const char* user, const char* pass);
+
+// Una chiamata con la risposta intera in response. params: array JSON già
+// serializzato, es. "[{\"rules\":[\"segwit\"]}]", o NULL se non ce ne sono
+bool bitcoin_rpc_call(const char* method, const char* params, JsonDocument& response);
+
+// getblocktemplate letto in streaming: header + merkle branch della coinbase,
+// senza mai tenere in RAM la risposta (megabyte su mainnet)
 bool bitcoin_rpc_get_block_template(BitcoinBlockTemplate* block_template);
 bool bitcoin_rpc_get_blockchain_info(uint32_t* block_height, char* chain);
-bool bitcoin_rpc_submit_block(const char* block_hex);
+
+// submitblock con il corpo generato in streaming da header, coinbase e template
+bool bitcoin_rpc_submit_block(const uint8_t header[80], const solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl);
+
+// Più chiamate in una sola richiesta (un giro di rete). I valori dei result
+// arrivano a callback in streaming; false se una chiamata fallisce.
+bool bitcoin_rpc_batch(const rpc_call_t* calls, int count, rpc_batch_callback_t callback, void* arg);
+
+// Long-poll del template in un task in background, su una connessione sua.
+// Se il nodo non lo offre controlla getbestblockhash ogni pochi secondi.
+void bitcoin_rpc_longpoll_start(void);
+void bitcoin_rpc_longpoll_stop(void);
+
+// Cresce a ogni template nuovo: il miner lo confronta con quello del suo lavoro
+uint32_t bitcoin_rpc_template_generation(void);
+// millis() dell'ultimo cambio, per misurare la latenza di aggiornamento
+unsigned long bitcoin_rpc_template_changed_ms(void);
+// La tip più recente vista (template, long-poll o getbestblockhash) non è più prevhash
+bool bitcoin_rpc_tip_changed(const char* prevhash);
+
+// Statistiche della sessione del miner (template, submitblock, test connessione)
+void bitcoin_rpc_get_stats(BitcoinRpcStats* out);
 
 // Test connessione
 bool bitcoin_rpc_test_connection(void);
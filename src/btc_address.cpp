@@ -0,0 +1,204 @@
+#include "btc_address.h"
+#include "merkle.h"
+#include <string.h>
+
+static const char BASE58_ALPHABET[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+static const char BECH32_CHARSET[] = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+
+#define BECH32_CONST 1
+#define BECH32M_CONST 0x2bc830a3
+
+// Base58 string -> bytes (big endian, leading '1's become zero bytes).
+// Returns the decoded length or -1.
+static int base58_decode(const char* in, uint8_t* out, size_t max_len) {
+    size_t in_len = strlen(in);
+    if (in_len == 0 || in_len > 64) {
+        return -1;
+    }
+
+    uint8_t num[64] = {0};      // Big-endian number, grows from the end
+    size_t num_len = 0;
+    size_t zeros = 0;
+    while (zeros < in_len && in[zeros] == '1') {
+        zeros++;
+    }
+    for (size_t i = zeros; i < in_len; i++) {
+        const char* digit = strchr(BASE58_ALPHABET, in[i]);
+        if (!digit) {
+            return -1;
+        }
+        uint32_t carry = (uint32_t)(digit - BASE58_ALPHABET);
+        for (size_t j = 0; j < num_len; j++) {
+            carry += (uint32_t)num[sizeof(num) - 1 - j] * 58;
+            num[sizeof(num) - 1 - j] = carry & 0xff;
+            carry >>= 8;
+        }
+        while (carry) {
+            if (num_len == sizeof(num)) {
+                return -1;
+            }
+            num[sizeof(num) - 1 - num_len++] = carry & 0xff;
+            carry >>= 8;
+        }
+    }
+
+    if (zeros + num_len > max_len) {
+        return -1;
+    }
+    memset(out, 0, zeros);
+    memcpy(out + zeros, num + sizeof(num) - num_len, num_len);
+    return (int)(zeros + num_len);
+}
+
+static uint32_t bech32_polymod_step(uint32_t chk, uint8_t value) {
+    static const uint32_t GEN[5] = {0x3b6a57b2, 0x26508e6d, 0x1ea119fa, 0x3d4233dd, 0x2a1462b3};
+    uint8_t top = chk >> 25;
+    chk = ((chk & 0x1ffffff) << 5) ^ value;
+    for (int i = 0; i < 5; i++) {
+        if ((top >> i) & 1) {
+            chk ^= GEN[i];
+        }
+    }
+    return chk;
+}
+
+// Segwit address -> witness version and program. Returns the program length or -1.
+static int segwit_decode(const char* in, int* version, uint8_t* program) {
+    size_t len = strlen(in);
+    if (len < 8 || len > 90) {
+        return -1;
+    }
+
+    // One case only; the separator is the last '1'
+    bool lower = false;
+    bool upper = false;
+    size_t sep = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = in[i];
+        if (c < 33 || c > 126) return -1;
+        if (c >= 'a' && c <= 'z') lower = true;
+        if (c >= 'A' && c <= 'Z') upper = true;
+        if (c == '1') sep = i;
+    }
+    if ((lower && upper) || sep == 0 || sep + 8 > len) {
+        return -1;
+    }
+
+    char hrp[8];
+    if (sep >= sizeof(hrp)) {
+        return -1;
+    }
+    for (size_t i = 0; i < sep; i++) {
+        hrp[i] = (in[i] >= 'A' && in[i] <= 'Z') ? in[i] + 32 : in[i];
+    }
+    hrp[sep] = 0;
+    if (strcmp(hrp, "bc") != 0 && strcmp(hrp, "tb") != 0 && strcmp(hrp, "bcrt") != 0) {
+        return -1;
+    }
+
+    uint32_t chk = 1;
+    for (size_t i = 0; i < sep; i++) {
+        chk = bech32_polymod_step(chk, hrp[i] >> 5);
+    }
+    chk = bech32_polymod_step(chk, 0);
+    for (size_t i = 0; i < sep; i++) {
+        chk = bech32_polymod_step(chk, hrp[i] & 31);
+    }
+
+    uint8_t data[90];
+    size_t data_len = len - sep - 1;
+    for (size_t i = 0; i < data_len; i++) {
+        char c = in[sep + 1 + i];
+        if (c >= 'A' && c <= 'Z') c += 32;
+        const char* digit = strchr(BECH32_CHARSET, c);
+        if (!digit) {
+            return -1;
+        }
+        data[i] = (uint8_t)(digit - BECH32_CHARSET);
+        chk = bech32_polymod_step(chk, data[i]);
+    }
+
+    // Version 0 uses bech32, later versions bech32m (BIP350)
+    *version = data[0];
+    if (*version > 16 || chk != (*version == 0 ? BECH32_CONST : BECH32M_CONST)) {
+        return -1;
+    }
+
+    // 5-bit groups -> bytes, no padding allowed beyond 4 zero bits
+    uint32_t acc = 0;
+    int bits = 0;
+    int out_len = 0;
+    for (size_t i = 1; i < data_len - 6; i++) {
+        acc = (acc << 5) | data[i];
+        bits += 5;
+        if (bits >= 8) {
+            bits -= 8;
+            if (out_len == 40) {
+                return -1;
+            }
+            program[out_len++] = (acc >> bits) & 0xff;
+        }
+    }
+    if (bits >= 5 || ((acc << (8 - bits)) & 0xff) != 0) {
+        return -1;
+    }
+    if (out_len < 2 || (*version == 0 && out_len != 20 && out_len != 32)) {
+        return -1;
+    }
+    return out_len;
+}
+
+int btc_address_to_script(const char* address, uint8_t* script, size_t max_len) {
+    if (!address || max_len < BTC_SCRIPT_MAX) {
+        return -1;
+    }
+
+    int version;
+    uint8_t program[40];
+    int program_len = segwit_decode(address, &version, program);
+    if (program_len > 0) {
+        script[0] = version == 0 ? 0x00 : (uint8_t)(0x50 + version);   // OP_0 / OP_1..OP_16
+        script[1] = (uint8_t)program_len;
+        memcpy(script + 2, program, program_len);
+        return program_len + 2;
+    }
+
+    // Base58Check: version byte + 20-byte hash + 4-byte checksum
+    uint8_t raw[25];
+    if (base58_decode(address, raw, sizeof(raw)) != 25) {
+        return -1;
+    }
+    uint8_t check[32];
+    merkle_sha256d(raw, 21, check);
+    if (memcmp(check, raw + 21, 4) != 0) {
+        return -1;
+    }
+    if (raw[0] == 0x00 || raw[0] == 0x6f) {
+        // P2PKH: OP_DUP OP_HASH160 <20> OP_EQUALVERIFY OP_CHECKSIG
+        script[0] = 0x76;
+        script[1] = 0xa9;
+        script[2] = 0x14;
+        memcpy(script + 3, raw + 1, 20);
+        script[23] = 0x88;
+        script[24] = 0xac;
+        return 25;
+    }
+    if (raw[0] == 0x05 || raw[0] == 0xc4) {
+        // P2SH: OP_HASH160 <20> OP_EQUAL
+        script[0] = 0xa9;
+        script[1] = 0x14;
+        memcpy(script + 2, raw + 1, 20);
+        script[22] = 0x87;
+        return 23;
+    }
+    return -1;
+}
+
+const char* btc_script_type(const uint8_t* script, int len) {
+    if (len == 25 && script[0] == 0x76) return "P2PKH";
+    if (len == 23 && script[0] == 0xa9) return "P2SH";
+    if (len == 22 && script[0] == 0x00) return "P2WPKH";
+    if (len == 34 && script[0] == 0x00) return "P2WSH";
+    if (len == 34 && script[0] == 0x51) return "P2TR";
+    return "witness";
+}
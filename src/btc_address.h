@@ -0,0 +1,22 @@
+#ifndef BTC_ADDRESS_H
+#define BTC_ADDRESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bitcoin address -> output script, for paying a solo-mined coinbase.
+// Base58Check (P2PKH, P2SH) and bech32/bech32m segwit addresses (P2WPKH,
+// P2WSH, P2TR and future versions) for mainnet, testnet/signet and regtest.
+// The network is not checked against the node: the caller decides.
+// Plain C++ with no Arduino dependencies.
+
+#define BTC_SCRIPT_MAX 42     // Largest standard output script (segwit v1+, 40-byte program)
+
+// Output script for an address. Returns the script length, or -1 if the
+// address is malformed or its checksum is wrong.
+int btc_address_to_script(const char* address, uint8_t* script, size_t max_len);
+
+// Short name of a standard script type ("P2WPKH", ...) for logs
+const char* btc_script_type(const uint8_t* script, int len);
+
+#endif // BTC_ADDRESS_H
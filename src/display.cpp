@@ -2,12 +2,41 @@
 #include "mining_task.h"
 #include "duino_task.h"
 #include "wifi_config.h"
+#include "frame_diff.h"
+#include "raster.h"
+#include "glyph_cache.h"
 #include <rm67162.h>
 #include "display_assets.h"
 
 // Frame buffer for the entire display
 uint16_t *framebuffer;
 
+#if LCD_ASYNC_FLUSH
+// While the panel receives one buffer, the next frame is drawn into the other.
+// Every page redraws the whole frame, so the swap needs no copy.
+static uint16_t *backBuffer = NULL;
+#endif
+
+// Frame diff: every page redraws the whole frame, and only the rectangles that
+// differ from what the panel shows are sent. A frame with no changes is not
+// sent at all.
+static frame_diff_t frameDiff;
+static bool diffReady = false;
+
+// Labels and digits expanded once per string and scale (see glyph_cache.h)
+static glyph_cache_t glyphCache;
+static bool glyphReady = false;
+
+#if DISPLAY_GLYPH_CACHE
+static const uint8_t* fontBitmap(char c)
+{
+    return getCharBitmap(c);
+}
+#endif
+
+static DisplayStats displayStats = {0};
+static unsigned long frameStartUs = 0;
+
 // Current color pair index for logo page
 static int currentColorPairIndex = 0;
 
@@ -42,6 +71,33 @@ void display_init(void)
         return;
     }
     
+#if LCD_ASYNC_FLUSH
+    backBuffer = (uint16_t*)ps_malloc(WIDTH * HEIGHT * sizeof(uint16_t));
+    if (!backBuffer) {
+        Serial.println("WARNING: No memory for a second framebuffer, flushing synchronously");
+    }
+#endif
+    
+#if DISPLAY_FRAME_DIFF
+    // Copy of the panel for the frame diff (PSRAM)
+    size_t diffBytes = frame_diff_bytes(WIDTH, HEIGHT);
+    void* diffBuffer = ps_malloc(diffBytes);
+    diffReady = diffBuffer && frame_diff_init(&frameDiff, framebuffer, diffBuffer, diffBytes, WIDTH, HEIGHT);
+    if (!diffReady) {
+        Serial.println("WARNING: No memory for the frame diff, sending full frames");
+        free(diffBuffer);
+    }
+#endif
+    
+#if DISPLAY_GLYPH_CACHE
+    void* glyphBuffer = malloc(GLYPH_CACHE_BYTES);
+    glyphReady = glyphBuffer && glyph_cache_init(&glyphCache, glyphBuffer, GLYPH_CACHE_BYTES, fontBitmap);
+    if (!glyphReady) {
+        Serial.println("WARNING: No memory for the glyph cache, drawing text from the font");
+        free(glyphBuffer);
+    }
+#endif
+    
     // Initialize the AMOLED display
     rm67162_init();
     lcd_setRotation(1);  // Landscape mode
@@ -59,11 +115,18 @@ void display_init(void)
     Serial.println("Display initialized successfully");
 }
 
+// The buffer the primitives draw into (it changes when the buffers are swapped)
+static inline raster_target_t target()
+{
+    raster_target_t t = {framebuffer, WIDTH, HEIGHT};
+    return t;
+}
+
 void fillScreen(uint16_t color)
 {
-    for(int i = 0; i < WIDTH * HEIGHT; i++) {
-        framebuffer[i] = color;
-    }
+    // Every page starts by clearing the screen: the frame's drawing time starts here
+    frameStartUs = micros();
+    raster_fill(framebuffer, WIDTH * HEIGHT, color);
 }
 
 void drawPixel(int x, int y, uint16_t color)
@@ -73,118 +136,114 @@ void drawPixel(int x, int y, uint16_t color)
     }
 }
 
+// Send a rectangle of the framebuffer to the panel, straight from its rows.
+// Queued when a back buffer is available: returns true if it is still on its way.
+static bool pushRect(const diff_rect_t& r)
+{
+    const uint16_t* src = framebuffer + r.y * WIDTH + r.x;
+#if LCD_ASYNC_FLUSH
+    if (backBuffer) {
+        return lcd_PushRectAsync(r.x, r.y, r.w, r.h, src, WIDTH, NULL, NULL);
+    }
+#endif
+    lcd_PushRect(r.x, r.y, r.w, r.h, src, WIDTH);
+    return false;
+}
+
 void pushFramebuffer()
 {
-    lcd_PushColors(0, 0, WIDTH, HEIGHT, framebuffer);
+    unsigned long flushStart = micros();
+    if (frameStartUs) {
+        displayStats.draw_us += flushStart - frameStartUs;
+        frameStartUs = 0;
+    }
+    displayStats.frames++;
+    
+    diff_rect_t rects[FRAME_DIFF_MAX_RECTS];
+    int count;
+    if (diffReady) {
+        frameDiff.frame = framebuffer;
+        count = frame_diff_collect(&frameDiff, rects, FRAME_DIFF_MAX_RECTS);
+    } else {
+        rects[0].x = 0;
+        rects[0].y = 0;
+        rects[0].w = WIDTH;
+        rects[0].h = HEIGHT;
+        count = 1;
+    }
+    if (count == 0) {
+        displayStats.frames_skipped++;
+    }
+    
+    // The previous frame may still be on its way, from the buffer we are about to draw into
+    if (count > 0) {
+        lcd_wait_flush();
+    }
+    bool queued = false;
+    for (int i = 0; i < count; i++) {
+        queued |= pushRect(rects[i]);
+        displayStats.rects++;
+        displayStats.bytes += rects[i].w * rects[i].h * sizeof(uint16_t);
+    }
+#if LCD_ASYNC_FLUSH
+    if (queued) {
+        uint16_t* sent = framebuffer;
+        framebuffer = backBuffer;
+        backBuffer = sent;
+    }
+#endif
+    displayStats.flush_us += micros() - flushStart;
+}
+
+void display_get_stats(DisplayStats* out)
+{
+    *out = displayStats;
+    lcd_flush_stats_t lcd;
+    lcd_get_flush_stats(&lcd);
+    out->panel_us = lcd.bus_us;
+    out->copy_us = lcd.copy_us;
+    out->text_hits = glyphCache.hits;
+    out->text_misses = glyphCache.misses;
 }
 
 // Draw a rectangle outline
 void drawRect(int x, int y, int w, int h, uint16_t color)
 {
-    // Top and bottom lines
-    for(int i = 0; i < w; i++) {
-        drawPixel(x + i, y, color);
-        drawPixel(x + i, y + h - 1, color);
-    }
-    // Left and right lines
-    for(int i = 0; i < h; i++) {
-        drawPixel(x, y + i, color);
-        drawPixel(x + w - 1, y + i, color);
-    }
+    raster_target_t t = target();
+    raster_rect(&t, x, y, w, h, color);
 }
 
 // Draw a filled rectangle
 void fillRect(int x, int y, int w, int h, uint16_t color)
 {
-    for(int j = 0; j < h; j++) {
-        for(int i = 0; i < w; i++) {
-            drawPixel(x + i, y + j, color);
-        }
-    }
+    raster_target_t t = target();
+    raster_fill_rect(&t, x, y, w, h, color);
 }
 
-// Draw a rounded rectangle with stroke
+// Draw a rounded rectangle with stroke (drawn inwards from the outer edge)
 void drawRoundRect(int x, int y, int w, int h, int r, uint16_t color, int strokeWidth)
 {
-    // Draw multiple strokes for thickness
-    for(int s = 0; s < strokeWidth; s++) {
-        int xo = x + s;
-        int yo = y + s;
-        int wo = w - 2 * s;
-        int ho = h - 2 * s;
-        int ro = r - s;
-        if (ro < 0) ro = 0;
-        
-        // Draw straight edges
-        // Top
-        for(int i = xo + ro; i < xo + wo - ro; i++) {
-            drawPixel(i, yo, color);
-        }
-        // Bottom
-        for(int i = xo + ro; i < xo + wo - ro; i++) {
-            drawPixel(i, yo + ho - 1, color);
-        }
-        // Left
-        for(int i = yo + ro; i < yo + ho - ro; i++) {
-            drawPixel(xo, i, color);
-        }
-        // Right
-        for(int i = yo + ro; i < yo + ho - ro; i++) {
-            drawPixel(xo + wo - 1, i, color);
-        }
-        
-        // Draw corners using Bresenham circle algorithm
-        int f = 1 - ro;
-        int ddF_x = 1;
-        int ddF_y = -2 * ro;
-        int px = 0;
-        int py = ro;
-        
-        while(px < py) {
-            if(f >= 0) {
-                py--;
-                ddF_y += 2;
-                f += ddF_y;
-            }
-            px++;
-            ddF_x += 2;
-            f += ddF_x;
-            
-            // Top-left
-            drawPixel(xo + ro - px, yo + ro - py, color);
-            drawPixel(xo + ro - py, yo + ro - px, color);
-            // Top-right
-            drawPixel(xo + wo - ro + px - 1, yo + ro - py, color);
-            drawPixel(xo + wo - ro + py - 1, yo + ro - px, color);
-            // Bottom-left
-            drawPixel(xo + ro - px, yo + ho - ro + py - 1, color);
-            drawPixel(xo + ro - py, yo + ho - ro + px - 1, color);
-            // Bottom-right
-            drawPixel(xo + wo - ro + px - 1, yo + ho - ro + py - 1, color);
-            drawPixel(xo + wo - ro + py - 1, yo + ho - ro + px - 1, color);
-        }
+    raster_target_t t = target();
+    raster_round_rect(&t, x, y, w, h, r, strokeWidth, color);
+}
+
+// Draw len characters of text at (x, y)
+static void drawGlyphs(int x, int y, const char* text, int len, uint16_t color, int scale)
+{
+    raster_target_t t = target();
+    if (glyphReady) {
+        glyph_cache_draw(&glyphCache, &t, x, y, text, len, scale, color);
+        return;
+    }
+    for (int i = 0; i < len; i++) {
+        raster_glyph(&t, x + i * 8 * scale, y, getCharBitmap(text[i]), scale, color);
     }
 }
 
 // Draw a character at position (x, y) with specified color and scale
 void drawChar(int x, int y, char c, uint16_t color, int scale)
 {
-    const uint8_t* bitmap = getCharBitmap(c);
-    
-    for(int row = 0; row < 8; row++) {
-        uint8_t line = bitmap[row];
-        for(int col = 0; col < 8; col++) {
-            // Reverse bit order to fix mirroring: read from bit 7 down to bit 0
-            if(line & (1 << (7 - col))) {
-                // Draw scaled pixel
-                for(int sy = 0; sy < scale; sy++) {
-                    for(int sx = 0; sx < scale; sx++) {
-                        drawPixel(x + col * scale + sx, y + row * scale + sy, color);
-                    }
-                }
-            }
-        }
-    }
+    drawGlyphs(x, y, &c, 1, color, scale);
 }
 
 // Draw text string with specified scale (centered if centerX is true)
@@ -195,9 +254,7 @@ void drawText(const char* text, int x, int y, uint16_t color, int scale, bool ce
     
     int startX = centerX ? (WIDTH - totalWidth) / 2 : x;
     
-    for(int i = 0; i < len; i++) {
-        drawChar(startX + i * 8 * scale, y, text[i], color, scale);
-    }
+    drawGlyphs(startX, y, text, len, color, scale);
 }
 
 // Refresh logo colors with a new random pair
@@ -243,7 +300,7 @@ void display_draw_status_bar(bool wifiConnected, const char* timeStr, bool minin
     // Fill the bottom part with corners
     for (int y = STATUS_BAR_HEIGHT - cornerRadius; y < STATUS_BAR_HEIGHT; y++) {
         int rowY = y - (STATUS_BAR_HEIGHT - cornerRadius);
-        int cutoff = cornerRadius - (int)sqrt(cornerRadius * cornerRadius - rowY * rowY);
+        int cutoff = raster_corner_inset(cornerRadius, rowY);
         
         // Left side - from cutoff to full width minus right cutoff
         fillRect(cutoff, y, WIDTH - 2 * cutoff, 1, darkGrey);
@@ -341,9 +398,7 @@ void display_draw_status_bar(bool wifiConnected, const char* timeStr, bool minin
         // Draw time in pure white with byte swap (0xFFFF -> 0xFFFF, no change needed)
         uint16_t white = 0xFFFF;
         
-        for (int i = 0; timeStr[i] != '\0'; i++) {
-            drawChar(timeX + i * 8 * timeScale, timeY, timeStr[i], white, timeScale);
-        }
+        drawText(timeStr, timeX, timeY, white, timeScale, false);
     }
 }
 
@@ -401,12 +456,7 @@ void drawScrollingAnswer(int yOffset, bool showText)
     int lineHeight2 = 8 * scale2;
     int spacing = 30;
     
-    // Calculate total height of the text block
-    int totalTextHeight = lineHeight1 + spacing + lineHeight2;
-    
-    // Starting position: below the visible area
-    // The text starts at HEIGHT and scrolls up to -totalTextHeight
-    int availableHeight = HEIGHT - STATUS_BAR_HEIGHT;
+    // Starting position: below the visible area, scrolled up by yOffset
     int startY = HEIGHT + yOffset;  // Start from bottom of screen
     
     int line1Y = startY;
@@ -581,13 +631,10 @@ void display_page_mining(bool miningActive, bool wifiConnected, const char* time
             
             // Adjust for rounded corners in the bottom area
             if (yOffset < cornerRadius) {
-                int cornerOffset = cornerRadius - yOffset;
-                xMargin = cornerRadius - (int)sqrt(cornerRadius * cornerRadius - cornerOffset * cornerOffset);
+                xMargin = raster_corner_inset(cornerRadius, cornerRadius - yOffset);
             }
             
-            for (int x = fillX + xMargin; x < fillX + fillWidth - xMargin; x++) {
-                drawPixel(x, y, fillColor);
-            }
+            fillRect(fillX + xMargin, y, fillWidth - 2 * xMargin, 1, fillColor);
         }
     }
     
@@ -603,9 +650,7 @@ void display_page_mining(bool miningActive, bool wifiConnected, const char* time
         int textX = btnX + (btnWidth - textWidth) / 2;
         int textY = btnY + (btnHeight - textHeight) / 2;
         
-        for(int i = 0; i < textLen; i++) {
-            drawChar(textX + i * 8 * textScale, textY, buttonText[i], lightBlue, textScale);
-        }
+        drawText(buttonText, textX, textY, lightBlue, textScale, false);
     } else {
         // Two rows: "Start" and "Mining" in orange
         const char* line1 = "Start";
@@ -627,14 +672,10 @@ void display_page_mining(bool miningActive, bool wifiConnected, const char* time
         int line2Y = startY + lineHeight + lineSpacing;
         
         // Draw first line in orange
-        for(int i = 0; i < line1Len; i++) {
-            drawChar(line1X + i * 8 * textScale, line1Y, line1[i], orange, textScale);
-        }
+        drawText(line1, line1X, line1Y, orange, textScale, false);
         
         // Draw second line in orange
-        for(int i = 0; i < line2Len; i++) {
-            drawChar(line2X + i * 8 * textScale, line2Y, line2[i], orange, textScale);
-        }
+        drawText(line2, line2X, line2Y, orange, textScale, false);
     }
     
     // Status panel - to the right of the button
@@ -784,9 +825,7 @@ void display_page_mining(bool miningActive, bool wifiConnected, const char* time
         int overlayY = btnY + btnHeight - overlayTextHeight - 8;  // 8px margin from bottom
         
         // Draw text in fuchsia
-        for(int i = 0; i < overlayTextLen; i++) {
-            drawChar(overlayX + i * 8 * overlayScale, overlayY, overlayText[i], fuchsia, overlayScale);
-        }
+        drawText(overlayText, overlayX, overlayY, fuchsia, overlayScale, false);
     }
     
     // Push to display
@@ -834,10 +873,8 @@ void display_page_setup(bool wifiEnabled, bool wifiConnected, const char* timeSt
     int textX = btnX + (btnWidth - textWidth) / 2;
     int textY = btnY + (btnHeight - textHeight) / 2;
     
-    // Manual positioning since we can't use the centered version with custom X
-    for(int i = 0; i < textLen; i++) {
-        drawChar(textX + i * 8 * textScale, textY, buttonText[i], textColor, textScale);
-    }
+    // Not centered on the screen: the button's own center
+    drawText(buttonText, textX, textY, textColor, textScale, false);
     
     // If WiFi AP is enabled, show connection info below button
     if (wifiEnabled) {
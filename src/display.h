@@ -11,8 +11,35 @@ enum Page {
     PAGE_COUNT = 3
 };
 
+// Frame diff: pushFramebuffer() compares the frame with the panel and sends
+// only the rectangles that changed (0 = the whole framebuffer every frame)
+#ifndef DISPLAY_FRAME_DIFF
+#define DISPLAY_FRAME_DIFF 1
+#endif
+
+// Text is drawn from a cache of pre-expanded strings (0 = every glyph from
+// the font bitmap on every frame, as before)
+#ifndef DISPLAY_GLYPH_CACHE
+#define DISPLAY_GLYPH_CACHE 1
+#endif
+
+// Panel traffic and frame times since boot
+struct DisplayStats {
+    uint32_t frames;          // pushFramebuffer() calls
+    uint32_t frames_skipped;  // Nothing changed: nothing sent
+    uint32_t rects;           // Rectangles sent
+    uint64_t bytes;           // Pixel bytes sent to the panel
+    uint64_t draw_us;         // Drawing (from the page's fillScreen to the flush)
+    uint64_t flush_us;        // pushFramebuffer(): frame diff, waits and synchronous transfers
+    uint64_t panel_us;        // Queued transfers, sent by the flush task meanwhile
+    uint64_t copy_us;         // Flush task copies into the DMA buffers (part of panel_us)
+    uint32_t text_hits;       // drawText()/drawChar() served from the glyph cache
+    uint32_t text_misses;     // Strings expanded into the cache
+};
+
 // Display initialization and management functions
 void display_init(void);
+void display_get_stats(DisplayStats* out);
 
 // Status bar (shared across all pages)
 #define STATUS_BAR_HEIGHT 45
@@ -1,10 +1,47 @@
 #include "duino_client.h"
+#include "duino_kernel.h"
+#include "duino_workers.h"
+#include "duino_tier.h"
 #include <mbedtls/md.h>
 #include <HTTPClient.h>
+#include "tls_transport.h"
 #include <ArduinoJson.h>
+#include <Preferences.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// NVS namespace of the cached pool picker result
+#define DUCO_POOL_PREFS "duco_pool"
+#define DUCO_CLOCK_VALID 1600000000   // time() below this: clock not synced yet
+
+// NVS namespace of the last settled difficulty tier
+#define DUCO_TIER_PREFS "duco_tier"
+
+// One pool connection: server version, then strictly JOB request -> job -> result -> verdict
+enum DuinoConnState {
+    CONN_CLOSED,
+    CONN_WAIT_BANNER,     // Connected, server version line not read yet
+    CONN_WAIT_JOB,        // JOB request sent
+    CONN_JOB_READY,       // Job received, waiting to be hashed
+    CONN_WAIT_VERDICT     // Result sent
+};
+
+struct DuinoConnection {
+    WiFiClient client;
+    DuinoConnState state;
+    unsigned long stateMs;        // When the current state was entered
+    char line[DUCO_LINE_MAX];     // Partial line received so far
+    size_t lineLen;
+    char lastBlockHash[DUCO_LINE_MAX];
+    char expectedHash[DUCO_LINE_MAX];
+    int difficulty;
+    int tier;                     // Difficulty tier the current job was requested with
+    uint32_t hashMs;              // Hashing time of the result awaiting a verdict
+};
 
 // Client state
-static WiFiClient client;
+static DuinoConnection connections[DUCO_CONNECTIONS];
 static DuinoState currentState = DUCO_DISCONNECTED;
 static String username = "";
 static String rigId = "";
@@ -16,18 +53,22 @@ static int poolPort = 0;
 static uint32_t acceptedShares = 0;
 static uint32_t rejectedShares = 0;
 static uint32_t totalHashes = 0;
-static unsigned long lastHashTime = 0;
 static uint32_t currentHashrate = 0;
 static float currentDifficulty = 0;
+static int kernelLanes = DUINO_SHA1_LANES;
+static DuinoTiming timing = {0};
+static int savedTier = 0;
+static volatile bool cancelRequested = false;
 
 // Protocol version
-static const char* DUCO_DIFFICULTY = "ESP32";  // Use ESP32 difficulty level
 static const char* MINER_BANNER = "Official ESP32 Miner";
 static const char* DUCO_VERSION = "4.2";  // Version identifier
 
 bool duino_fetch_pool(String &host, int &port) {
+    // The TLS session of the previous pick is resumed: no full handshake per reconnect
+    TlsClient tls;
     HTTPClient http;
-    http.begin(DUCO_POOL_PICKER_URL);
+    http.begin(tls, DUCO_POOL_PICKER_URL);
     http.addHeader("Accept", "*/*");
     http.setTimeout(5000);
     
@@ -65,6 +106,134 @@ bool duino_fetch_pool(String &host, int &port) {
     return false;
 }
 
+#ifndef DUCO_SERVER_HOST
+// Background pool picker query
+static TaskHandle_t refreshTaskHandle = NULL;
+
+// Cached pool picker result. savedAt is 0 when the clock was not set or the
+// entry is the fallback server; such entries are used but refreshed.
+struct DuinoPoolCache {
+    String host;
+    int port;
+    uint32_t savedAt;
+    uint8_t failures;
+};
+
+static bool pool_cache_load(DuinoPoolCache &cache) {
+    Preferences prefs;
+    prefs.begin(DUCO_POOL_PREFS, true);
+    cache.host = prefs.getString("host", "");
+    cache.port = prefs.getUShort("port", 0);
+    cache.savedAt = prefs.getUInt("savedAt", 0);
+    cache.failures = prefs.getUChar("fails", 0);
+    prefs.end();
+    return cache.host.length() > 0 && cache.port > 0;
+}
+
+static void pool_cache_save(const String &host, int port, bool fromPicker) {
+    time_t now = time(NULL);
+    Preferences prefs;
+    prefs.begin(DUCO_POOL_PREFS, false);
+    prefs.putString("host", host.c_str());
+    prefs.putUShort("port", port);
+    prefs.putUInt("savedAt", fromPicker && now > DUCO_CLOCK_VALID ? (uint32_t)now : 0);
+    prefs.putUChar("fails", 0);
+    prefs.end();
+}
+
+static void pool_cache_set_failures(uint8_t failures) {
+    Preferences prefs;
+    prefs.begin(DUCO_POOL_PREFS, false);
+    prefs.putUChar("fails", failures);
+    prefs.end();
+}
+
+static bool pool_cache_expired(const DuinoPoolCache &cache) {
+    time_t now = time(NULL);
+    if (cache.savedAt == 0 || now <= DUCO_CLOCK_VALID) {
+        return true;
+    }
+    return (uint32_t)now - cache.savedAt > DUCO_POOL_CACHE_TTL_S;
+}
+
+// One-shot task: query the picker and store the result for the next connect
+static void poolRefreshTask(void* parameter) {
+    String host;
+    int port = 0;
+    if (duino_fetch_pool(host, port)) {
+        pool_cache_save(host, port, true);
+    }
+    
+    refreshTaskHandle = NULL;
+    vTaskDelete(NULL);
+}
+
+static void pool_refresh_async(void) {
+    if (refreshTaskHandle != NULL) {
+        return;
+    }
+    
+    // Core 0 with WiFi; the HTTPS request never blocks the mining loop
+    xTaskCreatePinnedToCore(
+        poolRefreshTask,      // Task function
+        "DuinoPicker",        // Task name
+        8192,                 // Stack size (bytes) - TLS handshake
+        NULL,                 // Task parameter
+        1,                    // Priority (1 = low)
+        &refreshTaskHandle,   // Task handle
+        0                     // Core ID
+    );
+}
+
+// Pick the pool for this connect. Returns true if it came from the cache.
+static bool pool_select(void) {
+    DuinoPoolCache cache;
+    if (pool_cache_load(cache)) {
+        poolHost = cache.host;
+        poolPort = cache.port;
+        if (pool_cache_expired(cache) || cache.failures >= DUCO_POOL_MAX_FAILS) {
+            Serial.println("   Pool cache stale, re-querying picker in background");
+            pool_refresh_async();
+        }
+        Serial.printf("   Using cached pool %s:%d\n", poolHost.c_str(), poolPort);
+        return true;
+    }
+    
+    // First connect: nothing cached yet, ask the picker now
+    if (duino_fetch_pool(poolHost, poolPort)) {
+        pool_cache_save(poolHost, poolPort, true);
+    } else {
+        // Fallback to default server, cached as stale so the picker is retried in background
+        poolHost = DUCO_SERVER_FALLBACK;
+        poolPort = DUCO_PORT_FALLBACK;
+        Serial.printf("   Using fallback: %s:%d\n", poolHost.c_str(), poolPort);
+        pool_cache_save(poolHost, poolPort, false);
+    }
+    return false;
+}
+
+// Connect outcome for the cached pool: count consecutive failures, reset on success
+static void pool_report_connect(bool ok) {
+    DuinoPoolCache cache;
+    if (!pool_cache_load(cache) || cache.host != poolHost || cache.port != poolPort) {
+        return;
+    }
+    if (ok) {
+        if (cache.failures > 0) {
+            pool_cache_set_failures(0);
+        }
+        return;
+    }
+    if (cache.failures < 255) {
+        pool_cache_set_failures(cache.failures + 1);
+    }
+    if (cache.failures + 1 >= DUCO_POOL_MAX_FAILS) {
+        Serial.printf("   Cached pool failed %d times, re-querying picker in background\n", cache.failures + 1);
+        pool_refresh_async();
+    }
+}
+#endif
+
 void duino_init(const char* user, const char* rigIdentifier, const char* key) {
     username = String(user);
     rigId = String(rigIdentifier);
@@ -75,6 +244,15 @@ void duino_init(const char* user, const char* rigIdentifier, const char* key) {
     totalHashes = 0;
     currentHashrate = 0;
     currentDifficulty = 0;
+    memset(&timing, 0, sizeof(timing));
+    cancelRequested = false;
+    
+    // Resume at the tier that won last time instead of climbing from ESP32 again
+    Preferences prefs;
+    prefs.begin(DUCO_TIER_PREFS, true);
+    savedTier = prefs.getUChar("tier", 0);
+    prefs.end();
+    duino_tier_init(savedTier);
     
     Serial.println("╔════════════════════════════════════════════════════════╗");
     Serial.println("║           DUINO-COIN CLIENT INITIALIZED               ║");
@@ -82,9 +260,151 @@ void duino_init(const char* user, const char* rigIdentifier, const char* key) {
     Serial.printf("Username: %s\n", user);
     Serial.printf("Rig ID: %s\n", rigIdentifier);
     Serial.printf("Mining Key: %s\n", key && strlen(key) > 0 ? "***" : "None");
+    Serial.printf("Starting tier: %s\n", duino_tier_name(duino_tier_current()));
     Serial.println();
 }
 
+// Open one pool connection; the server version is read by conn_poll()
+static bool conn_open(DuinoConnection* conn) {
+    Serial.printf("   Connecting to %s:%d...\n", poolHost.c_str(), poolPort);
+    if (!conn->client.connect(poolHost.c_str(), poolPort)) {
+        Serial.println("❌ Connection failed!");
+        Serial.printf("   WiFi Status: %d\n", WiFi.status());
+        Serial.printf("   Local IP: %s\n", WiFi.localIP().toString().c_str());
+        return false;
+    }
+    
+    Serial.println("   TCP connection established!");
+    conn->lineLen = 0;
+    conn->state = CONN_WAIT_BANNER;
+    conn->stateMs = millis();
+    return true;
+}
+
+static void conn_close(DuinoConnection* conn) {
+    if (conn->client.connected()) {
+        conn->client.stop();
+    }
+    conn->state = CONN_CLOSED;
+}
+
+// Request format: JOB,username,difficulty,mining_key
+static void conn_request_job(DuinoConnection* conn) {
+    conn->tier = duino_tier_current();
+    String jobRequest = "JOB," + username + "," + String(duino_tier_name(conn->tier));
+    if (miningKey.length() > 0) {
+        jobRequest += "," + miningKey;
+    }
+    conn->client.println(jobRequest);
+    conn->state = CONN_WAIT_JOB;
+    conn->stateMs = millis();
+}
+
+// Job format: lastblockhash,expectedhash,difficulty
+static void conn_handle_job(DuinoConnection* conn, const char* line) {
+    const char* comma1 = strchr(line, ',');
+    const char* comma2 = comma1 ? strchr(comma1 + 1, ',') : NULL;
+    if (comma2 == NULL) {
+        Serial.printf("❌ Invalid job format: %s\n", line);
+        conn_close(conn);
+        return;
+    }
+    
+    size_t hashLen = comma1 - line;
+    size_t expectedLen = comma2 - comma1 - 1;
+    memcpy(conn->lastBlockHash, line, hashLen);
+    conn->lastBlockHash[hashLen] = 0;
+    memcpy(conn->expectedHash, comma1 + 1, expectedLen);
+    conn->expectedHash[expectedLen] = 0;
+    conn->difficulty = atoi(comma2 + 1);
+    
+    conn->state = CONN_JOB_READY;
+    conn->stateMs = millis();
+}
+
+// Verdict for the last result, then straight away ask this connection for its next job
+static void conn_handle_verdict(DuinoConnection* conn, const char* response) {
+    uint32_t rtt = millis() - conn->stateMs;
+    
+    if (strncmp(response, "GOOD", 4) == 0 || strncmp(response, "BLOCK", 5) == 0) {
+        acceptedShares++;
+        Serial.printf("✅ Share accepted! (%ums hash, %ums verdict, %u H/s)\n", conn->hashMs, rtt, currentHashrate);
+        
+        // Parse feedback if available (e.g., "GOOD,23.5")
+        const char* feedback = strchr(response, ',');
+        if (feedback) {
+            Serial.printf("   Feedback: %s DUCO\n", feedback + 1);
+        }
+        duino_tier_record_verdict(conn->tier, true);
+    } else if (strncmp(response, "BAD", 3) == 0) {
+        rejectedShares++;
+        Serial.printf("❌ Share rejected: %s\n", response);
+        duino_tier_record_verdict(conn->tier, false);
+    } else {
+        Serial.printf("⚠️  Unknown response: %s\n", response);
+    }
+    
+    conn_request_job(conn);
+}
+
+// Non-blocking: consume whatever the pool has sent and advance the connection
+static void conn_poll(DuinoConnection* conn) {
+    if (conn->state == CONN_CLOSED) {
+        return;
+    }
+    if (!conn->client.connected()) {
+        Serial.println("⚠️  Duino-Coin connection closed by pool");
+        conn_close(conn);
+        return;
+    }
+    
+    while (conn->client.available()) {
+        int c = conn->client.read();
+        if (c < 0) {
+            break;
+        }
+        if (c != '\n') {
+            if (c != '\r' && conn->lineLen < sizeof(conn->line) - 1) {
+                conn->line[conn->lineLen++] = (char)c;
+            }
+            continue;
+        }
+        conn->line[conn->lineLen] = 0;
+        conn->lineLen = 0;
+        
+        if (conn->state == CONN_WAIT_BANNER) {
+            // Server version: the connection is ready for its first job
+            Serial.printf("   Server version: %s\n", conn->line);
+            conn_request_job(conn);
+        } else if (conn->state == CONN_WAIT_JOB) {
+            conn_handle_job(conn, conn->line);
+        } else if (conn->state == CONN_WAIT_VERDICT) {
+            conn_handle_verdict(conn, conn->line);
+        } else {
+            Serial.printf("⚠️  Unexpected line from pool: %s\n", conn->line);
+        }
+        if (conn->state == CONN_CLOSED) {
+            return;
+        }
+    }
+    
+    if (conn->state == CONN_WAIT_BANNER && millis() - conn->stateMs > DUCO_BANNER_TIMEOUT_MS) {
+        Serial.println("❌ Timeout waiting for server response");
+        conn_close(conn);
+    } else if ((conn->state == CONN_WAIT_JOB || conn->state == CONN_WAIT_VERDICT) &&
+        millis() - conn->stateMs > DUCO_REPLY_TIMEOUT_MS) {
+        Serial.printf("❌ Timeout waiting for %s\n", conn->state == CONN_WAIT_JOB ? "job" : "submit response");
+        conn_close(conn);
+    }
+}
+
+// Poll every connection (also called between hashing chunks by the worker pool)
+static void duino_poll(void) {
+    for (int i = 0; i < DUCO_CONNECTIONS; i++) {
+        conn_poll(&connections[i]);
+    }
+}
+
 bool duino_connect(void) {
     // Check WiFi status first
     if (WiFi.status() != WL_CONNECTED) {
@@ -93,115 +413,143 @@ bool duino_connect(void) {
         return false;
     }
     
-    // Try to fetch best pool
-    if (!duino_fetch_pool(poolHost, poolPort)) {
-        // Fallback to default server
-        poolHost = DUCO_SERVER_FALLBACK;
-        poolPort = DUCO_PORT_FALLBACK;
-        Serial.printf("   Using fallback: %s:%d\n", poolHost.c_str(), poolPort);
-    }
+    unsigned long connectStart = millis();
+    
+#ifdef DUCO_SERVER_HOST
+    // Fixed server (local testing)
+    poolHost = DUCO_SERVER_HOST;
+    poolPort = DUCO_SERVER_PORT;
+    bool cached = false;
+#else
+    bool cached = pool_select();
+#endif
     
     Serial.println("🪙 Connecting to Duino-Coin pool...");
     Serial.printf("   Server: %s:%d\n", poolHost.c_str(), poolPort);
     
     currentState = DUCO_CONNECTING;
     
-    // Try to connect with timeout
-    Serial.printf("   Connecting to %s:%d...\n", poolHost.c_str(), poolPort);
-    if (!client.connect(poolHost.c_str(), poolPort)) {
-        Serial.println("❌ Connection failed!");
-        Serial.printf("   WiFi Status: %d\n", WiFi.status());
-        Serial.printf("   Local IP: %s\n", WiFi.localIP().toString().c_str());
-        currentState = DUCO_ERROR;
-        return false;
+    // Every connection asks for a job as soon as the server version is in (see conn_poll())
+    int opened = 0;
+    for (int i = 0; i < DUCO_CONNECTIONS; i++) {
+        conn_close(&connections[i]);
+        if (conn_open(&connections[i])) {
+            opened++;
+        }
     }
     
-    Serial.println("   TCP connection established!");
+#ifndef DUCO_SERVER_HOST
+    pool_report_connect(opened > 0);
+#endif
     
-    // Wait for server version
-    unsigned long timeout = millis();
-    while (!client.available()) {
-        if (millis() - timeout > 5000) {
-            Serial.println("❌ Timeout waiting for server response");
-            client.stop();
-            currentState = DUCO_ERROR;
-            return false;
-        }
-        delay(10);
+    if (opened == 0) {
+        currentState = DUCO_ERROR;
+        return false;
     }
     
-    String serverVersion = client.readStringUntil('\n');
-    Serial.printf("   Server version: %s\n", serverVersion.c_str());
+    duino_workers_set_poll(duino_poll);
+    
+    timing.connect_ms = millis() - connectStart;
+    timing.connect_cached = cached;
     
     currentState = DUCO_CONNECTED;
-    Serial.println("✅ Connected to Duino-Coin pool!");
+    Serial.printf("✅ Connected to Duino-Coin pool! (%d/%d connections, %u ms%s)\n", opened, DUCO_CONNECTIONS,
+                  timing.connect_ms, cached ? ", cached pool" : "");
     Serial.println();
     
     return true;
 }
 
 void duino_disconnect(void) {
-    if (client.connected()) {
-        client.stop();
+    duino_workers_set_poll(NULL);
+    for (int i = 0; i < DUCO_CONNECTIONS; i++) {
+        conn_close(&connections[i]);
     }
     currentState = DUCO_DISCONNECTED;
     Serial.println("Disconnected from Duino-Coin pool");
 }
 
 bool duino_is_connected(void) {
-    return client.connected() && (currentState == DUCO_CONNECTED || currentState == DUCO_MINING);
+    if (currentState != DUCO_CONNECTED && currentState != DUCO_MINING) {
+        return false;
+    }
+    for (int i = 0; i < DUCO_CONNECTIONS; i++) {
+        if (connections[i].state != CONN_CLOSED && connections[i].client.connected()) {
+            return true;
+        }
+    }
+    return false;
 }
 
 DuinoState duino_get_state(void) {
     return currentState;
 }
 
-// SHA-1 hash function for DUCO-S1
-String duino_sha1(String data) {
-    uint8_t hash[20];
-    mbedtls_md_context_t ctx;
-    mbedtls_md_type_t md_type = MBEDTLS_MD_SHA1;
+// DUCO-S1 mining algorithm
+int duino_duco_s1(const char* lastBlockHash, const char* expectedHash, int difficulty) {
+    unsigned long startTime = millis();
     
-    mbedtls_md_init(&ctx);
-    mbedtls_md_setup(&ctx, mbedtls_md_info_from_type(md_type), 0);
-    mbedtls_md_starts(&ctx);
-    mbedtls_md_update(&ctx, (const unsigned char*)data.c_str(), data.length());
-    mbedtls_md_finish(&ctx, hash);
-    mbedtls_md_free(&ctx);
+    // Fast path: prefix rounds precomputed once per job (see duino_kernel.h),
+    // range split across the workers on both cores
+    duino_kernel_job_t kernelJob;
+    if (duino_kernel_prepare(&kernelJob, lastBlockHash, expectedHash)) {
+        uint32_t hashes = 0;
+        int32_t result = duino_workers_search(&kernelJob, 100 * difficulty + 1, kernelLanes, &hashes);
+        totalHashes += hashes;
+        
+        unsigned long elapsed = millis() - startTime;
+        if (result >= 0 && elapsed > 0) {
+            currentHashrate = (hashes * 1000ULL) / elapsed;
+        }
+        return result;
+    }
     
-    // Convert to hex string
-    String result = "";
-    for (int i = 0; i < 20; i++) {
-        if (hash[i] < 16) result += "0";
-        result += String(hash[i], HEX);
+    // Generic path for unexpected prefix lengths: full SHA-1 per candidate,
+    // still compared in binary with no heap work inside the loop
+    uint8_t expected[20];
+    if (!duino_decode_hash(expectedHash, expected)) {
+        return -1;
     }
+    uint32_t expectedWord;
+    memcpy(&expectedWord, expected, 4);
     
-    return result;
-}
-
-// DUCO-S1 mining algorithm
-int duino_duco_s1(String lastBlockHash, String expectedHash, int difficulty) {
-    unsigned long startTime = millis();
+    mbedtls_md_context_t ctx;
+    mbedtls_md_init(&ctx);
+    mbedtls_md_setup(&ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA1), 0);
+    
+    duino_nonce_t nonce;
+    duino_nonce_set(&nonce, 0);
+    int result = -1;
     
     for (int ducos1res = 0; ducos1res < 100 * difficulty + 1; ducos1res++) {
-        String hash = duino_sha1(lastBlockHash + String(ducos1res));
+        uint8_t hash[20];
+        mbedtls_md_starts(&ctx);
+        mbedtls_md_update(&ctx, (const unsigned char*)lastBlockHash, strlen(lastBlockHash));
+        mbedtls_md_update(&ctx, (const unsigned char*)nonce.digits, nonce.len);
+        mbedtls_md_finish(&ctx, hash);
         totalHashes++;
         
-        if (hash == expectedHash) {
+        // First word decides almost every candidate
+        uint32_t hashWord;
+        memcpy(&hashWord, hash, 4);
+        if (hashWord == expectedWord && memcmp(hash, expected, 20) == 0) {
             // Calculate hashrate
             unsigned long elapsed = millis() - startTime;
             if (elapsed > 0) {
                 currentHashrate = (ducos1res * 1000) / elapsed;
             }
-            return ducos1res;
+            result = ducos1res;
+            break;
         }
+        duino_nonce_next(&nonce);
     }
     
-    return -1; // Not found (shouldn't happen with valid job)
+    mbedtls_md_free(&ctx);
+    return result; // -1: not found (shouldn't happen with valid job)
 }
 
 bool duino_mine_job(void) {
-    if (!client.connected()) {
+    if (!duino_is_connected()) {
         Serial.println("❌ Not connected to pool");
         currentState = DUCO_ERROR;
         return false;
@@ -209,98 +557,97 @@ bool duino_mine_job(void) {
     
     currentState = DUCO_MINING;
     
-    // Request job with format: JOB,username,difficulty,mining_key
-    String jobRequest = "JOB," + username + "," + String(DUCO_DIFFICULTY);
-    if (miningKey.length() > 0) {
-        jobRequest += "," + miningKey;
-    }
-    client.println(jobRequest);
-    Serial.printf("   → Job request: %s\n", jobRequest.c_str());
-    
-    // Wait for job response
-    unsigned long timeout = millis();
-    while (!client.available()) {
-        if (millis() - timeout > 10000) {
-            Serial.println("❌ Timeout waiting for job");
-            currentState = DUCO_ERROR;
-            return false;
+    // Network wait: until any connection holds a job (usually none with DUCO_CONNECTIONS 2)
+    unsigned long waitStart = millis();
+    DuinoConnection* conn = NULL;
+    while (conn == NULL) {
+        duino_poll();
+        bool open = false;
+        for (int i = 0; i < DUCO_CONNECTIONS; i++) {
+            DuinoConnection* c = &connections[i];
+            open |= c->state != CONN_CLOSED;
+            if (c->state == CONN_JOB_READY && (conn == NULL || c->stateMs < conn->stateMs)) {
+                conn = c;
+            }
+        }
+        if (conn == NULL) {
+            if (!open) {
+                currentState = DUCO_ERROR;
+                return false;
+            }
+            if (cancelRequested) {
+                currentState = DUCO_CONNECTED;
+                return false;
+            }
+            delay(1);
         }
-        delay(10);
     }
+    uint32_t netWait = millis() - waitStart;
     
-    String job = client.readStringUntil('\n');
+    currentDifficulty = conn->difficulty;
     
-    // Parse job: lastblockhash,expectedhash,difficulty
-    int comma1 = job.indexOf(',');
-    int comma2 = job.indexOf(',', comma1 + 1);
+    Serial.printf("📦 New job - Difficulty: %d (%s)\n", conn->difficulty, duino_tier_name(conn->tier));
     
-    if (comma1 == -1 || comma2 == -1) {
-        Serial.println("❌ Invalid job format");
-        currentState = DUCO_ERROR;
+    // Mine! (the other connections keep being polled between hashing chunks)
+    unsigned long mineStart = millis();
+    uint32_t hashesBefore = totalHashes;
+    int result = duino_duco_s1(conn->lastBlockHash, conn->expectedHash, conn->difficulty);
+    uint32_t mineTime = millis() - mineStart;
+    if (result == DUINO_SEARCH_CANCELLED) {
+        // Stopping: the connection is closed next, no result owed to the pool
+        currentState = DUCO_CONNECTED;
         return false;
     }
+    duino_tier_record_job(conn->tier, mineTime, netWait, totalHashes - hashesBefore, conn->difficulty);
     
-    String lastBlockHash = job.substring(0, comma1);
-    String expectedHash = job.substring(comma1 + 1, comma2);
-    int difficulty = job.substring(comma2 + 1).toInt();
-    
-    currentDifficulty = difficulty;
-    
-    Serial.printf("📦 New job - Difficulty: %d\n", difficulty);
-    
-    // Mine!
-    unsigned long mineStart = millis();
-    int result = duino_duco_s1(lastBlockHash, expectedHash, difficulty);
-    unsigned long mineTime = millis() - mineStart;
+    timing.jobs++;
+    timing.net_wait_ms = netWait;
+    timing.hash_ms = mineTime;
+    timing.net_wait_total_ms += netWait;
+    timing.hash_total_ms += mineTime;
     
     if (result == -1) {
+        // Still answer the job so the connection stays in step; the pool rejects it
         Serial.println("❌ Job solution not found (invalid job?)");
-        rejectedShares++;
-        return false;
+        result = 0;
     }
     
-    // Submit result
+    // Submit result; the verdict is handled by duino_poll() while the next job is hashed
     String submitStr = String(result) + "," + String(currentHashrate) + "," + 
                        MINER_BANNER + " " + DUCO_VERSION + "," + rigId;
-    client.println(submitStr);
-    
-    // Wait for response
-    timeout = millis();
-    while (!client.available()) {
-        if (millis() - timeout > 5000) {
-            Serial.println("❌ Timeout waiting for submit response");
-            currentState = DUCO_ERROR;
-            return false;
+    conn->client.println(submitStr);
+    conn->state = CONN_WAIT_VERDICT;
+    conn->stateMs = millis();
+    conn->hashMs = mineTime;
+    
+    // Tier decision once a window of verdicts is in; the next JOB request uses it
+    if (duino_tier_update()) {
+        const duino_tier_stats_t* tier = duino_tier_stats(duino_tier_current());
+        Serial.printf("🎚️  Tier decision: %s, now %s\n", duino_tier_reason(), tier->name);
+        if (duino_tier_settled() != savedTier) {
+            savedTier = duino_tier_settled();
+            Preferences prefs;
+            prefs.begin(DUCO_TIER_PREFS, false);
+            prefs.putUChar("tier", savedTier);
+            prefs.end();
         }
-        delay(10);
     }
     
-    String response = client.readStringUntil('\n');
-    response.trim();
-    
-    if (response.indexOf("GOOD") >= 0 || response.indexOf("BLOCK") >= 0) {
-        acceptedShares++;
-        Serial.printf("✅ Share accepted! (%ums, %u H/s)\n", mineTime, currentHashrate);
-        
-        // Parse feedback if available (e.g., "GOOD,23.5")
-        int commaPos = response.indexOf(',');
-        if (commaPos > 0) {
-            String feedback = response.substring(commaPos + 1);
-            Serial.printf("   Feedback: %s DUCO\n", feedback.c_str());
-        }
-        
-        currentState = DUCO_CONNECTED;
-        return true;
-    } else if (response.indexOf("BAD") >= 0) {
-        rejectedShares++;
-        Serial.printf("❌ Share rejected: %s\n", response.c_str());
-        currentState = DUCO_CONNECTED;
-        return false;
-    } else {
-        Serial.printf("⚠️  Unknown response: %s\n", response.c_str());
-        currentState = DUCO_CONNECTED;
-        return false;
+    currentState = DUCO_CONNECTED;
+    return true;
+}
+
+void duino_cancel(void) {
+    cancelRequested = true;
+    duino_workers_cancel();
+}
+
+void duino_set_kernel_lanes(int lanes) {
+    if (lanes != 1 && lanes != 2 && lanes != 4 && lanes != 8) {
+        Serial.printf("⚠️  Unsupported SHA-1 lane count %d, using 1\n", lanes);
+        lanes = 1;
     }
+    kernelLanes = lanes;
 }
 
 uint32_t duino_get_accepted_shares(void) {
@@ -318,3 +665,7 @@ uint32_t duino_get_hashrate(void) {
 float duino_get_difficulty(void) {
     return currentDifficulty;
 }
+
+DuinoTiming duino_get_timing(void) {
+    return timing;
+}
@@ -9,6 +9,33 @@
 #define DUCO_PORT_FALLBACK 2811
 #define DUCO_POOL_PICKER_URL "https://server.duinocoin.com/getPool"
 
+// Pool picker result cached in NVS: connects use the cached pool straight
+// away, the picker is re-queried in the background once the entry is older
+// than the TTL or after repeated connect failures
+#ifndef DUCO_POOL_CACHE_TTL_S
+#define DUCO_POOL_CACHE_TTL_S 21600   // 6 hours
+#endif
+#define DUCO_POOL_MAX_FAILS 3
+
+// Fixed server for local testing, skips the pool picker. Build flags e.g.
+// -DDUCO_SERVER_HOST=\"192.168.1.10\" -DDUCO_SERVER_PORT=2811
+#ifndef DUCO_SERVER_PORT
+#define DUCO_SERVER_PORT 2811
+#endif
+
+// Connections to the pool. Each one strictly alternates job and result and
+// asks for its next job as soon as a verdict arrives, so one connection waits
+// two round trips per job (verdict, then job). -DDUCO_CONNECTIONS=2 hides that
+// wait behind the hashing of the other connection's job, but the server sees
+// every connection as a separate miner: the board is listed twice under the
+// account, and per-account miner limits and reward scaling count it twice.
+#ifndef DUCO_CONNECTIONS
+#define DUCO_CONNECTIONS 1
+#endif
+#define DUCO_LINE_MAX 128
+#define DUCO_BANNER_TIMEOUT_MS 5000
+#define DUCO_REPLY_TIMEOUT_MS 10000
+
 // Duino-Coin client state
 enum DuinoState {
     DUCO_DISCONNECTED,
@@ -36,13 +63,34 @@ bool duino_is_connected(void);
 // Get current state
 DuinoState duino_get_state(void);
 
-// Mine one job (blocking call, returns accepted/rejected)
+// Per-job time split between waiting for the pool and hashing
+struct DuinoTiming {
+    uint32_t jobs;
+    uint32_t net_wait_ms;         // Last job
+    uint32_t hash_ms;             // Last job
+    uint32_t net_wait_total_ms;
+    uint32_t hash_total_ms;
+    uint32_t connect_ms;          // Last duino_connect(), picker included
+    bool connect_cached;          // Last duino_connect() used the cached pool
+};
+
+// Mine one job: wait for any connection's job, hash it, submit the result.
+// Verdicts arrive asynchronously (see duino_get_accepted_shares()).
 bool duino_mine_job(void);
 
+// Abandon duino_mine_job() from another task, whether it is waiting for a job
+// or hashing one: it returns false at its next chunk without submitting.
+// Stays set until duino_init().
+void duino_cancel(void);
+
+// SHA-1 lanes per DUCO-S1 batch (1, 2, 4 or 8; default DUINO_SHA1_LANES build flag)
+void duino_set_kernel_lanes(int lanes);
+
 // Get mining statistics
 uint32_t duino_get_accepted_shares(void);
 uint32_t duino_get_rejected_shares(void);
 uint32_t duino_get_hashrate(void);
 float duino_get_difficulty(void);
+DuinoTiming duino_get_timing(void);
 
 #endif // DUINO_CLIENT_H
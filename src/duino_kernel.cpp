@@ -0,0 +1,281 @@
+#include "duino_kernel.h"
+#include <string.h>
+
+#define ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define SHA1_K0 0x5A827999
+#define SHA1_K1 0x6ED9EBA1
+#define SHA1_K2 0x8F1BBCDC
+#define SHA1_K3 0xCA62C1D6
+
+static const uint32_t SHA1_INIT[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+// Round functions with their constants folded in
+#define SHA1_F0(b, c, d) (((d) ^ ((b) & ((c) ^ (d)))) + SHA1_K0)
+#define SHA1_F1(b, c, d) (((b) ^ (c) ^ (d)) + SHA1_K1)
+#define SHA1_F2(b, c, d) ((((b) & (c)) | ((d) & ((b) | (c)))) + SHA1_K2)
+#define SHA1_F3(b, c, d) (((b) ^ (c) ^ (d)) + SHA1_K3)
+
+#define SHA1_ROUND(F, w)                                      \
+    do {                                                      \
+        __typeof__(a) temp = ROTL(a, 5) + F(b, c, d) + e + (w); \
+        e = d;                                                \
+        d = c;                                                \
+        c = ROTL(b, 30);                                      \
+        b = a;                                                \
+        a = temp;                                             \
+    } while (0)
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool duino_decode_hash(const char* hex, uint8_t out[20]) {
+    if (strlen(hex) != 40) {
+        return false;
+    }
+    for (int i = 0; i < 20; i++) {
+        int hi = hex_value(hex[i * 2]);
+        int lo = hex_value(hex[i * 2 + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return true;
+}
+
+bool duino_kernel_prepare(duino_kernel_job_t* job, const char* last_block_hash, const char* expected_hash) {
+    uint8_t expected[20];
+    if (strlen(last_block_hash) != DUINO_KERNEL_PREFIX_LEN || !duino_decode_hash(expected_hash, expected)) {
+        return false;
+    }
+
+    // Expected digest -> 5 big endian words
+    for (int i = 0; i < 5; i++) {
+        job->expected[i] = ((uint32_t)expected[i * 4] << 24) | ((uint32_t)expected[i * 4 + 1] << 16) |
+                           ((uint32_t)expected[i * 4 + 2] << 8) | expected[i * 4 + 3];
+    }
+
+    // The final e is rotl30 of a after round 75, so H4 is known 4 rounds early
+    job->expected_a75 = ROTL(job->expected[4] - SHA1_INIT[4], 2);
+
+    // Message words 0-9 are the prefix characters
+    uint32_t w[10];
+    for (int i = 0; i < 10; i++) {
+        const uint8_t* p = (const uint8_t*)last_block_hash + i * 4;
+        w[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+    }
+
+    // Rounds 0-9 only read the prefix words
+    uint32_t a = SHA1_INIT[0], b = SHA1_INIT[1], c = SHA1_INIT[2], d = SHA1_INIT[3], e = SHA1_INIT[4];
+    for (int t = 0; t < 10; t++) {
+        SHA1_ROUND(SHA1_F0, w[t]);
+    }
+    job->state[0] = a;
+    job->state[1] = b;
+    job->state[2] = c;
+    job->state[3] = d;
+    job->state[4] = e;
+
+    // Schedule words 16-25 mix in prefix words (index < 10): fold those now
+    for (int t = 16; t < 26; t++) {
+        uint32_t x = 0;
+        if (t - 8 < 10) x ^= w[t - 8];
+        if (t - 14 < 10) x ^= w[t - 14];
+        x ^= w[t - 16];
+        job->w_prefix[t - 16] = x;
+    }
+    return true;
+}
+
+// Message words 10-15: digits, 0x80 padding, message length in bits
+static void suffix_words(const char* digits, size_t len, uint32_t* out) {
+    uint8_t tail[24];
+    memset(tail, 0, sizeof(tail));
+    memcpy(tail, digits, len);
+    tail[len] = 0x80;
+    uint32_t bits = (uint32_t)(DUINO_KERNEL_PREFIX_LEN + len) * 8;
+    tail[22] = (uint8_t)(bits >> 8);
+    tail[23] = (uint8_t)bits;
+    for (int i = 0; i < 6; i++) {
+        out[i] = ((uint32_t)tail[i * 4] << 24) | ((uint32_t)tail[i * 4 + 1] << 16) |
+                 ((uint32_t)tail[i * 4 + 2] << 8) | tail[i * 4 + 3];
+    }
+}
+
+// Next schedule word in a circular 16-word buffer
+#define W_NEXT(w, t) \
+    ((w)[(t) & 15] = ROTL((w)[((t) - 3) & 15] ^ (w)[((t) - 8) & 15] ^ (w)[((t) - 14) & 15] ^ (w)[(t) & 15], 1))
+
+// Rounds 10-75 on a schedule whose words 0-9 are zero (their terms are in w_prefix).
+// Shared by the scalar and vector kernels; leaves w ready for rounds 76-79.
+#define KERNEL_ROUNDS_10_75(job, w)                        \
+    do {                                                   \
+        for (int t = 10; t < 16; t++) {                    \
+            SHA1_ROUND(SHA1_F0, (w)[t]);                   \
+        }                                                  \
+        for (int t = 16; t < 20; t++) {                    \
+            (w)[t & 15] ^= (job)->w_prefix[t - 16];        \
+            SHA1_ROUND(SHA1_F0, W_NEXT(w, t));             \
+        }                                                  \
+        for (int t = 20; t < 26; t++) {                    \
+            (w)[t & 15] ^= (job)->w_prefix[t - 16];        \
+            SHA1_ROUND(SHA1_F1, W_NEXT(w, t));             \
+        }                                                  \
+        for (int t = 26; t < 40; t++) {                    \
+            SHA1_ROUND(SHA1_F1, W_NEXT(w, t));             \
+        }                                                  \
+        for (int t = 40; t < 60; t++) {                    \
+            SHA1_ROUND(SHA1_F2, W_NEXT(w, t));             \
+        }                                                  \
+        for (int t = 60; t < 76; t++) {                    \
+            SHA1_ROUND(SHA1_F3, W_NEXT(w, t));             \
+        }                                                  \
+    } while (0)
+
+// Hash one candidate
+static bool kernel_check(const duino_kernel_job_t* job, const char* digits, size_t len) {
+    uint32_t w[16];
+    memset(w, 0, 10 * sizeof(uint32_t));
+    suffix_words(digits, len, w + 10);
+
+    uint32_t a = job->state[0], b = job->state[1], c = job->state[2], d = job->state[3], e = job->state[4];
+    KERNEL_ROUNDS_10_75(job, w);
+
+    // Early reject: a after round 75 decides the last digest word
+    if (a != job->expected_a75) {
+        return false;
+    }
+
+    for (int t = 76; t < 80; t++) {
+        SHA1_ROUND(SHA1_F3, W_NEXT(w, t));
+    }
+    return a + SHA1_INIT[0] == job->expected[0] && b + SHA1_INIT[1] == job->expected[1] &&
+           c + SHA1_INIT[2] == job->expected[2] && d + SHA1_INIT[3] == job->expected[3] &&
+           e + SHA1_INIT[4] == job->expected[4];
+}
+
+bool duino_kernel_check(const duino_kernel_job_t* job, const char* digits, size_t len) {
+    if (len == 0 || len > DUINO_KERNEL_MAX_DIGITS) {
+        return false;
+    }
+    return kernel_check(job, digits, len);
+}
+
+void duino_nonce_set(duino_nonce_t* nonce, uint32_t value) {
+    char buf[12];
+    char* p = buf + sizeof(buf);
+    do {
+        *--p = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    nonce->len = buf + sizeof(buf) - p;
+    memcpy(nonce->digits, p, nonce->len);
+    nonce->digits[nonce->len] = 0;
+}
+
+void duino_nonce_next(duino_nonce_t* nonce) {
+    // Increment the last digit and carry
+    int i = (int)nonce->len - 1;
+    while (i >= 0 && nonce->digits[i] == '9') {
+        nonce->digits[i--] = '0';
+    }
+    if (i >= 0) {
+        nonce->digits[i]++;
+        return;
+    }
+
+    // 9...9 -> 10...0: one more digit
+    nonce->digits[0] = '1';
+    nonce->digits[nonce->len++] = '0';
+    nonce->digits[nonce->len] = 0;
+}
+
+// Scalar search: one candidate at a time
+static int32_t kernel_search_scalar(const duino_kernel_job_t* job, uint32_t start, uint32_t end, uint32_t* hashes) {
+    duino_nonce_t digits;
+    duino_nonce_set(&digits, start);
+
+    for (uint32_t nonce = start; nonce < end; nonce++) {
+        if (kernel_check(job, digits.digits, digits.len)) {
+            *hashes = nonce - start + 1;
+            return (int32_t)nonce;
+        }
+        duino_nonce_next(&digits);
+    }
+
+    *hashes = end > start ? end - start : 0;
+    return -1;
+}
+
+// Vector of LANES 32-bit words (GCC vector extension: SSE/AVX2 on x86, plain
+// registers elsewhere)
+template <int LANES> struct lane_vector;
+template <> struct lane_vector<2> { typedef uint32_t type __attribute__((vector_size(8))); };
+template <> struct lane_vector<4> { typedef uint32_t type __attribute__((vector_size(16))); };
+template <> struct lane_vector<8> { typedef uint32_t type __attribute__((vector_size(32))); };
+
+// Batched search: LANES consecutive nonces per pass, one vector element each.
+// Every lane builds its own suffix words, so a batch may straddle a
+// digit-length boundary (e.g. 98, 99, 100, 101).
+template <int LANES>
+static int32_t kernel_search_lanes(const duino_kernel_job_t* job, uint32_t start, uint32_t end, uint32_t* hashes) {
+    typedef typename lane_vector<LANES>::type vec;
+
+    duino_nonce_t counter;
+    duino_nonce_set(&counter, start);
+    duino_nonce_t lane_digits[LANES];
+
+    for (uint32_t base = start; base < end; base += LANES) {
+        // Circular 16-word schedule; words 0-9 stay zero, their terms are in w_prefix
+        vec w[16];
+        for (int i = 0; i < 10; i++) {
+            w[i] = vec{};
+        }
+        for (int lane = 0; lane < LANES; lane++) {
+            uint32_t words[6];
+            lane_digits[lane] = counter;
+            suffix_words(counter.digits, counter.len, words);
+            for (int i = 0; i < 6; i++) {
+                w[10 + i][lane] = words[i];
+            }
+            duino_nonce_next(&counter);
+        }
+
+        vec a = vec{} + job->state[0], b = vec{} + job->state[1], c = vec{} + job->state[2];
+        vec d = vec{} + job->state[3], e = vec{} + job->state[4];
+
+        KERNEL_ROUNDS_10_75(job, w);
+
+        // Early reject for the whole batch; a candidate lane is confirmed by the scalar kernel
+        vec match = (vec)(a == job->expected_a75);
+        for (int lane = 0; lane < LANES; lane++) {
+            if (match[lane] && base + lane < end &&
+                kernel_check(job, lane_digits[lane].digits, lane_digits[lane].len)) {
+                *hashes = base + lane - start + 1;
+                return (int32_t)(base + lane);
+            }
+        }
+    }
+
+    *hashes = end > start ? end - start : 0;
+    return -1;
+}
+
+int32_t duino_kernel_search_lanes(const duino_kernel_job_t* job, uint32_t start, uint32_t end, uint32_t* hashes,
+                                  int lanes) {
+    switch (lanes) {
+        case 2: return kernel_search_lanes<2>(job, start, end, hashes);
+        case 4: return kernel_search_lanes<4>(job, start, end, hashes);
+        case 8: return kernel_search_lanes<8>(job, start, end, hashes);
+        default: return kernel_search_scalar(job, start, end, hashes);
+    }
+}
+
+int32_t duino_kernel_search(const duino_kernel_job_t* job, uint32_t start, uint32_t end, uint32_t* hashes) {
+    return duino_kernel_search_lanes(job, start, end, hashes, DUINO_SHA1_LANES);
+}
@@ -0,0 +1,67 @@
+#ifndef DUINO_KERNEL_H
+#define DUINO_KERNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// DUCO-S1 search kernel: SHA-1(lastBlockHash + decimal nonce) == expectedHash.
+//
+// The 40-character block hash fills the first ten message words of the single
+// SHA-1 block, so their rounds and schedule terms are computed once per job and
+// only the nonce digits are hashed per candidate. Plain C with no Arduino
+// dependencies so the same code builds on the host for benchmarks.
+
+#define DUINO_KERNEL_PREFIX_LEN 40    // lastBlockHash is a 40-char hex SHA-1
+#define DUINO_KERNEL_MAX_DIGITS 15    // Prefix + digits + padding must fit one block
+
+// Candidates hashed side by side with interleaved rounds (1, 2, 4 or 8).
+// Lanes map to SIMD registers on x86 hosts (SSE2: 4, AVX2: 8); on the ESP32
+// they only add instruction-level parallelism, so the default stays scalar.
+#define DUINO_SHA1_MAX_LANES 8
+#ifndef DUINO_SHA1_LANES
+#if defined(__AVX2__)
+#define DUINO_SHA1_LANES 8
+#elif defined(__SSE2__)
+#define DUINO_SHA1_LANES 4
+#else
+#define DUINO_SHA1_LANES 1
+#endif
+#endif
+
+// Per-job precomputed state
+typedef struct {
+    uint32_t state[5];      // SHA-1 working variables a..e after rounds 0-9
+    uint32_t w_prefix[10];  // Prefix-only XOR terms of schedule words 16-25
+    uint32_t expected[5];   // Expected digest as big endian words
+    uint32_t expected_a75;  // Working variable a after round 75 implied by expected[4]
+} duino_kernel_job_t;
+
+// Decimal nonce kept as ASCII and incremented in place (no per-candidate
+// number formatting or heap)
+typedef struct {
+    char digits[DUINO_KERNEL_MAX_DIGITS + 1];
+    size_t len;
+} duino_nonce_t;
+
+void duino_nonce_set(duino_nonce_t* nonce, uint32_t value);
+void duino_nonce_next(duino_nonce_t* nonce);
+
+// Decode a 40-digit hex SHA-1 into 20 bytes (false if malformed)
+bool duino_decode_hash(const char* hex, uint8_t out[20]);
+
+// Prepare a job. Returns false if the prefix is not 40 characters or the
+// expected hash is not 40 hex digits (caller falls back to the generic path).
+bool duino_kernel_prepare(duino_kernel_job_t* job, const char* last_block_hash, const char* expected_hash);
+
+// Test one nonce given as ASCII digits
+bool duino_kernel_check(const duino_kernel_job_t* job, const char* digits, size_t len);
+
+// Search nonces in [start, end) with DUINO_SHA1_LANES lanes. Returns the
+// matching nonce or -1; *hashes receives the number of candidates tried.
+int32_t duino_kernel_search(const duino_kernel_job_t* job, uint32_t start, uint32_t end, uint32_t* hashes);
+
+// Same search with a lane count chosen at runtime (unsupported counts fall back to 1)
+int32_t duino_kernel_search_lanes(const duino_kernel_job_t* job, uint32_t start, uint32_t end, uint32_t* hashes,
+                                  int lanes);
+
+#endif // DUINO_KERNEL_H
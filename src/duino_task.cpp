@@ -1,5 +1,6 @@
 #include "duino_task.h"
 #include "duino_client.h"
+#include "duino_workers.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
@@ -56,10 +57,14 @@ void duinoTask(void* parameter)
         Serial.println("   2. Internet access is available");
         Serial.println("   3. server.duinocoin.com is reachable");
         taskRunning = false;
+        duinoTaskHandle = NULL;
         vTaskDelete(NULL);
         return;
     }
     
+    // Second worker on core 0 for the DUCO-S1 search
+    duino_workers_init(DUINO_WORKERS);
+    
     Serial.println("🚀 Starting mining loop...");
     Serial.println();
     
@@ -75,6 +80,20 @@ void duinoTask(void* parameter)
         stats.shares_accepted = duino_get_accepted_shares();
         stats.shares_rejected = duino_get_rejected_shares();
         stats.difficulty = duino_get_difficulty();
+        DuinoTiming timing = duino_get_timing();
+        stats.jobs = timing.jobs;
+        stats.net_wait_ms = timing.net_wait_ms;
+        stats.hash_ms = timing.hash_ms;
+        stats.net_wait_total_ms = timing.net_wait_total_ms;
+        stats.hash_total_ms = timing.hash_total_ms;
+        stats.connect_ms = timing.connect_ms;
+        stats.connect_cached = timing.connect_cached;
+        stats.tier = duino_tier_name(duino_tier_current());
+        stats.tier_reason = duino_tier_reason();
+        stats.tier_switches = duino_tier_switches();
+        for (int i = 0; i < DUINO_TIER_COUNT; i++) {
+            stats.tiers[i] = *duino_tier_stats(i);
+        }
         
         // Print stats every 10 seconds
         if (millis() - lastStatsUpdate >= 10000) {
@@ -90,6 +109,25 @@ void duinoTask(void* parameter)
                                    (stats.shares_accepted + stats.shares_rejected);
                 Serial.printf("   Success Rate: %.1f%%\n", successRate);
             }
+            uint32_t cycleMs = stats.net_wait_total_ms + stats.hash_total_ms;
+            if (stats.jobs > 0 && cycleMs > 0) {
+                Serial.printf("   Per job: %u ms hashing, %u ms network wait (%.1f%% of cycle)\n",
+                             stats.hash_total_ms / stats.jobs, stats.net_wait_total_ms / stats.jobs,
+                             stats.net_wait_total_ms * 100.0 / cycleMs);
+            }
+            Serial.printf("   Last connect: %u ms (%s)\n", stats.connect_ms,
+                         stats.connect_cached ? "cached pool" : "pool picker");
+            Serial.printf("   Tier: %s (%s, %u switches)\n", stats.tier, stats.tier_reason, stats.tier_switches);
+            for (int i = 0; i < DUINO_TIER_COUNT; i++) {
+                const duino_tier_stats_t* t = &stats.tiers[i];
+                if (t->jobs == 0) {
+                    continue;
+                }
+                Serial.printf("     %-6s %u jobs, %u ms/job, %u H/s, %u ok / %u bad, reward proxy %.2f/s\n", t->name,
+                             t->jobs, t->hash_ms / t->jobs,
+                             t->hash_ms > 0 ? (uint32_t)(t->hashes * 1000ULL / t->hash_ms) : 0, t->accepted,
+                             t->rejected, t->reward_proxy);
+            }
             Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
             Serial.println();
         }
@@ -104,11 +142,12 @@ void duinoTask(void* parameter)
             }
         }
         
-        // Small delay between jobs
-        delay(100);
+        // Yield a tick between jobs (the next job is usually already waiting)
+        delay(1);
     }
     
     // Cleanup
+    duino_workers_deinit();
     duino_disconnect();
     taskRunning = false;
     
@@ -117,6 +156,8 @@ void duinoTask(void* parameter)
     Serial.println("╚════════════════════════════════════════════════════════╝");
     Serial.println();
     
+    // Lets duino_task_stop() see the task has finished its cleanup
+    duinoTaskHandle = NULL;
     vTaskDelete(NULL);
 }
 
@@ -156,7 +197,7 @@ void duino_task_start(void) {
         1                    // Core 1
     );
     
-    Serial.println("✅ Duino-Coin mining task started on Core 1");
+    Serial.printf("✅ Duino-Coin mining task started on Core 1 (%d workers)\n", DUINO_WORKERS);
 }
 
 void duino_task_stop(void) {
@@ -167,6 +208,9 @@ void duino_task_stop(void) {
     
     taskRunning = false;
     
+    // Stop the job in progress at its next chunk, so the task runs its own cleanup
+    duino_cancel();
+    
     // Wait for task to finish
     unsigned long timeout = millis();
     while (duinoTaskHandle != NULL && (millis() - timeout < 5000)) {
@@ -2,6 +2,7 @@
 #define DUINO_TASK_H
 
 #include <Arduino.h>
+#include "duino_tier.h"
 
 // Duino-Coin mining statistics
 struct DuinoStats {
@@ -10,6 +11,17 @@ struct DuinoStats {
     uint32_t shares_rejected;
     float difficulty;
     uint32_t total_hashes;
+    uint32_t jobs;
+    uint32_t net_wait_ms;         // Last job: waiting for the pool
+    uint32_t hash_ms;             // Last job: hashing
+    uint32_t net_wait_total_ms;
+    uint32_t hash_total_ms;
+    uint32_t connect_ms;          // Last pool (re)connect
+    bool connect_cached;          // Last connect skipped the pool picker
+    const char* tier;             // Difficulty tier requested for new jobs
+    const char* tier_reason;      // Last tier decision
+    uint32_t tier_switches;
+    duino_tier_stats_t tiers[DUINO_TIER_COUNT];   // Per tier; reward_proxy is modelled, not the payout
 };
 
 // Duino task management
@@ -0,0 +1,182 @@
+#include "duino_tier.h"
+#include <string.h>
+
+// Tier names as sent in "JOB,user,tier", easiest first
+static const char* TIER_NAMES[DUINO_TIER_COUNT] = {"ESP32", "LOW", "MEDIUM"};
+static const float TIER_MULTIPLIERS[DUINO_TIER_COUNT] = DUINO_TIER_MULTIPLIERS;
+static const uint32_t TIER_MAX_HASHRATES[DUINO_TIER_COUNT] = DUINO_TIER_MAX_HASHRATES;
+
+static duino_tier_stats_t tiers[DUINO_TIER_COUNT];
+static int currentTier = 0;
+static int settledTier = 0;
+static int probeFrom = -1;        // Tier a probe started from (-1: not probing)
+static uint32_t switches = 0;
+static const char* lastReason = "starting";
+
+// Current window (results at the current tier only)
+static uint32_t winJobs = 0;
+static uint32_t winVerdicts = 0;
+static uint32_t winRejected = 0;
+static uint32_t winHashes = 0;
+static uint32_t winHashMs = 0;
+static uint32_t winCycleMs = 0;
+
+static void window_reset(void) {
+    winJobs = 0;
+    winVerdicts = 0;
+    winRejected = 0;
+    winHashes = 0;
+    winHashMs = 0;
+    winCycleMs = 0;
+}
+
+static bool valid_tier(int tier) {
+    return tier >= 0 && tier < DUINO_TIER_COUNT;
+}
+
+void duino_tier_init(int start) {
+    memset(tiers, 0, sizeof(tiers));
+    for (int i = 0; i < DUINO_TIER_COUNT; i++) {
+        tiers[i].name = TIER_NAMES[i];
+    }
+    currentTier = valid_tier(start) ? start : 0;
+    settledTier = currentTier;
+    probeFrom = -1;
+    switches = 0;
+    lastReason = "starting";
+    window_reset();
+}
+
+int duino_tier_current(void) {
+    return currentTier;
+}
+
+const char* duino_tier_name(int tier) {
+    return valid_tier(tier) ? TIER_NAMES[tier] : TIER_NAMES[0];
+}
+
+int duino_tier_settled(void) {
+    return settledTier;
+}
+
+void duino_tier_record_job(int tier, uint32_t hashMs, uint32_t netWaitMs, uint32_t hashes, uint32_t difficulty) {
+    if (!valid_tier(tier)) {
+        return;
+    }
+    duino_tier_stats_t* t = &tiers[tier];
+    t->jobs++;
+    t->hashes += hashes;
+    t->hash_ms += hashMs;
+    t->cycle_ms += hashMs + netWaitMs;
+    t->difficulty = difficulty;
+
+    if (tier == currentTier) {
+        winJobs++;
+        winHashes += hashes;
+        winHashMs += hashMs;
+        winCycleMs += hashMs + netWaitMs;
+    }
+}
+
+void duino_tier_record_verdict(int tier, bool accepted) {
+    if (!valid_tier(tier)) {
+        return;
+    }
+    duino_tier_stats_t* t = &tiers[tier];
+    if (accepted) {
+        t->accepted++;
+    } else {
+        t->rejected++;
+    }
+
+    // Verdicts for jobs requested before a switch stay out of the new window
+    if (tier == currentTier) {
+        winVerdicts++;
+        if (!accepted) {
+            winRejected++;
+        }
+    }
+}
+
+// Modelled reward per second of the current window (see duino_tier.h)
+static float window_reward_proxy(void) {
+    if (winCycleMs == 0) {
+        return 0;
+    }
+    float value = TIER_MULTIPLIERS[currentTier];
+    uint32_t cap = TIER_MAX_HASHRATES[currentTier];
+    uint32_t hashrate = winHashMs > 0 ? (uint32_t)(winHashes * 1000ULL / winHashMs) : 0;
+    if (cap > 0 && hashrate > cap) {
+        value *= DUINO_TIER_OVERCAP_PENALTY;
+    }
+    return (winVerdicts - winRejected) * value * 1000.0f / winCycleMs;
+}
+
+bool duino_tier_update(void) {
+    if (winVerdicts < DUINO_TIER_WINDOW) {
+        return false;
+    }
+
+    duino_tier_stats_t* t = &tiers[currentTier];
+    float rate = window_reward_proxy();
+    t->reward_proxy = t->reward_proxy > 0 ? (t->reward_proxy + rate) / 2 : rate;
+    float rejectRatio = (float)winRejected / winVerdicts;
+    uint32_t avgSolveMs = winJobs > 0 ? winHashMs / winJobs : 0;
+
+    for (int i = 0; i < DUINO_TIER_COUNT; i++) {
+        if (tiers[i].cooldown > 0) {
+            tiers[i].cooldown--;
+        }
+    }
+
+    int next = currentTier;
+    if (currentTier > 0 && (rejectRatio > DUINO_TIER_MAX_REJECT || avgSolveMs > DUINO_TIER_MAX_SOLVE_MS)) {
+        // Too hard for this device (or not allowed by the server): back off
+        next = currentTier - 1;
+        t->cooldown = DUINO_TIER_COOLDOWN;
+        probeFrom = -1;
+        lastReason = rejectRatio > DUINO_TIER_MAX_REJECT ? "too many rejects" : "jobs too slow";
+    } else if (probeFrom >= 0) {
+        if (rate > tiers[probeFrom].reward_proxy * (1.0f + DUINO_TIER_HYSTERESIS)) {
+            lastReason = "probe won";
+        } else {
+            next = probeFrom;
+            t->cooldown = DUINO_TIER_COOLDOWN;
+            lastReason = "probe lost";
+        }
+        probeFrom = -1;
+    } else if (currentTier > 0 && tiers[currentTier - 1].cooldown == 0 &&
+               tiers[currentTier - 1].reward_proxy > t->reward_proxy * (1.0f + DUINO_TIER_HYSTERESIS)) {
+        next = currentTier - 1;
+        lastReason = "easier tier pays more";
+    } else if (currentTier + 1 < DUINO_TIER_COUNT && tiers[currentTier + 1].cooldown == 0 &&
+               avgSolveMs < DUINO_TIER_PROBE_BELOW_MS) {
+        probeFrom = currentTier;
+        next = currentTier + 1;
+        lastReason = "probing harder tier";
+    } else {
+        lastReason = "holding";
+    }
+
+    if (probeFrom < 0) {
+        settledTier = next;
+    }
+    if (next != currentTier) {
+        currentTier = next;
+        switches++;
+    }
+    window_reset();
+    return true;
+}
+
+const char* duino_tier_reason(void) {
+    return lastReason;
+}
+
+const duino_tier_stats_t* duino_tier_stats(int tier) {
+    return valid_tier(tier) ? &tiers[tier] : &tiers[0];
+}
+
+uint32_t duino_tier_switches(void) {
+    return switches;
+}
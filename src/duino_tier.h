@@ -0,0 +1,81 @@
+#ifndef DUINO_TIER_H
+#define DUINO_TIER_H
+
+#include <stdint.h>
+
+// Duino-Coin difficulty tier selection. The tier named in each JOB request
+// sets the difficulty the server hands out. Every tier keeps its own results
+// (solve time, network wait, accepted/rejected, reward proxy); after each
+// window of verdicts the selector may probe the next harder tier, keep it
+// only if its reward proxy beats the tier it came from by the hysteresis
+// margin, and fall back when jobs get too slow or rejects pile up.
+//
+// The device never sees what a share pays, so the selector works on a model:
+// every accepted share is worth the tier's multiplier, cut by the over-cap
+// penalty when the device hashes faster than the tier's hashrate cap (the
+// server pays less to devices above the class a tier is meant for). A share
+// is not worth its difficulty: that would always favour the hardest tier.
+// The defaults are estimates, not published server figures; override them
+// with build flags.
+// Plain C++ with no Arduino dependencies.
+
+#define DUINO_TIER_COUNT 3            // ESP32, LOW, MEDIUM (easiest first)
+#define DUINO_TIER_WINDOW 16          // Verdicts per decision
+#define DUINO_TIER_HYSTERESIS 0.10f   // A probed tier must beat the old one by 10%
+#define DUINO_TIER_COOLDOWN 8         // Windows before a losing tier is probed again
+#define DUINO_TIER_MAX_SOLVE_MS 8000  // Average solve time above this: step down
+#define DUINO_TIER_PROBE_BELOW_MS 2000 // Only probe harder tiers while jobs are this quick
+#define DUINO_TIER_MAX_REJECT 0.25f   // Reject ratio in a window that forces a step down
+
+// Reward model, easiest tier first
+#ifndef DUINO_TIER_MULTIPLIERS
+#define DUINO_TIER_MULTIPLIERS {1.0f, 1.0f, 1.0f}        // Value of an accepted share
+#endif
+#ifndef DUINO_TIER_MAX_HASHRATES
+#define DUINO_TIER_MAX_HASHRATES {40000, 160000, 0}      // H/s the tier is meant for (0 = no cap)
+#endif
+#ifndef DUINO_TIER_OVERCAP_PENALTY
+#define DUINO_TIER_OVERCAP_PENALTY 0.5f                  // Share value above the cap
+#endif
+
+// Per-tier results
+typedef struct {
+    const char* name;
+    uint32_t jobs;
+    uint32_t accepted;
+    uint32_t rejected;
+    uint32_t hashes;
+    uint32_t hash_ms;             // Total solve time
+    uint32_t cycle_ms;            // Total solve time + network wait
+    uint32_t difficulty;          // Last difficulty handed out by the server
+    float reward_proxy;           // Smoothed modelled reward per second of cycle time (not the payout)
+    uint32_t cooldown;            // Windows left before this tier may be probed again
+} duino_tier_stats_t;
+
+// Start at the given tier (e.g. the last settled tier saved in NVS)
+void duino_tier_init(int start);
+
+int duino_tier_current(void);
+const char* duino_tier_name(int tier);
+
+// Tier the selector last settled on (probes excluded), worth persisting
+int duino_tier_settled(void);
+
+// One job solved at this tier
+void duino_tier_record_job(int tier, uint32_t hashMs, uint32_t netWaitMs, uint32_t hashes, uint32_t difficulty);
+
+// Verdict for a result at this tier
+void duino_tier_record_verdict(int tier, bool accepted);
+
+// Decide once a full window of verdicts at the current tier is in. Returns
+// true if a decision was made (see duino_tier_reason()); the tier may be
+// unchanged.
+bool duino_tier_update(void);
+
+// Last decision, e.g. "probing harder tier", "probe lost", "jobs too slow"
+const char* duino_tier_reason(void);
+
+const duino_tier_stats_t* duino_tier_stats(int tier);
+uint32_t duino_tier_switches(void);
+
+#endif // DUINO_TIER_H
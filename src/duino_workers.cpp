@@ -0,0 +1,174 @@
+#include "duino_workers.h"
+#include <atomic>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#else
+#include <thread>
+#endif
+
+// Candidates hashed by each worker in the current search
+static uint32_t workerHashes[DUINO_MAX_WORKERS];
+static int workerCount = 1;
+
+// Current job, shared with the helpers while a search is running
+static const duino_kernel_job_t* currentJob = nullptr;
+static int currentLanes = 1;
+static uint32_t currentEnd = 0;
+static std::atomic<uint32_t> nextChunk(0);
+static std::atomic<int32_t> foundNonce(-1);
+static std::atomic<bool> cancelled(false);
+static void (*pollHook)(void) = nullptr;
+
+#ifdef ARDUINO
+static TaskHandle_t helperHandles[DUINO_MAX_WORKERS];
+static SemaphoreHandle_t doneSemaphore = NULL;
+static volatile bool helpersExit = false;
+#endif
+
+// Take chunks from the shared counter until the range is done, any worker
+// has found the solution or the search is cancelled. Chunks go out in order,
+// so the workers sweep the range from 0 together and stop within one chunk
+// of the solution.
+static void worker_run(int index) {
+    workerHashes[index] = 0;
+
+    while (foundNonce.load(std::memory_order_relaxed) < 0 && !cancelled.load(std::memory_order_relaxed)) {
+        uint32_t chunk = nextChunk.fetch_add(DUINO_WORKER_CHUNK, std::memory_order_relaxed);
+        if (chunk >= currentEnd) {
+            return;
+        }
+        uint32_t chunkEnd = currentEnd - chunk > DUINO_WORKER_CHUNK ? chunk + DUINO_WORKER_CHUNK : currentEnd;
+        uint32_t hashes = 0;
+        int32_t result = duino_kernel_search_lanes(currentJob, chunk, chunkEnd, &hashes, currentLanes);
+        workerHashes[index] += hashes;
+        if (result >= 0) {
+            int32_t none = -1;
+            foundNonce.compare_exchange_strong(none, result);
+            return;
+        }
+        if (index == 0 && pollHook) {
+            pollHook();
+        }
+    }
+}
+
+#ifdef ARDUINO
+// Helper task: waits for a job, searches its slice, reports back
+static void duinoWorkerTask(void* parameter) {
+    int index = (int)(intptr_t)parameter;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (helpersExit) {
+            break;
+        }
+        worker_run(index);
+        xSemaphoreGive(doneSemaphore);
+    }
+
+    xSemaphoreGive(doneSemaphore);
+    vTaskDelete(NULL);
+}
+#endif
+
+void duino_workers_init(int workers) {
+    if (workers < 1) workers = 1;
+    if (workers > DUINO_MAX_WORKERS) workers = DUINO_MAX_WORKERS;
+    duino_workers_deinit();
+
+#ifdef ARDUINO
+    doneSemaphore = xSemaphoreCreateCounting(DUINO_MAX_WORKERS, 0);
+    helpersExit = false;
+
+    // Helpers run on core 0 at idle priority: the WiFi stack preempts them
+    // and the idle task still gets its time slice (task watchdog stays fed)
+    for (int i = 1; i < workers; i++) {
+        xTaskCreatePinnedToCore(
+            duinoWorkerTask,      // Task function
+            "DuinoWorker",        // Task name
+            4096,                 // Stack size (bytes)
+            (void*)(intptr_t)i,   // Worker index
+            0,                    // Priority (same as idle)
+            &helperHandles[i],    // Task handle
+            0                     // Core 0
+        );
+    }
+    Serial.printf("⚙️  DUCO-S1 workers: %d (caller + %d on core 0)\n", workers, workers - 1);
+#endif
+
+    workerCount = workers;
+    cancelled.store(false);
+}
+
+void duino_workers_deinit(void) {
+#ifdef ARDUINO
+    if (workerCount > 1) {
+        helpersExit = true;
+        for (int i = 1; i < workerCount; i++) {
+            xTaskNotifyGive(helperHandles[i]);
+        }
+        for (int i = 1; i < workerCount; i++) {
+            xSemaphoreTake(doneSemaphore, portMAX_DELAY);
+        }
+    }
+    if (doneSemaphore != NULL) {
+        vSemaphoreDelete(doneSemaphore);
+        doneSemaphore = NULL;
+    }
+#endif
+    workerCount = 1;
+}
+
+void duino_workers_cancel(void) {
+    cancelled.store(true);
+}
+
+void duino_workers_set_poll(void (*poll)(void)) {
+    pollHook = poll;
+}
+
+int duino_workers_count(void) {
+    return workerCount;
+}
+
+int32_t duino_workers_search(const duino_kernel_job_t* job, uint32_t end, int lanes, uint32_t* hashes) {
+    currentJob = job;
+    currentLanes = lanes;
+    currentEnd = end;
+    nextChunk.store(0);
+    foundNonce.store(-1);
+
+    // A range of one chunk cannot be shared: the caller searches it alone
+    int workers = end > DUINO_WORKER_CHUNK ? workerCount : 1;
+
+#ifdef ARDUINO
+    for (int i = 1; i < workers; i++) {
+        xTaskNotifyGive(helperHandles[i]);
+    }
+    worker_run(0);
+    for (int i = 1; i < workers; i++) {
+        xSemaphoreTake(doneSemaphore, portMAX_DELAY);
+    }
+#else
+    std::thread helpers[DUINO_MAX_WORKERS];
+    for (int i = 1; i < workers; i++) {
+        helpers[i] = std::thread(worker_run, i);
+    }
+    worker_run(0);
+    for (int i = 1; i < workers; i++) {
+        helpers[i].join();
+    }
+#endif
+
+    uint32_t total = 0;
+    for (int i = 0; i < workers; i++) {
+        total += workerHashes[i];
+    }
+    *hashes = total;
+    int32_t result = foundNonce.load();
+    return result < 0 && cancelled.load() ? DUINO_SEARCH_CANCELLED : result;
+}
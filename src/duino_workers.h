@@ -0,0 +1,43 @@
+#ifndef DUINO_WORKERS_H
+#define DUINO_WORKERS_H
+
+#include "duino_kernel.h"
+
+// DUCO-S1 worker pool: the workers take one job's nonce range chunk by chunk
+// from a shared counter, and the first worker to find the solution cancels
+// the rest.
+// The calling task is worker 0. On the ESP32 the other worker is a task on
+// core 0; on the host (no ARDUINO) workers are std::threads for scaling tests.
+
+#define DUINO_MAX_WORKERS 8
+#define DUINO_WORKER_CHUNK 1024   // Nonces per handout (and between cancellation checks)
+
+#ifndef DUINO_WORKERS
+#define DUINO_WORKERS 2           // One per ESP32-S3 core
+#endif
+
+// Start the helper workers (total workers including the caller)
+void duino_workers_init(int workers);
+
+// Stop the helper workers; searches then run on the caller only
+void duino_workers_deinit(void);
+
+// Abandon the running search from another task: every worker stops at its
+// next chunk and the search returns DUINO_SEARCH_CANCELLED, as does every
+// search after it until duino_workers_init()
+void duino_workers_cancel(void);
+
+// Called by the calling task between its chunks (e.g. to service pool sockets)
+void duino_workers_set_poll(void (*poll)(void));
+
+// Number of workers used by duino_workers_search()
+int duino_workers_count(void);
+
+#define DUINO_SEARCH_CANCELLED -2
+
+// Search [0, end) across all workers. Returns the solution, -1 or
+// DUINO_SEARCH_CANCELLED; *hashes receives the candidates tried by all
+// workers together.
+int32_t duino_workers_search(const duino_kernel_job_t* job, uint32_t end, int lanes, uint32_t* hashes);
+
+#endif // DUINO_WORKERS_H
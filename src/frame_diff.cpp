@@ -0,0 +1,156 @@
+#include "frame_diff.h"
+#include <string.h>
+
+// Rectangles kept while the rows are scanned, before the final merge
+#define DIFF_WORK_RECTS 32
+
+size_t frame_diff_bytes(int width, int height) {
+    return (size_t)width * height * sizeof(uint16_t);
+}
+
+bool frame_diff_init(frame_diff_t* diff, const uint16_t* frame, void* buffer, size_t bytes, int width, int height) {
+    if (!frame || !buffer || width <= 0 || height <= 0 || width > INT16_MAX || height > INT16_MAX ||
+        bytes < frame_diff_bytes(width, height)) {
+        return false;
+    }
+    diff->frame = frame;
+    diff->shown = (uint16_t*)buffer;
+    diff->width = width;
+    diff->height = height;
+    diff->changed = 0;
+    diff->valid = false;
+    return true;
+}
+
+void frame_diff_invalidate(frame_diff_t* diff) {
+    diff->valid = false;
+}
+
+static int32_t area(const diff_rect_t& r) {
+    return (int32_t)r.w * r.h;
+}
+
+static diff_rect_t bounds(const diff_rect_t& a, const diff_rect_t& b) {
+    int x0 = a.x < b.x ? a.x : b.x;
+    int y0 = a.y < b.y ? a.y : b.y;
+    int x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+    int y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+    diff_rect_t r = {(int16_t)x0, (int16_t)y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+    return r;
+}
+
+// Unchanged pixels sent if a and b go out as one rectangle (negative if they overlap)
+static int32_t merge_waste(const diff_rect_t& a, const diff_rect_t& b) {
+    return area(bounds(a, b)) - area(a) - area(b);
+}
+
+// Merge the pair that wastes least. Returns the waste, or INT32_MAX with fewer than 2 rectangles.
+static int32_t merge_cheapest(diff_rect_t* rects, int* count, bool only_if_cheap) {
+    int32_t best = INT32_MAX;
+    int bi = -1, bj = -1;
+    for (int i = 0; i < *count; i++) {
+        for (int j = i + 1; j < *count; j++) {
+            int32_t waste = merge_waste(rects[i], rects[j]);
+            if (waste < best) {
+                best = waste;
+                bi = i;
+                bj = j;
+            }
+        }
+    }
+    if (bi < 0 || (only_if_cheap && best > FRAME_DIFF_RECT_OVERHEAD)) {
+        return best;
+    }
+    rects[bi] = bounds(rects[bi], rects[bj]);
+    rects[bj] = rects[--*count];
+    return best;
+}
+
+// Add the changed span of a row: into the rectangle it extends most cheaply, or as a new one
+static void add_span(diff_rect_t* rects, int* count, int x0, int x1, int y) {
+    diff_rect_t span = {(int16_t)x0, (int16_t)y, (int16_t)(x1 - x0 + 1), 1};
+    int best = -1;
+    int32_t best_waste = FRAME_DIFF_RECT_OVERHEAD + 1;
+    for (int i = 0; i < *count; i++) {
+        int32_t waste = merge_waste(rects[i], span);
+        if (waste < best_waste) {
+            best_waste = waste;
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        rects[best] = bounds(rects[best], span);
+        return;
+    }
+    if (*count == DIFF_WORK_RECTS) {
+        merge_cheapest(rects, count, false);
+    }
+    rects[(*count)++] = span;
+}
+
+int frame_diff_collect(frame_diff_t* diff, diff_rect_t* rects, int max_rects) {
+    const int width = diff->width;
+    diff->changed = 0;
+    if (max_rects < 1) {
+        return 0;
+    }
+
+    // Panel content unknown: send everything
+    if (!diff->valid) {
+        memcpy(diff->shown, diff->frame, (size_t)width * diff->height * sizeof(uint16_t));
+        diff->valid = true;
+        diff->changed = (uint32_t)width * diff->height;
+        rects[0].x = 0;
+        rects[0].y = 0;
+        rects[0].w = (int16_t)width;
+        rects[0].h = (int16_t)diff->height;
+        return 1;
+    }
+
+    diff_rect_t work[DIFF_WORK_RECTS];
+    int count = 0;
+    for (int y = 0; y < diff->height; y++) {
+        const uint16_t* frame = diff->frame + (size_t)y * width;
+        uint16_t* shown = diff->shown + (size_t)y * width;
+
+        // Most rows are unchanged: one memcmp, then the changed span
+        if (memcmp(frame, shown, (size_t)width * sizeof(uint16_t)) == 0) {
+            continue;
+        }
+        int lo = 0;
+        int hi = width - 1;
+        while (frame[lo] == shown[lo]) {
+            lo++;
+        }
+        while (frame[hi] == shown[hi]) {
+            hi--;
+        }
+        memcpy(shown + lo, frame + lo, (size_t)(hi - lo + 1) * sizeof(uint16_t));
+        diff->changed += hi - lo + 1;
+        add_span(work, &count, lo, hi, y);
+    }
+
+    // Merge while it is cheaper than another rectangle, or while there are too many
+    while (count > 1) {
+        bool too_many = count > max_rects;
+        if (merge_cheapest(work, &count, !too_many) > FRAME_DIFF_RECT_OVERHEAD && !too_many) {
+            break;
+        }
+    }
+
+    // The panel ignores windows that are not aligned: widen the rectangles.
+    // The extra pixels are unchanged, so shown is still right.
+    for (int i = 0; i < count; i++) {
+        diff_rect_t& r = work[i];
+        int x0 = r.x - r.x % FRAME_DIFF_ALIGN;
+        int y0 = r.y - r.y % FRAME_DIFF_ALIGN;
+        int x1 = (r.x + r.w + FRAME_DIFF_ALIGN - 1) / FRAME_DIFF_ALIGN * FRAME_DIFF_ALIGN;
+        int y1 = (r.y + r.h + FRAME_DIFF_ALIGN - 1) / FRAME_DIFF_ALIGN * FRAME_DIFF_ALIGN;
+        r.x = (int16_t)x0;
+        r.y = (int16_t)y0;
+        r.w = (int16_t)((x1 > width ? width : x1) - x0);
+        r.h = (int16_t)((y1 > diff->height ? diff->height : y1) - y0);
+    }
+    memcpy(rects, work, count * sizeof(diff_rect_t));
+    return count;
+}
@@ -0,0 +1,52 @@
+#ifndef FRAME_DIFF_H
+#define FRAME_DIFF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Frame diff for a framebuffer that is redrawn from scratch every frame.
+// At flush time the whole frame is compared with a copy of what the panel
+// shows, so pixels redrawn with the color they already had (a page clears
+// the screen and draws the same logo again) are not sent. The changed
+// pixels are merged into a few rectangles: every rectangle costs a window
+// command and a new transfer on the bus, so nearby changes go out as one.
+// Plain C++ with no Arduino dependencies.
+
+#define FRAME_DIFF_MAX_RECTS 8         // Rectangles per flush
+#define FRAME_DIFF_RECT_OVERHEAD 512   // Bus cost of a rectangle, in pixels: merge if it wastes less
+#define FRAME_DIFF_ALIGN 2             // Rectangles start and end on even pixels (RM67162 window)
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+} diff_rect_t;
+
+typedef struct {
+    const uint16_t* frame;             // Framebuffer the page draws into
+    uint16_t* shown;                   // Pixels on the panel
+    int width;
+    int height;
+    bool valid;                        // shown matches the panel
+
+    uint32_t changed;                  // Pixels in the changed spans of the last collect
+} frame_diff_t;
+
+// Bytes needed for a width x height panel (copy of the panel)
+size_t frame_diff_bytes(int width, int height);
+
+// Diff frame using buffer (PSRAM on the board). The first collect covers
+// the whole panel. false if buffer is too small.
+bool frame_diff_init(frame_diff_t* diff, const uint16_t* frame, void* buffer, size_t bytes, int width, int height);
+
+// The panel content is unknown (it was drawn by someone else, or reset):
+// the next collect covers the whole panel
+void frame_diff_invalidate(frame_diff_t* diff);
+
+// Compare the frame with the panel copy and write the rectangles to send,
+// at most max_rects. The copy is updated as if they were sent. Returns the
+// number of rectangles, 0 if nothing changed.
+int frame_diff_collect(frame_diff_t* diff, diff_rect_t* rects, int max_rects);
+
+#endif // FRAME_DIFF_H
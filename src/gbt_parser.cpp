@@ -0,0 +1,257 @@
+#include "gbt_parser.h"
+#include <string.h>
+#include <stdlib.h>
+
+// Percorsi dei campi usati (NULL = indice di un array)
+static const char* const PATH_ERROR[] = {"error"};
+static const char* const PATH_ERROR_MESSAGE[] = {"error", "message"};
+static const char* const PATH_RESULT[] = {"result"};
+static const char* const PATH_VERSION[] = {"result", "version"};
+static const char* const PATH_PREVHASH[] = {"result", "previousblockhash"};
+static const char* const PATH_CURTIME[] = {"result", "curtime"};
+static const char* const PATH_BITS[] = {"result", "bits"};
+static const char* const PATH_HEIGHT[] = {"result", "height"};
+static const char* const PATH_COINBASEVALUE[] = {"result", "coinbasevalue"};
+static const char* const PATH_COMMITMENT[] = {"result", "default_witness_commitment"};
+static const char* const PATH_LONGPOLLID[] = {"result", "longpollid"};
+static const char* const PATH_TX[] = {"result", "transactions", NULL};
+static const char* const PATH_TX_TXID[] = {"result", "transactions", NULL, "txid"};
+static const char* const PATH_TX_HASH[] = {"result", "transactions", NULL, "hash"};
+static const char* const PATH_TX_DATA[] = {"result", "transactions", NULL, "data"};
+static const char* const PATH_TX_FEE[] = {"result", "transactions", NULL, "fee"};
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool gbt_hex_to_hash(const char* hex, uint8_t out[32]) {
+    for (int i = 0; i < 32; i++) {
+        int hi = hex_digit(hex[i * 2]);
+        int lo = hi < 0 ? -1 : hex_digit(hex[i * 2 + 1]);
+        if (lo < 0) {
+            return false;
+        }
+        out[31 - i] = (uint8_t)((hi << 4) | lo);
+    }
+    return hex[64] == 0;
+}
+
+// Pezzo di "data" esadecimale -> byte nello store. I pezzi possono spezzare una coppia hex.
+static void store_tx_hex(gbt_parser_t* parser, const char* hex, size_t len) {
+    if (!parser->tx_store || parser->tx_store_overflow) {
+        return;
+    }
+    for (size_t i = 0; i < len; i++) {
+        int digit = hex_digit(hex[i]);
+        if (digit < 0) {
+            parser->bad_field = true;
+            return;
+        }
+        if (parser->tx_nibble < 0) {
+            parser->tx_nibble = digit;
+            continue;
+        }
+        if (parser->tx_store_used == parser->tx_store_size) {
+            parser->tx_store_overflow = true;
+            return;
+        }
+        parser->tx_store[parser->tx_store_used++] = (uint8_t)((parser->tx_nibble << 4) | digit);
+        parser->tx_nibble = -1;
+    }
+}
+
+static void add_txid(gbt_parser_t* parser, const uint8_t txid[32]) {
+    merkle_store_t* store = parser->merkle_store;
+    if (!store) {
+        merkle_branch_add(&parser->merkle, txid);
+        return;
+    }
+    if (merkle_store_add(store, txid)) {
+        return;
+    }
+
+    // Store pieno: le foglie lette finora passano al builder, che continua da qui
+    for (size_t i = 1; i < store->pending; i++) {
+        merkle_branch_add(&parser->merkle, merkle_store_leaf(store, i));
+    }
+    merkle_branch_add(&parser->merkle, txid);
+    merkle_store_reset(store);
+    parser->merkle_store = NULL;
+}
+
+static void on_json(json_stream_t* js, json_event_t event, const char* value, size_t len, void* arg) {
+    gbt_parser_t* parser = (gbt_parser_t*)arg;
+    BitcoinBlockTemplate* tmpl = parser->tmpl;
+
+    if (json_stream_path_is(js, 1, PATH_ERROR)) {
+        if (event != JSON_EVENT_NULL && event != JSON_EVENT_END_OBJECT && event != JSON_EVENT_END_ARRAY) {
+            parser->rpc_error = true;
+        }
+        return;
+    }
+    if (json_stream_path_is(js, 2, PATH_ERROR_MESSAGE) && event == JSON_EVENT_STRING) {
+        strncpy(parser->rpc_message, value, GBT_RPC_MESSAGE_MAX - 1);
+        return;
+    }
+    if (json_stream_path_is(js, 1, PATH_RESULT)) {
+        if (event == JSON_EVENT_BEGIN_OBJECT) {
+            parser->has_result = true;
+        }
+        return;
+    }
+
+    // Transazioni: un txid alla volta nel merkle store o nel builder
+    if (json_stream_path_is(js, 3, PATH_TX)) {
+        if (event == JSON_EVENT_BEGIN_OBJECT) {
+            parser->tx_has_txid = false;
+            parser->tx_has_hash = false;
+        } else if (event == JSON_EVENT_END_OBJECT) {
+            if (parser->tx_has_txid) {
+                add_txid(parser, parser->tx_txid);
+            } else if (parser->tx_has_hash) {
+                add_txid(parser, parser->tx_hash);
+            } else {
+                parser->bad_field = true;
+            }
+            tmpl->transactions_count++;
+        }
+        return;
+    }
+    if (event == JSON_EVENT_STRING && json_stream_path_is(js, 4, PATH_TX_TXID)) {
+        parser->tx_has_txid = gbt_hex_to_hash(value, parser->tx_txid);
+        parser->bad_field |= !parser->tx_has_txid;
+        return;
+    }
+    if (event == JSON_EVENT_STRING && json_stream_path_is(js, 4, PATH_TX_HASH)) {
+        parser->tx_has_hash = gbt_hex_to_hash(value, parser->tx_hash);
+        return;
+    }
+    if ((event == JSON_EVENT_STRING_PART || event == JSON_EVENT_STRING) && json_stream_path_is(js, 4, PATH_TX_DATA)) {
+        store_tx_hex(parser, value, len);
+        if (event == JSON_EVENT_STRING && parser->tx_nibble >= 0 && !parser->tx_store_overflow) {
+            parser->bad_field = true;       // Numero dispari di cifre
+        }
+        return;
+    }
+    if (event == JSON_EVENT_NUMBER && json_stream_path_is(js, 4, PATH_TX_FEE)) {
+        tmpl->fees += strtoull(value, NULL, 10);
+        return;
+    }
+
+    // Campi dell'header
+    if (event == JSON_EVENT_NUMBER) {
+        if (json_stream_path_is(js, 2, PATH_VERSION)) {
+            tmpl->version = (uint32_t)strtoul(value, NULL, 10);
+        } else if (json_stream_path_is(js, 2, PATH_CURTIME)) {
+            tmpl->curtime = (uint32_t)strtoul(value, NULL, 10);
+        } else if (json_stream_path_is(js, 2, PATH_HEIGHT)) {
+            tmpl->height = (uint32_t)strtoul(value, NULL, 10);
+        } else if (json_stream_path_is(js, 2, PATH_COINBASEVALUE)) {
+            tmpl->coinbasevalue = strtoull(value, NULL, 10);
+        }
+    } else if (event == JSON_EVENT_STRING) {
+        if (json_stream_path_is(js, 2, PATH_PREVHASH)) {
+            if (len == 64) {
+                memcpy(tmpl->previousblockhash, value, 65);
+            } else {
+                parser->bad_field = true;
+            }
+        } else if (json_stream_path_is(js, 2, PATH_BITS)) {
+            tmpl->bits = (uint32_t)strtoul(value, NULL, 16);
+        } else if (json_stream_path_is(js, 2, PATH_LONGPOLLID)) {
+            // Un id troppo lungo si ignora: si ripiega sul controllo della tip
+            if (len < GBT_LONGPOLLID_MAX) {
+                memcpy(tmpl->longpollid, value, len + 1);
+            }
+        } else if (json_stream_path_is(js, 2, PATH_COMMITMENT)) {
+            if ((len & 1) || len / 2 > GBT_COMMITMENT_MAX) {
+                parser->bad_field = true;
+                return;
+            }
+            for (size_t i = 0; i < len / 2; i++) {
+                int hi = hex_digit(value[i * 2]);
+                int lo = hex_digit(value[i * 2 + 1]);
+                if (hi < 0 || lo < 0) {
+                    parser->bad_field = true;
+                    return;
+                }
+                tmpl->witness_commitment[i] = (uint8_t)((hi << 4) | lo);
+            }
+            tmpl->witness_commitment_len = (int)(len / 2);
+        }
+    }
+}
+
+void gbt_parser_init(gbt_parser_t* parser, BitcoinBlockTemplate* tmpl) {
+    memset(parser, 0, sizeof(*parser));
+    memset(tmpl, 0, sizeof(*tmpl));
+    parser->tmpl = tmpl;
+    parser->tx_nibble = -1;
+    json_stream_init(&parser->json, on_json, parser);
+    merkle_branch_init(&parser->merkle);
+}
+
+void gbt_parser_set_tx_store(gbt_parser_t* parser, uint8_t* store, size_t size) {
+    parser->tx_store = store;
+    parser->tx_store_size = size;
+    parser->tx_store_used = 0;
+}
+
+void gbt_parser_set_merkle_store(gbt_parser_t* parser, merkle_store_t* store) {
+    parser->merkle_store = store;
+    merkle_store_begin(store);
+}
+
+bool gbt_parser_feed(gbt_parser_t* parser, const char* data, size_t len) {
+    return json_stream_feed(&parser->json, data, len);
+}
+
+bool gbt_parser_finish(gbt_parser_t* parser) {
+    BitcoinBlockTemplate* tmpl = parser->tmpl;
+    if (!json_stream_done(&parser->json) || parser->rpc_error || !parser->has_result || parser->bad_field ||
+        tmpl->previousblockhash[0] == 0 || tmpl->bits == 0 || tmpl->coinbasevalue == 0) {
+        return false;
+    }
+
+    if (parser->merkle_store) {
+        tmpl->merkle_branch_len = merkle_store_finish(parser->merkle_store, tmpl->merkle_branch);
+        parser->merkle.branch_len = tmpl->merkle_branch_len;
+        if (tmpl->merkle_branch_len < 0) {
+            return false;
+        }
+    } else {
+        tmpl->merkle_branch_len = merkle_branch_finish(&parser->merkle);
+        if (tmpl->merkle_branch_len < 0) {
+            return false;
+        }
+        memcpy(tmpl->merkle_branch, parser->merkle.branch, sizeof(tmpl->merkle_branch));
+    }
+    tmpl->tx_data = parser->tx_store;
+    tmpl->tx_data_len = parser->tx_store_used;
+    tmpl->tx_data_complete = parser->tx_store && !parser->tx_store_overflow;
+    tmpl->valid = true;
+    return true;
+}
+
+void gbt_template_drop_transactions(BitcoinBlockTemplate* tmpl) {
+    tmpl->coinbasevalue -= tmpl->fees;
+    tmpl->fees = 0;
+    tmpl->witness_commitment_len = 0;
+    tmpl->transactions_count = 0;
+    tmpl->merkle_branch_len = 0;
+    tmpl->tx_data_len = 0;
+    tmpl->tx_data_complete = true;
+}
+
+const char* gbt_parser_error(const gbt_parser_t* parser) {
+    if (parser->json.error) return parser->json.error;
+    if (parser->rpc_error) return parser->rpc_message[0] ? parser->rpc_message : "errore RPC";
+    if (!json_stream_done(&parser->json)) return "risposta troncata";
+    if (!parser->has_result) return "result mancante";
+    if (parser->bad_field) return "campo malformato";
+    if (parser->merkle.branch_len < 0) return "troppe transazioni";
+    return "campi dell'header mancanti";
+}
@@ -0,0 +1,97 @@
+#ifndef GBT_PARSER_H
+#define GBT_PARSER_H
+
+#include "json_stream.h"
+#include "merkle.h"
+#include "merkle_store.h"
+
+// Parser in streaming della risposta di getblocktemplate.
+// Il corpo HTTP arriva a blocchi e non viene mai tenuto in RAM: si tengono
+// solo i campi che servono all'header e ogni txid va subito nel merkle
+// branch builder (memoria fissa). Alla fine resta solo il branch della
+// coinbase. C++ puro senza Arduino: lo stesso codice gira sull'host nei tool.
+//
+// Per sottomettere il blocco servono anche i dati grezzi delle transazioni:
+// se il chiamante fornisce uno store (PSRAM sul dispositivo) ci vengono
+// decodificati in binario, in ordine di blocco, man mano che arrivano.
+//
+// Con un merkle store (anche questo in PSRAM) il branch si ricalcola solo
+// sui percorsi delle transazioni cambiate rispetto al template precedente.
+
+#define GBT_RPC_MESSAGE_MAX 96
+#define GBT_COMMITMENT_MAX 64         // Script del witness commitment (di solito 38 byte)
+#define GBT_LONGPOLLID_MAX 96         // Core: hash della tip + contatore del mempool
+
+// Struttura per il block template ricevuto dal nodo Bitcoin
+struct BitcoinBlockTemplate {
+    uint32_t version;
+    char previousblockhash[65];
+    char longpollid[GBT_LONGPOLLID_MAX];          // Vuoto se il nodo non offre il long-poll
+    uint32_t curtime;
+    uint32_t bits;
+    uint32_t height;
+    uint64_t coinbasevalue;                       // Sussidio + fee in satoshi
+    uint64_t fees;                                // Somma delle fee delle transazioni
+    uint8_t witness_commitment[GBT_COMMITMENT_MAX];   // default_witness_commitment (0 = assente)
+    int witness_commitment_len;
+    int transactions_count;
+    uint8_t merkle_branch[MERKLE_MAX_DEPTH][32];  // Branch della coinbase (byte order interno)
+    int merkle_branch_len;
+    const uint8_t* tx_data;                       // Transazioni serializzate in ordine di blocco
+    size_t tx_data_len;
+    bool tx_data_complete;                        // false: store assente o troppo piccolo
+    bool valid;
+};
+
+typedef struct {
+    BitcoinBlockTemplate* tmpl;
+    json_stream_t json;
+    merkle_branch_builder_t merkle;
+    merkle_store_t* merkle_store;             // NULL = branch builder in streaming
+
+    // Transazione in lettura: "txid" (Core >= 0.13) oppure "hash" dei nodi più vecchi
+    uint8_t tx_txid[32];
+    uint8_t tx_hash[32];
+    bool tx_has_txid;
+    bool tx_has_hash;
+
+    // Store dei dati delle transazioni (NULL = non memorizzarle)
+    uint8_t* tx_store;
+    size_t tx_store_size;
+    size_t tx_store_used;
+    int tx_nibble;                            // Mezza coppia hex in sospeso tra due blocchi (-1 = nessuna)
+    bool tx_store_overflow;
+
+    bool has_result;
+    bool rpc_error;
+    bool bad_field;                           // Campo presente ma malformato
+    char rpc_message[GBT_RPC_MESSAGE_MAX];    // error.message del nodo
+} gbt_parser_t;
+
+void gbt_parser_init(gbt_parser_t* parser, BitcoinBlockTemplate* tmpl);
+
+// Memorizza i dati delle transazioni in store (da chiamare dopo init).
+// Se non bastano il template resta valido ma con tx_data_complete = false.
+void gbt_parser_set_tx_store(gbt_parser_t* parser, uint8_t* store, size_t size);
+
+// Branch incrementale tra un template e il successivo (da chiamare dopo init).
+// Se le transazioni non ci stanno si torna al branch builder.
+void gbt_parser_set_merkle_store(gbt_parser_t* parser, merkle_store_t* store);
+
+// Blocco successivo del corpo HTTP. false se il JSON è malformato.
+bool gbt_parser_feed(gbt_parser_t* parser, const char* data, size_t len);
+
+// Chiude il documento e il merkle tree. true se il template è valido.
+bool gbt_parser_finish(gbt_parser_t* parser);
+
+// Descrizione dell'errore dopo un fallimento
+const char* gbt_parser_error(const gbt_parser_t* parser);
+
+// Rinuncia alle transazioni del template: blocco con la sola coinbase
+// (sussidio senza fee, niente witness commitment)
+void gbt_template_drop_transactions(BitcoinBlockTemplate* tmpl);
+
+// Hash esadecimale come lo mostra bitcoind (big endian) -> byte order interno
+bool gbt_hex_to_hash(const char* hex, uint8_t out[32]);
+
+#endif // GBT_PARSER_H
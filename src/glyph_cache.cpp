@@ -0,0 +1,161 @@
+#include "glyph_cache.h"
+#include <string.h>
+
+// A filled block of a sprite: columns x .. x + w - 1 (scaled pixels) on font
+// rows row .. row + rows - 1
+typedef struct {
+    uint16_t x;
+    uint16_t w;
+    uint8_t row;
+    uint8_t rows;
+} glyph_run_t;
+
+#define MAX_ROW_RUNS (GLYPH_CACHE_MAX_TEXT * 4)  // At most every other font column set
+
+static uint32_t hash_text(const char* text, int len, int scale) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < len; i++) {
+        hash = (hash ^ (uint8_t)text[i]) * 16777619u;
+    }
+    return (hash ^ (uint8_t)scale) * 16777619u;
+}
+
+static const glyph_run_t* slot_runs(const glyph_cache_t* cache, const glyph_slot_t* slot) {
+    size_t offset = (slot->offset + slot->len + 1) & ~(size_t)1;
+    return (const glyph_run_t*)(cache->buffer + offset);
+}
+
+bool glyph_cache_init(glyph_cache_t* cache, void* buffer, size_t bytes, glyph_bitmap_fn bitmap) {
+    memset(cache, 0, sizeof(*cache));
+    if (!buffer || bytes < 256 || bytes > 0xFFFF || !bitmap) {
+        return false;
+    }
+    cache->buffer = (uint8_t*)buffer;
+    cache->bytes = bytes;
+    cache->bitmap = bitmap;
+    return true;
+}
+
+void glyph_cache_clear(glyph_cache_t* cache) {
+    memset(cache->slots, 0, sizeof(cache->slots));
+    cache->used = 0;
+    cache->count = 0;
+}
+
+// Expand text into runs at the end of the buffer and fill in slot. false if
+// the buffer has no room left.
+static bool build_sprite(glyph_cache_t* cache, glyph_slot_t* slot, uint32_t hash, const char* text, int len,
+                         int scale) {
+    size_t textOffset = cache->used;
+    size_t runsOffset = (textOffset + len + 1) & ~(size_t)1;
+    if (runsOffset > cache->bytes) {
+        return false;
+    }
+    glyph_run_t* runs = (glyph_run_t*)(cache->buffer + runsOffset);
+    size_t capacity = (cache->bytes - runsOffset) / sizeof(glyph_run_t);
+    size_t count = 0;
+
+    const uint8_t* bitmaps[GLYPH_CACHE_MAX_TEXT];
+    for (int i = 0; i < len; i++) {
+        bitmaps[i] = cache->bitmap(text[i]);
+    }
+
+    // Runs that reach the previous row, left to right: a run of this row with
+    // the same columns extends one of them instead of starting a new run
+    uint16_t open[2][MAX_ROW_RUNS];
+    int openCount = 0;
+    int columns = len * 8;
+    for (int row = 0; row < 8; row++) {
+        const uint16_t* above = open[row & 1];
+        uint16_t* next = open[(row + 1) & 1];
+        int nextCount = 0;
+        int a = 0;
+        int col = 0;
+        while (col < columns) {
+            if (!(bitmaps[col >> 3][row] & (0x80 >> (col & 7)))) {
+                col++;
+                continue;
+            }
+            int start = col;
+            while (col < columns && (bitmaps[col >> 3][row] & (0x80 >> (col & 7)))) {
+                col++;
+            }
+            uint16_t x = (uint16_t)(start * scale);
+            uint16_t w = (uint16_t)((col - start) * scale);
+            while (a < openCount && runs[above[a]].x < x) {
+                a++;
+            }
+            if (a < openCount && runs[above[a]].x == x && runs[above[a]].w == w) {
+                runs[above[a]].rows++;
+                next[nextCount++] = above[a++];
+                continue;
+            }
+            if (count == capacity) {
+                return false;
+            }
+            runs[count] = {x, w, (uint8_t)row, 1};
+            next[nextCount++] = (uint16_t)count++;
+        }
+        openCount = nextCount;
+    }
+
+    memcpy(cache->buffer + textOffset, text, len);
+    slot->hash = hash;
+    slot->offset = (uint16_t)textOffset;
+    slot->len = (uint8_t)len;
+    slot->scale = (uint8_t)scale;
+    slot->runs = (uint16_t)count;
+    cache->used = runsOffset + count * sizeof(glyph_run_t);
+    cache->count++;
+    return true;
+}
+
+// The sprite of text at scale, built if missing. NULL if it doesn't fit in
+// the buffer even when empty.
+static const glyph_slot_t* find_sprite(glyph_cache_t* cache, const char* text, int len, int scale) {
+    uint32_t hash = hash_text(text, len, scale);
+    for (int attempt = 0; attempt < 2; attempt++) {
+        unsigned i = hash & (GLYPH_CACHE_SLOTS - 1);
+        while (cache->slots[i].len) {
+            const glyph_slot_t* slot = &cache->slots[i];
+            if (slot->hash == hash && slot->len == len && slot->scale == scale &&
+                memcmp(cache->buffer + slot->offset, text, len) == 0) {
+                cache->hits++;
+                return slot;
+            }
+            i = (i + 1) & (GLYPH_CACHE_SLOTS - 1);
+        }
+        if (cache->count < GLYPH_CACHE_SLOTS * 3 / 4 && build_sprite(cache, &cache->slots[i], hash, text, len, scale)) {
+            cache->misses++;
+            return &cache->slots[i];
+        }
+        if (cache->count == 0) {
+            break;
+        }
+        glyph_cache_clear(cache);
+        cache->resets++;
+    }
+    return NULL;
+}
+
+void glyph_cache_draw(glyph_cache_t* cache, const raster_target_t* target, int x, int y, const char* text, int len,
+                      int scale, uint16_t color) {
+    if (len <= 0) {
+        return;
+    }
+    const glyph_slot_t* slot = NULL;
+    if (len <= GLYPH_CACHE_MAX_TEXT && scale >= 1 && scale <= 0xFF) {
+        slot = find_sprite(cache, text, len, scale);
+    }
+    if (!slot) {
+        cache->uncached++;
+        for (int i = 0; i < len; i++) {
+            raster_glyph(target, x + i * 8 * scale, y, cache->bitmap(text[i]), scale, color);
+        }
+        return;
+    }
+    const glyph_run_t* runs = slot_runs(cache, slot);
+    for (int i = 0; i < slot->runs; i++) {
+        raster_fill_rect(target, x + runs[i].x, y + runs[i].row * scale, runs[i].w, runs[i].rows * scale, color);
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "raster.h"
+
+// Cache of text sprites for the 8x8 font. A sprite is a string (a single
+// character or a whole label) at one scale, expanded once into the filled
+// runs of its rows: adjacent set bits across characters become one run, and
+// a run repeated on the rows below grows taller instead of being repeated.
+// Drawing a cached sprite is one span fill per run, with no font lookup and
+// no bit tests. The labels drawn on every frame hit the cache, and text that
+// changes (clock, hashrate) gets a new sprite only when it changes.
+//
+// Sprites live in a caller-provided buffer. When the buffer or the slot
+// table is full, the whole cache is cleared and refills from the next
+// frame: no per-entry bookkeeping, and the memory used never grows.
+// Plain C++ with no Arduino dependencies.
+
+#define GLYPH_CACHE_SLOTS 128          // Sprites kept (the table is cleared at 3/4)
+#define GLYPH_CACHE_MAX_TEXT 32        // Longer strings are drawn without the cache
+
+#ifndef GLYPH_CACHE_BYTES
+#define GLYPH_CACHE_BYTES 8192         // Buffer for the sprites' text and runs
+#endif
+
+// 8x8 bitmap of a character, bit 7 = left column
+typedef const uint8_t* (*glyph_bitmap_fn)(char c);
+
+typedef struct {
+    uint32_t hash;
+    uint16_t offset;                   // Text, then runs, in the buffer
+    uint8_t len;                       // 0 = free slot
+    uint8_t scale;
+    uint16_t runs;
+} glyph_slot_t;
+
+typedef struct {
+    glyph_slot_t slots[GLYPH_CACHE_SLOTS];
+    uint8_t* buffer;
+    size_t bytes;
+    size_t used;
+    int count;
+    glyph_bitmap_fn bitmap;
+
+    uint32_t hits;
+    uint32_t misses;                   // Sprites built
+    uint32_t uncached;                 // Too long or too large: drawn character by character
+    uint32_t resets;                   // Times the cache was cleared to make room
+} glyph_cache_t;
+
+// Cache sprites in buffer, using bitmap for the font. false if buffer is
+// too small to be useful or too large for the 16-bit offsets.
+bool glyph_cache_init(glyph_cache_t* cache, void* buffer, size_t bytes, glyph_bitmap_fn bitmap);
+
+// Draw len characters of text at x, y (top-left), every font pixel a
+// scale x scale block. Same pixels as raster_glyph() for each character.
+void glyph_cache_draw(glyph_cache_t* cache, const raster_target_t* target, int x, int y, const char* text, int len,
+                      int scale, uint16_t color);
+
+// Drop every sprite (hit and miss counters are kept)
+void glyph_cache_clear(glyph_cache_t* cache);
+
+#endif // GLYPH_CACHE_H
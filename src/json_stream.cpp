@@ -0,0 +1,341 @@
+#include "json_stream.h"
+#include <string.h>
+
+// Scanner states
+enum {
+    STATE_VALUE,          // Expecting a value
+    STATE_ARRAY_FIRST,    // After '[': value or ']'
+    STATE_OBJECT_FIRST,   // After '{': key or '}'
+    STATE_KEY,            // After ',' in an object: key
+    STATE_COLON,          // After a key
+    STATE_AFTER_VALUE,    // Expecting ',' or the closing bracket
+    STATE_STRING,
+    STATE_ESCAPE,
+    STATE_UNICODE,
+    STATE_NUMBER,
+    STATE_LITERAL,        // true / false / null
+    STATE_DONE,
+    STATE_ERROR
+};
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static void fail(json_stream_t* js, const char* error) {
+    js->error = error;
+    js->state = STATE_ERROR;
+}
+
+static void emit(json_stream_t* js, json_event_t event, const char* value, size_t len) {
+    if (js->callback) {
+        js->callback(js, event, value, len, js->arg);
+    }
+}
+
+// A value just ended: back to the enclosing container (or done at the top)
+static void value_done(json_stream_t* js) {
+    js->state = js->depth == 0 ? STATE_DONE : STATE_AFTER_VALUE;
+}
+
+static void push(json_stream_t* js, bool isArray) {
+    if (js->depth >= JSON_STREAM_MAX_DEPTH) {
+        fail(js, "nesting too deep");
+        return;
+    }
+    emit(js, isArray ? JSON_EVENT_BEGIN_ARRAY : JSON_EVENT_BEGIN_OBJECT, "", 0);
+    json_stream_level_t* level = &js->levels[js->depth++];
+    level->is_array = isArray;
+    level->index = 0;
+    level->key[0] = 0;
+    js->state = isArray ? STATE_ARRAY_FIRST : STATE_OBJECT_FIRST;
+}
+
+static void pop(json_stream_t* js, bool isArray) {
+    if (js->depth == 0 || js->levels[js->depth - 1].is_array != isArray) {
+        fail(js, "mismatched bracket");
+        return;
+    }
+    js->depth--;
+    emit(js, isArray ? JSON_EVENT_END_ARRAY : JSON_EVENT_END_OBJECT, "", 0);
+    value_done(js);
+}
+
+// Append one decoded character to the key or value being read
+static void put_char(json_stream_t* js, char c) {
+    if (js->in_key) {
+        if (js->key_len < JSON_STREAM_KEY_MAX - 1) {
+            json_stream_level_t* level = &js->levels[js->depth - 1];
+            level->key[js->key_len++] = c;
+            level->key[js->key_len] = 0;
+        }
+        return;
+    }
+    if (js->value_len == JSON_STREAM_VALUE_MAX) {
+        js->value[js->value_len] = 0;
+        emit(js, JSON_EVENT_STRING_PART, js->value, js->value_len);
+        js->value_len = 0;
+    }
+    js->value[js->value_len++] = c;
+}
+
+static void put_utf8(json_stream_t* js, uint32_t cp) {
+    if (cp < 0x80) {
+        put_char(js, (char)cp);
+    } else if (cp < 0x800) {
+        put_char(js, (char)(0xC0 | (cp >> 6)));
+        put_char(js, (char)(0x80 | (cp & 0x3F)));
+    } else {
+        put_char(js, (char)(0xE0 | (cp >> 12)));
+        put_char(js, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        put_char(js, (char)(0x80 | (cp & 0x3F)));
+    }
+}
+
+static void begin_string(json_stream_t* js, bool isKey) {
+    js->in_key = isKey;
+    js->value_len = 0;
+    if (isKey) {
+        js->key_len = 0;
+        js->levels[js->depth - 1].key[0] = 0;
+    }
+    js->state = STATE_STRING;
+}
+
+static void end_string(json_stream_t* js) {
+    if (js->in_key) {
+        js->in_key = false;
+        js->state = STATE_COLON;
+        return;
+    }
+    js->value[js->value_len] = 0;
+    emit(js, JSON_EVENT_STRING, js->value, js->value_len);
+    value_done(js);
+}
+
+static void end_number(json_stream_t* js) {
+    js->value[js->value_len] = 0;
+    emit(js, JSON_EVENT_NUMBER, js->value, js->value_len);
+    value_done(js);
+}
+
+static void end_literal(json_stream_t* js) {
+    js->value[js->value_len] = 0;
+    if (strcmp(js->value, "true") == 0) {
+        emit(js, JSON_EVENT_TRUE, "", 0);
+    } else if (strcmp(js->value, "false") == 0) {
+        emit(js, JSON_EVENT_FALSE, "", 0);
+    } else if (strcmp(js->value, "null") == 0) {
+        emit(js, JSON_EVENT_NULL, "", 0);
+    } else {
+        fail(js, "invalid literal");
+        return;
+    }
+    value_done(js);
+}
+
+// Start of any value
+static void begin_value(json_stream_t* js, char c) {
+    if (c == '{') {
+        push(js, false);
+    } else if (c == '[') {
+        push(js, true);
+    } else if (c == '"') {
+        begin_string(js, false);
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+        js->value_len = 0;
+        js->value[js->value_len++] = c;
+        js->state = STATE_NUMBER;
+    } else if (c >= 'a' && c <= 'z') {
+        js->value_len = 0;
+        js->value[js->value_len++] = c;
+        js->state = STATE_LITERAL;
+    } else {
+        fail(js, "unexpected character");
+    }
+}
+
+static void scan(json_stream_t* js, char c) {
+    switch (js->state) {
+        case STATE_VALUE:
+            if (!is_space(c)) {
+                begin_value(js, c);
+            }
+            break;
+
+        case STATE_ARRAY_FIRST:
+            if (c == ']') {
+                pop(js, true);
+            } else if (!is_space(c)) {
+                begin_value(js, c);
+            }
+            break;
+
+        case STATE_OBJECT_FIRST:
+        case STATE_KEY:
+            if (c == '"') {
+                begin_string(js, true);
+            } else if (c == '}' && js->state == STATE_OBJECT_FIRST) {
+                pop(js, false);
+            } else if (!is_space(c)) {
+                fail(js, "expected key");
+            }
+            break;
+
+        case STATE_COLON:
+            if (c == ':') {
+                js->state = STATE_VALUE;
+            } else if (!is_space(c)) {
+                fail(js, "expected ':'");
+            }
+            break;
+
+        case STATE_AFTER_VALUE: {
+            json_stream_level_t* level = &js->levels[js->depth - 1];
+            if (c == ',') {
+                if (level->is_array) {
+                    level->index++;
+                    js->state = STATE_VALUE;
+                } else {
+                    js->state = STATE_KEY;
+                }
+            } else if (c == ']' || c == '}') {
+                pop(js, c == ']');
+            } else if (!is_space(c)) {
+                fail(js, "expected ',' or closing bracket");
+            }
+            break;
+        }
+
+        case STATE_STRING:
+            if (c == '"') {
+                end_string(js);
+            } else if (c == '\\') {
+                js->state = STATE_ESCAPE;
+            } else if ((unsigned char)c < 0x20) {
+                fail(js, "control character in string");
+            } else {
+                put_char(js, c);
+            }
+            break;
+
+        case STATE_ESCAPE:
+            js->state = STATE_STRING;
+            switch (c) {
+                case '"':  put_char(js, '"'); break;
+                case '\\': put_char(js, '\\'); break;
+                case '/':  put_char(js, '/'); break;
+                case 'b':  put_char(js, '\b'); break;
+                case 'f':  put_char(js, '\f'); break;
+                case 'n':  put_char(js, '\n'); break;
+                case 'r':  put_char(js, '\r'); break;
+                case 't':  put_char(js, '\t'); break;
+                case 'u':
+                    js->unicode = 0;
+                    js->unicode_digits = 0;
+                    js->state = STATE_UNICODE;
+                    break;
+                default:
+                    fail(js, "invalid escape");
+                    break;
+            }
+            break;
+
+        case STATE_UNICODE: {
+            uint32_t digit;
+            if (c >= '0' && c <= '9') digit = c - '0';
+            else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+            else {
+                fail(js, "invalid \\u escape");
+                break;
+            }
+            js->unicode = (js->unicode << 4) | digit;
+            if (++js->unicode_digits == 4) {
+                put_utf8(js, js->unicode);
+                js->state = STATE_STRING;
+            }
+            break;
+        }
+
+        case STATE_NUMBER:
+            if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+                if (js->value_len == JSON_STREAM_VALUE_MAX) {
+                    fail(js, "number too long");
+                } else {
+                    js->value[js->value_len++] = c;
+                }
+            } else {
+                end_number(js);
+                if (js->state != STATE_ERROR) {
+                    scan(js, c);    // The delimiter belongs to the enclosing container
+                }
+            }
+            break;
+
+        case STATE_LITERAL:
+            if (c >= 'a' && c <= 'z' && js->value_len < 5) {
+                js->value[js->value_len++] = c;
+            } else {
+                end_literal(js);
+                if (js->state != STATE_ERROR) {
+                    scan(js, c);
+                }
+            }
+            break;
+
+        case STATE_DONE:
+            if (!is_space(c)) {
+                fail(js, "data after document");
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void json_stream_init(json_stream_t* js, json_stream_callback_t callback, void* arg) {
+    memset(js, 0, sizeof(*js));
+    js->callback = callback;
+    js->arg = arg;
+    js->state = STATE_VALUE;
+}
+
+bool json_stream_feed(json_stream_t* js, const char* data, size_t len) {
+    for (size_t i = 0; i < len && js->state != STATE_ERROR; i++) {
+        scan(js, data[i]);
+        js->offset++;
+    }
+    return js->state != STATE_ERROR;
+}
+
+bool json_stream_done(const json_stream_t* js) {
+    // A bare top-level number only ends at a delimiter; treat end of input as one
+    return js->state == STATE_DONE || (js->state == STATE_NUMBER && js->depth == 0);
+}
+
+const char* json_stream_key(const json_stream_t* js, int level) {
+    return level >= 0 && level < js->depth && !js->levels[level].is_array ? js->levels[level].key : "";
+}
+
+uint32_t json_stream_index(const json_stream_t* js, int level) {
+    return level >= 0 && level < js->depth && js->levels[level].is_array ? js->levels[level].index : 0;
+}
+
+bool json_stream_path_is(const json_stream_t* js, int depth, const char* const* keys) {
+    if (js->depth != depth) {
+        return false;
+    }
+    for (int i = 0; i < depth; i++) {
+        const json_stream_level_t* level = &js->levels[i];
+        if (keys[i] == NULL) {
+            if (!level->is_array) {
+                return false;
+            }
+        } else if (level->is_array || strcmp(level->key, keys[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Streaming JSON scanner: the document is fed in chunks of any size and
+// parsed with fixed memory. Every value is reported to a callback together
+// with the path leading to it (object key or array index per level), so a
+// caller keeps only the fields it needs. Strings longer than
+// JSON_STREAM_VALUE_MAX arrive in pieces (JSON_EVENT_STRING_PART, then a final
+// JSON_EVENT_STRING). Plain C++ with no Arduino dependencies.
+
+#define JSON_STREAM_MAX_DEPTH 8
+#define JSON_STREAM_KEY_MAX 32        // Longer keys are truncated
+#define JSON_STREAM_VALUE_MAX 128     // Longer strings are split, longer numbers rejected
+
+typedef enum {
+    JSON_EVENT_BEGIN_OBJECT,
+    JSON_EVENT_END_OBJECT,
+    JSON_EVENT_BEGIN_ARRAY,
+    JSON_EVENT_END_ARRAY,
+    JSON_EVENT_STRING_PART,     // Piece of a long string, more follows
+    JSON_EVENT_STRING,          // Whole string, or the last piece of a long one
+    JSON_EVENT_NUMBER,          // Number as its original text
+    JSON_EVENT_TRUE,
+    JSON_EVENT_FALSE,
+    JSON_EVENT_NULL
+} json_event_t;
+
+struct json_stream_t;
+
+// value/len: text for strings and numbers (NUL-terminated), empty otherwise.
+// For every event, including BEGIN/END of containers, levels[0..depth-1] is
+// the path to the value the event is about.
+typedef void (*json_stream_callback_t)(json_stream_t* js, json_event_t event, const char* value, size_t len,
+                                       void* arg);
+
+typedef struct {
+    bool is_array;
+    uint32_t index;                   // Current element (arrays)
+    char key[JSON_STREAM_KEY_MAX];    // Current member (objects)
+} json_stream_level_t;
+
+struct json_stream_t {
+    json_stream_callback_t callback;
+    void* arg;
+    json_stream_level_t levels[JSON_STREAM_MAX_DEPTH];
+    int depth;                        // Open containers
+    uint8_t state;
+    bool in_key;                      // String being read is a member key
+    char value[JSON_STREAM_VALUE_MAX + 1];
+    size_t value_len;
+    size_t key_len;
+    uint32_t unicode;                 // \uXXXX being decoded
+    uint8_t unicode_digits;
+    const char* error;                // NULL while the document is valid
+    size_t offset;                    // Bytes consumed (error position)
+};
+
+void json_stream_init(json_stream_t* js, json_stream_callback_t callback, void* arg);
+
+// Returns false once the document is malformed (see js->error)
+bool json_stream_feed(json_stream_t* js, const char* data, size_t len);
+
+// True if a complete document has been read
+bool json_stream_done(const json_stream_t* js);
+
+// Path helpers: level 0 is the outermost container
+const char* json_stream_key(const json_stream_t* js, int level);
+uint32_t json_stream_index(const json_stream_t* js, int level);
+
+// True if the path has exactly these keys (NULL entries match any array index)
+bool json_stream_path_is(const json_stream_t* js, int depth, const char* const* keys);
+
+#endif // JSON_STREAM_H
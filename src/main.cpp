@@ -4,6 +4,7 @@
 #include "wifi_config.h"
 #include "mining_task.h"
 #include "duino_task.h"
+#include "pool_manager.h"
 
 // Button pins (from pins_config.h)
 #define PIN_BUTTON_1 0
@@ -33,6 +34,31 @@ struct ButtonState {
 ButtonState button1State = {HIGH, false, 0, 0, false};
 ButtonState button2State = {HIGH, false, 0, 0, false};
 
+// BCH solo pool: primary pool in BCH mode, split session in BTC pool mode
+#define BCH_POOL_HOST "eu2.solopool.org"
+#define BCH_POOL_PORT 8002
+
+// Pool mining setup from the saved config (boot and mode toggle)
+static void configurePoolMining(const WifiConfig& config)
+{
+    if (config.useBitcoinCash) {
+        Serial.println("Configuring Bitcoin Cash pool mining (" BCH_POOL_HOST ")...");
+        const char* wallet = (strlen(config.bchWallet) > 0) ? config.bchWallet : config.btcWallet;
+        mining_set_pool(BCH_POOL_HOST, BCH_POOL_PORT, wallet, 
+                      "esp32miner", "x");
+    } else {
+        Serial.println("Configuring Bitcoin pool mining...");
+        mining_set_pool(config.poolUrl, config.poolPort, config.btcWallet, 
+                      "esp32miner", config.poolPassword);
+        mining_add_backup_pools(config.backupPools);
+        if (config.bchSplitPercent > 0 && strlen(config.bchWallet) > 0) {
+            mining_add_split_pool("BCH", BCH_POOL_HOST, BCH_POOL_PORT, config.bchWallet,
+                                  "esp32miner", "x", config.bchSplitPercent);
+        }
+    }
+    mining_set_mode(MINING_MODE_POOL);
+}
+
 void setup()
 {
     Serial.begin(115200);
@@ -81,22 +107,11 @@ void setup()
                 // Configura nodo Bitcoin RPC per Solo mining
                 Serial.println("Solo mining mode - configuring Bitcoin RPC node...");
                 mining_set_bitcoin_node(config.rpcHost, config.rpcPort, 
-                                       config.rpcUser, config.rpcPassword);
+                                       config.rpcUser, config.rpcPassword, config.btcWallet);
                 mining_set_mode(MINING_MODE_SOLO);
             } else {
                 // Configura pool mining
-                if (config.useBitcoinCash) {
-                    Serial.println("Configuring Bitcoin Cash pool mining...");
-                    // BCH solo pool - eu2.solopool.org:8002
-                    const char* wallet = (strlen(config.bchWallet) > 0) ? config.bchWallet : config.btcWallet;
-                    mining_set_pool("eu2.solopool.org", 8002, wallet, 
-                                  "esp32miner", "x");
-                } else {
-                    Serial.println("Configuring Bitcoin pool mining...");
-                    mining_set_pool(config.poolUrl, config.poolPort, config.btcWallet, 
-                                  "esp32miner", config.poolPassword);
-                }
-                mining_set_mode(MINING_MODE_POOL);
+                configurePoolMining(config);
             }
             
             // Auto start Bitcoin/BCH mining if enabled and WiFi is connected
@@ -199,22 +214,12 @@ void handleButton2LongPress()
         // Switch to SOLO mode
         Serial.println("Switching to SOLO MINING mode (session only)");
         mining_set_bitcoin_node(config.rpcHost, config.rpcPort, 
-                               config.rpcUser, config.rpcPassword);
+                               config.rpcUser, config.rpcPassword, config.btcWallet);
         mining_set_mode(MINING_MODE_SOLO);
     } else {
         // Switch to POOL mode
         Serial.println("Switching to POOL MINING mode (session only)");
-        if (config.useBitcoinCash) {
-            Serial.println("Using Bitcoin Cash pool (eu2.solopool.org)...");
-            const char* wallet = (strlen(config.bchWallet) > 0) ? config.bchWallet : config.btcWallet;
-            mining_set_pool("eu2.solopool.org", 8002, wallet, 
-                          "esp32miner", "x");
-        } else {
-            Serial.println("Using Bitcoin pool...");
-            mining_set_pool(config.poolUrl, config.poolPort, config.btcWallet, 
-                          "esp32miner", config.poolPassword);
-        }
-        mining_set_mode(MINING_MODE_POOL);
+        configurePoolMining(config);
     }
     
     // Restart mining if it was active
@@ -449,6 +454,68 @@ void loop()
             Serial.println("WiFi: Disconnected");
         }
         
+        // Display traffic over the last 10 seconds
+        static DisplayStats lastDisplay = {0};
+        DisplayStats display;
+        display_get_stats(&display);
+        uint32_t frames = display.frames - lastDisplay.frames;
+        if (frames > 0) {
+            Serial.printf("🖥️  Display: %.1f fps, %lu skipped, %llu KB/s to panel, %llu us draw + %llu us flush per frame"
+                          " (+%llu us queued, %llu us copying), text cache %lu hits / %lu misses\n",
+                          frames / 10.0f, (unsigned long)(display.frames_skipped - lastDisplay.frames_skipped),
+                          (unsigned long long)((display.bytes - lastDisplay.bytes) / 10240),
+                          (unsigned long long)((display.draw_us - lastDisplay.draw_us) / frames),
+                          (unsigned long long)((display.flush_us - lastDisplay.flush_us) / frames),
+                          (unsigned long long)((display.panel_us - lastDisplay.panel_us) / frames),
+                          (unsigned long long)((display.copy_us - lastDisplay.copy_us) / frames),
+                          (unsigned long)(display.text_hits - lastDisplay.text_hits),
+                          (unsigned long)(display.text_misses - lastDisplay.text_misses));
+        }
+        lastDisplay = display;
+        
+        // Failover list: health, probe RTT, DNS cache and time on each pool
+        if (!isDuinoCoinMode) {
+            int activePool = pool_manager_get_active();
+            for (int i = 0; i < pool_manager_count(); i++) {
+                PoolStats pool;
+                if (!pool_manager_get_stats(i, &pool)) {
+                    continue;
+                }
+                Serial.printf("🌐 Pool %d%s: %s:%u %s, RTT %lu ms, DNS %s (%lu s old), %lu s mined\n",
+                              i, i == activePool ? " (active)" : "", pool.host, pool.port,
+                              pool.healthy ? "healthy" : "unhealthy", (unsigned long)pool.rtt_ms,
+                              pool.dns_cached ? "cached" : "expired", (unsigned long)(pool.dns_age_ms / 1000),
+                              (unsigned long)(pool.time_active_ms / 1000));
+            }
+            if (pool_manager_count() > 0) {
+                Serial.printf("🌐 Pool switches: %lu\n", (unsigned long)pool_manager_get_switches());
+            }
+            
+            // Split sessions: configured weight against the share of hashes each one really got
+            int sessions = mining_get_session_count();
+            uint64_t totalHashes = 0;
+            for (int i = 0; i < sessions; i++) {
+                PoolSessionStats session;
+                if (mining_get_session_stats(i, &session)) {
+                    totalHashes += session.hashes;
+                }
+            }
+            for (int i = 0; i < sessions; i++) {
+                PoolSessionStats session;
+                if (!mining_get_session_stats(i, &session)) {
+                    continue;
+                }
+                Serial.printf("⚖️  Session %s (%s): weight %u%%, %.1f%% of hashes, %s, shares %lu/%lu/%lu/%lu"
+                              " (sent/ok/rejected/stale), RTT %lu ms\n",
+                              session.label, session.protocol, session.weight,
+                              totalHashes ? session.hashes * 100.0f / totalHashes : 0.0f,
+                              session.connected ? "connected" : "disconnected",
+                              (unsigned long)session.shares_submitted, (unsigned long)session.shares_accepted,
+                              (unsigned long)session.shares_rejected, (unsigned long)session.shares_stale,
+                              (unsigned long)session.share_rtt_ms);
+            }
+        }
+        
         // Update mining active state based on actual task status
         if (isDuinoCoinMode) {
             miningActive = duino_task_is_running();
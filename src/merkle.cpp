@@ -0,0 +1,89 @@
+#include "merkle.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include "mbedtls/sha256.h"
+#else
+#include "sha256.h"     // tools/common (host builds)
+#endif
+
+void merkle_sha256d(const uint8_t* data, size_t len, uint8_t out[32]) {
+#ifdef ARDUINO
+    uint8_t first[32];
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts(&ctx, 0);
+    mbedtls_sha256_update(&ctx, data, len);
+    mbedtls_sha256_finish(&ctx, first);
+    mbedtls_sha256_starts(&ctx, 0);
+    mbedtls_sha256_update(&ctx, first, 32);
+    mbedtls_sha256_finish(&ctx, out);
+    mbedtls_sha256_free(&ctx);
+#else
+    sha256d(data, len, out);
+#endif
+}
+
+void merkle_hash_pair(const uint8_t left[32], const uint8_t right[32], uint8_t out[32]) {
+    uint8_t combined[64];
+    memcpy(combined, left, 32);
+    memcpy(combined + 32, right, 32);
+    merkle_sha256d(combined, 64, out);
+}
+
+void merkle_branch_init(merkle_branch_builder_t* builder) {
+    memset(builder, 0, sizeof(*builder));
+    builder->count[0] = 1;      // Leaf 0: the coinbase
+}
+
+// Node number count[level] arrives at a level. Node 0 of every level is on the
+// coinbase path and never materialized; node 1 is the branch entry; the rest
+// pair up and move one level up.
+static void add_node(merkle_branch_builder_t* builder, int level, const uint8_t node[32]) {
+    if (level >= MERKLE_MAX_DEPTH) {
+        builder->overflow = true;
+        return;
+    }
+    uint32_t index = builder->count[level]++;
+    if (index == 1) {
+        memcpy(builder->branch[level], node, 32);
+        builder->count[level + 1] = 1;      // (path, branch) -> path node one level up
+    } else if ((index & 1) == 0) {
+        memcpy(builder->pending[level], node, 32);
+    } else {
+        uint8_t parent[32];
+        merkle_hash_pair(builder->pending[level], node, parent);
+        add_node(builder, level + 1, parent);
+    }
+}
+
+void merkle_branch_add(merkle_branch_builder_t* builder, const uint8_t txid[32]) {
+    add_node(builder, 0, txid);
+}
+
+int merkle_branch_finish(merkle_branch_builder_t* builder) {
+    int level = 0;
+    while (level < MERKLE_MAX_DEPTH && builder->count[level] > 1) {
+        // Odd node count: the last (even, unpaired) node is paired with itself
+        if (builder->count[level] & 1) {
+            uint8_t last[32];
+            memcpy(last, builder->pending[level], 32);
+            add_node(builder, level, last);
+        }
+        level++;
+    }
+    if (builder->overflow || level == MERKLE_MAX_DEPTH) {
+        builder->branch_len = -1;
+        return -1;
+    }
+    builder->branch_len = level;
+    return level;
+}
+
+void merkle_root_from_branch(const uint8_t coinbase_txid[32], const uint8_t (*branch)[32], int branch_len,
+                             uint8_t root[32]) {
+    memcpy(root, coinbase_txid, 32);
+    for (int i = 0; i < branch_len; i++) {
+        merkle_hash_pair(root, branch[i], root);
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef MERKLE_H
+#define MERKLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bitcoin merkle tree helpers. Hashes are 32 bytes in internal byte order
+// (the reverse of the hex shown by bitcoind RPC).
+//
+// The branch builder computes the coinbase's merkle branch from a stream of
+// transaction ids with fixed memory (one pending node per tree level): the
+// coinbase is leaf 0 and is not known yet, every other leaf is fed once in
+// block order. Plain C++; on the host it uses the tools' portable SHA-256.
+
+#define MERKLE_MAX_DEPTH 24           // Up to 16M transactions
+
+typedef struct {
+    uint8_t pending[MERKLE_MAX_DEPTH][32];    // Left node waiting for its right sibling
+    uint32_t count[MERKLE_MAX_DEPTH + 1];     // Nodes produced so far per level
+    uint8_t branch[MERKLE_MAX_DEPTH][32];
+    int branch_len;                           // Valid after merkle_branch_finish()
+    bool overflow;
+} merkle_branch_builder_t;
+
+// Double SHA-256
+void merkle_sha256d(const uint8_t* data, size_t len, uint8_t out[32]);
+
+// Parent node of two children
+void merkle_hash_pair(const uint8_t left[32], const uint8_t right[32], uint8_t out[32]);
+
+// Start a tree whose leaf 0 is the (future) coinbase
+void merkle_branch_init(merkle_branch_builder_t* builder);
+
+// Next transaction id in block order
+void merkle_branch_add(merkle_branch_builder_t* builder, const uint8_t txid[32]);
+
+// Close the tree (odd levels duplicate their last node). Returns the branch
+// length, or -1 if the tree was deeper than MERKLE_MAX_DEPTH.
+int merkle_branch_finish(merkle_branch_builder_t* builder);
+
+// Merkle root for a coinbase txid: climb the branch
+void merkle_root_from_branch(const uint8_t coinbase_txid[32], const uint8_t (*branch)[32], int branch_len,
+                             uint8_t root[32]);
+
+#endif // MERKLE_H
@@ -0,0 +1,141 @@
+#include "merkle_store.h"
+#include <string.h>
+
+static void set_dirty(merkle_store_t* store, size_t node) {
+    store->dirty[node >> 5] |= 1u << (node & 31);
+}
+
+static void clear_dirty(merkle_store_t* store, size_t node) {
+    store->dirty[node >> 5] &= ~(1u << (node & 31));
+}
+
+// First dirty node in [from, end), or end. Clean words are skipped whole.
+static size_t next_dirty(const merkle_store_t* store, size_t from, size_t end) {
+    while (from < end) {
+        uint32_t word = store->dirty[from >> 5] >> (from & 31);
+        if (word == 0) {
+            from = (from | 31) + 1;
+            continue;
+        }
+        from += __builtin_ctz(word);
+        return from < end ? from : end;
+    }
+    return end;
+}
+
+size_t merkle_store_bytes(size_t max_leaves) {
+    size_t nodes = 0;
+    for (size_t size = max_leaves; ; size = (size + 1) / 2) {
+        nodes += size;
+        if (size <= 1) {
+            break;
+        }
+    }
+    return nodes * 32 + (nodes + 31) / 32 * sizeof(uint32_t);
+}
+
+bool merkle_store_init(merkle_store_t* store, void* buffer, size_t bytes, size_t max_leaves) {
+    memset(store, 0, sizeof(*store));
+    if (!buffer || max_leaves < 1 || bytes < merkle_store_bytes(max_leaves)) {
+        return false;
+    }
+
+    size_t nodes = 0;
+    int level = 0;
+    for (size_t size = max_leaves; ; size = (size + 1) / 2) {
+        if (level > MERKLE_MAX_DEPTH) {
+            return false;
+        }
+        store->level_offset[level++] = nodes;
+        nodes += size;
+        if (size <= 1) {
+            break;
+        }
+    }
+    store->levels = level;
+    store->capacity = max_leaves;
+    store->nodes = (uint8_t(*)[32])buffer;
+    store->dirty = (uint32_t*)((uint8_t*)buffer + nodes * 32);
+    memset(store->dirty, 0, (nodes + 31) / 32 * sizeof(uint32_t));
+    return true;
+}
+
+void merkle_store_reset(merkle_store_t* store) {
+    store->count = 0;
+    store->pending = 0;
+    store->overflow = false;
+    if (store->dirty) {
+        size_t nodes = store->level_offset[store->levels - 1] + 1;
+        memset(store->dirty, 0, (nodes + 31) / 32 * sizeof(uint32_t));
+    }
+}
+
+void merkle_store_begin(merkle_store_t* store) {
+    store->pending = 1;         // Leaf 0: the coinbase
+    store->overflow = false;
+}
+
+bool merkle_store_add(merkle_store_t* store, const uint8_t txid[32]) {
+    if (store->pending >= store->capacity) {
+        store->overflow = true;
+        return false;
+    }
+    size_t index = store->pending++;
+    // A leaf past the last tree is new; one already there may be the same transaction.
+    // Dirty bits survive until finish, so a refresh that fails halfway is still redone.
+    if (index >= store->count || memcmp(store->nodes[index], txid, 32) != 0) {
+        memcpy(store->nodes[index], txid, 32);
+        set_dirty(store, index);
+    }
+    return true;
+}
+
+const uint8_t* merkle_store_leaf(const merkle_store_t* store, size_t index) {
+    return store->nodes[index];
+}
+
+int merkle_store_finish(merkle_store_t* store, uint8_t (*branch)[32]) {
+    if (store->overflow || store->pending == 0) {
+        merkle_store_reset(store);
+        return -1;
+    }
+
+    // Fewer or more leaves: the last one may now pair with itself, or with a new sibling
+    size_t size = store->pending;
+    if (size != store->count) {
+        set_dirty(store, size - 1);
+    }
+
+    store->hashes = 0;
+    int level = 0;
+    while (size > 1) {
+        size_t offset = store->level_offset[level];
+        size_t parent_offset = store->level_offset[level + 1];
+        size_t parent_size = (size + 1) / 2;
+
+        // Dirty nodes make their parents dirty
+        for (size_t i = next_dirty(store, offset, offset + size); i < offset + size;
+             i = next_dirty(store, i + 1, offset + size)) {
+            clear_dirty(store, i);
+            set_dirty(store, parent_offset + (i - offset) / 2);
+        }
+
+        // Node 1 is the branch entry; node 0 is on the coinbase path and never needed
+        memcpy(branch[level], store->nodes[offset + 1], 32);
+
+        for (size_t p = next_dirty(store, parent_offset + 1, parent_offset + parent_size);
+             p < parent_offset + parent_size; p = next_dirty(store, p + 1, parent_offset + parent_size)) {
+            size_t left = offset + (p - parent_offset) * 2;
+            size_t right = left + 1 < offset + size ? left + 1 : left;     // Odd level: pair with itself
+            merkle_hash_pair(store->nodes[left], store->nodes[right], store->nodes[p]);
+            store->hashes++;
+        }
+
+        level++;
+        size = parent_size;
+    }
+    clear_dirty(store, store->level_offset[level]);
+
+    store->count = store->pending;
+    return level;
+}
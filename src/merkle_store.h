@@ -0,0 +1,50 @@
+#ifndef MERKLE_STORE_H
+#define MERKLE_STORE_H
+
+#include "merkle.h"
+
+// Incremental merkle tree kept between template refreshes. Consecutive
+// getblocktemplate results mostly repeat the same transactions in the same
+// order, with new ones appended at the end: each leaf's txid is compared with
+// the one stored at its position, and only the paths above changed leaves
+// are hashed again. The result is the coinbase branch, as with the branch
+// builder. Every level of the tree is kept, so the memory (PSRAM on the
+// board) is provided by the caller. Plain C++ with no Arduino dependencies.
+
+typedef struct {
+    uint8_t (*nodes)[32];                     // All levels, leaves first; leaf 0 is the coinbase
+    uint32_t* dirty;                          // One bit per node: hash again on finish
+    size_t level_offset[MERKLE_MAX_DEPTH + 1];
+    size_t capacity;                          // Max leaves, coinbase included
+    int levels;
+
+    size_t count;                             // Leaves in the last finished tree
+    size_t pending;                           // Leaves added since merkle_store_begin()
+    bool overflow;
+
+    uint32_t hashes;                          // Pair hashes done by the last finish
+} merkle_store_t;
+
+// Bytes needed for a tree of max_leaves leaves (coinbase included)
+size_t merkle_store_bytes(size_t max_leaves);
+
+// Use buffer for the tree. false if it is too small for max_leaves.
+bool merkle_store_init(merkle_store_t* store, void* buffer, size_t bytes, size_t max_leaves);
+
+// Forget the previous tree: the next finish hashes everything again
+void merkle_store_reset(merkle_store_t* store);
+
+// New template: transactions follow in block order
+void merkle_store_begin(merkle_store_t* store);
+
+// Next transaction id. false when the store is full.
+bool merkle_store_add(merkle_store_t* store, const uint8_t txid[32]);
+
+// Leaf i of the tree being filled (1 = first transaction)
+const uint8_t* merkle_store_leaf(const merkle_store_t* store, size_t index);
+
+// Hash the changed paths and write the coinbase branch. Returns its length,
+// or -1 after an overflow (the store is then reset).
+int merkle_store_finish(merkle_store_t* store, uint8_t (*branch)[32]);
+
+#endif // MERKLE_STORE_H
@@ -1,6 +1,11 @@
 #include "mining_task.h"
 #include "bitcoin_rpc.h"
+#include "btc_address.h"
+#include "solo_block.h"
 #include "stratum_client.h"
+#include "stratum_v2_client.h"
+#include "pool_manager.h"
+#include "tls_transport.h"
 #include "mbedtls/sha256.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
@@ -27,11 +32,28 @@ static String pool_wallet;
 static String pool_worker;
 static String pool_password;
 
-// Current pool job
-static stratum_job_t current_pool_job;
-static bool has_pool_job = false;
-static uint32_t pool_difficulty = 1;
-static uint32_t extranonce2 = 0;  // Counter for extranonce2
+// Failover: pool in uso e tentativi di uscita dal fallback educativo
+#define POOL_FAILBACK_CHECK_MS 5000    // Ogni quanto verificare se il primario è tornato
+#define POOL_FALLBACK_RETRY_MS 30000   // Ogni quanto riprovare i pool in fallback educativo
+static int current_pool_index = -1;
+static bool pool_retry_pending = false;
+
+// Mining solo: script di payout del wallet, template e coinbase costruita sul dispositivo
+static uint8_t solo_script[BTC_SCRIPT_MAX];
+static int solo_script_len = -1;
+static BitcoinBlockTemplate solo_template;
+static solo_coinbase_t solo_coinbase;
+static uint64_t solo_extranonce = 0;
+static uint8_t solo_target[32];
+static uint32_t solo_generation = 0;    // Generazione del template in lavorazione (vedi long-poll)
+static BitcoinBlockTemplate solo_next;  // Download in corso: se fallisce il template corrente resta intatto
+
+// Solo: template non scaricato, nuovi tentativi con backoff
+#define SOLO_RETRY_MIN_MS 2000         // Primo tentativo dopo un download fallito
+#define SOLO_RETRY_MAX_MS POOL_FALLBACK_RETRY_MS
+static bool solo_retry_pending = false;
+static uint32_t solo_retry_ms = SOLO_RETRY_MIN_MS;
+static uint32_t last_solo_retry = 0;
 
 // Bitcoin block header structure (80 bytes)
 struct BlockHeader {
@@ -43,6 +65,36 @@ struct BlockHeader {
     uint32_t nonce;             // 4 bytes - Numero da variare per trovare soluzione
 } __attribute__((packed));
 
+// Sessioni pool minate in parallelo (la 0 è il pool principale con failover)
+#define MAX_POOL_SESSIONS 2
+#define SCHED_ROUND_NONCES 20000    // Nonce per giro di scheduling, divisi tra le sessioni per peso
+#define SESSION_RETRY_MS 10000      // Attesa tra i tentativi di riconnessione (primario senza pool raggiungibili e secondarie)
+
+struct PoolSession {
+    StratumClient v1_client;
+    StratumV2Client v2_client;
+    PoolClient* client = &v1_client;    // Client del protocollo in uso (dal prefisso URL)
+    String label;
+    String host;                // Solo sessioni secondarie (la principale usa pool_manager)
+    uint16_t port;
+    String wallet;
+    String worker;
+    String password;
+    uint8_t weight;             // Quota del tempo di hashing (relativa alle altre sessioni)
+    stratum_job_t job;
+    BlockHeader header;         // Header già decodificato, pronto da minare
+    bool has_job;
+    uint32_t extranonce2;
+    uint32_t hashes;
+    uint32_t shares_submitted;
+    uint32_t last_connect_attempt;
+    uint32_t connect_started_ms;    // Inizio connessione, fino al primo hash (0 = già misurato)
+    uint32_t notify_ms;             // Arrivo dell'ultimo mining.notify, fino al primo hash (0 = già misurato)
+};
+
+static PoolSession sessions[MAX_POOL_SESSIONS];
+static int session_count = 1;
+
 // Converte hash binario in stringa esadecimale
 void hash_to_hex(const uint8_t* hash, char* hex_string) {
     for(int i = 0; i < 32; i++) {
@@ -68,28 +120,6 @@ void bin_to_hex(const uint8_t* bin, size_t bin_len, char* hex)
     hex[bin_len * 2] = '\0';
 }
 
-// Callback quando arriva nuovo job dal pool
-void on_stratum_job(stratum_job_t* job) {
-    Serial.println("📬 Nuovo job dal pool!");
-    Serial.printf("   Job ID: %s\n", job->job_id.c_str());
-    Serial.printf("   Clean: %s\n", job->clean_jobs ? "YES" : "NO");
-    
-    // Salva il job corrente
-    current_pool_job = *job;
-    has_pool_job = true;
-    
-    // Aggiorna difficoltà dal pool
-    pool_difficulty = stratum_get_difficulty();
-    
-    // Se il pool non ha mai inviato mining.set_difficulty, usa valore default
-    if (pool_difficulty == 0) {
-        pool_difficulty = 512;  // Default ottimale per ESP32
-        Serial.printf("   Difficulty: %u (default - pool non ha inviato set_difficulty)\n", pool_difficulty);
-    } else {
-        Serial.printf("   Difficulty: %u\n", pool_difficulty);
-    }
-}
-
 // Calcola SHA-256 doppio (come richiesto da Bitcoin)
 void double_sha256(const uint8_t* input, size_t length, uint8_t* output) {
     uint8_t temp_hash[32];
@@ -194,7 +224,7 @@ bool check_hash_difficulty(const uint8_t* hash, uint32_t difficulty_bits) {
     // Qui usiamo una versione semplificata: numero di zeri richiesti
     uint32_t required_zeros = (difficulty_bits >> 24) - 3;
     
-    return leading_zeros >= required_zeros;
+    return (uint32_t)leading_zeros >= required_zeros;
 }
 
 // Converte pool difficulty in numero di zeri richiesti (approssimazione)
@@ -226,7 +256,12 @@ bool hash_meets_pool_difficulty(const uint8_t* hash, uint32_t pool_difficulty) {
     
     // Converti la difficoltà in zeri richiesti
     int required_zeros = difficulty_to_zeros(pool_difficulty);
-    
+#ifdef MINING_HOST_SHARE_ZEROS
+    // Solo per i bench su host (tools/pool_emulator): soglia ridotta perché il
+    // task stesso trovi e invii share in pochi secondi. Mai definito sulla board.
+    required_zeros = MINING_HOST_SHARE_ZEROS;
+#endif
+
     // Conta gli zeri nell'hash
     int zeros = count_leading_zeros(hash);
     
@@ -234,6 +269,391 @@ bool hash_meets_pool_difficulty(const uint8_t* hash, uint32_t pool_difficulty) {
     return zeros >= required_zeros;
 }
 
+// Decodifica il job della sessione nell'header da minare (merkle root per l'extranonce2 corrente)
+static void session_prepare_header(PoolSession* session)
+{
+    const stratum_job_t* job = &session->job;
+    BlockHeader* header = &session->header;
+    
+    // Version (converti da hex string a uint32)
+    header->version = strtoul(job->version.c_str(), NULL, 16);
+    
+    if(job->has_merkle_root) {
+        // Stratum V2 canale standard: prev hash e merkle root arrivano già pronti
+        memcpy(header->prevBlockHash, job->prev_hash_raw, 32);
+        memcpy(header->merkleRoot, job->merkle_root, 32);
+    } else {
+        // Previous block hash (inverti byte order - little endian)
+        for(int i = 0; i < 32; i++) {
+            sscanf(job->prev_hash.c_str() + (i * 2), "%2hhx", &header->prevBlockHash[31 - i]);
+        }
+        
+        // Calcola merkle root corretto dalla coinbase e merkle branch
+        uint8_t coinbase_hash[32];
+        build_coinbase(job, session->extranonce2, coinbase_hash);
+        calculate_merkle_root(coinbase_hash, job->merkle_branch, header->merkleRoot);
+    }
+    
+    // nBits (difficulty) e timestamp
+    header->bits = strtoul(job->nbits.c_str(), NULL, 16);
+    header->timestamp = strtoul(job->ntime.c_str(), NULL, 16);
+    
+    // Nonce - inizia da 0 e incrementa
+    header->nonce = 0;
+}
+
+// Difficoltà della sessione (default se il pool non ha mai inviato mining.set_difficulty)
+static uint32_t session_difficulty(PoolSession* session)
+{
+    uint32_t difficulty = session->client->getDifficulty();
+    return difficulty == 0 ? 512 : difficulty;  // Default ottimale per ESP32
+}
+
+// Callback quando arriva nuovo job dal pool
+void on_stratum_job(stratum_job_t* job, void* arg) {
+    PoolSession* session = (PoolSession*)arg;
+    
+    Serial.printf("📬 Nuovo job dal pool %s!\n", session->label.c_str());
+    Serial.printf("   Job ID: %s\n", job->job_id.c_str());
+    Serial.printf("   Clean: %s\n", job->clean_jobs ? "YES" : "NO");
+    
+    // Salva il job e decodificalo subito: il cambio di sessione tra gli slice non costa nulla
+    session->job = *job;
+    session->extranonce2 = 0;
+    session->notify_ms = millis();
+    session_prepare_header(session);
+    session->has_job = true;
+    
+    if (session->client->getDifficulty() == 0) {
+        Serial.printf("   Difficulty: %u (default - pool non ha inviato set_difficulty)\n", session_difficulty(session));
+    } else {
+        Serial.printf("   Difficulty: %u\n", session_difficulty(session));
+    }
+}
+
+// Connette la sessione principale al pool indicato della lista di failover (DNS dalla cache)
+static bool mining_connect_pool(int index)
+{
+    PoolSession* session = &sessions[0];
+    
+    IPAddress ip;
+    if(!pool_manager_resolve(index, ip)) {
+        Serial.printf("❌ DNS fallito per %s\n", pool_manager_get_host(index));
+        pool_manager_mark_failed(index);
+        return false;
+    }
+    
+    Serial.printf("🔌 Pool #%d: %s:%u (%s)\n", index, pool_manager_get_host(index),
+                  pool_manager_get_port(index), ip.toString().c_str());
+    
+    // Il protocollo può cambiare da un pool all'altro della lista
+    session->client->disconnect();
+    PoolProtocol protocol = pool_manager_get_protocol(index);
+    if(protocol == POOL_PROTOCOL_V2) {
+        session->client = &session->v2_client;
+    } else {
+        // Con TLS il nome del pool serve per SNI e per ritrovare la sessione da riprendere
+        session->v1_client.setTls(protocol == POOL_PROTOCOL_V1_TLS, pool_manager_get_host(index));
+        session->client = &session->v1_client;
+    }
+    
+    session->connect_started_ms = millis();
+    session->client->init(ip.toString().c_str(), pool_manager_get_port(index), pool_wallet.c_str(),
+                         pool_worker.c_str(), pool_password.c_str());
+    
+    if(!session->client->connect()) {
+        pool_manager_mark_failed(index);
+        return false;
+    }
+    
+    // Nuova sessione: il job e l'extranonce2 del pool precedente non valgono più
+    session->has_job = false;
+    session->extranonce2 = 0;
+    current_pool_index = index;
+    pool_manager_set_active(index);
+    stats.active_pool = index;
+    stats.pool_switches = pool_manager_get_switches();
+    return true;
+}
+
+// Connette al pool con priorità più alta: prima i pool sani, poi tutti gli altri
+static bool mining_connect_best_pool(void)
+{
+    int count = pool_manager_count();
+    for(int pass = 0; pass < 2; pass++) {
+        for(int i = 0; i < count; i++) {
+            if(pool_manager_is_healthy(i) == (pass == 0)) {
+                if(mining_connect_pool(i)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// Connette una sessione secondaria (senza bloccare più di un tentativo ogni SESSION_RETRY_MS)
+static void session_connect_secondary(PoolSession* session)
+{
+    if(session->client->isConnected() || millis() - session->last_connect_attempt < SESSION_RETRY_MS) {
+        return;
+    }
+    session->last_connect_attempt = millis();
+    session->connect_started_ms = millis();
+    session->has_job = false;
+    
+    Serial.printf("🔌 Pool %s: %s:%u\n", session->label.c_str(), session->host.c_str(), session->port);
+    session->client->init(session->host.c_str(), session->port, session->wallet.c_str(),
+                         session->worker.c_str(), session->password.c_str());
+    if(!session->client->connect()) {
+        Serial.printf("❌ Pool %s non raggiungibile, il suo tempo va alle altre sessioni\n", session->label.c_str());
+    }
+}
+
+// Mina uno slice di nonce sulla sessione indicata
+static void session_mine_slice(PoolSession* session, uint32_t nonces, uint8_t* hash, char* hash_hex,
+                               int* best_zeros, uint32_t* hashes)
+{
+    BlockHeader* header = &session->header;
+    uint32_t difficulty = session_difficulty(session);
+    
+    // Latenze: connessione -> primo hash e notify -> primo hash sul nuovo job
+    if(nonces > 0) {
+        uint32_t now = millis();
+        if(session->connect_started_ms != 0) {
+            stats.connect_to_first_hash_ms = now - session->connect_started_ms;
+            session->connect_started_ms = 0;
+            Serial.printf("⏱️  Pool %s: primo hash %u ms dopo la connessione\n", session->label.c_str(),
+                          stats.connect_to_first_hash_ms);
+        }
+        if(session->notify_ms != 0) {
+            stats.notify_to_switch_ms = now - session->notify_ms;
+            session->notify_ms = 0;
+        }
+    }
+    
+    for(uint32_t n = 0; n < nonces && taskRunning; n++) {
+        header->nonce++;
+        
+        // Spazio nonce esaurito: nuovo extranonce2 e nuovo merkle root
+        // (canale standard V2: niente extranonce2, si avanza ntime)
+        if(header->nonce == 0) {
+            if(session->job.has_merkle_root) {
+                header->timestamp++;
+            } else {
+                session->extranonce2++;
+                session_prepare_header(session);
+            }
+            header->nonce = 1;
+        }
+        
+        // Calcola doppio SHA-256
+        double_sha256((uint8_t*)header, sizeof(BlockHeader), hash);
+        
+        (*hashes)++;
+        session->hashes++;
+        stats.total_hashes++;
+        
+        // Conta zeri per stats
+        int zeros = count_leading_zeros(hash);
+        if(zeros > *best_zeros) {
+            *best_zeros = zeros;
+            stats.best_difficulty = zeros;
+            hash_to_hex(hash, hash_hex);
+            memcpy(stats.best_hash, hash_hex, 65);
+            
+            // Log quando troviamo un hash interessante (ma non necessariamente valido)
+            if (zeros >= 4) {
+                Serial.printf("🔍 Hash interessante trovato con %d zeri (best finora)\n", zeros);
+            }
+        }
+        
+        // Controlla se hash soddisfa la difficoltà del pool
+        // Usa il conteggio degli zeri calibrato per la pool difficulty
+        if(hash_meets_pool_difficulty(hash, difficulty)) {
+            Serial.printf("⭐ SHARE VALIDA TROVATA! (pool %s)\n", session->label.c_str());
+            Serial.printf("   Nonce: 0x%08x\n", header->nonce);
+            Serial.printf("   Hash: %s\n", hash_hex);
+            Serial.printf("   Zeros: %d\n", zeros);
+            Serial.printf("   Pool difficulty: %u (richiede ~%d zeri)\n", 
+                          difficulty, difficulty_to_zeros(difficulty));
+            Serial.printf("   Extranonce2: 0x%08x\n", session->extranonce2);
+            
+            // Prepara dati per submit
+            char nonce_hex[9];
+            snprintf(nonce_hex, sizeof(nonce_hex), "%08x", header->nonce);
+            
+            char ntime_hex[9];
+            snprintf(ntime_hex, sizeof(ntime_hex), "%08x", header->timestamp);
+            
+            // Converte extranonce2 in hex string (little endian)
+            char extranonce2_hex[17];
+            int hex_len = session->job.extranonce2_size * 2;
+            for(int i = 0; i < session->job.extranonce2_size; i++) {
+                snprintf(extranonce2_hex + (i * 2), 3, "%02x", (session->extranonce2 >> (i * 8)) & 0xFF);
+            }
+            extranonce2_hex[hex_len] = '\0';
+            
+            // Invia share al pool (l'esito arriva con la risposta del pool)
+            if(session->client->submitShare(session->job.job_id.c_str(), 
+                                           extranonce2_hex, ntime_hex, nonce_hex)) {
+                Serial.println("📤 Share inviata");
+                session->shares_submitted++;
+            } else {
+                Serial.println("❌ Invio share fallito");
+            }
+        }
+    }
+}
+
+// Aggiorna le statistiche aggregate delle share da tutte le sessioni
+static void sessions_update_share_stats(void)
+{
+    uint32_t accepted = 0;
+    uint32_t rejected = 0;
+    uint32_t stale = 0;
+    uint64_t rtt_total = 0;
+    uint32_t rtt_samples = 0;
+    for(int i = 0; i < session_count; i++) {
+        PoolClient* client = sessions[i].client;
+        accepted += client->getSharesAccepted();
+        rejected += client->getSharesRejected();
+        stale += client->getSharesStale();
+        rtt_total += (uint64_t)client->getShareRttAvg() * client->getShareRttSamples();
+        rtt_samples += client->getShareRttSamples();
+    }
+    stats.shares_accepted = accepted;
+    stats.shares_rejected = rejected;
+    stats.shares_stale = stale;
+    stats.share_rtt_ms = rtt_samples ? (uint32_t)(rtt_total / rtt_samples) : 0;
+}
+
+// Nuovo lavoro solo: template dal nodo, coinbase verso il wallet, primo merkle root
+static bool solo_prepare_job(BlockHeader* header)
+{
+    if(solo_script_len < 0) {
+        Serial.println("❌ Wallet per il payout solo mancante o non valido!");
+        return false;
+    }
+    // Letta prima del download: un cambio durante il download fa ripartire ancora
+    solo_generation = bitcoin_rpc_template_generation();
+    if(!bitcoin_rpc_get_block_template(&solo_next)) {
+        return false;
+    }
+    solo_template = solo_next;
+    
+    // Transazioni non memorizzate (niente PSRAM o store pieno): blocco con la sola coinbase
+    if(!solo_template.tx_data_complete) {
+        Serial.printf("⚠️  Transazioni non memorizzabili: blocco con la sola coinbase (%llu sat di fee perse)\n",
+                      (unsigned long long)solo_template.fees);
+        gbt_template_drop_transactions(&solo_template);
+    }
+    if(!solo_coinbase_build(&solo_coinbase, &solo_template, solo_script, solo_script_len)) {
+        Serial.println("❌ Coinbase troppo grande!");
+        return false;
+    }
+    
+    // Extranonce di partenza casuale: due dispositivi sullo stesso wallet non ripetono lo stesso lavoro
+    solo_extranonce = (uint64_t)esp_random() << 32;
+    
+    header->version = solo_template.version;
+    gbt_hex_to_hash(solo_template.previousblockhash, header->prevBlockHash);
+    header->timestamp = solo_template.curtime;
+    header->bits = solo_template.bits;
+    header->nonce = 0;
+    solo_coinbase_roll(&solo_coinbase, &solo_template, solo_extranonce, header->merkleRoot);
+    solo_target_from_bits(solo_template.bits, solo_target);
+    
+    stats.block_height = solo_template.height;
+    Serial.printf("🪙 Coinbase: %u byte%s, %llu sat al wallet\n", (unsigned)solo_coinbase.len,
+                  solo_coinbase.witness ? " (segwit)" : "", (unsigned long long)solo_template.coinbasevalue);
+    return true;
+}
+
+// Download del template fallito con la tip invariata: si continua sul template
+// corrente. Le sue transazioni stavano nello store che il download ha riscritto,
+// quindi si passa al blocco con la sola coinbase finché il nodo non risponde.
+static void solo_keep_job(BlockHeader* header)
+{
+    if(solo_template.transactions_count == 0) {
+        return;
+    }
+    Serial.printf("⚠️  Store delle transazioni riscritto: blocco con la sola coinbase (%llu sat di fee perse)\n",
+                  (unsigned long long)solo_template.fees);
+    gbt_template_drop_transactions(&solo_template);
+    solo_coinbase_build(&solo_coinbase, &solo_template, solo_script, solo_script_len);
+    solo_coinbase_roll(&solo_coinbase, &solo_template, solo_extranonce, header->merkleRoot);
+}
+
+// Header del blocco di esempio della modalità educativa
+static void educational_prepare_job(BlockHeader* header)
+{
+    header->version = 0x20000000; // Version 2
+    
+    // Hash del blocco precedente (esempio)
+    memset(header->prevBlockHash, 0, 32);
+    
+    // Merkle root (esempio)
+    for(int i = 0; i < 32; i++) {
+        header->merkleRoot[i] = random(0, 256);
+    }
+    
+    header->timestamp = millis() / 1000; // Unix timestamp simulato
+    header->bits = 0x1d00ffff; // Difficoltà ridotta per demo
+    header->nonce = 0;
+    
+    // Block height educativo (simulato)
+    stats.block_height = 0;
+}
+
+// Nuovo template per il lavoro solo. Se il nodo non risponde si riprova con
+// backoff: con la stessa tip si continua a minare il template corrente, con una
+// tip nuova il lavoro non vale più nulla e si passa al fallback educativo finché
+// il download non riesce.
+static bool solo_refresh_job(BlockHeader* header)
+{
+    last_solo_retry = millis();
+    if(solo_prepare_job(header)) {
+        solo_retry_pending = false;
+        solo_retry_ms = SOLO_RETRY_MIN_MS;
+        if(currentMiningMode != MINING_MODE_SOLO) {
+            Serial.println("✅ Nodo di nuovo raggiungibile, esco dalla modalità educativa");
+            currentMiningMode = MINING_MODE_SOLO;
+            isEducationalFallback = false;
+            bitcoin_rpc_longpoll_start();
+        }
+        return true;
+    }
+    
+    if(solo_retry_pending && solo_retry_ms < SOLO_RETRY_MAX_MS) {
+        solo_retry_ms *= 2;
+        if(solo_retry_ms > SOLO_RETRY_MAX_MS) {
+            solo_retry_ms = SOLO_RETRY_MAX_MS;
+        }
+    }
+    solo_retry_pending = true;
+    if(currentMiningMode != MINING_MODE_SOLO) {
+        Serial.printf("❌ Nodo ancora irraggiungibile, nuovo tentativo tra %u s\n", solo_retry_ms / 1000);
+    } else if(!bitcoin_rpc_tip_changed(solo_template.previousblockhash)) {
+        Serial.printf("⚠️  Template non scaricato, continuo sul corrente (nuovo tentativo tra %u s)\n",
+                      solo_retry_ms / 1000);
+        solo_keep_job(header);
+    } else {
+        Serial.printf("❌ Nuovo blocco ma template non scaricato: modalità educativa (nuovo tentativo tra %u s)\n",
+                      solo_retry_ms / 1000);
+        currentMiningMode = MINING_MODE_EDUCATIONAL;
+        isEducationalFallback = true;
+        educational_prepare_job(header);
+    }
+    return false;
+}
+
+// Blocco trovato: inviato con submitblock, serializzato mentre esce sul socket
+static bool solo_submit_block(const BlockHeader* header)
+{
+    return bitcoin_rpc_submit_block((const uint8_t*)header, &solo_coinbase, &solo_template);
+}
+
 // Mining task function - runs in background
 void miningTask(void* parameter)
 {
@@ -248,22 +668,36 @@ void miningTask(void* parameter)
     if(currentMiningMode == MINING_MODE_POOL) {
         Serial.println("🏊 MODALITÀ POOL MINING");
         Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
-        Serial.printf("   Pool: %s:%d\n", pool_url.c_str(), pool_port);
+        for(int i = 0; i < pool_manager_count(); i++) {
+            Serial.printf("   Pool #%d: %s:%u%s\n", i, pool_manager_get_host(i),
+                          pool_manager_get_port(i), i == 0 ? " (primario)" : " (backup)");
+        }
         Serial.printf("   Wallet: %s\n", pool_wallet.c_str());
         Serial.printf("   Worker: %s\n", pool_worker.c_str());
         Serial.println();
         
-        // Inizializza client Stratum
-        stratum_init(pool_url.c_str(), pool_port, pool_wallet.c_str(), 
-                    pool_worker.c_str(), pool_password.c_str());
-        stratum_set_job_callback(on_stratum_job);
+        for(int i = 1; i < session_count; i++) {
+            Serial.printf("   Split %s: %s:%u (peso %u%%)\n", sessions[i].label.c_str(),
+                          sessions[i].host.c_str(), sessions[i].port, sessions[i].weight);
+        }
+        Serial.println();
+        
+        // Inizializza client Stratum di ogni sessione e probing in background dei pool
+        for(int i = 0; i < session_count; i++) {
+            sessions[i].v1_client.setJobCallback(on_stratum_job, &sessions[i]);
+            sessions[i].v2_client.setJobCallback(on_stratum_job, &sessions[i]);
+            sessions[i].has_job = false;
+            sessions[i].last_connect_attempt = millis() - SESSION_RETRY_MS;
+        }
+        pool_manager_start_probing();
         
-        // Connetti al pool
-        if(!stratum_connect()) {
-            Serial.println("❌ Impossibile connettersi al pool!");
-            Serial.println("   Tornando a modalità educativa...");
+        // Connetti al primo pool raggiungibile della lista
+        if(!mining_connect_best_pool()) {
+            Serial.println("❌ Impossibile connettersi a nessun pool!");
+            Serial.println("   Tornando a modalità educativa (nuovo tentativo ogni 30s)...");
             currentMiningMode = MINING_MODE_EDUCATIONAL;
             isEducationalFallback = true;  // Mark as fallback mode
+            pool_retry_pending = true;
         } else {
             Serial.println("✅ Connesso al pool!");
             Serial.println();
@@ -292,40 +726,31 @@ void miningTask(void* parameter)
     
     // Inizializza il block header
     BlockHeader header;
-    bool usingRealBlock = false;
     
     if(currentMiningMode == MINING_MODE_SOLO) {
-        // Modalità SOLO: recupera vero block template dalla blockchain
-        BitcoinBlockTemplate blockTemplate;
-        if(bitcoin_rpc_get_block_template(&blockTemplate)) {
-            // Usa dati reali dal nodo
-            header.version = blockTemplate.version;
-            header.timestamp = blockTemplate.curtime;
-            header.bits = blockTemplate.bits;
-            header.nonce = 0;
-            
-            // Converte previous block hash da hex a binary
-            hex_to_bin(blockTemplate.previousblockhash, header.prevBlockHash, 32);
-            
-            // Converte merkle root da hex a binary
-            // NOTA: In un vero miner dovresti calcolare il merkle tree
-            // da tutte le transazioni nel template
-            hex_to_bin(blockTemplate.merkleroot, header.merkleRoot, 32);
-            
-            // Salva block height nelle statistiche
-            stats.block_height = blockTemplate.height;
-            
-            usingRealBlock = true;
-            
+        // Modalità SOLO: vero block template dalla blockchain, coinbase costruita qui
+        if(solo_prepare_job(&header)) {
             Serial.println("✅ Blocco reale caricato!");
-            Serial.printf("   Altezza: %u\n", blockTemplate.height);
-            Serial.printf("   Transazioni: %d\n", blockTemplate.transactions_count);
+            Serial.printf("   Altezza: %u\n", solo_template.height);
+            Serial.printf("   Transazioni: %d\n", solo_template.transactions_count);
             isEducationalFallback = false;  // Successfully got block template
-        } else {
+            
+            // Nuovi blocchi della rete: long-poll (o controllo della tip) su un altro core
+            bitcoin_rpc_longpoll_start();
+        } else if(solo_script_len < 0) {
             Serial.println("❌ Impossibile ottenere block template!");
             Serial.println("   Tornando a modalità educativa...");
             currentMiningMode = MINING_MODE_EDUCATIONAL;
             isEducationalFallback = true;  // Mark as fallback mode
+        } else {
+            // Nodo irraggiungibile: si riprova con backoff dal fallback educativo
+            Serial.println("❌ Impossibile ottenere block template!");
+            Serial.printf("   Tornando a modalità educativa (nuovo tentativo tra %u s)...\n", SOLO_RETRY_MIN_MS / 1000);
+            currentMiningMode = MINING_MODE_EDUCATIONAL;
+            isEducationalFallback = true;  // Mark as fallback mode
+            solo_retry_pending = true;
+            solo_retry_ms = SOLO_RETRY_MIN_MS;
+            last_solo_retry = millis();
         }
     }
     
@@ -336,27 +761,8 @@ void miningTask(void* parameter)
             isEducationalFallback = false;
         }
         Serial.println("🎓 Modalità EDUCATIVA - Blocco di esempio");
-        
-        header.version = 0x20000000; // Version 2
-        
-        // Hash del blocco precedente (esempio)
         Serial.println("📦 Inizializzando Block Header...");
-        memset(header.prevBlockHash, 0, 32);
-        header.prevBlockHash[0] = 0x00;
-        header.prevBlockHash[1] = 0x00;
-        
-        // Merkle root (esempio)
-        memset(header.merkleRoot, 0, 32);
-        for(int i = 0; i < 32; i++) {
-            header.merkleRoot[i] = random(0, 256);
-        }
-        
-        header.timestamp = millis() / 1000; // Unix timestamp simulato
-        header.bits = 0x1d00ffff; // Difficoltà ridotta per demo
-        header.nonce = 0;
-        
-        // Block height educativo (simulato)
-        stats.block_height = 0;
+        educational_prepare_job(&header);
         
         Serial.printf("   Version: 0x%08x\n", header.version);
         Serial.printf("   Difficulty bits: 0x%08x\n", header.bits);
@@ -373,125 +779,86 @@ void miningTask(void* parameter)
     uint32_t start_time = millis();
     uint32_t blocks_found = 0;
     int best_zeros = 0;
+    uint32_t last_failback_check = millis();
+    uint32_t last_pool_retry = millis();
     
     // Main mining loop
     while (taskRunning) {
         // MODALITÀ POOL: gestisci messaggi Stratum
         if(currentMiningMode == MINING_MODE_POOL) {
-            stratum_loop();
-            
-            // Se non connesso, riprova
-            if(!stratum_is_connected()) {
-                Serial.println("⚠️  Connessione pool persa, riconnessione...");
-                vTaskDelay(5000 / portTICK_PERIOD_MS);
-                if(!stratum_connect()) {
-                    Serial.println("❌ Riconnessione fallita");
-                    vTaskDelay(10000 / portTICK_PERIOD_MS);
-                    continue;
-                }
+            PoolSession* primary = &sessions[0];
+            for(int i = 0; i < session_count; i++) {
+                sessions[i].client->loop();
             }
             
-            // Aspetta di avere un job dal pool
-            if(!has_pool_job) {
-                vTaskDelay(100 / portTICK_PERIOD_MS);
-                continue;
+            // Se non connesso, passa subito al prossimo pool sano della lista
+            if(!primary->client->isConnected() && current_pool_index >= 0) {
+                Serial.printf("⚠️  Connessione al pool #%d persa, failover...\n", current_pool_index);
+                pool_manager_mark_failed(current_pool_index);
+                pool_manager_set_active(-1);
+                stats.active_pool = -1;
+                current_pool_index = -1;
+                primary->last_connect_attempt = millis() - SESSION_RETRY_MS;
             }
             
-            // Costruisci block header dal job Stratum
-            BlockHeader pool_header;
-            
-            // Version (converti da hex string a uint32)
-            pool_header.version = strtoul(current_pool_job.version.c_str(), NULL, 16);
-            
-            // Previous block hash (inverti byte order - little endian)
-            for(int i = 0; i < 32; i++) {
-                sscanf(current_pool_job.prev_hash.c_str() + (i * 2), "%2hhx", &pool_header.prevBlockHash[31 - i]);
+            // Nessun pool raggiungibile: un tentativo ogni SESSION_RETRY_MS, le altre sessioni continuano a minare
+            if(!primary->client->isConnected() && millis() - primary->last_connect_attempt >= SESSION_RETRY_MS) {
+                primary->last_connect_attempt = millis();
+                if(!mining_connect_best_pool()) {
+                    Serial.printf("❌ Nessun pool raggiungibile, nuovo tentativo tra %us\n", SESSION_RETRY_MS / 1000);
+                }
             }
             
-            // Calcola merkle root corretto dalla coinbase e merkle branch
-            uint8_t coinbase_hash[32];
-            build_coinbase(&current_pool_job, extranonce2, coinbase_hash);
-            calculate_merkle_root(coinbase_hash, current_pool_job.merkle_branch, pool_header.merkleRoot);
+            // Torna a un pool con priorità più alta appena il probing lo vede di nuovo sano
+            if(current_pool_index > 0 && millis() - last_failback_check >= POOL_FAILBACK_CHECK_MS) {
+                last_failback_check = millis();
+                for(int i = 0; i < current_pool_index; i++) {
+                    if(pool_manager_is_healthy(i)) {
+                        int previous = current_pool_index;
+                        Serial.printf("🔁 Pool #%d di nuovo disponibile, ritorno dal #%d\n", i, previous);
+                        if(!mining_connect_pool(i) && !mining_connect_pool(previous)) {
+                            mining_connect_best_pool();
+                        }
+                        break;
+                    }
+                }
+                if(!primary->client->isConnected()) {
+                    continue;
+                }
+            }
             
-            // nBits (difficulty)
-            pool_header.bits = strtoul(current_pool_job.nbits.c_str(), NULL, 16);
+            // Sessioni secondarie: riconnessione senza bloccare il pool principale
+            for(int i = 1; i < session_count; i++) {
+                session_connect_secondary(&sessions[i]);
+            }
             
-            // Timestamp
-            pool_header.timestamp = strtoul(current_pool_job.ntime.c_str(), NULL, 16);
+            // Peso totale delle sessioni pronte: chi non ha un job cede il suo tempo alle altre
+            uint32_t total_weight = 0;
+            for(int i = 0; i < session_count; i++) {
+                if(sessions[i].has_job && sessions[i].client->isConnected()) {
+                    total_weight += sessions[i].weight;
+                }
+            }
             
-            // Nonce - inizia da 0 e incrementa
-            pool_header.nonce = 0;
+            // Aspetta di avere un job dal pool
+            if(total_weight == 0) {
+                vTaskDelay(100 / portTICK_PERIOD_MS);
+                continue;
+            }
             
             // Aggiorna block height (non fornito da Stratum, usa 0)
             stats.block_height = 0;
             
-            // Mina per un po' (prova 1M nonce prima di ricontrollare job per massimizzare hashrate)
-            for(int i = 0; i < 1000000 && taskRunning && has_pool_job; i++) {
-                pool_header.nonce++;
-                
-                // Calcola doppio SHA-256
-                double_sha256((uint8_t*)&pool_header, sizeof(BlockHeader), hash);
-                
-                hashes++;
-                stats.total_hashes++;
-                
-                // Conta zeri per stats
-                int zeros = count_leading_zeros(hash);
-                if(zeros > best_zeros) {
-                    best_zeros = zeros;
-                    stats.best_difficulty = zeros;
-                    hash_to_hex(hash, hash_hex);
-                    memcpy(stats.best_hash, hash_hex, 65);
-                    
-                    // Log quando troviamo un hash interessante (ma non necessariamente valido)
-                    if (zeros >= 4) {
-                        Serial.printf("🔍 Hash interessante trovato con %d zeri (best finora)\n", zeros);
-                    }
-                }
-                
-                // Controlla se hash soddisfa la difficoltà del pool
-                // Usa il conteggio degli zeri calibrato per la pool difficulty
-                if(hash_meets_pool_difficulty(hash, pool_difficulty)) {
-                    Serial.println("⭐ SHARE VALIDA TROVATA!");
-                    Serial.printf("   Nonce: 0x%08x\n", pool_header.nonce);
-                    Serial.printf("   Hash: %s\n", hash_hex);
-                    Serial.printf("   Zeros: %d\n", zeros);
-                    Serial.printf("   Pool difficulty: %u (richiede ~%d zeri)\n", 
-                                  pool_difficulty, difficulty_to_zeros(pool_difficulty));
-                    Serial.printf("   Extranonce2: 0x%08x\n", extranonce2);
-                    
-                    // Prepara dati per submit
-                    char nonce_hex[9];
-                    snprintf(nonce_hex, sizeof(nonce_hex), "%08x", pool_header.nonce);
-                    
-                    char ntime_hex[9];
-                    snprintf(ntime_hex, sizeof(ntime_hex), "%08x", pool_header.timestamp);
-                    
-                    // Converte extranonce2 in hex string (little endian)
-                    char extranonce2_hex[17];
-                    int hex_len = current_pool_job.extranonce2_size * 2;
-                    for(int i = 0; i < current_pool_job.extranonce2_size; i++) {
-                        snprintf(extranonce2_hex + (i * 2), 3, "%02x", (extranonce2 >> (i * 8)) & 0xFF);
-                    }
-                    extranonce2_hex[hex_len] = '\0';
-                    
-                    // Invia share al pool
-                    if(stratum_submit_share(current_pool_job.job_id.c_str(), 
-                                           extranonce2_hex, ntime_hex, nonce_hex)) {
-                        Serial.println("✅ Share accettata!");
-                        stats.shares_accepted++;
-                    } else {
-                        Serial.println("❌ Share rifiutata");
-                        stats.shares_rejected++;
-                    }
-                    
-                    // Incrementa extranonce2 per la prossima share
-                    extranonce2++;
-                    
-                    // Ricomincia con nuovo nonce
-                    break;
+            // Un giro di scheduling: ogni sessione mina la sua quota di nonce sul proprio header
+            for(int i = 0; i < session_count && taskRunning; i++) {
+                PoolSession* session = &sessions[i];
+                if(!session->has_job || !session->client->isConnected()) {
+                    continue;
                 }
+                uint32_t slice = (SCHED_ROUND_NONCES * session->weight) / total_weight;
+                session_mine_slice(session, slice, hash, hash_hex, &best_zeros, &hashes);
             }
+            sessions_update_share_stats();
             
             // Aggiorna hash rate ogni secondo
             uint32_t elapsed = millis() - start_time;
@@ -504,10 +871,46 @@ void miningTask(void* parameter)
             continue;
         }
         
+        // Fallback educativo dopo errore pool: riprova periodicamente la lista dei pool
+        if(pool_retry_pending && millis() - last_pool_retry >= POOL_FALLBACK_RETRY_MS) {
+            last_pool_retry = millis();
+            if(mining_connect_best_pool()) {
+                Serial.println("✅ Pool di nuovo raggiungibile, esco dalla modalità educativa");
+                currentMiningMode = MINING_MODE_POOL;
+                isEducationalFallback = false;
+                pool_retry_pending = false;
+                continue;
+            }
+        }
+        
         // MODALITÀ SOLO/EDUCATIONAL: mining classico
+        // Solo: template nuovo dal long-poll, il lavoro corrente non vale più nulla
+        if(currentMiningMode == MINING_MODE_SOLO && bitcoin_rpc_template_generation() != solo_generation) {
+            unsigned long changed_ms = bitcoin_rpc_template_changed_ms();
+            if(solo_refresh_job(&header)) {
+                stats.template_refresh_ms = millis() - changed_ms;
+                Serial.printf("🔄 Lavoro aggiornato in %u ms\n", stats.template_refresh_ms);
+            }
+            hashes = 0;
+            start_time = millis();
+        } else if(solo_retry_pending && millis() - last_solo_retry >= solo_retry_ms) {
+            // Download fallito (sul template corrente o in fallback educativo): nuovo tentativo
+            if(solo_refresh_job(&header)) {
+                Serial.println("✅ Template di nuovo scaricato");
+            }
+            hashes = 0;
+            start_time = millis();
+        }
+        
         // Incrementa il nonce per ogni tentativo
         header.nonce++;
         
+        // Solo: spazio nonce esaurito, nuovo extranonce nella coinbase e nuovo merkle root
+        if(currentMiningMode == MINING_MODE_SOLO && header.nonce == 0) {
+            solo_extranonce++;
+            solo_coinbase_roll(&solo_coinbase, &solo_template, solo_extranonce, header.merkleRoot);
+        }
+        
         // Calcola il doppio SHA-256 del block header (80 bytes)
         // Questo è il cuore del mining Bitcoin!
         double_sha256((uint8_t*)&header, sizeof(BlockHeader), hash);
@@ -523,8 +926,10 @@ void miningTask(void* parameter)
             hash_to_hex(hash, stats.best_hash);
         }
         
-        // Verifica se abbiamo trovato un hash valido
-        if(check_hash_difficulty(hash, header.bits)) {
+        // Verifica se abbiamo trovato un hash valido (solo: confronto con il vero target)
+        bool found = (currentMiningMode == MINING_MODE_SOLO) ? solo_hash_meets_target(hash, solo_target)
+                                                             : check_hash_difficulty(hash, header.bits);
+        if(found) {
             hash_to_hex(hash, hash_hex);
             blocks_found++;
             stats.blocks_found = blocks_found;  // Update global stats
@@ -543,6 +948,13 @@ void miningTask(void* parameter)
             if(currentMiningMode == MINING_MODE_POOL) {
                 Serial.println("💡 Inviando share al pool...");
                 // TODO: Implementare submit della share
+            } else if(currentMiningMode == MINING_MODE_SOLO) {
+                solo_submit_block(&header);
+                
+                // Accettato o no, il template è superato: si riparte dal nuovo (o si riprova con backoff)
+                solo_refresh_job(&header);
+                hashes = 0;
+                start_time = millis();
             } else {
                 Serial.println("💡 In un vero miner, questo blocco verrebbe inviato!");
             }
@@ -603,12 +1015,41 @@ void miningTask(void* parameter)
     Serial.printf("   Blocchi trovati: %u\n", blocks_found);
     Serial.printf("   Miglior difficoltà: %d zeri iniziali\n", best_zeros);
     
+    if(currentMiningMode == MINING_MODE_SOLO || solo_retry_pending) {
+        bitcoin_rpc_longpoll_stop();
+        solo_retry_pending = false;
+    }
+    
     // Disconnetti dal pool se connesso
-    if(currentMiningMode == MINING_MODE_POOL) {
-        stratum_disconnect();
+    if(currentMiningMode == MINING_MODE_POOL || pool_retry_pending) {
+        for(int i = 0; i < session_count; i++) {
+            PoolClient* client = sessions[i].client;
+            
+            // Traffico e costo di parsing per protocollo (confronto V1 JSON / V2 binario)
+            uint32_t messages = client->getMessagesParsed();
+            Serial.printf("   Pool %s (%s): %u B ricevuti, %u B inviati, %u messaggi, parsing %u us/msg\n",
+                          sessions[i].label.c_str(), client->protocolName(), client->getBytesReceived(),
+                          client->getBytesSent(), messages, messages ? client->getParseTimeUs() / messages : 0);
+            
+            client->disconnect();
+            sessions[i].has_job = false;
+        }
+        pool_manager_stop_probing();
+        pool_manager_set_active(-1);
+        pool_retry_pending = false;
         Serial.println("   Disconnesso dal pool");
     }
     
+    // Handshake TLS (pool stratum+ssl:// e nodo https://): completi contro ripresi
+    TlsStats tls;
+    tls_get_stats(&tls);
+    if(tls.full_handshakes + tls.resumed_handshakes + tls.failures > 0) {
+        Serial.printf("   TLS: %u completi (media %u ms), %u ripresi (media %u ms), %u falliti\n",
+                      tls.full_handshakes, tls.full_handshakes ? tls.full_ms_total / tls.full_handshakes : 0,
+                      tls.resumed_handshakes, tls.resumed_handshakes ? tls.resumed_ms_total / tls.resumed_handshakes : 0,
+                      tls.failures);
+    }
+    
     Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     Serial.println();
     
@@ -628,6 +1069,8 @@ void mining_task_start(void)
     
     // Reset statistiche
     memset(&stats, 0, sizeof(MiningStats));
+    stats.active_pool = -1;
+    current_pool_index = -1;
     
     // Create FreeRTOS task
     // Task name: "MiningTask"
@@ -691,7 +1134,8 @@ bool mining_has_found_block(void)
 }
 
 // Configura nodo Bitcoin per mining SOLO
-void mining_set_bitcoin_node(const char* host, uint16_t port, const char* user, const char* pass)
+void mining_set_bitcoin_node(const char* host, uint16_t port, const char* user, const char* pass,
+                             const char* wallet_address)
 {
     Serial.println();
     Serial.println("╔════════════════════════════════════════════════════════╗");
@@ -700,6 +1144,14 @@ void mining_set_bitcoin_node(const char* host, uint16_t port, const char* user,
     
     bitcoin_rpc_init(host, port, user, pass);
     
+    // Il blocco trovato paga la coinbase a questo indirizzo
+    solo_script_len = btc_address_to_script(wallet_address, solo_script, sizeof(solo_script));
+    if(solo_script_len > 0) {
+        Serial.printf("💳 Payout solo: %s (%s)\n", wallet_address, btc_script_type(solo_script, solo_script_len));
+    } else {
+        Serial.printf("❌ Indirizzo wallet non valido per il payout solo: %s\n", wallet_address ? wallet_address : "");
+    }
+    
     // Test connessione
     if(bitcoin_rpc_test_connection()) {
         Serial.println("✅ Nodo Bitcoin configurato correttamente!");
@@ -726,6 +1178,15 @@ void mining_set_pool(const char* pool_url_str, uint16_t port, const char* wallet
     pool_worker = worker_name ? worker_name : "esp32";
     pool_password = password ? password : "x";
     
+    // Il pool configurato è il primario della lista di failover
+    pool_manager_clear();
+    pool_manager_add(pool_url.c_str(), pool_port);
+    
+    // Nuova configurazione: solo la sessione principale, con tutto il tempo di hashing
+    session_count = 1;
+    sessions[0].label = pool_url;
+    sessions[0].weight = 100;
+    
     Serial.printf("✅ Pool configurato: %s:%d\n", pool_url.c_str(), pool_port);
     Serial.printf("   Wallet: %s\n", pool_wallet.c_str());
     Serial.printf("   Worker: %s\n", pool_worker.c_str());
@@ -733,6 +1194,97 @@ void mining_set_pool(const char* pool_url_str, uint16_t port, const char* wallet
     Serial.println();
 }
 
+// Aggiunge pool di backup alla lista di failover
+void mining_add_backup_pools(const char* pool_list)
+{
+    int first = pool_manager_count();
+    pool_manager_add_list(pool_list);
+    
+    for(int i = first; i < pool_manager_count(); i++) {
+        Serial.printf("   Backup pool #%d: %s:%u\n", i, pool_manager_get_host(i), pool_manager_get_port(i));
+    }
+}
+
+// Aggiunge un pool minato in parallelo al principale con una quota di tempo in percentuale
+bool mining_add_split_pool(const char* label, const char* pool_url_str, uint16_t port,
+                           const char* wallet_address, const char* worker_name,
+                           const char* password, uint8_t weight)
+{
+    if(weight == 0 || !pool_url_str || strlen(pool_url_str) == 0 || !wallet_address || strlen(wallet_address) == 0) {
+        return false;
+    }
+    if(session_count >= MAX_POOL_SESSIONS) {
+        Serial.printf("⚠️  Troppe sessioni pool, ignoro %s\n", label);
+        return false;
+    }
+    
+    // Al pool principale resta almeno l'1% del tempo
+    uint32_t split_total = weight;
+    for(int i = 1; i < session_count; i++) {
+        split_total += sessions[i].weight;
+    }
+    if(split_total > 99) {
+        weight -= split_total - 99;
+        split_total = 99;
+    }
+    
+    PoolSession* session = &sessions[session_count++];
+    session->label = label;
+    PoolProtocol protocol = pool_manager_parse_url(pool_url_str, session->host);
+    if(protocol == POOL_PROTOCOL_V2) {
+        session->client = &session->v2_client;
+    } else {
+        session->v1_client.setTls(protocol == POOL_PROTOCOL_V1_TLS, session->host.c_str());
+        session->client = &session->v1_client;
+    }
+    session->port = port;
+    session->wallet = wallet_address;
+    session->worker = worker_name ? worker_name : "esp32";
+    session->password = password ? password : "x";
+    session->weight = weight;
+    session->has_job = false;
+    session->hashes = 0;
+    session->shares_submitted = 0;
+    sessions[0].weight = 100 - split_total;
+    
+    Serial.printf("   Split pool %s: %s:%u (%u%%, principale %u%%)\n", label, pool_url_str, port,
+                  weight, sessions[0].weight);
+    return true;
+}
+
+// Numero di sessioni pool configurate (principale + split)
+int mining_get_session_count(void)
+{
+    return session_count;
+}
+
+// Statistiche per sessione pool
+bool mining_get_session_stats(int index, PoolSessionStats* out)
+{
+    if(!out || index < 0 || index >= session_count) {
+        return false;
+    }
+    
+    PoolSession* session = &sessions[index];
+    strncpy(out->label, session->label.c_str(), sizeof(out->label) - 1);
+    out->label[sizeof(out->label) - 1] = '\0';
+    out->weight = session->weight;
+    out->connected = session->client->isConnected();
+    out->hashes = session->hashes;
+    out->shares_submitted = session->shares_submitted;
+    out->shares_accepted = session->client->getSharesAccepted();
+    out->shares_rejected = session->client->getSharesRejected();
+    out->shares_stale = session->client->getSharesStale();
+    out->share_rtt_ms = session->client->getShareRttAvg();
+    strncpy(out->protocol, session->client->protocolName(), sizeof(out->protocol) - 1);
+    out->protocol[sizeof(out->protocol) - 1] = '\0';
+    out->bytes_received = session->client->getBytesReceived();
+    out->bytes_sent = session->client->getBytesSent();
+    out->messages_parsed = session->client->getMessagesParsed();
+    out->parse_time_us = session->client->getParseTimeUs();
+    return true;
+}
+
 // Imposta modalità mining
 void mining_set_mode(MiningMode mode)
 {
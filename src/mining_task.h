@@ -13,6 +13,31 @@ struct MiningStats {
     uint32_t shares_rejected;
     uint32_t blocks_found;  // Number of blocks found
     uint32_t block_height;  // Current block height being mined
+    int8_t active_pool;     // Index of the pool in use (-1 = none, 0 = primary)
+    uint32_t pool_switches; // Number of failover/failback switches
+    uint32_t connect_to_first_hash_ms; // Pool connect start -> first hash on its job (last session)
+    uint32_t notify_to_switch_ms;      // mining.notify received -> first hash on the new job (last)
+    uint32_t share_rtt_ms;             // Average mining.submit round trip across sessions
+    uint32_t shares_stale;             // Rejected because the job was already stale (in shares_rejected)
+    uint32_t template_refresh_ms;      // Solo: new template signalled -> first hash on it (last)
+};
+
+// Per-session statistics when hashing is split across several pools
+struct PoolSessionStats {
+    char label[32];
+    uint8_t weight;            // Share of hashing time in percent
+    bool connected;
+    uint32_t hashes;
+    uint32_t shares_submitted;
+    uint32_t shares_accepted;
+    uint32_t shares_rejected;
+    uint32_t shares_stale;
+    uint32_t share_rtt_ms;     // Average submit round trip
+    char protocol[4];          // "V1" (JSON) or "V2" (binary)
+    uint32_t bytes_received;   // Bytes on the wire, to compare protocols
+    uint32_t bytes_sent;
+    uint32_t messages_parsed;
+    uint32_t parse_time_us;    // CPU time spent decoding pool messages
 };
 
 // Mining modes
@@ -29,13 +54,26 @@ bool mining_task_is_running(void);
 MiningStats mining_get_stats(void);
 bool mining_has_found_block(void);  // Check if a block has been found
 
-// Configurazione nodo Bitcoin per mining solo
-void mining_set_bitcoin_node(const char* host, uint16_t port, const char* user, const char* pass);
+// Configurazione nodo Bitcoin per mining solo (wallet_address riceve la coinbase)
+void mining_set_bitcoin_node(const char* host, uint16_t port, const char* user, const char* pass,
+                             const char* wallet_address);
 
 // Configurazione pool per mining pool
 void mining_set_pool(const char* pool_url, uint16_t port, const char* wallet_address, 
                      const char* worker_name = nullptr, const char* password = nullptr);
 
+// Aggiunge pool di backup alla lista di failover ("host:port,host:port", in ordine)
+void mining_add_backup_pools(const char* pool_list);
+
+// Aggiunge un pool minato in parallelo al principale (weight = % del tempo di hashing)
+bool mining_add_split_pool(const char* label, const char* pool_url, uint16_t port,
+                           const char* wallet_address, const char* worker_name = nullptr,
+                           const char* password = nullptr, uint8_t weight = 50);
+
+// Statistiche per sessione pool (0 = principale)
+int mining_get_session_count(void);
+bool mining_get_session_stats(int index, PoolSessionStats* out);
+
 // Imposta modalità di mining
 void mining_set_mode(MiningMode mode);
 MiningMode mining_get_mode(void);
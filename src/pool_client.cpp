@@ -0,0 +1,44 @@
+#include "pool_client.h"
+
+PoolClient::PoolClient()
+    : difficulty(0), shares_accepted(0), shares_rejected(0), shares_stale(0),
+      bytes_received(0), bytes_sent(0), messages_parsed(0), parse_time_us(0),
+      share_rtt_last_ms(0), share_rtt_total_ms(0), share_rtt_count(0),
+      job_callback(nullptr), job_callback_arg(nullptr) {
+    clearPendingSubmits();
+}
+
+void PoolClient::setJobCallback(stratum_job_callback_t callback, void* arg) {
+    job_callback = callback;
+    job_callback_arg = arg;
+}
+
+void PoolClient::notifyJob(stratum_job_t* job) {
+    // Notifica il mining task se c'è un callback
+    if (job_callback) {
+        job_callback(job, job_callback_arg);
+    }
+}
+
+void PoolClient::submitSent(uint32_t id) {
+    PendingSubmit* slot = &pending_submits[id % STRATUM_PENDING_SUBMITS];
+    slot->id = id;
+    slot->sent_ms = millis();
+}
+
+void PoolClient::submitAnswered(uint32_t id) {
+    for (int i = 0; i < STRATUM_PENDING_SUBMITS; i++) {
+        if (pending_submits[i].id == id) {
+            share_rtt_last_ms = millis() - pending_submits[i].sent_ms;
+            share_rtt_total_ms += share_rtt_last_ms;
+            share_rtt_count++;
+            pending_submits[i].id = 0;
+            return;
+        }
+    }
+}
+
+void PoolClient::clearPendingSubmits() {
+    // Le share in volo di una sessione chiusa non riceveranno più risposta
+    memset(pending_submits, 0, sizeof(pending_submits));
+}
@@ -0,0 +1,130 @@
+#ifndef POOL_CLIENT_H
+#define POOL_CLIENT_H
+
+#include <Arduino.h>
+#include <vector>
+
+// Struttura per un job di mining Stratum (V1 e V2)
+struct stratum_job_t {
+    String job_id;
+    String prev_hash;
+    String coinb1;
+    String coinb2;
+    std::vector<String> merkle_branch;
+    String version;
+    String nbits;
+    String ntime;
+    bool clean_jobs;
+    String extranonce1;
+    int extranonce2_size;
+
+    // Stratum V2 (canale standard): merkle root e prev hash già binari in ordine header,
+    // niente coinbase né extranonce2 da gestire sul dispositivo
+    bool has_merkle_root;
+    uint8_t merkle_root[32];
+    uint8_t prev_hash_raw[32];
+};
+
+// Prefissi URL del pool: "stratum2+tcp://" seleziona Stratum V2 (senza cifratura Noise),
+// "stratum+ssl://" Stratum V1 su TLS con ripresa della sessione (tls_transport)
+#define STRATUM_V1_URL_PREFIX "stratum+tcp://"
+#define STRATUM_TLS_URL_PREFIX "stratum+ssl://"
+#define STRATUM_V2_URL_PREFIX "stratum2+tcp://"
+
+// Share inviate in attesa di risposta (per misurare il round trip)
+#define STRATUM_PENDING_SUBMITS 8
+
+// Callback quando arriva un nuovo job (arg = puntatore passato a setJobCallback)
+typedef void (*stratum_job_callback_t)(stratum_job_t* job, void* arg);
+
+// Interfaccia comune dei client pool (Stratum V1 JSON e Stratum V2 binario):
+// il mining task vede solo job e share, il protocollo resta nel client
+class PoolClient {
+public:
+    PoolClient();
+    virtual ~PoolClient() {}
+
+    // Inizializza il client
+    virtual void init(const char* pool_url, uint16_t port, const char* wallet_address,
+                      const char* worker_name = nullptr, const char* password = nullptr) = 0;
+
+    // Connetti al pool
+    virtual bool connect() = 0;
+
+    // Disconnetti dal pool
+    virtual void disconnect() = 0;
+
+    // Controlla se connesso
+    virtual bool isConnected() = 0;
+
+    // Loop principale - chiamare regolarmente per gestire messaggi
+    virtual void loop() = 0;
+
+    // Invia una share al pool
+    virtual bool submitShare(const char* job_id, const char* extranonce2,
+                             const char* ntime, const char* nonce) = 0;
+
+    // Nome del protocollo (per log e statistiche)
+    virtual const char* protocolName() const = 0;
+
+    // Imposta callback per nuovi job
+    void setJobCallback(stratum_job_callback_t callback, void* arg);
+
+    // Ottieni difficoltà corrente
+    uint32_t getDifficulty() const { return difficulty; }
+
+    // Share confermate o rifiutate dal pool
+    uint32_t getSharesAccepted() const { return shares_accepted; }
+    uint32_t getSharesRejected() const { return shares_rejected; }
+
+    // Share rifiutate perché il job era già scaduto (incluse nelle rifiutate)
+    uint32_t getSharesStale() const { return shares_stale; }
+
+    // Round trip submit -> risposta del pool
+    uint32_t getShareRttLast() const { return share_rtt_last_ms; }
+    uint32_t getShareRttAvg() const { return share_rtt_count ? share_rtt_total_ms / share_rtt_count : 0; }
+    uint32_t getShareRttSamples() const { return share_rtt_count; }
+
+    // Traffico e costo di parsing (per confrontare V1 e V2)
+    uint32_t getBytesReceived() const { return bytes_received; }
+    uint32_t getBytesSent() const { return bytes_sent; }
+    uint32_t getMessagesParsed() const { return messages_parsed; }
+    uint32_t getParseTimeUs() const { return parse_time_us; }
+
+protected:
+    // Registra una share inviata / la sua risposta (aggiorna il round trip)
+    void submitSent(uint32_t id);
+    void submitAnswered(uint32_t id);
+    void clearPendingSubmits();
+
+    // Passa il job al mining task
+    void notifyJob(stratum_job_t* job);
+
+    uint32_t difficulty;
+
+    uint32_t shares_accepted;
+    uint32_t shares_rejected;
+    uint32_t shares_stale;
+
+    uint32_t bytes_received;
+    uint32_t bytes_sent;
+    uint32_t messages_parsed;
+    uint32_t parse_time_us;
+
+private:
+    // Submit in volo: id della richiesta e istante di invio (id 0 = slot libero)
+    struct PendingSubmit {
+        uint32_t id;
+        uint32_t sent_ms;
+    };
+    PendingSubmit pending_submits[STRATUM_PENDING_SUBMITS];
+    uint32_t share_rtt_last_ms;
+    uint32_t share_rtt_total_ms;
+    uint32_t share_rtt_count;
+
+    // Callback per mining task
+    stratum_job_callback_t job_callback;
+    void* job_callback_arg;
+};
+
+#endif // POOL_CLIENT_H
@@ -0,0 +1,342 @@
+#include "pool_manager.h"
+#include "pool_client.h"
+#include <WiFi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Probe configuration
+#define POOL_PROBE_INTERVAL_MS 30000   // Time between probe rounds
+#define POOL_PROBE_TIMEOUT_MS  3000    // TCP connect timeout for a probe
+#define POOL_DNS_TTL_MS        600000  // Re-resolve hostnames every 10 minutes
+#define POOL_FAILS_UNHEALTHY   2       // Consecutive failures before a pool is unhealthy
+
+struct PoolEntry {
+    char host[128];
+    uint16_t port;
+    PoolProtocol protocol;
+    IPAddress ip;
+    unsigned long resolvedAt;
+    bool resolved;
+    bool healthy;
+    uint32_t rttMs;
+    uint32_t probeFailures;
+    uint32_t timeActiveMs;
+};
+
+static PoolEntry pools[POOL_MAX_ENTRIES];
+static int poolCount = 0;
+
+// Active pool accounting
+static int activePool = -1;
+static int lastActivePool = -1;
+static unsigned long activeSince = 0;
+static uint32_t poolSwitches = 0;
+
+// Probe task
+static TaskHandle_t probeTaskHandle = NULL;
+static volatile bool probeRunning = false;
+
+// Protects the entries shared between the mining task and the probe task
+static portMUX_TYPE poolMux = portMUX_INITIALIZER_UNLOCKED;
+
+void pool_manager_clear(void) {
+    portENTER_CRITICAL(&poolMux);
+    for (int i = 0; i < POOL_MAX_ENTRIES; i++) {
+        pools[i] = PoolEntry();
+    }
+    poolCount = 0;
+    activePool = -1;
+    lastActivePool = -1;
+    activeSince = 0;
+    poolSwitches = 0;
+    portEXIT_CRITICAL(&poolMux);
+}
+
+PoolProtocol pool_manager_parse_url(const char* url, String& host) {
+    host = url ? url : "";
+    if (host.startsWith(STRATUM_V2_URL_PREFIX)) {
+        host = host.substring(strlen(STRATUM_V2_URL_PREFIX));
+        return POOL_PROTOCOL_V2;
+    }
+    if (host.startsWith(STRATUM_TLS_URL_PREFIX)) {
+        host = host.substring(strlen(STRATUM_TLS_URL_PREFIX));
+        return POOL_PROTOCOL_V1_TLS;
+    }
+    if (host.startsWith(STRATUM_V1_URL_PREFIX)) {
+        host = host.substring(strlen(STRATUM_V1_URL_PREFIX));
+    }
+    return POOL_PROTOCOL_V1;
+}
+
+bool pool_manager_add(const char* url, uint16_t port) {
+    String hostName;
+    PoolProtocol protocol = pool_manager_parse_url(url, hostName);
+    const char* host = hostName.c_str();
+    if (strlen(host) == 0 || port == 0) {
+        return false;
+    }
+    if (poolCount >= POOL_MAX_ENTRIES) {
+        Serial.printf("⚠️  Pool list full, ignoring %s:%u\n", host, port);
+        return false;
+    }
+    if (strlen(host) >= sizeof(pools[0].host)) {
+        Serial.printf("⚠️  Pool host too long, ignoring %s\n", host);
+        return false;
+    }
+
+    portENTER_CRITICAL(&poolMux);
+    PoolEntry& entry = pools[poolCount];
+    entry = PoolEntry();
+    strcpy(entry.host, host);
+    entry.port = port;
+    entry.protocol = protocol;
+    entry.healthy = true;  // Optimistic until the first probe says otherwise
+    poolCount++;
+    portEXIT_CRITICAL(&poolMux);
+
+    return true;
+}
+
+int pool_manager_add_list(const char* list) {
+    if (!list) {
+        return 0;
+    }
+
+    int added = 0;
+    String items = String(list);
+    int start = 0;
+    while (start < (int)items.length()) {
+        int comma = items.indexOf(',', start);
+        if (comma == -1) {
+            comma = items.length();
+        }
+        String item = items.substring(start, comma);
+        item.trim();
+        start = comma + 1;
+
+        int colon = item.lastIndexOf(':');
+        if (colon <= 0) {
+            continue;
+        }
+        String host = item.substring(0, colon);
+        int port = item.substring(colon + 1).toInt();
+        if (port > 0 && port <= 65535 && pool_manager_add(host.c_str(), (uint16_t)port)) {
+            added++;
+        }
+    }
+    return added;
+}
+
+int pool_manager_count(void) {
+    return poolCount;
+}
+
+const char* pool_manager_get_host(int index) {
+    if (index < 0 || index >= poolCount) {
+        return "";
+    }
+    return pools[index].host;
+}
+
+uint16_t pool_manager_get_port(int index) {
+    if (index < 0 || index >= poolCount) {
+        return 0;
+    }
+    return pools[index].port;
+}
+
+PoolProtocol pool_manager_get_protocol(int index) {
+    if (index < 0 || index >= poolCount) {
+        return POOL_PROTOCOL_V1;
+    }
+    return pools[index].protocol;
+}
+
+bool pool_manager_resolve(int index, IPAddress& ip) {
+    if (index < 0 || index >= poolCount) {
+        return false;
+    }
+
+    PoolEntry& entry = pools[index];
+    unsigned long now = millis();
+
+    portENTER_CRITICAL(&poolMux);
+    bool fresh = entry.resolved && (now - entry.resolvedAt < POOL_DNS_TTL_MS);
+    IPAddress cached = entry.ip;
+    bool haveCached = entry.resolved;
+    portEXIT_CRITICAL(&poolMux);
+
+    if (fresh) {
+        ip = cached;
+        return true;
+    }
+
+    // Numeric addresses never need a lookup
+    IPAddress resolved;
+    if (!resolved.fromString(entry.host) && !WiFi.hostByName(entry.host, resolved)) {
+        if (haveCached) {
+            // Keep mining on the last known address if DNS is temporarily down
+            ip = cached;
+            return true;
+        }
+        return false;
+    }
+
+    portENTER_CRITICAL(&poolMux);
+    entry.ip = resolved;
+    entry.resolvedAt = now;
+    entry.resolved = true;
+    portEXIT_CRITICAL(&poolMux);
+
+    ip = resolved;
+    return true;
+}
+
+// Probe one pool with a TCP connect and record the round trip
+static void pool_probe(int index) {
+    IPAddress ip;
+    bool ok = false;
+    uint32_t rtt = 0;
+
+    if (pool_manager_resolve(index, ip)) {
+        WiFiClient probe;
+        unsigned long start = millis();
+        ok = probe.connect(ip, pools[index].port, POOL_PROBE_TIMEOUT_MS);
+        rtt = millis() - start;
+        probe.stop();
+    }
+
+    portENTER_CRITICAL(&poolMux);
+    PoolEntry& entry = pools[index];
+    if (ok) {
+        entry.rttMs = rtt;
+        entry.probeFailures = 0;
+        entry.healthy = true;
+    } else {
+        entry.probeFailures++;
+        if (entry.probeFailures >= POOL_FAILS_UNHEALTHY) {
+            entry.healthy = false;
+        }
+    }
+    portEXIT_CRITICAL(&poolMux);
+}
+
+static void poolProbeTask(void* parameter) {
+    while (probeRunning) {
+        if (WiFi.status() == WL_CONNECTED) {
+            for (int i = 0; i < poolCount && probeRunning; i++) {
+                pool_probe(i);
+            }
+        }
+
+        // Sleep in short steps so stop requests are served quickly
+        for (int waited = 0; waited < POOL_PROBE_INTERVAL_MS && probeRunning; waited += 250) {
+            vTaskDelay(250 / portTICK_PERIOD_MS);
+        }
+    }
+
+    probeTaskHandle = NULL;
+    vTaskDelete(NULL);
+}
+
+void pool_manager_start_probing(void) {
+    if (probeTaskHandle != NULL || poolCount == 0) {
+        return;
+    }
+
+    probeRunning = true;
+
+    // Core 0 together with WiFi, so the mining core never blocks on probes
+    xTaskCreatePinnedToCore(
+        poolProbeTask,        // Task function
+        "PoolProbe",          // Task name
+        4096,                 // Stack size (bytes)
+        NULL,                 // Task parameter
+        1,                    // Priority (1 = low)
+        &probeTaskHandle,     // Task handle
+        0                     // Core ID
+    );
+}
+
+void pool_manager_stop_probing(void) {
+    if (probeTaskHandle == NULL) {
+        return;
+    }
+
+    probeRunning = false;
+    while (probeTaskHandle != NULL) {
+        vTaskDelay(50 / portTICK_PERIOD_MS);
+    }
+}
+
+bool pool_manager_is_healthy(int index) {
+    if (index < 0 || index >= poolCount) {
+        return false;
+    }
+    portENTER_CRITICAL(&poolMux);
+    bool healthy = pools[index].healthy;
+    portEXIT_CRITICAL(&poolMux);
+    return healthy;
+}
+
+void pool_manager_mark_failed(int index) {
+    if (index < 0 || index >= poolCount) {
+        return;
+    }
+    // A failed session counts as an unhealthy probe until the prober sees it again
+    portENTER_CRITICAL(&poolMux);
+    pools[index].healthy = false;
+    pools[index].probeFailures = POOL_FAILS_UNHEALTHY;
+    portEXIT_CRITICAL(&poolMux);
+}
+
+void pool_manager_set_active(int index) {
+    unsigned long now = millis();
+
+    portENTER_CRITICAL(&poolMux);
+    if (activePool >= 0 && activePool < poolCount) {
+        pools[activePool].timeActiveMs += now - activeSince;
+    }
+    // A switch is a change of pool, reconnecting to the same one is not
+    if (index >= 0) {
+        if (lastActivePool >= 0 && index != lastActivePool) {
+            poolSwitches++;
+        }
+        lastActivePool = index;
+    }
+    activePool = index;
+    activeSince = now;
+    portEXIT_CRITICAL(&poolMux);
+}
+
+int pool_manager_get_active(void) {
+    return activePool;
+}
+
+uint32_t pool_manager_get_switches(void) {
+    return poolSwitches;
+}
+
+bool pool_manager_get_stats(int index, PoolStats* out) {
+    if (!out || index < 0 || index >= poolCount) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&poolMux);
+    const PoolEntry& entry = pools[index];
+    memcpy(out->host, entry.host, sizeof(out->host));
+    out->port = entry.port;
+    out->healthy = entry.healthy;
+    out->rtt_ms = entry.rttMs;
+    out->probe_failures = entry.probeFailures;
+    out->time_active_ms = entry.timeActiveMs;
+    unsigned long now = millis();
+    if (index == activePool) {
+        out->time_active_ms += now - activeSince;
+    }
+    out->dns_age_ms = entry.resolved ? now - entry.resolvedAt : 0;
+    out->dns_cached = entry.resolved && out->dns_age_ms < POOL_DNS_TTL_MS;
+    portEXIT_CRITICAL(&poolMux);
+
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef POOL_MANAGER_H
+#define POOL_MANAGER_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+// Maximum number of pools in the failover list (primary + backups)
+#define POOL_MAX_ENTRIES 4
+
+// Pool protocol, selected by the URL prefix (plain "host" = Stratum V1)
+enum PoolProtocol {
+    POOL_PROTOCOL_V1,
+    POOL_PROTOCOL_V1_TLS,     // "stratum+ssl://host"
+    POOL_PROTOCOL_V2
+};
+
+// Split "stratum2+tcp://host" into protocol and bare host name
+PoolProtocol pool_manager_parse_url(const char* url, String& host);
+
+// Per-pool health and usage statistics
+struct PoolStats {
+    char host[128];
+    uint16_t port;
+    bool healthy;             // Last probes succeeded
+    uint32_t rtt_ms;          // Last TCP connect round trip (0 = never measured)
+    uint32_t probe_failures;  // Consecutive failed probes
+    uint32_t time_active_ms;  // Total time spent mining on this pool
+    bool dns_cached;          // Resolved address still within POOL_DNS_TTL_MS
+    uint32_t dns_age_ms;      // Time since the last resolution (0 = never resolved)
+};
+
+// Pool list management (index 0 = primary, higher index = lower priority)
+void pool_manager_clear(void);
+bool pool_manager_add(const char* host, uint16_t port);
+int pool_manager_count(void);
+const char* pool_manager_get_host(int index);
+uint16_t pool_manager_get_port(int index);
+PoolProtocol pool_manager_get_protocol(int index);
+
+// Parse a "host:port,host:port" list and append the entries
+int pool_manager_add_list(const char* list);
+
+// Cached DNS resolution (refreshed after POOL_DNS_TTL_MS)
+bool pool_manager_resolve(int index, IPAddress& ip);
+
+// Background TCP/RTT probing task (core 0)
+void pool_manager_start_probing(void);
+void pool_manager_stop_probing(void);
+
+// Health tracking
+bool pool_manager_is_healthy(int index);
+void pool_manager_mark_failed(int index);
+
+// Active pool tracking (time accounting and switch events)
+void pool_manager_set_active(int index);
+int pool_manager_get_active(void);
+uint32_t pool_manager_get_switches(void);
+bool pool_manager_get_stats(int index, PoolStats* out);
+
+#endif // POOL_MANAGER_H
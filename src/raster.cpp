@@ -0,0 +1,230 @@
+#include "raster.h"
+#include <math.h>
+#include <string.h>
+
+// 32-bit stores into the 16-bit framebuffer
+typedef uint32_t __attribute__((may_alias)) raster_pair_t;
+
+void raster_fill(uint16_t* dst, size_t count, uint16_t color) {
+    if ((color >> 8) == (color & 0xFF)) {
+        memset(dst, color & 0xFF, count * sizeof(uint16_t));
+        return;
+    }
+    if (count > 0 && ((uintptr_t)dst & 2)) {
+        *dst++ = color;
+        count--;
+    }
+    raster_pair_t* pairs = (raster_pair_t*)dst;
+    raster_pair_t pair = color | (uint32_t)color << 16;
+    for (size_t i = 0; i < count / 2; i++) {
+        pairs[i] = pair;
+    }
+    if (count & 1) {
+        dst[count - 1] = color;
+    }
+}
+
+void raster_fill_rect(const raster_target_t* target, int x, int y, int w, int h, uint16_t color) {
+    int x0 = x < 0 ? 0 : x;
+    int y0 = y < 0 ? 0 : y;
+    int x1 = x + w > target->width ? target->width : x + w;
+    int y1 = y + h > target->height ? target->height : y + h;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+    uint16_t* row = target->pixels + (size_t)y0 * target->width + x0;
+    if (x0 == 0 && x1 == target->width) {
+        raster_fill(row, (size_t)(y1 - y0) * target->width, color);
+        return;
+    }
+    for (int r = y0; r < y1; r++) {
+        raster_fill(row, x1 - x0, color);
+        row += target->width;
+    }
+}
+
+void raster_rect(const raster_target_t* target, int x, int y, int w, int h, uint16_t color) {
+    raster_fill_rect(target, x, y, w, 1, color);
+    raster_fill_rect(target, x, y + h - 1, w, 1, color);
+    raster_fill_rect(target, x, y, 1, h, color);
+    raster_fill_rect(target, x + w - 1, y, 1, h, color);
+}
+
+// ---------------------------------------------------------------------------
+// Corner tables
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    int radius;                            // 0 = free
+    int16_t inset[RASTER_MAX_RADIUS + 1];
+} inset_entry_t;
+
+typedef struct {
+    int radius;                            // 0 = free
+    int stroke;
+    uint64_t rows[RASTER_MAX_RADIUS + 1];  // Bit c of row j: arc pixel at (c, j) from the corner
+} arc_entry_t;
+
+static inset_entry_t inset_cache[RASTER_CORNER_CACHE];
+static int inset_next = 0;
+static arc_entry_t arc_cache[RASTER_CORNER_CACHE];
+static int arc_next = 0;
+
+static int compute_inset(int radius, int k) {
+    return radius - (int)sqrt(radius * radius - k * k);
+}
+
+int raster_corner_inset(int radius, int k) {
+    if (radius <= 0 || radius > RASTER_MAX_RADIUS) {
+        return compute_inset(radius, k);
+    }
+    for (int i = 0; i < RASTER_CORNER_CACHE; i++) {
+        if (inset_cache[i].radius == radius) {
+            return inset_cache[i].inset[k];
+        }
+    }
+    inset_entry_t* entry = &inset_cache[inset_next];
+    inset_next = (inset_next + 1) % RASTER_CORNER_CACHE;
+    entry->radius = radius;
+    for (int j = 0; j <= radius; j++) {
+        entry->inset[j] = (int16_t)compute_inset(radius, j);
+    }
+    return entry->inset[k];
+}
+
+// Arc pixels of the outline layers, as offsets from the top-left corner of the
+// outer rectangle. Layer s is inset by s with radius radius - s, and all its
+// arc points land within radius of the corner.
+typedef void (*arc_point_fn)(void* ctx, int col, int row);
+
+static void for_each_arc_point(int radius, int stroke, arc_point_fn fn, void* ctx) {
+    for (int s = 0; s < stroke && s < radius; s++) {
+        int ro = radius - s;
+        int f = 1 - ro;
+        int ddF_x = 1;
+        int ddF_y = -2 * ro;
+        int px = 0;
+        int py = ro;
+        while (px < py) {
+            if (f >= 0) {
+                py--;
+                ddF_y += 2;
+                f += ddF_y;
+            }
+            px++;
+            ddF_x += 2;
+            f += ddF_x;
+            fn(ctx, radius - px, radius - py);
+            fn(ctx, radius - py, radius - px);
+        }
+    }
+}
+
+static void set_arc_bit(void* ctx, int col, int row) {
+    ((uint64_t*)ctx)[row] |= (uint64_t)1 << col;
+}
+
+static const uint64_t* arc_rows(int radius, int stroke) {
+    for (int i = 0; i < RASTER_CORNER_CACHE; i++) {
+        if (arc_cache[i].radius == radius && arc_cache[i].stroke == stroke) {
+            return arc_cache[i].rows;
+        }
+    }
+    arc_entry_t* entry = &arc_cache[arc_next];
+    arc_next = (arc_next + 1) % RASTER_CORNER_CACHE;
+    entry->radius = radius;
+    entry->stroke = stroke;
+    memset(entry->rows, 0, sizeof(entry->rows));
+    for_each_arc_point(radius, stroke, set_arc_bit, entry->rows);
+    return entry->rows;
+}
+
+typedef struct {
+    const raster_target_t* target;
+    int x, y, w, h;
+    uint16_t color;
+} corner_ctx_t;
+
+// A run of arc pixels on row j of the top-left corner, mirrored into all four
+static void fill_corner_run(const corner_ctx_t* c, int col0, int col1, int j) {
+    int len = col1 - col0 + 1;
+    raster_fill_rect(c->target, c->x + col0, c->y + j, len, 1, c->color);
+    raster_fill_rect(c->target, c->x + c->w - 1 - col1, c->y + j, len, 1, c->color);
+    raster_fill_rect(c->target, c->x + col0, c->y + c->h - 1 - j, len, 1, c->color);
+    raster_fill_rect(c->target, c->x + c->w - 1 - col1, c->y + c->h - 1 - j, len, 1, c->color);
+}
+
+static void put_corner_point(void* ctx, int col, int row) {
+    fill_corner_run((const corner_ctx_t*)ctx, col, col, row);
+}
+
+void raster_round_rect(const raster_target_t* target, int x, int y, int w, int h, int radius, int stroke,
+                       uint16_t color) {
+    if (radius < 0) {
+        radius = 0;
+    }
+
+    // Top and bottom edges: layer s spans the columns outside both arcs
+    for (int s = 0; s < stroke; s++) {
+        int indent = s > radius ? s : radius;
+        raster_fill_rect(target, x + indent, y + s, w - 2 * indent, 1, color);
+        raster_fill_rect(target, x + indent, y + h - 1 - s, w - 2 * indent, 1, color);
+    }
+
+    // Left and right edges: between the arcs, row j has the layers s <= j from both ends
+    for (int j = radius; j <= h - 1 - radius; j++) {
+        int band = stroke;
+        if (j + 1 < band) {
+            band = j + 1;
+        }
+        if (h - j < band) {
+            band = h - j;
+        }
+        raster_fill_rect(target, x, y + j, band, 1, color);
+        raster_fill_rect(target, x + w - band, y + j, band, 1, color);
+    }
+
+    // Corners
+    corner_ctx_t ctx = {target, x, y, w, h, color};
+    if (radius > RASTER_MAX_RADIUS) {
+        for_each_arc_point(radius, stroke, put_corner_point, &ctx);
+        return;
+    }
+    const uint64_t* rows = arc_rows(radius, stroke);
+    for (int j = 0; j <= radius; j++) {
+        uint64_t bits = rows[j];
+        int col = 0;
+        while (bits) {
+            while (!(bits & 1)) {
+                bits >>= 1;
+                col++;
+            }
+            int start = col;
+            while (bits & 1) {
+                bits >>= 1;
+                col++;
+            }
+            fill_corner_run(&ctx, start, col - 1, j);
+        }
+    }
+}
+
+void raster_glyph(const raster_target_t* target, int x, int y, const uint8_t* bitmap, int scale, uint16_t color) {
+    for (int row = 0; row < 8; row++) {
+        uint8_t line = bitmap[row];
+        int col = 0;
+        while (line) {
+            // Bit 7 is the left column
+            while (!(line & 0x80)) {
+                line <<= 1;
+                col++;
+            }
+            int start = col;
+            while (line & 0x80) {
+                line <<= 1;
+                col++;
+            }
+            raster_fill_rect(target, x + start * scale, y + row * scale, (col - start) * scale, scale, color);
+        }
+    }
+}
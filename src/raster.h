@@ -0,0 +1,43 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Span-based drawing into a 16-bit framebuffer. Each primitive is clipped
+// once and then fills whole rows with 32-bit stores, instead of writing and
+// bounds-checking one pixel at a time. Rounded corners come from tables
+// computed once per radius (and stroke width) and kept in a small cache.
+// Plain C++ with no Arduino dependencies.
+
+#define RASTER_MAX_RADIUS 32           // Larger corners are computed on every call
+#define RASTER_CORNER_CACHE 4          // Radii (or radius and stroke pairs) kept
+
+typedef struct {
+    uint16_t* pixels;
+    int width;
+    int height;
+} raster_target_t;
+
+// count pixels of color from dst
+void raster_fill(uint16_t* dst, size_t count, uint16_t color);
+
+// Filled rectangle, clipped to the target
+void raster_fill_rect(const raster_target_t* target, int x, int y, int w, int h, uint16_t color);
+
+// Rectangle outline, 1 pixel wide
+void raster_rect(const raster_target_t* target, int x, int y, int w, int h, uint16_t color);
+
+// Pixels cut from each side of row k of a filled corner of the given radius,
+// k = 0 at the corner's flat edge: radius - (int)sqrt(radius^2 - k^2)
+int raster_corner_inset(int radius, int k);
+
+// Rounded rectangle outline, stroke pixels thick and drawn inwards. Same
+// pixels as stacking stroke 1-pixel outlines with a Bresenham arc each.
+void raster_round_rect(const raster_target_t* target, int x, int y, int w, int h, int radius, int stroke,
+                       uint16_t color);
+
+// 8x8 bitmap (bit 7 = left column) with every pixel drawn as a scale x scale block
+void raster_glyph(const raster_target_t* target, int x, int y, const uint8_t* bitmap, int scale, uint16_t color);
+
+#endif // RASTER_H
@@ -0,0 +1,123 @@
+#include "rpc_batch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+size_t rpc_batch_request(char* out, size_t size, const rpc_call_t* calls, int count) {
+    if (size == 0 || count < 1 || count > RPC_BATCH_MAX) {
+        return 0;
+    }
+    size_t used = 0;
+    for (int i = 0; i < count; i++) {
+        int n = snprintf(out + used, size - used, "%c{\"jsonrpc\":\"1.0\",\"id\":%d,\"method\":\"%s\",\"params\":%s}",
+                         i == 0 ? '[' : ',', i, calls[i].method, calls[i].params ? calls[i].params : "[]");
+        if (n < 0 || (size_t)n >= size - used) {
+            out[0] = 0;
+            return 0;
+        }
+        used += n;
+    }
+    if (used + 2 > size) {
+        out[0] = 0;
+        return 0;
+    }
+    out[used++] = ']';
+    out[used] = 0;
+    return used;
+}
+
+static void copy_message(char* out, const char* value) {
+    strncpy(out, value, RPC_BATCH_MESSAGE_MAX - 1);
+    out[RPC_BATCH_MESSAGE_MAX - 1] = 0;
+}
+
+static void on_json(json_stream_t* js, json_event_t event, const char* value, size_t len, void* arg) {
+    rpc_batch_reader_t* reader = (rpc_batch_reader_t*)arg;
+
+    // Risposta singola invece dell'array: il nodo ha rifiutato tutta la richiesta
+    if (js->depth == 0) {
+        reader->not_array |= event != JSON_EVENT_BEGIN_ARRAY && event != JSON_EVENT_END_ARRAY;
+        return;
+    }
+    if (!js->levels[0].is_array) {
+        if (event == JSON_EVENT_STRING && js->depth == 2 && strcmp(json_stream_key(js, 0), "error") == 0 &&
+            strcmp(json_stream_key(js, 1), "message") == 0) {
+            copy_message(reader->rpc_message, value);
+        }
+        return;
+    }
+
+    uint32_t element = json_stream_index(js, 0);
+    if (element >= (uint32_t)reader->count) {
+        reader->bad_id = true;
+        return;
+    }
+    rpc_batch_reply_t* reply = &reader->replies[element];
+
+    // Inizio e fine di un elemento: la risposta conta solo con l'id della sua posizione
+    if (js->depth == 1) {
+        if (event == JSON_EVENT_BEGIN_OBJECT) {
+            reader->element_id = -1;
+        } else if (event == JSON_EVENT_END_OBJECT) {
+            if (reader->element_id == (int)element) {
+                reply->answered = true;
+            } else {
+                reader->bad_id = true;
+            }
+        } else {
+            reader->bad_id = true;      // Elemento che non è un oggetto
+        }
+        return;
+    }
+
+    const char* member = json_stream_key(js, 1);
+    if (js->depth == 2 && strcmp(member, "id") == 0) {
+        reader->element_id = event == JSON_EVENT_NUMBER ? atoi(value) : -2;
+        return;
+    }
+    if (strcmp(member, "error") == 0) {
+        if (js->depth == 2 && event != JSON_EVENT_NULL && event != JSON_EVENT_END_OBJECT &&
+            event != JSON_EVENT_END_ARRAY) {
+            reply->error = true;
+        } else if (js->depth == 3 && event == JSON_EVENT_STRING && strcmp(json_stream_key(js, 2), "message") == 0) {
+            copy_message(reply->message, value);
+        }
+        return;
+    }
+    if (strcmp(member, "result") == 0 && reader->callback) {
+        reader->callback((int)element, js, event, value, len, reader->arg);
+    }
+}
+
+void rpc_batch_reader_init(rpc_batch_reader_t* reader, int count, rpc_batch_callback_t callback, void* arg) {
+    memset(reader, 0, sizeof(*reader));
+    reader->count = count < 0 ? 0 : count > RPC_BATCH_MAX ? RPC_BATCH_MAX : count;
+    reader->callback = callback;
+    reader->arg = arg;
+    reader->element_id = -1;
+    json_stream_init(&reader->json, on_json, reader);
+}
+
+bool rpc_batch_reader_feed(rpc_batch_reader_t* reader, const char* data, size_t len) {
+    return json_stream_feed(&reader->json, data, len);
+}
+
+bool rpc_batch_reader_finish(rpc_batch_reader_t* reader) {
+    if (!json_stream_done(&reader->json) || reader->not_array || reader->bad_id) {
+        return false;
+    }
+    for (int i = 0; i < reader->count; i++) {
+        if (!reader->replies[i].answered) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* rpc_batch_reader_error(const rpc_batch_reader_t* reader) {
+    if (reader->json.error) return reader->json.error;
+    if (reader->not_array) return reader->rpc_message[0] ? reader->rpc_message : "risposta non è un batch";
+    if (!json_stream_done(&reader->json)) return "risposta troncata";
+    if (reader->bad_id) return "id fuori ordine";
+    return "risposte mancanti";
+}
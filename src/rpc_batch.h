@@ -0,0 +1,62 @@
+#ifndef RPC_BATCH_H
+#define RPC_BATCH_H
+
+#include "json_stream.h"
+
+// Batch JSON-RPC: più chiamate in una sola richiesta HTTP, un solo giro di
+// rete. La richiesta è un array di chiamate con id 0, 1, 2... e la risposta
+// un array di risposte, letto in streaming come getblocktemplate: ogni valore
+// dentro un "result" arriva al callback con l'indice della sua chiamata, senza
+// mai tenere in RAM il documento. bitcoind risponde nell'ordine delle
+// chiamate: un id fuori posto rende il batch non valido.
+// C++ puro senza Arduino: lo stesso codice gira sull'host nei tool.
+
+#define RPC_BATCH_MAX 8
+#define RPC_BATCH_MESSAGE_MAX 64
+
+typedef struct {
+    const char* method;
+    const char* params;                       // Array JSON, NULL = []
+} rpc_call_t;
+
+// Valore dentro il result della chiamata call. Il percorso relativo al result
+// è levels[2..depth-1]: json_stream_key(js, 2) è il primo campo (depth 2 =
+// result scalare, es. getbestblockhash).
+typedef void (*rpc_batch_callback_t)(int call, json_stream_t* js, json_event_t event, const char* value,
+                                     size_t len, void* arg);
+
+typedef struct {
+    bool answered;                            // Risposta completa con l'id giusto
+    bool error;                               // error non null
+    char message[RPC_BATCH_MESSAGE_MAX];      // error.message del nodo
+} rpc_batch_reply_t;
+
+typedef struct {
+    json_stream_t json;
+    rpc_batch_callback_t callback;
+    void* arg;
+    int count;
+    rpc_batch_reply_t replies[RPC_BATCH_MAX];
+
+    int element_id;                           // id letto nell'elemento corrente (-1 = nessuno)
+    bool not_array;                           // Risposta singola: errore sull'intera richiesta
+    bool bad_id;                              // id fuori posto o elementi in più
+    char rpc_message[RPC_BATCH_MESSAGE_MAX];  // error.message della risposta singola
+} rpc_batch_reader_t;
+
+// Corpo della richiesta in out (terminato da NUL). Ritorna la lunghezza, 0 se non ci sta.
+size_t rpc_batch_request(char* out, size_t size, const rpc_call_t* calls, int count);
+
+void rpc_batch_reader_init(rpc_batch_reader_t* reader, int count, rpc_batch_callback_t callback, void* arg);
+
+// Blocco successivo del corpo HTTP. false se il JSON è malformato.
+bool rpc_batch_reader_feed(rpc_batch_reader_t* reader, const char* data, size_t len);
+
+// true se il documento è completo e ogni chiamata ha la sua risposta
+// (con result o error: vedere replies[i].error)
+bool rpc_batch_reader_finish(rpc_batch_reader_t* reader);
+
+// Descrizione dell'errore dopo un fallimento
+const char* rpc_batch_reader_error(const rpc_batch_reader_t* reader);
+
+#endif // RPC_BATCH_H
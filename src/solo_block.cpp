@@ -0,0 +1,246 @@
+#include "solo_block.h"
+#include <string.h>
+
+// Scrittura sequenziale nella coinbase con controllo dello spazio
+typedef struct {
+    solo_coinbase_t* cb;
+    bool overflow;
+} cb_writer_t;
+
+static void put(cb_writer_t* w, const void* data, size_t len) {
+    if (w->cb->len + len > SOLO_COINBASE_MAX) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->cb->data + w->cb->len, data, len);
+    w->cb->len += len;
+}
+
+static void put_byte(cb_writer_t* w, uint8_t value) {
+    put(w, &value, 1);
+}
+
+static void put_le(cb_writer_t* w, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        put_byte(w, (uint8_t)(value >> (i * 8)));
+    }
+}
+
+// Varint di Bitcoin (CompactSize) in buf, ritorna la lunghezza
+static size_t varint(uint64_t value, uint8_t buf[9]) {
+    if (value < 0xfd) {
+        buf[0] = (uint8_t)value;
+        return 1;
+    }
+    int bytes = value <= 0xffff ? 2 : value <= 0xffffffffULL ? 4 : 8;
+    buf[0] = bytes == 2 ? 0xfd : bytes == 4 ? 0xfe : 0xff;
+    for (int i = 0; i < bytes; i++) {
+        buf[1 + i] = (uint8_t)(value >> (i * 8));
+    }
+    return 1 + bytes;
+}
+
+// Altezza come la scrive Bitcoin Core (CScript() << height): OP_0, OP_1..OP_16,
+// altrimenti push del numero little endian minimo con bit di segno libero.
+// BIP34 richiede che lo scriptSig della coinbase inizi esattamente così.
+static void put_height(cb_writer_t* w, uint32_t height) {
+    if (height == 0) {
+        put_byte(w, 0x00);
+        return;
+    }
+    if (height <= 16) {
+        put_byte(w, (uint8_t)(0x50 + height));
+        return;
+    }
+    uint8_t num[5];
+    int len = 0;
+    while (height) {
+        num[len++] = height & 0xff;
+        height >>= 8;
+    }
+    if (num[len - 1] & 0x80) {
+        num[len++] = 0x00;
+    }
+    put_byte(w, (uint8_t)len);
+    put(w, num, len);
+}
+
+bool solo_coinbase_build(solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl, const uint8_t* script,
+                         int script_len) {
+    memset(cb, 0, sizeof(*cb));
+    cb_writer_t w = {cb, false};
+    static const uint8_t null_prevout[32] = {0};
+    static const char tag[] = SOLO_COINBASE_TAG;
+
+    put_le(&w, 2, 4);                       // Versione
+    put_byte(&w, 1);                        // Un input senza prevout
+    put(&w, null_prevout, 32);
+    put_le(&w, 0xffffffff, 4);
+
+    // scriptSig: altezza BIP34, extranonce, tag
+    cb_writer_t script_sig = {cb, false};
+    size_t script_sig_len_offset = cb->len;
+    put_byte(&w, 0);                        // Lunghezza, scritta dopo
+    size_t script_sig_start = cb->len;
+    put_height(&script_sig, tmpl->height);
+    put_byte(&script_sig, SOLO_EXTRANONCE_SIZE);
+    cb->extranonce_offset = cb->len;
+    put_le(&script_sig, 0, SOLO_EXTRANONCE_SIZE);
+    put_byte(&script_sig, (uint8_t)(sizeof(tag) - 1));
+    put(&script_sig, tag, sizeof(tag) - 1);
+    size_t script_sig_len = cb->len - script_sig_start;
+    if (script_sig.overflow || script_sig_len < 2 || script_sig_len > 100) {
+        return false;
+    }
+    cb->data[script_sig_len_offset] = (uint8_t)script_sig_len;
+    put_le(&w, 0xffffffff, 4);              // Sequence
+
+    // Output: payout e, nei blocchi segwit, il witness commitment
+    cb->witness = tmpl->witness_commitment_len > 0;
+    put_byte(&w, cb->witness ? 2 : 1);
+    put_le(&w, tmpl->coinbasevalue, 8);
+    put_byte(&w, (uint8_t)script_len);
+    put(&w, script, script_len);
+    if (cb->witness) {
+        put_le(&w, 0, 8);
+        put_byte(&w, (uint8_t)tmpl->witness_commitment_len);
+        put(&w, tmpl->witness_commitment, tmpl->witness_commitment_len);
+    }
+
+    cb->locktime_offset = cb->len;
+    put_le(&w, 0, 4);                       // Locktime
+    return !w.overflow && script_len > 0 && script_len < 0xfd;
+}
+
+void solo_coinbase_roll(solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl, uint64_t extranonce,
+                        uint8_t merkle_root[32]) {
+    for (int i = 0; i < SOLO_EXTRANONCE_SIZE; i++) {
+        cb->data[cb->extranonce_offset + i] = (uint8_t)(extranonce >> (i * 8));
+    }
+    uint8_t txid[32];
+    merkle_sha256d(cb->data, cb->len, txid);
+    merkle_root_from_branch(txid, tmpl->merkle_branch, tmpl->merkle_branch_len, merkle_root);
+}
+
+void solo_target_from_bits(uint32_t bits, uint8_t target[32]) {
+    memset(target, 0, 32);
+    int exponent = bits >> 24;
+    uint32_t mantissa = bits & 0x007fffff;
+    if (bits & 0x00800000) {
+        return;                             // Target negativo: nessun hash valido
+    }
+    if (exponent <= 3) {
+        mantissa >>= 8 * (3 - exponent);
+        exponent = 3;
+    }
+    for (int i = 0; i < 3; i++) {
+        int pos = exponent - 3 + i;
+        if (pos < 32) {
+            target[pos] = (uint8_t)(mantissa >> (i * 8));
+        }
+    }
+}
+
+bool solo_hash_meets_target(const uint8_t hash[32], const uint8_t target[32]) {
+    for (int i = 31; i >= 0; i--) {
+        if (hash[i] != target[i]) {
+            return hash[i] < target[i];
+        }
+    }
+    return true;
+}
+
+// Pezzi del blocco in ordine. Con witness la coinbase è:
+// version | marker 00 flag 01 | input/output | witness: 1 elemento da 32 zeri | locktime
+static void block_layout(solo_block_layout_t* layout, const uint8_t header[80], const solo_coinbase_t* cb,
+                         const BitcoinBlockTemplate* tmpl) {
+    static const uint8_t marker_flag[2] = {0x00, 0x01};
+    static const uint8_t reserved[2 + 32] = {0x01, 0x20};
+    int n = 0;
+
+    layout->data[n] = header;
+    layout->len[n++] = 80;
+    layout->data[n] = layout->varint;
+    layout->len[n++] = varint((uint64_t)tmpl->transactions_count + 1, layout->varint);
+    if (cb->witness) {
+        layout->data[n] = cb->data;
+        layout->len[n++] = 4;
+        layout->data[n] = marker_flag;
+        layout->len[n++] = sizeof(marker_flag);
+        layout->data[n] = cb->data + 4;
+        layout->len[n++] = cb->locktime_offset - 4;
+        layout->data[n] = reserved;
+        layout->len[n++] = sizeof(reserved);
+        layout->data[n] = cb->data + cb->locktime_offset;
+        layout->len[n++] = cb->len - cb->locktime_offset;
+    } else {
+        layout->data[n] = cb->data;
+        layout->len[n++] = cb->len;
+    }
+    if (tmpl->tx_data_len > 0) {
+        layout->data[n] = tmpl->tx_data;
+        layout->len[n++] = tmpl->tx_data_len;
+    }
+    layout->count = n;
+}
+
+size_t solo_block_size(const solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl) {
+    uint8_t buf[9];
+    size_t size = 80 + varint((uint64_t)tmpl->transactions_count + 1, buf) + cb->len + tmpl->tx_data_len;
+    if (cb->witness) {
+        size += 2 + 1 + 1 + 32;             // Marker/flag e witness reserved value
+    }
+    return size;
+}
+
+size_t solo_block_serialize(const uint8_t header[80], const solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl,
+                            solo_write_t write, void* arg) {
+    solo_block_layout_t layout;
+    block_layout(&layout, header, cb, tmpl);
+    size_t total = 0;
+    for (int i = 0; i < layout.count; i++) {
+        write(layout.data[i], layout.len[i], arg);
+        total += layout.len[i];
+    }
+    return total;
+}
+
+void solo_submit_body_init(solo_submit_body_t* body, const uint8_t header[80], const solo_coinbase_t* cb,
+                           const BitcoinBlockTemplate* tmpl) {
+    memset(body, 0, sizeof(*body));
+    block_layout(&body->layout, header, cb, tmpl);
+    for (int i = 0; i < body->layout.count; i++) {
+        body->block_size += body->layout.len[i];
+    }
+    body->body_len = sizeof(SOLO_SUBMIT_PREFIX) - 1 + body->block_size * 2 + sizeof(SOLO_SUBMIT_SUFFIX) - 1;
+}
+
+size_t solo_submit_body_read(solo_submit_body_t* body, char* out, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    static const size_t prefix_len = sizeof(SOLO_SUBMIT_PREFIX) - 1;
+    size_t hex_end = prefix_len + body->block_size * 2;
+    size_t done = 0;
+
+    while (done < len && body->pos < body->body_len) {
+        if (body->pos < prefix_len) {
+            out[done++] = SOLO_SUBMIT_PREFIX[body->pos++];
+        } else if (body->pos < hex_end) {
+            // Due cifre per byte: una lettura può chiudersi a metà byte
+            const solo_block_layout_t* layout = &body->layout;
+            while (body->segment_pos == layout->len[body->segment]) {
+                body->segment++;
+                body->segment_pos = 0;
+            }
+            uint8_t value = layout->data[body->segment][body->segment_pos];
+            bool high = ((body->pos - prefix_len) & 1) == 0;
+            out[done++] = digits[high ? value >> 4 : value & 15];
+            if (!high) {
+                body->segment_pos++;
+            }
+            body->pos++;
+        } else {
+            out[done++] = SOLO_SUBMIT_SUFFIX[body->pos++ - hex_end];
+        }
+    }
+    return done;
+}
@@ -0,0 +1,82 @@
+#ifndef SOLO_BLOCK_H
+#define SOLO_BLOCK_H
+
+#include "gbt_parser.h"
+
+// Blocco del mining solo costruito sul dispositivo a partire dal template:
+// - coinbase con altezza BIP34, extranonce, script di payout del wallet e
+//   witness commitment quando il template lo prevede
+// - merkle root = txid della coinbase + branch del template: ogni nuovo
+//   extranonce costa un doppio SHA-256 della coinbase e la risalita del branch
+// - serializzazione del blocco per submitblock, anche a pezzi: il corpo
+//   JSON-RPC si genera mentre si invia, senza copie del blocco in RAM
+// C++ puro senza Arduino: lo usano anche i tool sull'host.
+
+#define SOLO_COINBASE_MAX 256
+#define SOLO_EXTRANONCE_SIZE 8
+#define SOLO_COINBASE_TAG "/TzCoinMiner/"
+
+typedef struct {
+    uint8_t data[SOLO_COINBASE_MAX];  // Serializzazione senza witness (quella del txid)
+    size_t len;
+    size_t extranonce_offset;
+    size_t locktime_offset;           // Il witness va inserito qui nella serializzazione del blocco
+    bool witness;                     // Blocco segwit: la coinbase porta il witness reserved value
+} solo_coinbase_t;
+
+// Destinazione dei byte serializzati (buffer, hex, corpo HTTP...)
+typedef void (*solo_write_t)(const uint8_t* data, size_t len, void* arg);
+
+// Il blocco come sequenza di pezzi già in memoria (header, coinbase, store delle transazioni)
+#define SOLO_BLOCK_SEGMENTS 8
+
+typedef struct {
+    const uint8_t* data[SOLO_BLOCK_SEGMENTS];
+    size_t len[SOLO_BLOCK_SEGMENTS];
+    int count;
+    uint8_t varint[9];                // Numero di transazioni
+} solo_block_layout_t;
+
+// Corpo JSON-RPC di submitblock: prefisso, blocco in hex, suffisso
+#define SOLO_SUBMIT_PREFIX "{\"jsonrpc\":\"1.0\",\"id\":\"esp32\",\"method\":\"submitblock\",\"params\":[\""
+#define SOLO_SUBMIT_SUFFIX "\"]}"
+
+typedef struct {
+    solo_block_layout_t layout;
+    size_t block_size;
+    size_t body_len;                  // Content-Length
+    size_t pos;                       // Byte del corpo già letti
+    int segment;                      // Posizione nel blocco: pezzo e offset
+    size_t segment_pos;
+} solo_submit_body_t;
+
+// Coinbase che paga coinbasevalue a script. false se non ci sta.
+bool solo_coinbase_build(solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl, const uint8_t* script,
+                         int script_len);
+
+// Nuovo extranonce: aggiorna la coinbase e calcola il merkle root dell'header
+void solo_coinbase_roll(solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl, uint64_t extranonce,
+                        uint8_t merkle_root[32]);
+
+// Target dai bits compatti, in byte order interno come gli hash
+void solo_target_from_bits(uint32_t bits, uint8_t target[32]);
+
+// Hash del blocco <= target (entrambi in byte order interno)
+bool solo_hash_meets_target(const uint8_t hash[32], const uint8_t target[32]);
+
+// Dimensione del blocco serializzato in byte
+size_t solo_block_size(const solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl);
+
+// Blocco completo: header, numero di transazioni, coinbase, transazioni del template
+size_t solo_block_serialize(const uint8_t header[80], const solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl,
+                            solo_write_t write, void* arg);
+
+// Corpo di submitblock da leggere a pezzi. I dati restano dove sono (header,
+// coinbase, store): devono restare validi fino alla fine della lettura.
+void solo_submit_body_init(solo_submit_body_t* body, const uint8_t header[80], const solo_coinbase_t* cb,
+                           const BitcoinBlockTemplate* tmpl);
+
+// Prossimi byte del corpo (al più len). 0 alla fine.
+size_t solo_submit_body_read(solo_submit_body_t* body, char* out, size_t len);
+
+#endif // SOLO_BLOCK_H
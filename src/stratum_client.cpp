@@ -1,6 +1,4 @@
 #include "stratum_client.h"
-#include <WiFi.h>
-#include <ArduinoJson.h>
 #include "esp_log.h"
 #include <mbedtls/sha256.h>
 
@@ -11,77 +9,44 @@ static const char* TAG = "STRATUM";
 #define MIN_DIFFICULTY 256        // Minimo accettabile per ESP32
 #define MAX_DIFFICULTY 4096       // Massimo gestibile da ESP32
 
-static WiFiClient stratum_tcp_client;
-static bool stratum_connected = false;
-static String stratum_host;
-static uint16_t stratum_port;
-static String stratum_wallet;
-static String stratum_worker;
-static String stratum_password;
+// Id JSON-RPC: 1 = subscribe, 2 = authorize, da 3 in su = mining.submit
+#define FIRST_SUBMIT_ID 3
 
-static uint32_t stratum_subscription_id = 0;
-static String stratum_session_id;
-static String stratum_extranonce1;
-static int stratum_extranonce2_size = 0;
+// Codice errore Stratum per share su job scaduto
+#define STRATUM_ERROR_STALE 21
 
-static String stratum_job_id;
-static String stratum_prev_hash;
-static String stratum_coinb1;
-static String stratum_coinb2;
-static std::vector<String> stratum_merkle_branch;
-static String stratum_version;
-static String stratum_nbits;
-static String stratum_ntime;
-static bool stratum_clean_jobs = false;
-
-static uint32_t stratum_difficulty = 0;
-
-// Callback per mining task
-static stratum_job_callback_t job_callback = nullptr;
-
-// Helper: converti hex string a bytes
-static void hex_to_bytes(const String& hex, uint8_t* bytes, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        sscanf(hex.substring(i * 2, i * 2 + 2).c_str(), "%2hhx", &bytes[i]);
-    }
-}
-
-// Helper: converti bytes a hex string
-static String bytes_to_hex(const uint8_t* bytes, size_t len) {
-    String hex;
-    hex.reserve(len * 2);
-    for (size_t i = 0; i < len; i++) {
-        char buf[3];
-        sprintf(buf, "%02x", bytes[i]);
-        hex += buf;
-    }
-    return hex;
+StratumClient::StratumClient()
+    : socket(&tcp_client), connected(false), port(0), extranonce2_size(0), next_submit_id(FIRST_SUBMIT_ID) {
+    job.clean_jobs = false;
+    job.extranonce2_size = 0;
+    job.has_merkle_root = false;
 }
 
 // Invia messaggio JSON-RPC
-static bool stratum_send_message(JsonDocument& doc) {
+bool StratumClient::sendMessage(JsonDocument& doc) {
     String msg;
     serializeJson(doc, msg);
     msg += "\n";
     
     ESP_LOGI(TAG, "Sending: %s", msg.c_str());
     
-    if (!stratum_tcp_client.connected()) {
+    if (!socket->connected()) {
         ESP_LOGE(TAG, "Not connected");
         return false;
     }
     
-    size_t sent = stratum_tcp_client.print(msg);
+    size_t sent = socket->print(msg);
+    bytes_sent += sent;
     return sent == msg.length();
 }
 
 // Leggi e processa risposta
-static bool stratum_read_response(JsonDocument& doc) {
-    if (!stratum_tcp_client.available()) {
+bool StratumClient::readResponse(JsonDocument& doc) {
+    if (!socket->available()) {
         return false;
     }
     
-    String line = stratum_tcp_client.readStringUntil('\n');
+    String line = socket->readStringUntil('\n');
     line.trim();
     
     if (line.length() == 0) {
@@ -89,8 +54,12 @@ static bool stratum_read_response(JsonDocument& doc) {
     }
     
     ESP_LOGI(TAG, "Received: %s", line.c_str());
+    bytes_received += line.length() + 1;
     
+    uint32_t parse_start = micros();
     DeserializationError error = deserializeJson(doc, line);
+    parse_time_us += micros() - parse_start;
+    messages_parsed++;
     if (error) {
         ESP_LOGE(TAG, "JSON parse error: %s", error.c_str());
         return false;
@@ -100,51 +69,41 @@ static bool stratum_read_response(JsonDocument& doc) {
 }
 
 // Processa mining.notify (nuovo job)
-static void stratum_process_notify(JsonArray params) {
+void StratumClient::processNotify(JsonArray params) {
+    uint32_t parse_start = micros();
+    
     if (params.size() < 8) {
         ESP_LOGE(TAG, "Invalid notify params");
         return;
     }
     
-    stratum_job_id = params[0].as<String>();
-    stratum_prev_hash = params[1].as<String>();
-    stratum_coinb1 = params[2].as<String>();
-    stratum_coinb2 = params[3].as<String>();
+    job.job_id = params[0].as<String>();
+    job.prev_hash = params[1].as<String>();
+    job.coinb1 = params[2].as<String>();
+    job.coinb2 = params[3].as<String>();
     
-    stratum_merkle_branch.clear();
+    job.merkle_branch.clear();
     JsonArray merkle = params[4].as<JsonArray>();
     for (JsonVariant v : merkle) {
-        stratum_merkle_branch.push_back(v.as<String>());
+        job.merkle_branch.push_back(v.as<String>());
     }
     
-    stratum_version = params[5].as<String>();
-    stratum_nbits = params[6].as<String>();
-    stratum_ntime = params[7].as<String>();
-    stratum_clean_jobs = params[8].as<bool>();
-    
-    ESP_LOGI(TAG, "New job: %s", stratum_job_id.c_str());
-    
-    // Notifica il mining task se c'è un callback
-    if (job_callback) {
-        stratum_job_t job;
-        job.job_id = stratum_job_id;
-        job.prev_hash = stratum_prev_hash;
-        job.coinb1 = stratum_coinb1;
-        job.coinb2 = stratum_coinb2;
-        job.merkle_branch = stratum_merkle_branch;
-        job.version = stratum_version;
-        job.nbits = stratum_nbits;
-        job.ntime = stratum_ntime;
-        job.clean_jobs = stratum_clean_jobs;
-        job.extranonce1 = stratum_extranonce1;
-        job.extranonce2_size = stratum_extranonce2_size;
-        
-        job_callback(&job);
-    }
+    job.version = params[5].as<String>();
+    job.nbits = params[6].as<String>();
+    job.ntime = params[7].as<String>();
+    job.clean_jobs = params[8].as<bool>();
+    job.extranonce1 = extranonce1;
+    job.extranonce2_size = extranonce2_size;
+    
+    parse_time_us += micros() - parse_start;
+    
+    ESP_LOGI(TAG, "New job: %s", job.job_id.c_str());
+    
+    notifyJob(&job);
 }
 
 // Processa mining.set_difficulty
-static void stratum_process_difficulty(JsonArray params) {
+void StratumClient::processDifficulty(JsonArray params) {
     if (params.size() < 1) {
         return;
     }
@@ -162,20 +121,20 @@ static void stratum_process_difficulty(JsonArray params) {
         Serial.printf("   Il pool abbasserà automaticamente quando non riceve share\n");
         
         // Usa comunque la difficoltà del pool (il pool si auto-regolerà)
-        stratum_difficulty = requested_difficulty;
+        difficulty = requested_difficulty;
     } else if (requested_difficulty < MIN_DIFFICULTY) {
         Serial.printf("⚠️  Difficoltà molto bassa: %u (min raccomandato: %u)\n", 
                       requested_difficulty, MIN_DIFFICULTY);
-        stratum_difficulty = requested_difficulty;
+        difficulty = requested_difficulty;
     } else {
         // Difficoltà nel range ottimale per ESP32
-        stratum_difficulty = requested_difficulty;
-        Serial.printf("✅ Difficoltà ottimale per ESP32: %u\n", stratum_difficulty);
+        difficulty = requested_difficulty;
+        Serial.printf("✅ Difficoltà ottimale per ESP32: %u\n", difficulty);
     }
     
     // Calcola zeri approssimativi richiesti (per info)
     int approx_zeros = 8;
-    uint32_t d = stratum_difficulty;
+    uint32_t d = difficulty;
     if (d <= 1) approx_zeros = 8;
     else if (d <= 2) approx_zeros = 9;
     else if (d <= 8) approx_zeros = 10;
@@ -189,10 +148,10 @@ static void stratum_process_difficulty(JsonArray params) {
     else approx_zeros = 17;
     
     Serial.printf("📊 Pool difficulty settata a: %u (~%d zeri richiesti)\n", 
-                  stratum_difficulty, approx_zeros);
+                  difficulty, approx_zeros);
     
     // Stima tempo medio per share (correzione per evitare overflow)
-    if (stratum_difficulty <= MAX_DIFFICULTY && approx_zeros <= 16) {
+    if (difficulty <= MAX_DIFFICULTY && approx_zeros <= 16) {
         // Calcolo più accurato: 2^(zeros * 4) / hashrate
         // Per evitare overflow, calcoliamo in modo incrementale
         double avg_hashes = pow(2.0, approx_zeros * 4);  // Più accurato di 16^zeros
@@ -210,33 +169,43 @@ static void stratum_process_difficulty(JsonArray params) {
     }
 }
 
-void stratum_init(const char* pool_url, uint16_t port, const char* wallet_address, const char* worker_name, const char* password) {
-    stratum_host = pool_url;
-    stratum_port = port;
-    stratum_wallet = wallet_address;
-    stratum_worker = worker_name ? worker_name : "esp32";
-    stratum_password = password ? password : "x";
+void StratumClient::init(const char* pool_url, uint16_t pool_port, const char* wallet_address, const char* worker_name, const char* pool_password) {
+    host = pool_url;
+    port = pool_port;
+    wallet = wallet_address;
+    worker = worker_name ? worker_name : "esp32";
+    password = pool_password ? pool_password : "x";
     
-    stratum_connected = false;
-    stratum_subscription_id = 0;
+    connected = false;
     
-    ESP_LOGI(TAG, "Initialized with pool: %s:%d", pool_url, port);
+    ESP_LOGI(TAG, "Initialized with pool: %s:%d", pool_url, pool_port);
+}
+
+void StratumClient::setTls(bool enabled, const char* server_name) {
+    WiFiClient* wanted = enabled ? (WiFiClient*)&tls_client : &tcp_client;
+    if (wanted != socket) {
+        disconnect();
+        socket = wanted;
+    }
+    tls_client.setServerName(server_name);
 }
 
-bool stratum_connect() {
-    if (stratum_tcp_client.connected()) {
-        stratum_tcp_client.stop();
+bool StratumClient::connect() {
+    if (socket->connected()) {
+        socket->stop();
     }
     
-    ESP_LOGI(TAG, "Connecting to %s:%d...", stratum_host.c_str(), stratum_port);
+    clearPendingSubmits();
     
-    if (!stratum_tcp_client.connect(stratum_host.c_str(), stratum_port)) {
+    ESP_LOGI(TAG, "Connecting to %s:%d...", host.c_str(), port);
+    
+    if (!socket->connect(host.c_str(), port)) {
         ESP_LOGE(TAG, "Connection failed");
         return false;
     }
     
-    ESP_LOGI(TAG, "Connected to pool");
-    stratum_connected = true;
+    ESP_LOGI(TAG, "Connected to pool%s", socket == &tls_client ? " (TLS)" : "");
+    connected = true;
     
     // Invia mining.subscribe con suggest_difficulty (come NerdMiner)
     JsonDocument doc;
@@ -257,38 +226,39 @@ bool stratum_connect() {
     
     Serial.printf("📡 Richiesta al pool con difficoltà suggerita: %d\n", DEFAULT_DIFFICULTY);
     
-    if (!stratum_send_message(doc)) {
-        stratum_tcp_client.stop();
-        stratum_connected = false;
+    if (!sendMessage(doc)) {
+        socket->stop();
+        connected = false;
         return false;
     }
     
     return true;
 }
 
-void stratum_disconnect() {
-    if (stratum_tcp_client.connected()) {
-        stratum_tcp_client.stop();
+void StratumClient::disconnect() {
+    if (socket->connected()) {
+        socket->stop();
     }
-    stratum_connected = false;
+    connected = false;
     ESP_LOGI(TAG, "Disconnected");
 }
 
-bool stratum_is_connected() {
-    return stratum_connected && stratum_tcp_client.connected();
+bool StratumClient::isConnected() {
+    return connected && socket->connected();
 }
 
-void stratum_loop() {
-    if (!stratum_is_connected()) {
-        return;
-    }
-    
-    // Leggi eventuali messaggi dal pool
-    JsonDocument doc;
-    if (!stratum_read_response(doc)) {
-        return;
+void StratumClient::loop() {
+    // Processa tutti i messaggi in coda (subscribe, notify e difficulty arrivano insieme)
+    for (int i = 0; i < 8 && isConnected(); i++) {
+        JsonDocument doc;
+        if (!readResponse(doc)) {
+            return;
+        }
+        handleMessage(doc);
     }
-    
+}
+
+void StratumClient::handleMessage(JsonDocument& doc) {
     // Risposta a una nostra richiesta
     if (!doc["id"].isNull()) {
         int id = doc["id"].as<int>();
@@ -297,34 +267,34 @@ void stratum_loop() {
         if (id == 1) {
             if (!doc["error"].isNull()) {
                 ESP_LOGE(TAG, "Subscribe error");
-                stratum_disconnect();
+                disconnect();
                 return;
             }
             
             JsonArray result = doc["result"].as<JsonArray>();
             if (result.size() >= 2) {
-                stratum_extranonce1 = result[1].as<String>();
-                stratum_extranonce2_size = result[2].as<int>();
+                extranonce1 = result[1].as<String>();
+                extranonce2_size = result[2].as<int>();
                 
                 ESP_LOGI(TAG, "Subscribed - extranonce1: %s, extranonce2_size: %d", 
-                         stratum_extranonce1.c_str(), stratum_extranonce2_size);
+                         extranonce1.c_str(), extranonce2_size);
                 
                 // Invia mining.authorize
                 JsonDocument auth_doc;
                 auth_doc["id"] = 2;
                 auth_doc["method"] = "mining.authorize";
                 JsonArray auth_params = auth_doc["params"].to<JsonArray>();
-                auth_params.add(stratum_wallet + "." + stratum_worker);
-                auth_params.add(stratum_password);
+                auth_params.add(wallet + "." + worker);
+                auth_params.add(password);
                 
-                stratum_send_message(auth_doc);
+                sendMessage(auth_doc);
             }
         }
         // Risposta a mining.authorize
         else if (id == 2) {
             if (!doc["error"].isNull()) {
                 ESP_LOGE(TAG, "Authorization failed");
-                stratum_disconnect();
+                disconnect();
                 return;
             }
             
@@ -333,21 +303,12 @@ void stratum_loop() {
                 ESP_LOGI(TAG, "Authorized successfully");
             } else {
                 ESP_LOGE(TAG, "Not authorized");
-                stratum_disconnect();
+                disconnect();
             }
         }
         // Risposta a mining.submit
-        else if (id == 3) {
-            if (!doc["error"].isNull()) {
-                ESP_LOGW(TAG, "Share rejected");
-            } else {
-                bool accepted = doc["result"].as<bool>();
-                if (accepted) {
-                    ESP_LOGI(TAG, "Share accepted!");
-                } else {
-                    ESP_LOGW(TAG, "Share not accepted");
-                }
-            }
+        else if (id >= FIRST_SUBMIT_ID) {
+            processSubmitResponse(id, doc);
         }
     }
     // Notifica dal pool
@@ -356,53 +317,61 @@ void stratum_loop() {
         JsonArray params = doc["params"].as<JsonArray>();
         
         if (method == "mining.notify") {
-            stratum_process_notify(params);
+            processNotify(params);
         }
         else if (method == "mining.set_difficulty") {
-            stratum_process_difficulty(params);
+            processDifficulty(params);
         }
     }
 }
 
-bool stratum_submit_share(const char* job_id, const char* extranonce2, const char* ntime, const char* nonce) {
-    if (!stratum_is_connected()) {
+// Processa la risposta a mining.submit (esito e round trip)
+void StratumClient::processSubmitResponse(int id, JsonDocument& doc) {
+    submitAnswered(id);
+    
+    if (!doc["error"].isNull()) {
+        if (doc["error"][0].as<int>() == STRATUM_ERROR_STALE) {
+            ESP_LOGW(TAG, "Share rejected (stale job)");
+            shares_stale++;
+        } else {
+            ESP_LOGW(TAG, "Share rejected");
+        }
+        shares_rejected++;
+    } else {
+        bool accepted = doc["result"].as<bool>();
+        if (accepted) {
+            ESP_LOGI(TAG, "Share accepted! (%u ms)", getShareRttLast());
+            shares_accepted++;
+        } else {
+            ESP_LOGW(TAG, "Share not accepted");
+            shares_rejected++;
+        }
+    }
+}
+
+bool StratumClient::submitShare(const char* job_id, const char* extranonce2, const char* ntime, const char* nonce) {
+    if (!isConnected()) {
         ESP_LOGE(TAG, "Not connected");
         return false;
     }
     
+    // Id univoco per abbinare la risposta e misurare il round trip
+    uint32_t id = next_submit_id++;
+    submitSent(id);
+    
     JsonDocument doc;
-    doc["id"] = 3;
+    doc["id"] = id;
     doc["method"] = "mining.submit";
     JsonArray params = doc["params"].to<JsonArray>();
-    params.add(stratum_wallet + "." + stratum_worker);
+    params.add(wallet + "." + worker);
     params.add(job_id);
     params.add(extranonce2);
     params.add(ntime);
     params.add(nonce);
     
-    return stratum_send_message(doc);
-}
-
-void stratum_set_job_callback(stratum_job_callback_t callback) {
-    job_callback = callback;
-}
-
-uint32_t stratum_get_difficulty() {
-    return stratum_difficulty;
+    return sendMessage(doc);
 }
 
-stratum_job_t stratum_get_current_job() {
-    stratum_job_t job;
-    job.job_id = stratum_job_id;
-    job.prev_hash = stratum_prev_hash;
-    job.coinb1 = stratum_coinb1;
-    job.coinb2 = stratum_coinb2;
-    job.merkle_branch = stratum_merkle_branch;
-    job.version = stratum_version;
-    job.nbits = stratum_nbits;
-    job.ntime = stratum_ntime;
-    job.clean_jobs = stratum_clean_jobs;
-    job.extranonce1 = stratum_extranonce1;
-    job.extranonce2_size = stratum_extranonce2_size;
+stratum_job_t StratumClient::getCurrentJob() const {
     return job;
 }
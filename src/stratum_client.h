@@ -2,53 +2,57 @@
 #define STRATUM_CLIENT_H
 
 #include <Arduino.h>
+#include <WiFi.h>
+#include <ArduinoJson.h>
 #include <vector>
+#include "pool_client.h"
+#include "tls_transport.h"
+
+// Client Stratum V1: ogni istanza gestisce una sessione con un pool
+class StratumClient : public PoolClient {
+public:
+    StratumClient();
+
+    void init(const char* pool_url, uint16_t port, const char* wallet_address,
+              const char* worker_name = nullptr, const char* password = nullptr) override;
+    bool connect() override;
+    void disconnect() override;
+    bool isConnected() override;
+    void loop() override;
+    bool submitShare(const char* job_id, const char* extranonce2,
+                     const char* ntime, const char* nonce) override;
+    const char* protocolName() const override { return "V1"; }
+
+    // Stratum su TLS (stratum+ssl://): server_name è l'host per SNI e cache delle
+    // sessioni, visto che init() riceve l'IP già risolto
+    void setTls(bool enabled, const char* server_name = nullptr);
+
+    // Ottieni job corrente
+    stratum_job_t getCurrentJob() const;
+
+private:
+    bool sendMessage(JsonDocument& doc);
+    bool readResponse(JsonDocument& doc);
+    void handleMessage(JsonDocument& doc);
+    void processNotify(JsonArray params);
+    void processDifficulty(JsonArray params);
+    void processSubmitResponse(int id, JsonDocument& doc);
+
+    WiFiClient tcp_client;
+    TlsClient tls_client;
+    WiFiClient* socket;         // tcp_client o tls_client
+    bool connected;
+    String host;
+    uint16_t port;
+    String wallet;
+    String worker;
+    String password;
 
-// Struttura per un job di mining Stratum
-struct stratum_job_t {
-    String job_id;
-    String prev_hash;
-    String coinb1;
-    String coinb2;
-    std::vector<String> merkle_branch;
-    String version;
-    String nbits;
-    String ntime;
-    bool clean_jobs;
     String extranonce1;
     int extranonce2_size;
-};
-
-// Callback quando arriva un nuovo job
-typedef void (*stratum_job_callback_t)(stratum_job_t* job);
-
-// Inizializza il client Stratum
-void stratum_init(const char* pool_url, uint16_t port, const char* wallet_address, 
-                  const char* worker_name = nullptr, const char* password = nullptr);
-
-// Connetti al pool
-bool stratum_connect();
-
-// Disconnetti dal pool
-void stratum_disconnect();
-
-// Controlla se connesso
-bool stratum_is_connected();
 
-// Loop principale - chiamare regolarmente per gestire messaggi
-void stratum_loop();
-
-// Invia una share al pool
-bool stratum_submit_share(const char* job_id, const char* extranonce2, 
-                         const char* ntime, const char* nonce);
-
-// Imposta callback per nuovi job
-void stratum_set_job_callback(stratum_job_callback_t callback);
-
-// Ottieni difficoltà corrente
-uint32_t stratum_get_difficulty();
-
-// Ottieni job corrente
-stratum_job_t stratum_get_current_job();
+    stratum_job_t job;
+    uint32_t next_submit_id;
+};
 
 #endif // STRATUM_CLIENT_H
@@ -0,0 +1,419 @@
+#include "stratum_v2_client.h"
+#include "esp_log.h"
+
+static const char* TAG = "STRATUM_V2";
+
+// Framing: extension_type (U16) + msg_type (U8) + msg_length (U24), tutto little endian
+#define SV2_HEADER_SIZE 6
+#define SV2_CHANNEL_MSG_BIT 0x8000   // Bit di extension_type per i messaggi legati a un canale
+
+// Tipi di messaggio del Mining Protocol
+#define SV2_SETUP_CONNECTION                  0x00
+#define SV2_SETUP_CONNECTION_SUCCESS          0x01
+#define SV2_SETUP_CONNECTION_ERROR            0x02
+#define SV2_OPEN_STANDARD_MINING_CHANNEL      0x10
+#define SV2_OPEN_STANDARD_MINING_CHANNEL_OK   0x11
+#define SV2_OPEN_MINING_CHANNEL_ERROR         0x12
+#define SV2_NEW_MINING_JOB                    0x15
+#define SV2_SUBMIT_SHARES_STANDARD            0x1a
+#define SV2_SUBMIT_SHARES_SUCCESS             0x1c
+#define SV2_SUBMIT_SHARES_ERROR               0x1d
+#define SV2_SET_NEW_PREV_HASH                 0x20
+#define SV2_SET_TARGET                        0x21
+
+#define SV2_PROTOCOL_MINING       0
+#define SV2_VERSION               2
+#define SV2_FLAG_STANDARD_JOBS    0x01     // Il dispositivo gestisce solo job standard (header-only)
+#define SV2_NOMINAL_HASHRATE      30000.0f // Hashrate dichiarato al pool (H/s), solo indicativo
+
+// Helper: lettura/scrittura little endian
+static uint32_t read_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void write_u32(uint8_t* p, uint32_t value) {
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = (value >> 24) & 0xFF;
+}
+
+// Helper: scrive una stringa STR0_255 (lunghezza su un byte + dati)
+static size_t write_str0_255(uint8_t* p, const char* str) {
+    size_t len = strlen(str);
+    if (len > 255) {
+        len = 255;
+    }
+    p[0] = (uint8_t)len;
+    memcpy(p + 1, str, len);
+    return len + 1;
+}
+
+StratumV2Client::StratumV2Client()
+    : state(SV2_DISCONNECTED), port(0), channel_id(0), next_sequence(1), rx_len(0),
+      future_pending(false), future_job_id(0), future_version(0), have_prev_hash(false),
+      prev_ntime(0), prev_nbits(0), job_version(0), callback_time_us(0) {
+    job.clean_jobs = false;
+    job.extranonce2_size = 0;
+    job.has_merkle_root = true;
+    memset(job.merkle_root, 0, sizeof(job.merkle_root));
+    memset(job.prev_hash_raw, 0, sizeof(job.prev_hash_raw));
+}
+
+void StratumV2Client::init(const char* pool_url, uint16_t pool_port, const char* wallet_address,
+                           const char* worker_name, const char* pool_password) {
+    // Accetta sia "host" sia "stratum2+tcp://host"
+    host = pool_url;
+    if (host.startsWith(STRATUM_V2_URL_PREFIX)) {
+        host = host.substring(strlen(STRATUM_V2_URL_PREFIX));
+    }
+    port = pool_port;
+    user_identity = String(wallet_address) + "." + (worker_name ? worker_name : "esp32");
+    state = SV2_DISCONNECTED;
+
+    ESP_LOGI(TAG, "Initialized with pool: %s:%d", host.c_str(), pool_port);
+}
+
+bool StratumV2Client::sendFrame(uint16_t extension_type, uint8_t msg_type, const uint8_t* payload, uint32_t length) {
+    if (!tcp_client.connected()) {
+        ESP_LOGE(TAG, "Not connected");
+        return false;
+    }
+
+    uint8_t header[SV2_HEADER_SIZE];
+    header[0] = extension_type & 0xFF;
+    header[1] = (extension_type >> 8) & 0xFF;
+    header[2] = msg_type;
+    header[3] = length & 0xFF;
+    header[4] = (length >> 8) & 0xFF;
+    header[5] = (length >> 16) & 0xFF;
+
+    size_t sent = tcp_client.write(header, SV2_HEADER_SIZE);
+    sent += tcp_client.write(payload, length);
+    bytes_sent += sent;
+    return sent == SV2_HEADER_SIZE + length;
+}
+
+bool StratumV2Client::connect() {
+    if (tcp_client.connected()) {
+        tcp_client.stop();
+    }
+
+    clearPendingSubmits();
+    rx_len = 0;
+    future_pending = false;
+    have_prev_hash = false;
+
+    ESP_LOGI(TAG, "Connecting to %s:%d...", host.c_str(), port);
+
+    if (!tcp_client.connect(host.c_str(), port)) {
+        ESP_LOGE(TAG, "Connection failed");
+        return false;
+    }
+
+    // SetupConnection: protocollo mining, versione 2, solo job standard
+    uint8_t payload[SV2_MAX_FRAME];
+    size_t len = 0;
+    payload[len++] = SV2_PROTOCOL_MINING;
+    payload[len++] = SV2_VERSION & 0xFF;
+    payload[len++] = SV2_VERSION >> 8;
+    payload[len++] = SV2_VERSION & 0xFF;
+    payload[len++] = SV2_VERSION >> 8;
+    write_u32(payload + len, SV2_FLAG_STANDARD_JOBS);
+    len += 4;
+    len += write_str0_255(payload + len, host.c_str());
+    payload[len++] = port & 0xFF;
+    payload[len++] = port >> 8;
+    len += write_str0_255(payload + len, "TzCoinMiner");
+    len += write_str0_255(payload + len, "ESP32-S3");
+    len += write_str0_255(payload + len, "1.0");
+    len += write_str0_255(payload + len, "");
+
+    if (!sendFrame(0, SV2_SETUP_CONNECTION, payload, len)) {
+        tcp_client.stop();
+        return false;
+    }
+
+    state = SV2_SETUP_SENT;
+    Serial.printf("📡 Stratum V2: SetupConnection inviato a %s:%u\n", host.c_str(), port);
+    return true;
+}
+
+void StratumV2Client::disconnect() {
+    if (tcp_client.connected()) {
+        tcp_client.stop();
+    }
+    state = SV2_DISCONNECTED;
+    ESP_LOGI(TAG, "Disconnected");
+}
+
+bool StratumV2Client::isConnected() {
+    return state != SV2_DISCONNECTED && tcp_client.connected();
+}
+
+// Legge i byte disponibili nel frame corrente; true quando il frame è completo
+bool StratumV2Client::readFrame() {
+    while (tcp_client.available()) {
+        uint32_t needed;
+        if (rx_len < SV2_HEADER_SIZE) {
+            needed = SV2_HEADER_SIZE - rx_len;
+        } else {
+            uint32_t payload_len = rx_buf[3] | (rx_buf[4] << 8) | (rx_buf[5] << 16);
+            if (payload_len > SV2_MAX_FRAME - SV2_HEADER_SIZE) {
+                ESP_LOGE(TAG, "Frame too large: %u bytes", payload_len);
+                disconnect();
+                return false;
+            }
+            needed = SV2_HEADER_SIZE + payload_len - rx_len;
+        }
+
+        if (needed == 0) {
+            return true;
+        }
+
+        int n = tcp_client.read(rx_buf + rx_len, needed);
+        if (n <= 0) {
+            return false;
+        }
+        rx_len += n;
+        bytes_received += n;
+
+        if (rx_len >= SV2_HEADER_SIZE) {
+            uint32_t payload_len = rx_buf[3] | (rx_buf[4] << 8) | (rx_buf[5] << 16);
+            if (rx_len == SV2_HEADER_SIZE + payload_len) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void StratumV2Client::loop() {
+    // Processa tutti i frame in coda (job e prev hash arrivano insieme)
+    for (int i = 0; i < 8 && isConnected(); i++) {
+        if (!readFrame()) {
+            return;
+        }
+        uint32_t payload_len = rx_buf[3] | (rx_buf[4] << 8) | (rx_buf[5] << 16);
+        rx_len = 0;
+        handleFrame(rx_buf[2], rx_buf + SV2_HEADER_SIZE, payload_len);
+    }
+}
+
+// Converte il target del canale (U256 little endian) nella difficoltà pool equivalente
+void StratumV2Client::processTarget(const uint8_t* target) {
+    double value = 0;
+    for (int i = 31; i >= 0; i--) {
+        value = value * 256.0 + target[i];
+    }
+    if (value <= 0) {
+        return;
+    }
+
+    // Difficoltà 1 = 0xFFFF * 2^208
+    double diff = 65535.0 * pow(2.0, 208) / value;
+    difficulty = diff < 1.0 ? 1 : (uint32_t)diff;
+    ESP_LOGI(TAG, "Channel target -> difficulty %u", difficulty);
+}
+
+// Rende attivo un job: header pronto per il mining task
+void StratumV2Client::activateJob(uint32_t job_id, uint32_t ntime) {
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%u", job_id);
+    job.job_id = buf;
+    snprintf(buf, sizeof(buf), "%08x", job_version);
+    job.version = buf;
+    snprintf(buf, sizeof(buf), "%08x", prev_nbits);
+    job.nbits = buf;
+    snprintf(buf, sizeof(buf), "%08x", ntime);
+    job.ntime = buf;
+
+    ESP_LOGI(TAG, "New job: %u", job_id);
+    uint32_t callback_start = micros();
+    notifyJob(&job);
+    callback_time_us += micros() - callback_start;
+}
+
+// NewMiningJob: channel_id, job_id, min_ntime (OPTION<U32>, vuoto = job futuro), version, merkle_root
+void StratumV2Client::processNewMiningJob(const uint8_t* payload, uint32_t length) {
+    if (length < 4 + 4 + 1 + 4 + 32) {
+        return;
+    }
+    uint32_t job_id = read_u32(payload + 4);
+    bool has_ntime = payload[8] != 0;
+    const uint8_t* p = payload + 9;
+    uint32_t min_ntime = 0;
+    if (has_ntime) {
+        if (length < 4 + 4 + 1 + 4 + 4 + 32) {
+            return;
+        }
+        min_ntime = read_u32(p);
+        p += 4;
+    }
+    uint32_t version = read_u32(p);
+    const uint8_t* merkle_root = p + 4;
+
+    if (!has_ntime) {
+        // Job futuro: diventa attivo con il prossimo SetNewPrevHash
+        future_pending = true;
+        future_job_id = job_id;
+        future_version = version;
+        memcpy(future_merkle_root, merkle_root, 32);
+        return;
+    }
+
+    if (!have_prev_hash) {
+        return;
+    }
+
+    // Job per il prev hash corrente: nessun job da scartare
+    job_version = version;
+    memcpy(job.merkle_root, merkle_root, 32);
+    job.clean_jobs = false;
+    activateJob(job_id, min_ntime);
+}
+
+// SetNewPrevHash: channel_id, job_id, prev_hash (U256), min_ntime, nbits
+void StratumV2Client::processSetNewPrevHash(const uint8_t* payload, uint32_t length) {
+    if (length < 4 + 4 + 32 + 4 + 4) {
+        return;
+    }
+    uint32_t job_id = read_u32(payload + 4);
+    memcpy(job.prev_hash_raw, payload + 8, 32);
+    prev_ntime = read_u32(payload + 40);
+    prev_nbits = read_u32(payload + 44);
+    have_prev_hash = true;
+
+    if (!future_pending || future_job_id != job_id) {
+        ESP_LOGW(TAG, "SetNewPrevHash for unknown job %u", job_id);
+        return;
+    }
+
+    // Nuovo blocco: il job futuro diventa attivo, i precedenti sono scaduti
+    future_pending = false;
+    job_version = future_version;
+    memcpy(job.merkle_root, future_merkle_root, 32);
+    job.clean_jobs = true;
+    activateJob(job_id, prev_ntime);
+}
+
+void StratumV2Client::handleFrame(uint8_t msg_type, const uint8_t* payload, uint32_t length) {
+    uint32_t parse_start = micros();
+    callback_time_us = 0;
+    messages_parsed++;
+
+    switch (msg_type) {
+        case SV2_SETUP_CONNECTION_SUCCESS: {
+            ESP_LOGI(TAG, "SetupConnection accepted");
+
+            // OpenStandardMiningChannel: request_id, user_identity, nominal_hash_rate (F32), max_target
+            uint8_t out[SV2_MAX_FRAME];
+            size_t len = 0;
+            write_u32(out + len, 1);
+            len += 4;
+            len += write_str0_255(out + len, user_identity.c_str());
+            float hashrate = SV2_NOMINAL_HASHRATE;
+            memcpy(out + len, &hashrate, 4);
+            len += 4;
+            memset(out + len, 0xFF, 32);
+            len += 32;
+
+            if (sendFrame(0, SV2_OPEN_STANDARD_MINING_CHANNEL, out, len)) {
+                state = SV2_CHANNEL_SENT;
+            }
+            break;
+        }
+
+        case SV2_SETUP_CONNECTION_ERROR:
+        case SV2_OPEN_MINING_CHANNEL_ERROR:
+            Serial.println("❌ Stratum V2: il pool ha rifiutato la connessione/canale");
+            disconnect();
+            break;
+
+        case SV2_OPEN_STANDARD_MINING_CHANNEL_OK: {
+            // request_id, channel_id, target (U256), extranonce_prefix (B0_32), group_channel_id
+            if (length < 4 + 4 + 32) {
+                break;
+            }
+            channel_id = read_u32(payload + 4);
+            processTarget(payload + 8);
+            state = SV2_READY;
+            Serial.printf("✅ Stratum V2: canale %u aperto (difficoltà %u)\n", channel_id, difficulty);
+            break;
+        }
+
+        case SV2_SET_TARGET:
+            if (length >= 4 + 32) {
+                processTarget(payload + 4);
+            }
+            break;
+
+        case SV2_NEW_MINING_JOB:
+            processNewMiningJob(payload, length);
+            break;
+
+        case SV2_SET_NEW_PREV_HASH:
+            processSetNewPrevHash(payload, length);
+            break;
+
+        case SV2_SUBMIT_SHARES_SUCCESS: {
+            // channel_id, last_sequence_number, new_submits_accepted_count, new_shares_sum
+            if (length < 12) {
+                break;
+            }
+            submitAnswered(read_u32(payload + 4));
+            uint32_t count = read_u32(payload + 8);
+            shares_accepted += count;
+            ESP_LOGI(TAG, "Shares accepted: %u (%u ms)", count, getShareRttLast());
+            break;
+        }
+
+        case SV2_SUBMIT_SHARES_ERROR: {
+            // channel_id, sequence_number, error_code (STR0_255)
+            if (length < 9) {
+                break;
+            }
+            submitAnswered(read_u32(payload + 4));
+            uint8_t code_len = payload[8];
+            String code;
+            for (uint32_t i = 0; i < code_len && 9 + i < length; i++) {
+                code += (char)payload[9 + i];
+            }
+            if (code == "stale-share") {
+                shares_stale++;
+            }
+            shares_rejected++;
+            ESP_LOGW(TAG, "Share rejected: %s", code.c_str());
+            break;
+        }
+
+        default:
+            ESP_LOGW(TAG, "Unhandled message type 0x%02x", msg_type);
+            break;
+    }
+
+    // Il tempo del callback (decodifica header nel mining task) non è parsing
+    parse_time_us += (micros() - parse_start) - callback_time_us;
+}
+
+bool StratumV2Client::submitShare(const char* job_id, const char* extranonce2, const char* ntime, const char* nonce) {
+    (void)extranonce2;  // Canale standard: nessun extranonce2
+
+    if (state != SV2_READY || !tcp_client.connected()) {
+        ESP_LOGE(TAG, "Channel not open");
+        return false;
+    }
+
+    // SubmitSharesStandard: channel_id, sequence_number, job_id, nonce, ntime, version
+    uint32_t sequence = next_sequence++;
+    uint8_t payload[24];
+    write_u32(payload, channel_id);
+    write_u32(payload + 4, sequence);
+    write_u32(payload + 8, strtoul(job_id, NULL, 10));
+    write_u32(payload + 12, strtoul(nonce, NULL, 16));
+    write_u32(payload + 16, strtoul(ntime, NULL, 16));
+    write_u32(payload + 20, job_version);
+
+    submitSent(sequence);
+    return sendFrame(SV2_CHANNEL_MSG_BIT, SV2_SUBMIT_SHARES_STANDARD, payload, sizeof(payload));
+}
@@ -0,0 +1,71 @@
+#ifndef STRATUM_V2_CLIENT_H
+#define STRATUM_V2_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "pool_client.h"
+
+// Dimensione massima di un frame ricevuto (i messaggi del canale standard sono piccoli)
+#define SV2_MAX_FRAME 512
+
+// Client Stratum V2: canale di mining standard, framing binario non cifrato.
+// Il pool invia merkle root già calcolato, quindi niente coinbase né JSON sul dispositivo.
+class StratumV2Client : public PoolClient {
+public:
+    StratumV2Client();
+
+    void init(const char* pool_url, uint16_t port, const char* wallet_address,
+              const char* worker_name = nullptr, const char* password = nullptr) override;
+    bool connect() override;
+    void disconnect() override;
+    bool isConnected() override;
+    void loop() override;
+    bool submitShare(const char* job_id, const char* extranonce2,
+                     const char* ntime, const char* nonce) override;
+    const char* protocolName() const override { return "V2"; }
+
+private:
+    // Stato della connessione
+    enum State {
+        SV2_DISCONNECTED,
+        SV2_SETUP_SENT,        // SetupConnection inviato
+        SV2_CHANNEL_SENT,      // OpenStandardMiningChannel inviato
+        SV2_READY              // Canale aperto, si ricevono job
+    };
+
+    bool sendFrame(uint16_t extension_type, uint8_t msg_type, const uint8_t* payload, uint32_t length);
+    bool readFrame();
+    void handleFrame(uint8_t msg_type, const uint8_t* payload, uint32_t length);
+    void processNewMiningJob(const uint8_t* payload, uint32_t length);
+    void processSetNewPrevHash(const uint8_t* payload, uint32_t length);
+    void processTarget(const uint8_t* target);
+    void activateJob(uint32_t job_id, uint32_t ntime);
+
+    WiFiClient tcp_client;
+    State state;
+    String host;
+    uint16_t port;
+    String user_identity;
+
+    uint32_t channel_id;
+    uint32_t next_sequence;
+
+    // Buffer di ricezione del frame corrente
+    uint8_t rx_buf[SV2_MAX_FRAME];
+    uint32_t rx_len;
+
+    // Job futuro (in attesa di SetNewPrevHash) e prev hash corrente
+    bool future_pending;
+    uint32_t future_job_id;
+    uint32_t future_version;
+    uint8_t future_merkle_root[32];
+    bool have_prev_hash;
+    uint32_t prev_ntime;
+    uint32_t prev_nbits;
+
+    stratum_job_t job;
+    uint32_t job_version;
+    uint32_t callback_time_us;      // Tempo speso nel callback durante il frame corrente
+};
+
+#endif // STRATUM_V2_CLIENT_H
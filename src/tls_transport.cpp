@@ -0,0 +1,480 @@
+#include "tls_transport.h"
+#include <mbedtls/error.h>
+#include <mbedtls/net_sockets.h>      // MBEDTLS_ERR_NET_* returned by the socket callbacks
+#include <mbedtls/ssl_internal.h>     // mbedtls_ssl_handshake_params: was the session resumed?
+#include <esp_system.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#if TLS_SESSION_NVS
+#include <Preferences.h>
+#endif
+
+// NVS namespace of the persisted sessions
+#define TLS_PREFS "tls"
+
+struct TlsCacheEntry {
+    char key[TLS_KEY_MAX];
+    uint8_t* data;                     // Serialized mbedtls session (heap), NULL = free
+    size_t len;
+    uint32_t used;                     // LRU clock
+};
+
+static TlsCacheEntry cache[TLS_CACHE_ENTRIES];
+static uint32_t cacheClock = 0;
+static TlsStats stats = {0};
+
+// Protects the cache and the stats, shared by the mining, RPC and picker tasks
+static portMUX_TYPE tlsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Hardware RNG (true random with WiFi on): no DRBG state to share between tasks
+static int tls_random(void* arg, unsigned char* out, size_t len) {
+    esp_fill_random(out, len);
+    return 0;
+}
+
+// Copy of the cached session for key into out. Returns its length, 0 if none.
+static size_t cache_lookup(const char* key, uint8_t* out, size_t size) {
+    size_t len = 0;
+    portENTER_CRITICAL(&tlsMux);
+    for (int i = 0; i < TLS_CACHE_ENTRIES; i++) {
+        if (cache[i].data && strcmp(cache[i].key, key) == 0) {
+            if (cache[i].len <= size) {
+                memcpy(out, cache[i].data, cache[i].len);
+                len = cache[i].len;
+            }
+            cache[i].used = ++cacheClock;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&tlsMux);
+    return len;
+}
+
+// Store the session for key in its entry, or in the least recently used one.
+// data == NULL drops the entry.
+static void cache_store(const char* key, const uint8_t* data, size_t len) {
+    uint8_t* copy = NULL;
+    if (data) {
+        copy = (uint8_t*)malloc(len);
+        if (!copy) {
+            return;
+        }
+        memcpy(copy, data, len);
+    }
+
+    uint8_t* old = NULL;
+    portENTER_CRITICAL(&tlsMux);
+    int slot = -1;
+    for (int i = 0; i < TLS_CACHE_ENTRIES; i++) {
+        if (cache[i].data && strcmp(cache[i].key, key) == 0) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0 && copy) {
+        slot = 0;
+        for (int i = 1; i < TLS_CACHE_ENTRIES; i++) {
+            if (cache[i].used < cache[slot].used) {
+                slot = i;
+            }
+        }
+    }
+    if (slot >= 0) {
+        old = cache[slot].data;
+        strncpy(cache[slot].key, key, TLS_KEY_MAX - 1);
+        cache[slot].key[TLS_KEY_MAX - 1] = '\0';
+        cache[slot].data = copy;
+        cache[slot].len = copy ? len : 0;
+        cache[slot].used = copy ? ++cacheClock : 0;
+    }
+    portEXIT_CRITICAL(&tlsMux);
+    free(old);
+}
+
+#if TLS_SESSION_NVS
+// NVS keys are at most 15 characters: "s" + FNV-1a of host:port
+static void nvs_key(const char* key, char out[10]) {
+    uint32_t hash = 2166136261u;
+    for (const char* p = key; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 16777619u;
+    }
+    snprintf(out, 10, "s%08x", hash);
+}
+
+static size_t nvs_load(const char* key, uint8_t* out, size_t size) {
+    char name[10];
+    nvs_key(key, name);
+    Preferences prefs;
+    if (!prefs.begin(TLS_PREFS, true)) {
+        return 0;                      // Namespace not created yet
+    }
+    size_t len = prefs.getBytesLength(name);
+    len = len > 0 && len <= size ? prefs.getBytes(name, out, size) : 0;
+    prefs.end();
+    return len;
+}
+
+static void nvs_save(const char* key, const uint8_t* data, size_t len) {
+    char name[10];
+    nvs_key(key, name);
+    Preferences prefs;
+    prefs.begin(TLS_PREFS, false);
+    if (data) {
+        prefs.putBytes(name, data, len);
+    } else {
+        prefs.remove(name);
+    }
+    prefs.end();
+}
+#endif
+
+TlsClient::TlsClient()
+    : caPem(NULL), handshakeTimeoutMs(TLS_HANDSHAKE_TIMEOUT_MS), open(false), setup(false), peeked(-1),
+      lastResumed(false), lastHandshakeMs(0) {
+    serverName[0] = '\0';
+}
+
+TlsClient::~TlsClient() {
+    stop();
+}
+
+void TlsClient::setServerName(const char* name) {
+    strncpy(serverName, name ? name : "", sizeof(serverName) - 1);
+    serverName[sizeof(serverName) - 1] = '\0';
+}
+
+void TlsClient::setCACert(const char* pem) {
+    caPem = pem;
+}
+
+// Socket I/O for mbedtls through the plain WiFiClient underneath
+int TlsClient::bioSend(void* ctx, const unsigned char* buf, size_t len) {
+    TlsClient* self = (TlsClient*)ctx;
+    size_t sent = self->WiFiClient::write(buf, len);
+    return sent > 0 ? (int)sent : MBEDTLS_ERR_NET_SEND_FAILED;
+}
+
+int TlsClient::bioRecv(void* ctx, unsigned char* buf, size_t len) {
+    TlsClient* self = (TlsClient*)ctx;
+    if (self->WiFiClient::available() <= 0) {
+        return self->WiFiClient::connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_CONN_RESET;
+    }
+    int got = self->WiFiClient::read(buf, len);
+    return got > 0 ? got : MBEDTLS_ERR_SSL_WANT_READ;
+}
+
+void TlsClient::release() {
+    if (setup) {
+        mbedtls_ssl_free(&ssl);
+        mbedtls_ssl_config_free(&conf);
+        mbedtls_x509_crt_free(&caCert);
+        setup = false;
+    }
+    open = false;
+    peeked = -1;
+}
+
+// TLS handshake on the connected socket, offering the cached session for name:port
+bool TlsClient::handshake(const char* name, uint16_t port) {
+    char key[TLS_KEY_MAX];
+    snprintf(key, sizeof(key), "%s:%u", name, port);
+
+    mbedtls_ssl_init(&ssl);
+    mbedtls_ssl_config_init(&conf);
+    mbedtls_x509_crt_init(&caCert);
+    setup = true;
+
+    int ret = mbedtls_ssl_config_defaults(&conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                          MBEDTLS_SSL_PRESET_DEFAULT);
+    if (ret == 0 && caPem) {
+        ret = mbedtls_x509_crt_parse(&caCert, (const unsigned char*)caPem, strlen(caPem) + 1);
+    }
+    if (ret == 0) {
+        mbedtls_ssl_conf_authmode(&conf, caPem ? MBEDTLS_SSL_VERIFY_REQUIRED : MBEDTLS_SSL_VERIFY_NONE);
+        if (caPem) {
+            mbedtls_ssl_conf_ca_chain(&conf, &caCert, NULL);
+        }
+        mbedtls_ssl_conf_rng(&conf, tls_random, NULL);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+        mbedtls_ssl_conf_session_tickets(&conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+        ret = mbedtls_ssl_setup(&ssl, &conf);
+    }
+    if (ret == 0) {
+        ret = mbedtls_ssl_set_hostname(&ssl, name);
+    }
+    if (ret != 0) {
+        Serial.printf("❌ TLS %s: setup failed (-0x%04x)\n", key, -ret);
+        return false;
+    }
+    mbedtls_ssl_set_bio(&ssl, this, bioSend, bioRecv, NULL);
+
+    // Offer the session of the last handshake with this server
+    uint8_t* blob = (uint8_t*)malloc(TLS_SESSION_MAX);
+    bool offered = false;
+    if (blob) {
+        size_t len = cache_lookup(key, blob, TLS_SESSION_MAX);
+#if TLS_SESSION_NVS
+        if (len == 0) {
+            len = nvs_load(key, blob, TLS_SESSION_MAX);
+        }
+#endif
+        if (len > 0) {
+            mbedtls_ssl_session session;
+            mbedtls_ssl_session_init(&session);
+            offered = mbedtls_ssl_session_load(&session, blob, len) == 0 && mbedtls_ssl_set_session(&ssl, &session) == 0;
+            mbedtls_ssl_session_free(&session);
+        }
+    }
+
+    // Step by step: after the ServerHello the handshake state says whether
+    // the server took the session (it is freed once the handshake is over)
+    unsigned long start = millis();
+    bool resumed = false;
+    ret = 0;
+    while (ssl.state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+        ret = mbedtls_ssl_handshake_step(&ssl);
+        if (ssl.handshake) {
+            resumed = ssl.handshake->resume != 0;
+        }
+        if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+            if (millis() - start > handshakeTimeoutMs) {
+                ret = MBEDTLS_ERR_SSL_TIMEOUT;
+                break;
+            }
+            vTaskDelay(1);
+            ret = 0;
+            continue;
+        }
+        if (ret != 0) {
+            break;
+        }
+    }
+    uint32_t elapsed = millis() - start;
+
+    if (ret != 0) {
+        char err[64];
+        mbedtls_strerror(ret, err, sizeof(err));
+        Serial.printf("❌ TLS %s: handshake failed after %lu ms (-0x%04x %s)\n", key, (unsigned long)elapsed, -ret,
+                      err);
+        // A session the server chokes on is not offered again
+        if (offered) {
+            cache_store(key, NULL, 0);
+#if TLS_SESSION_NVS
+            nvs_save(key, NULL, 0);
+#endif
+        }
+        portENTER_CRITICAL(&tlsMux);
+        stats.failures++;
+        portEXIT_CRITICAL(&tlsMux);
+        free(blob);
+        return false;
+    }
+
+    // Keep the session for the next connect: a resumed handshake may bring a new ticket.
+    // Only full handshakes go to NVS, so flash is written when the CPU was spent anyway.
+    if (blob) {
+        mbedtls_ssl_session session;
+        mbedtls_ssl_session_init(&session);
+        size_t len = 0;
+        if (mbedtls_ssl_get_session(&ssl, &session) == 0 &&
+            mbedtls_ssl_session_save(&session, blob, TLS_SESSION_MAX, &len) == 0) {
+            cache_store(key, blob, len);
+#if TLS_SESSION_NVS
+            if (!resumed) {
+                nvs_save(key, blob, len);
+            }
+#endif
+        } else {
+            Serial.printf("⚠️  TLS %s: session too large to cache\n", key);
+        }
+        mbedtls_ssl_session_free(&session);
+        free(blob);
+    }
+
+    portENTER_CRITICAL(&tlsMux);
+    if (resumed) {
+        stats.resumed_handshakes++;
+        stats.resumed_ms_total += elapsed;
+    } else {
+        stats.full_handshakes++;
+        stats.full_ms_total += elapsed;
+        stats.resume_misses += offered ? 1 : 0;
+    }
+    stats.last_ms = elapsed;
+    portEXIT_CRITICAL(&tlsMux);
+
+    lastResumed = resumed;
+    lastHandshakeMs = elapsed;
+    open = true;
+    Serial.printf("🔐 TLS %s: %s handshake in %lu ms (%s)\n", key, resumed ? "resumed" : "full",
+                  (unsigned long)elapsed, mbedtls_ssl_get_ciphersuite(&ssl));
+    return true;
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port) {
+    stop();
+    if (!WiFiClient::connect(ip, port)) {
+        return 0;
+    }
+    String address = ip.toString();
+    if (!handshake(serverName[0] ? serverName : address.c_str(), port)) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port, int32_t timeout) {
+    stop();
+    if (!WiFiClient::connect(ip, port, timeout)) {
+        return 0;
+    }
+    String address = ip.toString();
+    if (!handshake(serverName[0] ? serverName : address.c_str(), port)) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+int TlsClient::connect(const char* host, uint16_t port) {
+    stop();
+    if (!WiFiClient::connect(host, port)) {
+        return 0;
+    }
+    if (!handshake(serverName[0] ? serverName : host, port)) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+int TlsClient::connect(const char* host, uint16_t port, int32_t timeout) {
+    stop();
+    if (!WiFiClient::connect(host, port, timeout)) {
+        return 0;
+    }
+    if (!handshake(serverName[0] ? serverName : host, port)) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+size_t TlsClient::write(uint8_t data) {
+    return write(&data, 1);
+}
+
+size_t TlsClient::write(const uint8_t* buf, size_t size) {
+    if (!open) {
+        return 0;
+    }
+    size_t sent = 0;
+    unsigned long start = millis();
+    while (sent < size) {
+        int ret = mbedtls_ssl_write(&ssl, buf + sent, size - sent);
+        if (ret > 0) {
+            sent += ret;
+        } else if ((ret == MBEDTLS_ERR_SSL_WANT_WRITE || ret == MBEDTLS_ERR_SSL_WANT_READ) &&
+                   millis() - start < handshakeTimeoutMs) {
+            vTaskDelay(1);
+        } else {
+            break;
+        }
+    }
+    return sent;
+}
+
+int TlsClient::available() {
+    if (!open) {
+        return peeked >= 0 ? 1 : 0;
+    }
+    // A zero-length read decrypts the next record if it has arrived
+    int ret = mbedtls_ssl_read(&ssl, NULL, 0);
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        int pending = peeked >= 0 ? 1 : 0;
+        int saved = peeked;
+        stop();                        // Peer closed (close_notify) or the connection broke
+        peeked = saved;
+        return pending;
+    }
+    return (int)mbedtls_ssl_get_bytes_avail(&ssl) + (peeked >= 0 ? 1 : 0);
+}
+
+int TlsClient::read() {
+    uint8_t data;
+    return read(&data, 1) == 1 ? data : -1;
+}
+
+int TlsClient::read(uint8_t* buf, size_t size) {
+    size_t got = 0;
+    if (size > 0 && peeked >= 0) {
+        buf[0] = (uint8_t)peeked;
+        peeked = -1;
+        got = 1;
+    }
+    if (got < size && open) {
+        int ret = mbedtls_ssl_read(&ssl, buf + got, size - got);
+        if (ret > 0) {
+            got += ret;
+        } else if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            stop();
+        }
+    }
+    return got > 0 ? (int)got : -1;
+}
+
+int TlsClient::peek() {
+    if (peeked < 0 && open) {
+        uint8_t data;
+        if (mbedtls_ssl_read(&ssl, &data, 1) == 1) {
+            peeked = data;
+        }
+    }
+    return peeked;
+}
+
+void TlsClient::flush() {
+    // Records go out in write(): nothing buffered here
+}
+
+void TlsClient::stop() {
+    if (open) {
+        mbedtls_ssl_close_notify(&ssl);
+    }
+    release();
+    WiFiClient::stop();
+}
+
+uint8_t TlsClient::connected() {
+    if (peeked >= 0 || (open && mbedtls_ssl_get_bytes_avail(&ssl) > 0)) {
+        return 1;
+    }
+    return open && WiFiClient::connected();
+}
+
+void tls_get_stats(TlsStats* out) {
+    portENTER_CRITICAL(&tlsMux);
+    *out = stats;
+    portEXIT_CRITICAL(&tlsMux);
+}
+
+void tls_forget_sessions(void) {
+    uint8_t* old[TLS_CACHE_ENTRIES];
+    portENTER_CRITICAL(&tlsMux);
+    for (int i = 0; i < TLS_CACHE_ENTRIES; i++) {
+        old[i] = cache[i].data;
+        cache[i] = TlsCacheEntry();
+    }
+    portEXIT_CRITICAL(&tlsMux);
+    for (int i = 0; i < TLS_CACHE_ENTRIES; i++) {
+        free(old[i]);
+    }
+#if TLS_SESSION_NVS
+    Preferences prefs;
+    prefs.begin(TLS_PREFS, false);
+    prefs.clear();
+    prefs.end();
+#endif
+}
@@ -0,0 +1,100 @@
+#ifndef TLS_TRANSPORT_H
+#define TLS_TRANSPORT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/x509_crt.h>
+
+// Shared TLS transport for the Stratum client (stratum+ssl://), the Bitcoin
+// RPC client (https:// nodes) and the Duino-Coin pool picker.
+//
+// A full TLS 1.2 handshake costs seconds of CPU on the ESP32 (ECDHE and the
+// server's signature). The session it establishes is kept in a small RAM
+// cache keyed by host:port and offered on the next connect, so a reconnect to
+// the same server is an abbreviated handshake (session ticket, or session ID
+// when the server has no tickets) with no public-key work at all.
+// With TLS_SESSION_NVS=1 the sessions of full handshakes are also written to
+// NVS and survive a reboot; they hold the session's master secret.
+//
+// Like the HTTPS path it replaces, the server certificate is only verified
+// when a CA is set with setCACert().
+
+#ifndef TLS_SESSION_NVS
+#define TLS_SESSION_NVS 0
+#endif
+
+#define TLS_CACHE_ENTRIES 4            // Pool, backup pool, node, pool picker
+#define TLS_SESSION_MAX 2048           // Largest serialized session (ticket + peer certificate)
+#define TLS_KEY_MAX 80                 // "host:port"
+#define TLS_HANDSHAKE_TIMEOUT_MS 15000
+
+// Handshake counters for every TlsClient
+struct TlsStats {
+    uint32_t full_handshakes;
+    uint32_t resumed_handshakes;
+    uint32_t resume_misses;            // Session offered, the server did a full handshake
+    uint32_t failures;
+    uint32_t last_ms;
+    uint32_t full_ms_total;
+    uint32_t resumed_ms_total;
+};
+
+// WiFiClient with TLS on top: drop-in for HTTPClient::begin(client, url) and
+// for the Stratum client's socket
+class TlsClient : public WiFiClient {
+public:
+    TlsClient();
+    ~TlsClient();
+    TlsClient(const TlsClient&) = delete;
+    TlsClient& operator=(const TlsClient&) = delete;
+
+    // SNI and session cache name in place of the address passed to connect()
+    // (the pool list connects to the IP it resolved itself)
+    void setServerName(const char* name);
+    void setCACert(const char* pem);
+    void setHandshakeTimeout(uint32_t ms) { handshakeTimeoutMs = ms; }
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(IPAddress ip, uint16_t port, int32_t timeout) override;
+    int connect(const char* host, uint16_t port) override;
+    int connect(const char* host, uint16_t port, int32_t timeout) override;
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override;
+    void flush() override;
+    void stop() override;
+    uint8_t connected() override;
+
+    // Last handshake
+    bool resumed() const { return lastResumed; }
+    uint32_t handshakeMs() const { return lastHandshakeMs; }
+
+private:
+    bool handshake(const char* name, uint16_t port);
+    void release();
+    static int bioSend(void* ctx, const unsigned char* buf, size_t len);
+    static int bioRecv(void* ctx, unsigned char* buf, size_t len);
+
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_config conf;
+    mbedtls_x509_crt caCert;
+    const char* caPem;
+    char serverName[TLS_KEY_MAX];
+    uint32_t handshakeTimeoutMs;
+    bool open;                         // Handshake done, ssl usable
+    bool setup;                        // ssl/conf allocated
+    int peeked;                        // Byte read by peek() (-1 = none)
+    bool lastResumed;
+    uint32_t lastHandshakeMs;
+};
+
+void tls_get_stats(TlsStats* out);
+
+// Drop every cached session (RAM and NVS): the next connects are full handshakes
+void tls_forget_sessions(void);
+
+#endif // TLS_TRANSPORT_H
@@ -4,6 +4,7 @@
 #include <DNSServer.h>
 #include <Preferences.h>
 #include <time.h>
+#include "tls_transport.h"
 
 // AP credentials
 #define AP_SSID "TzCoinMinerWifi"
@@ -290,6 +291,18 @@ const char HTML_PAGE[] PROGMEM = R"rawliteral(
                     <input type="number" id="poolPort" name="poolPort" value="%POOL_PORT%">
                 </div>
                 
+                <div class="form-group">
+                    <label for="backupPools">Backup Pools (optional)</label>
+                    <input type="text" id="backupPools" name="backupPools" value="%BACKUP_POOLS%" placeholder="host:port, host:port">
+                    <small style="color: #666; display: block; margin-top: 5px;">Used in order when the main pool is unreachable</small>
+                </div>
+                
+                <div class="form-group">
+                    <label for="bchSplit">BCH Split (%)</label>
+                    <input type="number" id="bchSplit" name="bchSplit" value="%BCH_SPLIT%" min="0" max="99">
+                    <small style="color: #666; display: block; margin-top: 5px;">Hashing time given to the BCH pool while mining BTC (0 = off, uses the BCH wallet)</small>
+                </div>
+                
                 <div class="form-group">
                     <label for="poolPassword">Pool Password</label>
                     <input type="text" id="poolPassword" name="poolPassword" value="%POOL_PW%">
@@ -461,9 +474,11 @@ String getHtmlPage() {
     html.replace("%WIFI_PW%", currentConfig.password);
     html.replace("%POOL_URL%", currentConfig.poolUrl);
     html.replace("%POOL_PORT%", String(currentConfig.poolPort));
+    html.replace("%BACKUP_POOLS%", currentConfig.backupPools);
     html.replace("%POOL_PW%", currentConfig.poolPassword);
     html.replace("%BTC_WALLET%", currentConfig.btcWallet);
     html.replace("%BCH_WALLET%", currentConfig.bchWallet);
+    html.replace("%BCH_SPLIT%", String(currentConfig.bchSplitPercent));
     html.replace("%RPC_HOST%", currentConfig.rpcHost);
     html.replace("%RPC_PORT%", String(currentConfig.rpcPort));
     html.replace("%RPC_USER%", currentConfig.rpcUser);
@@ -530,6 +545,8 @@ void handleRoot() {
 
 // Handle save configuration
 void handleSave() {
+    WifiConfig previous = currentConfig;
+    
     // Get form data
     if (server.hasArg("ssid")) {
         strncpy(currentConfig.ssid, server.arg("ssid").c_str(), sizeof(currentConfig.ssid) - 1);
@@ -546,6 +563,9 @@ void handleSave() {
     if (server.hasArg("poolPort")) {
         currentConfig.poolPort = server.arg("poolPort").toInt();
     }
+    if (server.hasArg("backupPools")) {
+        strncpy(currentConfig.backupPools, server.arg("backupPools").c_str(), sizeof(currentConfig.backupPools) - 1);
+    }
     if (server.hasArg("poolPassword")) {
         strncpy(currentConfig.poolPassword, server.arg("poolPassword").c_str(), sizeof(currentConfig.poolPassword) - 1);
     }
@@ -555,6 +575,9 @@ void handleSave() {
     if (server.hasArg("bchWallet")) {
         strncpy(currentConfig.bchWallet, server.arg("bchWallet").c_str(), sizeof(currentConfig.bchWallet) - 1);
     }
+    if (server.hasArg("bchSplit")) {
+        currentConfig.bchSplitPercent = constrain(server.arg("bchSplit").toInt(), 0, 99);
+    }
     if (server.hasArg("rpcHost")) {
         strncpy(currentConfig.rpcHost, server.arg("rpcHost").c_str(), sizeof(currentConfig.rpcHost) - 1);
     }
@@ -595,6 +618,13 @@ void handleSave() {
         Serial.printf("Solo Mode: %s\n", currentConfig.soloMode ? "ON" : "OFF");
         Serial.printf("Auto Start Mining: %s\n", currentConfig.autoStartMining ? "ON" : "OFF");
         
+        // New pools or node: the TLS sessions cached for the old servers are never resumed again
+        if (strcmp(previous.poolUrl, currentConfig.poolUrl) != 0 || previous.poolPort != currentConfig.poolPort ||
+            strcmp(previous.backupPools, currentConfig.backupPools) != 0 ||
+            strcmp(previous.rpcHost, currentConfig.rpcHost) != 0 || previous.rpcPort != currentConfig.rpcPort) {
+            tls_forget_sessions();
+        }
+        
         // Update global config variable
         memcpy(&config, &currentConfig, sizeof(WifiConfig));
         
@@ -861,9 +891,11 @@ bool wifi_load_config(WifiConfig &config) {
         strcpy(config.password, "myWifiPassword");
         strcpy(config.poolUrl, "public-pool.io");
         config.poolPort = 21496;
+        strcpy(config.backupPools, "");
         strcpy(config.poolPassword, "x");
         strcpy(config.btcWallet, "YOUR_BTC_WALLET_ADDRESS");
         strcpy(config.bchWallet, "YOUR_BCH_WALLET_ADDRESS");  // Empty by default
+        config.bchSplitPercent = 0;  // Default: all hashing time on the BTC pool
         strcpy(config.rpcHost, "127.0.0.1");
         config.rpcPort = 8332;
         strcpy(config.rpcUser, "bitcoinrpc");
@@ -883,9 +915,11 @@ bool wifi_load_config(WifiConfig &config) {
     preferences.getString("password", config.password, sizeof(config.password));
     preferences.getString("poolUrl", config.poolUrl, sizeof(config.poolUrl));
     config.poolPort = preferences.getUShort("poolPort", 21496);
+    preferences.getString("backupPools", config.backupPools, sizeof(config.backupPools));
     preferences.getString("poolPW", config.poolPassword, sizeof(config.poolPassword));
     preferences.getString("btcWallet", config.btcWallet, sizeof(config.btcWallet));
     preferences.getString("bchWallet", config.bchWallet, sizeof(config.bchWallet));
+    config.bchSplitPercent = preferences.getUChar("bchSplit", 0);
     preferences.getString("rpcHost", config.rpcHost, sizeof(config.rpcHost));
     config.rpcPort = preferences.getUShort("rpcPort", 8332);
     preferences.getString("rpcUser", config.rpcUser, sizeof(config.rpcUser));
@@ -911,9 +945,11 @@ bool wifi_save_config(const WifiConfig &config) {
     preferences.putString("password", config.password);
     preferences.putString("poolUrl", config.poolUrl);
     preferences.putUShort("poolPort", config.poolPort);
+    preferences.putString("backupPools", config.backupPools);
     preferences.putString("poolPW", config.poolPassword);
     preferences.putString("btcWallet", config.btcWallet);
     preferences.putString("bchWallet", config.bchWallet);
+    preferences.putUChar("bchSplit", config.bchSplitPercent);
     preferences.putString("rpcHost", config.rpcHost);
     preferences.putUShort("rpcPort", config.rpcPort);
     preferences.putString("rpcUser", config.rpcUser);
@@ -945,6 +981,12 @@ bool wifi_save_config(const WifiConfig &config) {
         Serial.printf("  DUCO Username: %s\n", config.ducoUsername);
     } else {
         Serial.printf("  Pool: %s:%d\n", config.poolUrl, config.poolPort);
+        if (strlen(config.backupPools) > 0) {
+            Serial.printf("  Backup Pools: %s\n", config.backupPools);
+        }
+        if (config.bchSplitPercent > 0) {
+            Serial.printf("  BCH Split: %u%%\n", config.bchSplitPercent);
+        }
         Serial.printf("  Wallet: %s\n", config.btcWallet);
         Serial.printf("  RPC: %s:%d (user: %s)\n", config.rpcHost, config.rpcPort, config.rpcUser);
         Serial.printf("  Solo Mode: %s\n", config.soloMode ? "YES" : "NO");
@@ -9,9 +9,11 @@ struct WifiConfig {
     char password[64];
     char poolUrl[128];
     uint16_t poolPort;
+    char backupPools[192];  // Failover pools "host:port,host:port" (tried in order after poolUrl)
     char poolPassword[64];
     char btcWallet[128];
     char bchWallet[128];    // Separate BCH wallet address
+    uint8_t bchSplitPercent; // Share of BTC pool hashing time given to the BCH pool (0 = off)
     char rpcHost[128];      // Bitcoin RPC host
     uint16_t rpcPort;       // Bitcoin RPC port
     char rpcUser[64];       // Bitcoin RPC username
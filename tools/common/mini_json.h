@@ -0,0 +1,301 @@
+#ifndef MINI_JSON_H
+#define MINI_JSON_H
+
+// Minimal JSON reader/writer for the host-side Stratum tools.
+// Stratum V1 only needs strings, numbers, bools, null and nested arrays,
+// so this keeps numbers as their original text to re-serialize them unchanged.
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+
+struct JsonValue {
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type type = NUL;
+    bool boolean = false;
+    std::string text;   // String contents, or the literal text of a number
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    bool isNull() const { return type == NUL; }
+    size_t size() const { return type == ARRAY ? items.size() : 0; }
+    double asNumber() const { return type == NUMBER ? strtod(text.c_str(), NULL) : 0.0; }
+    bool asBool() const { return type == BOOL ? boolean : false; }
+    const std::string& asString() const { return text; }
+
+    // Array element (a null value when out of range)
+    const JsonValue& operator[](int index) const {
+        static const JsonValue null_value;
+        return (type == ARRAY && index >= 0 && (size_t)index < items.size()) ? items[index] : null_value;
+    }
+
+    // Object member (a null value when missing)
+    const JsonValue& operator[](const char* key) const {
+        static const JsonValue null_value;
+        if (type == OBJECT) {
+            for (const auto& member : members) {
+                if (member.first == key) {
+                    return member.second;
+                }
+            }
+        }
+        return null_value;
+    }
+
+    std::string dump() const;
+};
+
+// Quote and escape a string for JSON output
+inline std::string json_quote(const std::string& s) {
+    std::string out = "\"";
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    out += "\"";
+    return out;
+}
+
+inline std::string JsonValue::dump() const {
+    switch (type) {
+        case BOOL:   return boolean ? "true" : "false";
+        case NUMBER: return text;
+        case STRING: return json_quote(text);
+        case ARRAY: {
+            std::string out = "[";
+            for (size_t i = 0; i < items.size(); i++) {
+                if (i > 0) out += ",";
+                out += items[i].dump();
+            }
+            return out + "]";
+        }
+        case OBJECT: {
+            std::string out = "{";
+            for (size_t i = 0; i < members.size(); i++) {
+                if (i > 0) out += ",";
+                out += json_quote(members[i].first) + ":" + members[i].second.dump();
+            }
+            return out + "}";
+        }
+        default:
+            return "null";
+    }
+}
+
+// Recursive descent parser over a single line
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& s) : src(s), pos(0) {}
+
+    bool parse(JsonValue& out) {
+        skipSpace();
+        if (!parseValue(out, 0)) {
+            return false;
+        }
+        skipSpace();
+        return pos == src.size();
+    }
+
+private:
+    static const int MAX_DEPTH = 16;
+
+    const std::string& src;
+    size_t pos;
+
+    void skipSpace() {
+        while (pos < src.size() && (src[pos] == ' ' || src[pos] == '\t' || src[pos] == '\r' || src[pos] == '\n')) {
+            pos++;
+        }
+    }
+
+    bool literal(const char* word) {
+        size_t len = strlen(word);
+        if (src.compare(pos, len, word) != 0) {
+            return false;
+        }
+        pos += len;
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        if (pos >= src.size() || src[pos] != '"') {
+            return false;
+        }
+        pos++;
+        while (pos < src.size()) {
+            char c = src[pos++];
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= src.size()) {
+                return false;
+            }
+            char e = src[pos++];
+            switch (e) {
+                case '"': case '\\': case '/': out += e; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    // Stratum never carries non-ASCII text, keep BMP code points as UTF-8
+                    if (pos + 4 > src.size()) {
+                        return false;
+                    }
+                    unsigned cp = strtoul(src.substr(pos, 4).c_str(), NULL, 16);
+                    pos += 4;
+                    if (cp < 0x80) {
+                        out += (char)cp;
+                    } else if (cp < 0x800) {
+                        out += (char)(0xC0 | (cp >> 6));
+                        out += (char)(0x80 | (cp & 0x3F));
+                    } else {
+                        out += (char)(0xE0 | (cp >> 12));
+                        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+                        out += (char)(0x80 | (cp & 0x3F));
+                    }
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    bool parseValue(JsonValue& out, int depth) {
+        if (depth > MAX_DEPTH || pos >= src.size()) {
+            return false;
+        }
+
+        char c = src[pos];
+        if (c == '"') {
+            out.type = JsonValue::STRING;
+            return parseString(out.text);
+        }
+        if (c == '[') {
+            out.type = JsonValue::ARRAY;
+            pos++;
+            skipSpace();
+            if (pos < src.size() && src[pos] == ']') {
+                pos++;
+                return true;
+            }
+            while (true) {
+                out.items.emplace_back();
+                skipSpace();
+                if (!parseValue(out.items.back(), depth + 1)) {
+                    return false;
+                }
+                skipSpace();
+                if (pos >= src.size()) {
+                    return false;
+                }
+                if (src[pos] == ',') {
+                    pos++;
+                } else if (src[pos] == ']') {
+                    pos++;
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+        }
+        if (c == '{') {
+            out.type = JsonValue::OBJECT;
+            pos++;
+            skipSpace();
+            if (pos < src.size() && src[pos] == '}') {
+                pos++;
+                return true;
+            }
+            while (true) {
+                std::string key;
+                skipSpace();
+                if (!parseString(key)) {
+                    return false;
+                }
+                skipSpace();
+                if (pos >= src.size() || src[pos] != ':') {
+                    return false;
+                }
+                pos++;
+                skipSpace();
+                out.members.emplace_back(key, JsonValue());
+                if (!parseValue(out.members.back().second, depth + 1)) {
+                    return false;
+                }
+                skipSpace();
+                if (pos >= src.size()) {
+                    return false;
+                }
+                if (src[pos] == ',') {
+                    pos++;
+                } else if (src[pos] == '}') {
+                    pos++;
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+        }
+        if (literal("true")) {
+            out.type = JsonValue::BOOL;
+            out.boolean = true;
+            return true;
+        }
+        if (literal("false")) {
+            out.type = JsonValue::BOOL;
+            out.boolean = false;
+            return true;
+        }
+        if (literal("null")) {
+            out.type = JsonValue::NUL;
+            return true;
+        }
+
+        // Number: keep the literal text
+        size_t start = pos;
+        while (pos < src.size() && (isdigit((unsigned char)src[pos]) || src[pos] == '-' || src[pos] == '+' ||
+                                    src[pos] == '.' || src[pos] == 'e' || src[pos] == 'E')) {
+            pos++;
+        }
+        if (pos == start) {
+            return false;
+        }
+        out.type = JsonValue::NUMBER;
+        out.text = src.substr(start, pos - start);
+        return true;
+    }
+};
+
+inline bool json_parse(const std::string& text, JsonValue& out) {
+    out = JsonValue();
+    JsonParser parser(text);
+    return parser.parse(out);
+}
+
+#endif // MINI_JSON_H
@@ -0,0 +1,101 @@
+#ifndef TOOLS_SHA1_H
+#define TOOLS_SHA1_H
+
+// Portable SHA-1 for the host-side tools (the device uses mbedtls).
+// Used as the reference the DUCO-S1 kernel is checked and benchmarked against.
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+struct Sha1 {
+    uint32_t state[5];
+    uint64_t length;
+    uint8_t block[64];
+    size_t used;
+
+    Sha1() { reset(); }
+
+    void reset() {
+        static const uint32_t init[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+        memcpy(state, init, sizeof(state));
+        length = 0;
+        used = 0;
+    }
+
+    void update(const uint8_t* data, size_t len) {
+        length += len;
+        while (len > 0) {
+            size_t take = 64 - used;
+            if (take > len) {
+                take = len;
+            }
+            memcpy(block + used, data, take);
+            used += take;
+            data += take;
+            len -= take;
+            if (used == 64) {
+                transform(block);
+                used = 0;
+            }
+        }
+    }
+
+    void finish(uint8_t out[20]) {
+        uint64_t bits = length * 8;
+        uint8_t pad = 0x80;
+        update(&pad, 1);
+        pad = 0;
+        while (used != 56) {
+            update(&pad, 1);
+        }
+        uint8_t len_be[8];
+        for (int i = 0; i < 8; i++) {
+            len_be[i] = (uint8_t)(bits >> (56 - i * 8));
+        }
+        update(len_be, 8);
+        for (int i = 0; i < 5; i++) {
+            out[i * 4 + 0] = (uint8_t)(state[i] >> 24);
+            out[i * 4 + 1] = (uint8_t)(state[i] >> 16);
+            out[i * 4 + 2] = (uint8_t)(state[i] >> 8);
+            out[i * 4 + 3] = (uint8_t)(state[i]);
+        }
+    }
+
+private:
+    static uint32_t rotl(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+    void transform(const uint8_t* p) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            w[i] = ((uint32_t)p[i * 4] << 24) | ((uint32_t)p[i * 4 + 1] << 16) |
+                   ((uint32_t)p[i * 4 + 2] << 8) | (uint32_t)p[i * 4 + 3];
+        }
+        for (int i = 16; i < 80; i++) {
+            w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = rotl(b, 30); b = a; a = temp;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d; state[4] += e;
+    }
+};
+
+#endif // TOOLS_SHA1_H
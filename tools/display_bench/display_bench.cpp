@@ -0,0 +1,309 @@
+// Host benchmark for the display frame diff (src/frame_diff.cpp).
+//
+// Draws the frames of the logo page the way display.cpp does: every frame
+// clears the screen and redraws the status bar, the clock and the page. Two
+// scenes are played at the board's refresh rate (one frame every 20 ms):
+//
+//   logo       the idle logo page: only the clock changes, once a second
+//   animation  the star field with "The answer is 42" scrolling up 2 pixels
+//              per frame
+//
+// The rectangles from frame_diff_collect() are compared with pushing the whole
+// framebuffer (the old pushFramebuffer). A simulated panel receives the
+// rectangles and must equal the framebuffer after every frame. The tool
+// prints bytes per second to the panel, rectangles per frame and the CPU time
+// of the diff, and exits non-zero on any mismatch.
+//
+// Glyphs are pseudo-random 8x8 bitmaps: display_assets.h needs Arduino.h.
+// Only the amount of pixels that change matters here, not their shape.
+//
+// Build: see README.md
+// Usage: display_bench [-t seconds] [-m max_rects] [-s seed]
+
+#include "frame_diff.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define WIDTH 536                   // Panel of the T-Display S3 AMOLED
+#define HEIGHT 240
+#define STATUS_BAR_HEIGHT 45
+#define FRAME_MS 20                 // Logo page refresh on the board
+#define BUS_BYTES_PER_SEC 37500000  // 75 MHz QSPI, 4 bits per clock
+#define NUM_STARS 50
+
+static int opt_seconds = 10;
+static int opt_max_rects = FRAME_DIFF_MAX_RECTS;
+static unsigned opt_seed = 1;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("❌ %s\n", what);
+        failures++;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Drawing, as in display.cpp
+// ---------------------------------------------------------------------------
+
+static uint16_t framebuffer[WIDTH * HEIGHT];
+static frame_diff_t diff;
+
+static inline void putPixel(int x, int y, uint16_t color) {
+    if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT) {
+        framebuffer[y * WIDTH + x] = color;
+    }
+}
+
+static void fillScreen(uint16_t color) {
+    for (int i = 0; i < WIDTH * HEIGHT; i++) {
+        framebuffer[i] = color;
+    }
+}
+
+static void fillRect(int x, int y, int w, int h, uint16_t color) {
+    for (int j = 0; j < h; j++) {
+        for (int i = 0; i < w; i++) {
+            putPixel(x + i, y + j, color);
+        }
+    }
+}
+
+static void drawPixel(int x, int y, uint16_t color) {
+    putPixel(x, y, color);
+}
+
+static uint8_t glyphs[128][8];
+
+static void drawChar(int x, int y, char c, uint16_t color, int scale) {
+    const uint8_t* bitmap = glyphs[c & 127];
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            if (bitmap[row] & (0x80 >> col)) {
+                for (int sy = 0; sy < scale; sy++) {
+                    for (int sx = 0; sx < scale; sx++) {
+                        putPixel(x + col * scale + sx, y + row * scale + sy, color);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void drawText(const char* text, int x, int y, uint16_t color, int scale, bool centerX) {
+    int len = strlen(text);
+    int startX = centerX ? (WIDTH - len * 8 * scale) / 2 : x;
+    for (int i = 0; i < len; i++) {
+        drawChar(startX + i * 8 * scale, y, text[i], color, scale);
+    }
+}
+
+static void drawStatusBar(int second) {
+    const uint16_t darkGrey = 0x0421;
+    const int cornerRadius = 12;
+    fillRect(0, 0, WIDTH, STATUS_BAR_HEIGHT - cornerRadius, darkGrey);
+    for (int row = 0; row < cornerRadius; row++) {
+        int cutoff = cornerRadius - (int)__builtin_sqrt(cornerRadius * cornerRadius - row * row);
+        fillRect(cutoff, STATUS_BAR_HEIGHT - cornerRadius + row, WIDTH - 2 * cutoff, 1, darkGrey);
+    }
+
+    // WiFi and mining icons, coin, mode letter
+    for (int i = 0; i < 16 * 16; i += 3) {
+        drawPixel(WIDTH - 26 + i % 16, 14 + i / 16, 0xE007);
+        drawPixel(WIDTH - 50 + i % 16, 14 + i / 16, 0xE007);
+    }
+    for (int dy = -8; dy <= 8; dy++) {
+        for (int dx = -8; dx <= 8; dx++) {
+            if (dx * dx + dy * dy <= 64) {
+                drawPixel(WIDTH - 74 + dx, 22 + dy, 0x0000);
+            }
+        }
+    }
+    drawText("P", WIDTH - 106, 14, 0xE007, 2, false);
+
+    char timeStr[32];
+    snprintf(timeStr, sizeof(timeStr), "%02d/%02d/%02d - %02d:%02d:%02d", 18, 10, 26, 12, 30 + second / 60,
+             second % 60);
+    drawText(timeStr, 10, (STATUS_BAR_HEIGHT - 16) / 2, 0xFFFF, 2, false);
+}
+
+static void drawLogoPage(int second) {
+    fillScreen(0x0000);
+    drawStatusBar(second);
+    int lineHeight = 8 * 5;
+    int startY = STATUS_BAR_HEIGHT + (HEIGHT - STATUS_BAR_HEIGHT - (lineHeight * 2 + 10)) / 2;
+    drawText("TzCoinMiner", 0, startY, 0x20FC, 5, true);
+    drawText("BTC POOL", 0, startY + lineHeight + 10, 0xF83C, 5, true);
+}
+
+static int starX[NUM_STARS];
+static int starY[NUM_STARS];
+
+static void drawAnimation(int second, int scrollOffset) {
+    fillScreen(0x0000);
+    fillRect(0, STATUS_BAR_HEIGHT, WIDTH, HEIGHT - STATUS_BAR_HEIGHT, 0x0000);
+    for (int i = 0; i < NUM_STARS; i++) {
+        drawPixel(starX[i], starY[i], 0xFFFF);
+        drawPixel(starX[i] + 1, starY[i], 0xFFFF);
+        drawPixel(starX[i], starY[i] + 1, 0xFFFF);
+        drawPixel(starX[i] + 1, starY[i] + 1, 0xFFFF);
+    }
+    int line1Y = HEIGHT + scrollOffset;
+    int line2Y = line1Y + 32 + 30;
+    if (line1Y < HEIGHT && line1Y + 32 > STATUS_BAR_HEIGHT) {
+        drawText("The answer is", 0, line1Y, 0x20FC, 4, true);
+    }
+    if (line2Y < HEIGHT && line2Y + 64 > STATUS_BAR_HEIGHT) {
+        drawText("42", 0, line2Y, 0xF83C, 8, true);
+    }
+    if (line1Y < STATUS_BAR_HEIGHT || line2Y < STATUS_BAR_HEIGHT) {
+        fillRect(0, 0, WIDTH, STATUS_BAR_HEIGHT, 0x0000);
+    }
+    drawStatusBar(second);
+}
+
+// ---------------------------------------------------------------------------
+// Scenes
+// ---------------------------------------------------------------------------
+
+struct SceneStats {
+    const char* name;
+    int frames;
+    int skipped;
+    uint64_t rects;
+    uint64_t bytes;
+    uint64_t changed;
+    double collect_us;
+};
+
+static uint16_t panel[WIDTH * HEIGHT];
+
+static SceneStats play(const char* name, bool animation) {
+    SceneStats stats = {name, 0, 0, 0, 0, 0, 0};
+    int frames = opt_seconds * 1000 / FRAME_MS;
+    int scrollOffset = 0;
+    int travel = (HEIGHT - STATUS_BAR_HEIGHT) + (32 + 30 + 64);
+
+    // Panel content unknown at the start: the first frame is a full push
+    frame_diff_invalidate(&diff);
+    for (int frame = 0; frame <= frames; frame++) {
+        int second = frame * FRAME_MS / 1000;
+        if (animation) {
+            drawAnimation(second, scrollOffset);
+            scrollOffset -= 2;
+            if (scrollOffset < -travel) {
+                scrollOffset = 0;
+            }
+        } else {
+            drawLogoPage(second);
+        }
+
+        diff_rect_t rects[FRAME_DIFF_MAX_RECTS];
+        auto start = std::chrono::steady_clock::now();
+        int count = frame_diff_collect(&diff, rects, opt_max_rects);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        for (int i = 0; i < count; i++) {
+            const diff_rect_t& r = rects[i];
+            check(r.x >= 0 && r.y >= 0 && r.w > 0 && r.h > 0 && r.x + r.w <= WIDTH && r.y + r.h <= HEIGHT,
+                  "rectangle inside the panel");
+            check(r.x % FRAME_DIFF_ALIGN == 0 && r.y % FRAME_DIFF_ALIGN == 0 && r.w % FRAME_DIFF_ALIGN == 0 &&
+                      r.h % FRAME_DIFF_ALIGN == 0,
+                  "rectangle aligned for the panel");
+            for (int y = r.y; y < r.y + r.h; y++) {
+                memcpy(panel + y * WIDTH + r.x, framebuffer + y * WIDTH + r.x, r.w * sizeof(uint16_t));
+            }
+        }
+        check(count <= opt_max_rects, "at most max_rects rectangles");
+        check(memcmp(panel, framebuffer, sizeof(panel)) == 0, "panel matches the framebuffer");
+        if (frame == 0) {
+            continue;  // First frame of the scene: full push
+        }
+
+        stats.frames++;
+        stats.skipped += count == 0;
+        stats.rects += count;
+        stats.changed += diff.changed;
+        stats.collect_us += us;
+        for (int i = 0; i < count; i++) {
+            stats.bytes += (uint64_t)rects[i].w * rects[i].h * sizeof(uint16_t);
+        }
+    }
+    return stats;
+}
+
+static void report(const SceneStats& s) {
+    double seconds = s.frames * FRAME_MS / 1000.0;
+    double full_bytes = (double)WIDTH * HEIGHT * sizeof(uint16_t) * s.frames;
+    double full_bus_ms = (double)WIDTH * HEIGHT * sizeof(uint16_t) * 1000.0 / BUS_BYTES_PER_SEC;
+    double diff_bus_ms = s.bytes * 1000.0 / BUS_BYTES_PER_SEC / s.frames;
+
+    printf("┌─────────────────────────────────────────────────────┐\n");
+    printf("│ %-10s %-40s │\n", s.name, "");
+    printf("├─────────────────────────────────────────────────────┤\n");
+    printf("│ Frames:        %9d (%d skipped)%*s│\n", s.frames, s.skipped, 17 - snprintf(NULL, 0, "%d", s.skipped), "");
+    printf("│ Rectangles:    %9.2f per frame                  │\n", (double)s.rects / s.frames);
+    printf("│ Full push:     %9.0f KB/s                       │\n", full_bytes / seconds / 1024);
+    printf("│ Diff push:     %9.0f KB/s                       │\n", s.bytes / seconds / 1024);
+    printf("│ Bus full:      %9.3f ms per frame               │\n", full_bus_ms);
+    printf("│ Bus diff:      %9.3f ms per frame               │\n", diff_bus_ms);
+    printf("│ Changed:       %9.0f pixels per frame           │\n", (double)s.changed / s.frames);
+    printf("│ Collect:       %9.1f us per frame (host)        │\n", s.collect_us / s.frames);
+    printf("└─────────────────────────────────────────────────────┘\n");
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "t:m:s:")) != -1) {
+        switch (opt) {
+            case 't': opt_seconds = atoi(optarg); break;
+            case 'm': opt_max_rects = atoi(optarg); break;
+            case 's': opt_seed = (unsigned)strtoul(optarg, NULL, 10); break;
+            default:
+                fprintf(stderr, "Usage: %s [-t seconds] [-m max_rects] [-s seed]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (opt_seconds < 1 || opt_max_rects < 1 || opt_max_rects > FRAME_DIFF_MAX_RECTS) {
+        fprintf(stderr, "seconds must be >= 1, max_rects between 1 and %d\n", FRAME_DIFF_MAX_RECTS);
+        return 2;
+    }
+
+    std::mt19937 rng(opt_seed);
+    for (int c = 0; c < 128; c++) {
+        for (int row = 0; row < 8; row++) {
+            glyphs[c][row] = c == ' ' ? 0 : (uint8_t)rng();
+        }
+    }
+    for (int i = 0; i < NUM_STARS; i++) {
+        starX[i] = rng() % WIDTH;
+        starY[i] = STATUS_BAR_HEIGHT + rng() % (HEIGHT - STATUS_BAR_HEIGHT);
+    }
+
+    std::vector<uint8_t> buffer(frame_diff_bytes(WIDTH, HEIGHT));
+    if (!frame_diff_init(&diff, framebuffer, buffer.data(), buffer.size(), WIDTH, HEIGHT)) {
+        fprintf(stderr, "frame_diff_init failed\n");
+        return 1;
+    }
+
+    printf("🖥️  %dx%d panel, %d s per scene at %d fps, up to %d rectangles\n\n", WIDTH, HEIGHT, opt_seconds,
+           1000 / FRAME_MS, opt_max_rects);
+    report(play("LOGO", false));
+    report(play("ANIMATION", true));
+
+    if (failures) {
+        printf("\n❌ %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("\n✅ Panel matched the framebuffer after every frame\n");
+    return 0;
+}
@@ -0,0 +1,239 @@
+// Host benchmark for the DUCO-S1 search.
+//
+// Generates random jobs the way a Duino-Coin server does (random block hash,
+// random solution in 0..100*difficulty, expected = SHA-1(hash + solution)) and
+// solves each one with:
+//   - reference: the original per-candidate loop (string concat, full SHA-1,
+//     hex string, string compare), with mbedtls replaced by a portable SHA-1
+//   - kernel:    duino_kernel_search_lanes() from src/duino_kernel.cpp, once
+//     per lane count (1, 2, 4, 8)
+//   - workers:   duino_workers_search() from src/duino_workers.cpp with 1..N
+//     std::thread workers and the default lane count (scaling test)
+// All must find the same nonce. Before timing, the ASCII nonce counter is
+// checked against std::to_string and the kernel is run on solutions sitting
+// on digit-length boundaries. The tool exits non-zero on any mismatch.
+//
+// Build: see README.md
+// Usage: duco_bench [-j jobs] [-d difficulty] [-s seed] [-t max_workers]
+
+#include "../common/sha1.h"
+#include "duino_kernel.h"
+#include "duino_workers.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+static const int LANE_COUNTS[] = {1, 2, 4, 8};
+
+struct Job {
+    std::string prefix;
+    std::string expected;
+    int solution;
+};
+
+static std::string sha1_hex(const std::string& data) {
+    uint8_t hash[20];
+    Sha1 ctx;
+    ctx.update((const uint8_t*)data.data(), data.size());
+    ctx.finish(hash);
+
+    // Same per-byte hex building as the original duino_sha1()
+    std::string result = "";
+    for (int i = 0; i < 20; i++) {
+        char buf[3];
+        snprintf(buf, sizeof(buf), "%02x", hash[i]);
+        result += buf;
+    }
+    return result;
+}
+
+// Original duino_duco_s1() loop
+static int reference_search(const std::string& last_block_hash, const std::string& expected_hash, int difficulty,
+                            uint64_t* hashes) {
+    for (int ducos1res = 0; ducos1res < 100 * difficulty + 1; ducos1res++) {
+        std::string hash = sha1_hex(last_block_hash + std::to_string(ducos1res));
+        (*hashes)++;
+        if (hash == expected_hash) {
+            return ducos1res;
+        }
+    }
+    return -1;
+}
+
+// Random 40-char block hash
+static std::string random_prefix(std::mt19937& rng) {
+    std::string prefix;
+    for (int i = 0; i < 40; i++) {
+        prefix += "0123456789abcdef"[rng() % 16];
+    }
+    return prefix;
+}
+
+// In-place ASCII counter must match decimal formatting, from 0 and from random starts
+static int check_counter(std::mt19937& rng) {
+    int errors = 0;
+    duino_nonce_t nonce;
+    duino_nonce_set(&nonce, 0);
+    for (uint32_t v = 0; v < 2000000; v++) {
+        if (std::string(nonce.digits, nonce.len) != std::to_string(v)) {
+            printf("❌ Counter: %u formatted as %s\n", v, nonce.digits);
+            errors++;
+            break;
+        }
+        duino_nonce_next(&nonce);
+    }
+    for (int i = 0; i < 1000 && errors == 0; i++) {
+        uint32_t start = rng() % 4000000000u;
+        duino_nonce_set(&nonce, start);
+        for (uint32_t k = 0; k < 1000; k++) {
+            if (std::string(nonce.digits, nonce.len) != std::to_string(start + k)) {
+                printf("❌ Counter: %u formatted as %s\n", start + k, nonce.digits);
+                errors++;
+                break;
+            }
+            duino_nonce_next(&nonce);
+        }
+    }
+    return errors;
+}
+
+// Solutions right at and around digit-length boundaries, searched from 0, from
+// just below and from just past the solution (batches straddle the boundary)
+static int check_boundaries(std::mt19937& rng, int lanes) {
+    static const int solutions[] = {0, 1, 7, 9, 10, 11, 99, 100, 999, 1000, 9999, 10000, 99999, 100000, 100100};
+    int errors = 0;
+    for (int solution : solutions) {
+        std::string prefix = random_prefix(rng);
+        std::string expected = sha1_hex(prefix + std::to_string(solution));
+        duino_kernel_job_t job;
+        if (!duino_kernel_prepare(&job, prefix.c_str(), expected.c_str())) {
+            printf("❌ Prepare failed\n");
+            return 1;
+        }
+        uint32_t hashes = 0;
+        uint32_t end = 100 * 1001 + 1;
+        for (uint32_t start = solution > 9 ? solution - 9 : 0; start <= (uint32_t)solution; start++) {
+            int32_t found = duino_kernel_search_lanes(&job, start, end, &hashes, lanes);
+            if (found != solution || hashes != solution - start + 1) {
+                printf("❌ %d lanes, boundary %d from %u -> %d (%u hashes)\n", lanes, solution, start, found, hashes);
+                errors++;
+            }
+        }
+        int32_t past = duino_kernel_search_lanes(&job, solution + 1, end, &hashes, lanes);
+        int32_t cut = duino_kernel_search_lanes(&job, 0, solution, &hashes, lanes);
+        if (past != -1 || cut != -1) {
+            printf("❌ %d lanes, boundary %d: past -> %d, range end -> %d\n", lanes, solution, past, cut);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int jobs = 20;
+    int difficulty = 1500;
+    unsigned seed = 1;
+    int max_workers = 2;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:d:s:t:")) != -1) {
+        switch (opt) {
+            case 'j': jobs = atoi(optarg); break;
+            case 'd': difficulty = atoi(optarg); break;
+            case 's': seed = (unsigned)atoi(optarg); break;
+            case 't': max_workers = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-j jobs] [-d difficulty] [-s seed] [-t max_workers]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (jobs <= 0 || difficulty <= 0 || max_workers < 1 || max_workers > DUINO_MAX_WORKERS) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+
+    std::mt19937 rng(seed);
+    int mismatches = check_counter(rng);
+    for (int lanes : LANE_COUNTS) {
+        mismatches += check_boundaries(rng, lanes);
+    }
+
+    std::vector<Job> job_list;
+    for (int j = 0; j < jobs; j++) {
+        Job job;
+        job.prefix = random_prefix(rng);
+        job.solution = (int)(rng() % (100 * difficulty + 1));
+        job.expected = sha1_hex(job.prefix + std::to_string(job.solution));
+        job_list.push_back(job);
+    }
+
+    printf("DUCO-S1 benchmark: %d jobs, difficulty %d (default lanes: %d)\n", jobs, difficulty, DUINO_SHA1_LANES);
+
+    uint64_t ref_hashes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t j = 0; j < job_list.size(); j++) {
+        int result = reference_search(job_list[j].prefix, job_list[j].expected, difficulty, &ref_hashes);
+        if (result != job_list[j].solution) {
+            printf("❌ Job %zu: solution %d, reference %d\n", j, job_list[j].solution, result);
+            mismatches++;
+        }
+    }
+    double ref_rate = ref_hashes / seconds_since(start);
+    printf("  reference:  %10.0f H/s\n", ref_rate);
+
+    for (int lanes : LANE_COUNTS) {
+        uint64_t kernel_hashes = 0;
+        start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < job_list.size(); j++) {
+            duino_kernel_job_t job;
+            int32_t result = -1;
+            uint32_t hashes = 0;
+            if (duino_kernel_prepare(&job, job_list[j].prefix.c_str(), job_list[j].expected.c_str())) {
+                result = duino_kernel_search_lanes(&job, 0, 100 * difficulty + 1, &hashes, lanes);
+            }
+            kernel_hashes += hashes;
+            if (result != job_list[j].solution) {
+                printf("❌ Job %zu: solution %d, %d lanes %d\n", j, job_list[j].solution, lanes, result);
+                mismatches++;
+            }
+        }
+        double rate = kernel_hashes / seconds_since(start);
+        printf("  %d lane%s:    %10.0f H/s (%.2fx)\n", lanes, lanes == 1 ? " " : "s", rate, rate / ref_rate);
+    }
+
+    // Worker pool scaling: H/s counts every candidate hashed by any worker,
+    // solve time is what a job actually takes
+    for (int workers = 1; workers <= max_workers; workers++) {
+        duino_workers_init(workers);
+        uint64_t total_hashes = 0;
+        start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < job_list.size(); j++) {
+            duino_kernel_job_t job;
+            duino_kernel_prepare(&job, job_list[j].prefix.c_str(), job_list[j].expected.c_str());
+            uint32_t hashes = 0;
+            int32_t result = duino_workers_search(&job, 100 * difficulty + 1, DUINO_SHA1_LANES, &hashes);
+            total_hashes += hashes;
+            if (result != job_list[j].solution) {
+                printf("❌ Job %zu: solution %d, %d workers %d\n", j, job_list[j].solution, workers, result);
+                mismatches++;
+            }
+        }
+        double elapsed = seconds_since(start);
+        printf("  %d worker%s:  %10.0f H/s, %6.2f ms per job\n", workers, workers == 1 ? " " : "s",
+               total_hashes / elapsed, 1000.0 * elapsed / jobs);
+    }
+    duino_workers_deinit();
+
+    printf("%s\n", mismatches ? "❌ Results differ" : "✅ All results match");
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+// Host driver for the device's Duino-Coin client.
+//
+// Compiles src/duino_client.cpp and the DUCO-S1 workers as they are, against
+// the shim in shim/ (HTTPClient, Preferences, mbedtls SHA-1) and the Arduino,
+// WiFi and FreeRTOS shim of tools/pool_emulator, and mines against a local
+// duco_emulator exactly like the DUCO task does: duino_connect(), then
+// duino_mine_job() in a loop. The server is fixed at build time with
+// -DDUCO_SERVER_HOST / -DDUCO_SERVER_PORT, as on the board, or, built with
+// -DDUCO_PICKER_PORT instead, comes from the emulator's pool picker (-P)
+// through the client's NVS pool cache.
+//
+// It mines until the verdicts of the first -j jobs are in (the last jobs'
+// verdicts arrive while the next ones are hashed), then prints what the
+// client measured in DuinoTiming: hashing and network wait per job. With -r
+// it then reconnects -r times each way: from an empty pool cache, which asks
+// the picker first as every connect used to, and from the cached pool. The
+// tool exits non-zero if a share is rejected or the connection is lost.
+//
+// Build: see README.md
+// Usage: client_bench [-j jobs] [-w workers] [-r reconnects] [-v]
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <Preferences.h>
+
+#include "duino_client.h"
+#include "duino_workers.h"
+
+static int opt_jobs = 20;
+static int opt_workers = 1;
+static int opt_reconnects = 0;
+
+// duino_connect() times in µs, from the bench's side
+struct ConnectTimes {
+    int count = 0;
+    bool all_cached = true;
+    bool none_cached = true;
+    unsigned long total_us = 0;
+    unsigned long min_us = ~0UL;
+    unsigned long max_us = 0;
+    uint32_t client_total_ms = 0;     // DuinoTiming.connect_ms, the client's own figure
+};
+
+static bool timed_connect(ConnectTimes* times) {
+    duino_disconnect();
+    unsigned long start = micros();
+    bool ok = duino_connect();
+    unsigned long us = micros() - start;
+    DuinoTiming timing = duino_get_timing();
+    times->count++;
+    times->all_cached &= timing.connect_cached;
+    times->none_cached &= !timing.connect_cached;
+    times->total_us += us;
+    times->min_us = us < times->min_us ? us : times->min_us;
+    times->max_us = us > times->max_us ? us : times->max_us;
+    times->client_total_ms += timing.connect_ms;
+    return ok;
+}
+
+static void print_connect(const char* label, const ConnectTimes& t) {
+    printf("│ %-11s %6.2f ms %6.2f ms %6.2f ms %6u ms │\n", label, t.total_us / 1000.0 / t.count,
+           t.min_us / 1000.0, t.max_us / 1000.0, (unsigned)(t.client_total_ms / t.count));
+}
+
+static void usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -j <jobs>     jobs whose verdicts are waited for (default 20)\n"
+            "  -w <N>        DUCO-S1 workers (default 1)\n"
+            "  -r <N>        then reconnect N times from an empty pool cache and N times from the cached pool\n"
+            "  -v            print the device's serial output\n",
+            name);
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "j:w:r:v")) != -1) {
+        switch (opt) {
+            case 'j': opt_jobs = atoi(optarg); break;
+            case 'w': opt_workers = atoi(optarg); break;
+            case 'r': opt_reconnects = atoi(optarg); break;
+            case 'v': Serial.echo = true; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (opt_jobs <= 0 || opt_workers <= 0 || opt_workers > DUINO_MAX_WORKERS || opt_reconnects < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+#ifdef DUCO_SERVER_HOST
+    char server[64];
+    snprintf(server, sizeof(server), "%s:%d", DUCO_SERVER_HOST, DUCO_SERVER_PORT);
+#else
+    const char* server = "from the pool picker";
+#endif
+    printf("🪙 Client bench: server %s, %d jobs, %d worker(s)\n", server, opt_jobs, opt_workers);
+
+    duino_init("bench", "host");
+    duino_workers_init(opt_workers);
+    if (!duino_connect()) {
+        fprintf(stderr, "❌ Cannot connect to the server %s\n", server);
+        return 1;
+    }
+
+    bool lost = false;
+    while (duino_get_accepted_shares() + duino_get_rejected_shares() < (uint32_t)opt_jobs) {
+        if (!duino_mine_job()) {
+            lost = true;
+            break;
+        }
+    }
+    DuinoTiming timing = duino_get_timing();
+    uint32_t accepted = duino_get_accepted_shares();
+    uint32_t rejected = duino_get_rejected_shares();
+
+    // Reconnects: the picker in line (empty cache, as before the cache) against the cached pool
+    ConnectTimes picker_times, cached_times;
+    for (int i = 0; i < opt_reconnects && !lost; i++) {
+        Preferences prefs;
+        prefs.begin("duco_pool");    // DUCO_POOL_PREFS in duino_client.cpp
+        prefs.clear();
+        prefs.end();
+        lost = !timed_connect(&picker_times) || !timed_connect(&cached_times);
+    }
+    duino_disconnect();
+    duino_workers_deinit();
+
+    uint32_t jobs = timing.jobs ? timing.jobs : 1;
+    uint32_t cycle = timing.hash_total_ms + timing.net_wait_total_ms;
+    printf("┌─────────────────── Client bench ────────────────────┐\n");
+    printf("│ Jobs mined %-6u  accepted %-6u  rejected %-6u │\n", timing.jobs, accepted, rejected);
+    printf("│ Connect        %6u ms                            │\n", timing.connect_ms);
+    printf("│ Hashing        %6u ms/job   %8u H/s         │\n", timing.hash_total_ms / jobs, duino_get_hashrate());
+    printf("│ Network wait   %6u ms/job   %5.1f %% of the cycle │\n", timing.net_wait_total_ms / jobs,
+           cycle ? 100.0 * timing.net_wait_total_ms / cycle : 0.0);
+    if (picker_times.count > 0) {
+        printf("├ %2d reconnects ── avg ────── min ────── max ─ client ┤\n", picker_times.count);
+        print_connect("Empty cache", picker_times);
+        print_connect("Cached pool", cached_times);
+    }
+    printf("└─────────────────────────────────────────────────────┘\n");
+
+    if (lost) {
+        fprintf(stderr, "❌ Lost the connection to the server\n");
+        return 1;
+    }
+#ifndef DUCO_SERVER_HOST
+    if (picker_times.count > 0 && (!picker_times.none_cached || !cached_times.all_cached)) {
+        fprintf(stderr, "❌ Reconnects did not take the expected path (picker, then cached pool)\n");
+        return 1;
+    }
+#endif
+    if (rejected > 0) {
+        fprintf(stderr, "❌ %u share(s) rejected\n", rejected);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,415 @@
+// Local Duino-Coin server stand-in for testing the device's DUCO client.
+//
+// Speaks the DUCO-S1 mining protocol: a version line on connect, then per
+// connection strictly "JOB,user,tier[,key]" -> "lastblockhash,expected,diff"
+// -> "result,hashrate,banner,rig" -> "GOOD" / "BAD". Results are checked
+// against the job's real solution. Every reply can be delayed by a fixed
+// latency (plus jitter) to emulate a distant pool, and the emulator measures
+// how long clients leave their connections idle, so sequential and pipelined
+// clients can be compared. A JOB request on a connection that still owes a
+// result is answered with "BAD,Protocol" and counted. The requested tier
+// scales the difficulty (see TIERS) so tier selection can be exercised.
+//
+// With -P the emulator also stands in for the pool picker (getPool) on a
+// second port, over plain HTTP: every GET is answered after the same latency
+// with this emulator as the best pool, then the connection is closed.
+//
+// Build: g++ -std=c++17 -O2 -Wall -o duco_emulator duco_emulator.cpp
+// Usage: duco_emulator [-p port] [-d difficulty] [-l latency_ms] [-j jitter_ms] [-P picker_port]
+
+#include "../common/sha1.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#define EMU_VERSION "3.0"
+#define EMU_STATS_INTERVAL_MS 10000
+
+// Difficulty per requested tier, as a multiple of -d (unknown tiers: 1x)
+struct Tier {
+    const char* name;
+    int multiplier;
+    uint64_t jobs;
+};
+static Tier TIERS[] = {{"ESP32", 1, 0}, {"LOW", 4, 0}, {"MEDIUM", 16, 0}};
+
+// Reply held back until its due time
+struct Pending {
+    uint64_t due_ms;
+    std::string text;
+};
+
+struct Miner {
+    int fd = -1;
+    std::string address;
+    std::string inbuf;
+    std::string outbuf;
+    std::deque<Pending> pending;
+    bool expect_result = false;     // A job was handed out and its result is owed
+    int solution = 0;
+    uint64_t job_sent_ms = 0;       // Job reply actually written
+    uint64_t verdict_sent_ms = 0;   // Verdict reply actually written (0 = none yet)
+    uint32_t good = 0;
+    uint32_t bad = 0;
+    bool picker = false;            // Connection to the pool picker port (-P)
+    bool close_after_send = false;  // Picker answer queued: close once it is written
+};
+
+// Options
+static uint16_t opt_port = 2811;
+static int opt_difficulty = 50;
+static int opt_latency_ms = 0;
+static int opt_jitter_ms = 0;
+static uint16_t opt_picker_port = 0;     // 0 = no pool picker
+
+static std::map<int, Miner> miners;
+static volatile bool running = true;
+static std::mt19937 rng(1234);
+
+// Statistics
+static uint64_t stat_jobs = 0;
+static uint64_t stat_good = 0;
+static uint64_t stat_bad = 0;
+static uint64_t stat_protocol_errors = 0;
+static uint64_t stat_solve_total_ms = 0;    // Job written -> result received
+static uint64_t stat_idle_total_ms = 0;     // Verdict written -> next JOB received
+static uint64_t stat_idle_count = 0;
+static uint64_t stat_picker_requests = 0;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static std::string sha1_hex(const std::string& data) {
+    uint8_t hash[20];
+    Sha1 ctx;
+    ctx.update((const uint8_t*)data.data(), data.size());
+    ctx.finish(hash);
+    char hex[41];
+    for (int i = 0; i < 20; i++) {
+        snprintf(hex + i * 2, 3, "%02x", hash[i]);
+    }
+    return std::string(hex, 40);
+}
+
+static void reply(Miner& miner, const std::string& text) {
+    int delay = opt_latency_ms + (opt_jitter_ms > 0 ? (int)(rng() % (opt_jitter_ms + 1)) : 0);
+    miner.pending.push_back({now_ms() + delay, text});
+}
+
+static void handle_line(Miner& miner, const std::string& line) {
+    uint64_t now = now_ms();
+
+    if (line.compare(0, 4, "JOB,") == 0) {
+        if (miner.expect_result) {
+            stat_protocol_errors++;
+            printf("⚠️  %s: JOB request while a result is owed\n", miner.address.c_str());
+            reply(miner, "BAD,Protocol\n");
+            return;
+        }
+        if (miner.verdict_sent_ms != 0) {
+            stat_idle_total_ms += now - miner.verdict_sent_ms;
+            stat_idle_count++;
+        }
+
+        char prefix[41];
+        for (int i = 0; i < 40; i++) {
+            prefix[i] = "0123456789abcdef"[rng() % 16];
+        }
+        prefix[40] = 0;
+        // JOB,user,tier[,key]
+        int difficulty = opt_difficulty;
+        size_t tier_start = line.find(',', 4);
+        if (tier_start != std::string::npos) {
+            std::string tier = line.substr(tier_start + 1, line.find(',', tier_start + 1) - tier_start - 1);
+            for (Tier& t : TIERS) {
+                if (tier == t.name) {
+                    difficulty = opt_difficulty * t.multiplier;
+                    t.jobs++;
+                }
+            }
+        }
+        miner.solution = (int)(rng() % (100 * difficulty + 1));
+        std::string expected = sha1_hex(std::string(prefix) + std::to_string(miner.solution));
+        miner.expect_result = true;
+        stat_jobs++;
+        reply(miner, std::string(prefix) + "," + expected + "," + std::to_string(difficulty) + "\n");
+        return;
+    }
+
+    if (!miner.expect_result) {
+        printf("⚠️  %s: unexpected line: %s\n", miner.address.c_str(), line.c_str());
+        return;
+    }
+
+    // result,hashrate,banner,rig
+    miner.expect_result = false;
+    stat_solve_total_ms += now - miner.job_sent_ms;
+    if (atoi(line.c_str()) == miner.solution && !line.empty() && isdigit((unsigned char)line[0])) {
+        miner.good++;
+        stat_good++;
+        reply(miner, "GOOD\n");
+    } else {
+        miner.bad++;
+        stat_bad++;
+        printf("❌ %s: wrong result %s (solution %d)\n", miner.address.c_str(), line.c_str(), miner.solution);
+        reply(miner, "BAD\n");
+    }
+}
+
+// getPool over HTTP: this emulator is the best pool, like the picker's JSON
+static void handle_picker(Miner& miner) {
+    stat_picker_requests++;
+    char body[160];
+    snprintf(body, sizeof(body),
+             "{\"name\":\"emulator\",\"ip\":\"127.0.0.1\",\"port\":%u,\"server\":\"emulator\",\"success\":true}",
+             opt_port);
+    char head[160];
+    snprintf(head, sizeof(head),
+             "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+             strlen(body));
+    reply(miner, std::string(head) + body);
+    miner.inbuf.clear();
+    miner.close_after_send = true;
+}
+
+// Move due replies to the output buffer, remembering when jobs and verdicts go out
+static void release_pending(Miner& miner) {
+    uint64_t now = now_ms();
+    while (!miner.pending.empty() && miner.pending.front().due_ms <= now) {
+        const std::string& text = miner.pending.front().text;
+        if (text.compare(0, 4, "GOOD") == 0 || text.compare(0, 3, "BAD") == 0) {
+            miner.verdict_sent_ms = now;
+        } else {
+            miner.job_sent_ms = now;
+        }
+        miner.outbuf += text;
+        miner.pending.pop_front();
+    }
+}
+
+static void print_stats(void) {
+    uint64_t results = stat_good + stat_bad;
+    printf("┌──────────────── DUCO emulator stats ────────────────┐\n");
+    printf("│ Miners: %-4zu Jobs: %-7llu Good: %-6llu Bad: %-5llu  │\n", miners.size(),
+           (unsigned long long)stat_jobs, (unsigned long long)stat_good, (unsigned long long)stat_bad);
+    printf("│ Protocol errors: %-6llu                             │\n", (unsigned long long)stat_protocol_errors);
+    printf("│ Job -> result avg: %-8llu ms                      │\n",
+           (unsigned long long)(results ? stat_solve_total_ms / results : 0));
+    printf("│ Verdict -> next JOB avg: %-8llu ms                │\n",
+           (unsigned long long)(stat_idle_count ? stat_idle_total_ms / stat_idle_count : 0));
+    printf("│ Tiers: ESP32 %-8llu LOW %-8llu MEDIUM %-9llu │\n", (unsigned long long)TIERS[0].jobs,
+           (unsigned long long)TIERS[1].jobs, (unsigned long long)TIERS[2].jobs);
+    if (opt_picker_port) {
+        printf("│ Pool picker requests: %-8llu                      │\n", (unsigned long long)stat_picker_requests);
+    }
+    printf("└─────────────────────────────────────────────────────┘\n");
+}
+
+static void close_miner(int fd) {
+    auto it = miners.find(fd);
+    if (it == miners.end()) {
+        return;
+    }
+    if (!it->second.picker) {
+        printf("➖ %s disconnected (%u good, %u bad)\n", it->second.address.c_str(), it->second.good, it->second.bad);
+    }
+    close(fd);
+    miners.erase(it);
+}
+
+static int listen_on(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+        fprintf(stderr, "❌ Cannot listen on port %u: %s\n", port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    return fd;
+}
+
+static void on_signal(int) {
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "p:d:l:j:P:")) != -1) {
+        switch (opt) {
+            case 'p': opt_port = (uint16_t)atoi(optarg); break;
+            case 'd': opt_difficulty = atoi(optarg); break;
+            case 'l': opt_latency_ms = atoi(optarg); break;
+            case 'j': opt_jitter_ms = atoi(optarg); break;
+            case 'P': opt_picker_port = (uint16_t)atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-p port] [-d difficulty] [-l latency_ms] [-j jitter_ms] [-P picker_port]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+    if (opt_difficulty <= 0 || opt_latency_ms < 0 || opt_jitter_ms < 0) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    int one = 1;
+    int listen_fd = listen_on(opt_port);
+    int picker_fd = opt_picker_port ? listen_on(opt_picker_port) : -1;
+    if (listen_fd < 0 || (opt_picker_port && picker_fd < 0)) {
+        return 1;
+    }
+    printf("🪙 DUCO emulator on :%u (difficulty %d, latency %d ms + %d ms jitter)\n", opt_port, opt_difficulty,
+           opt_latency_ms, opt_jitter_ms);
+    if (opt_picker_port) {
+        printf("🔎 Pool picker on :%u (http://127.0.0.1:%u/getPool)\n", opt_picker_port, opt_picker_port);
+    }
+
+    uint64_t last_stats = now_ms();
+
+    while (running) {
+        if (now_ms() - last_stats >= EMU_STATS_INTERVAL_MS) {
+            last_stats = now_ms();
+            print_stats();
+        }
+
+        std::vector<struct pollfd> fds;
+        fds.push_back({listen_fd, POLLIN, 0});
+        if (picker_fd >= 0) {
+            fds.push_back({picker_fd, POLLIN, 0});
+        }
+        for (auto& entry : miners) {
+            fds.push_back({entry.first, (short)(POLLIN | (entry.second.outbuf.empty() ? 0 : POLLOUT)), 0});
+        }
+        // Short timeout so delayed replies go out on time
+        if (poll(fds.data(), fds.size(), 1) < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+
+        for (size_t i = 0; i < fds.size(); i++) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            if (fds[i].fd == listen_fd || fds[i].fd == picker_fd) {
+                struct sockaddr_in peer;
+                socklen_t len = sizeof(peer);
+                int fd;
+                while ((fd = accept(fds[i].fd, (struct sockaddr*)&peer, &len)) >= 0) {
+                    fcntl(fd, F_SETFL, O_NONBLOCK);
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    Miner& miner = miners[fd];
+                    miner.fd = fd;
+                    char buf[32];
+                    snprintf(buf, sizeof(buf), "%s:%u", inet_ntoa(peer.sin_addr), ntohs(peer.sin_port));
+                    miner.address = buf;
+                    miner.picker = fds[i].fd == picker_fd;
+                    if (miner.picker) {
+                        printf("🔎 %s asks the pool picker\n", buf);
+                    } else {
+                        miner.outbuf = EMU_VERSION "\n";
+                        printf("➕ %s connected\n", buf);
+                    }
+                    len = sizeof(peer);
+                }
+                continue;
+            }
+
+            auto it = miners.find(fds[i].fd);
+            if (it == miners.end() || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            Miner& miner = it->second;
+            char chunk[1024];
+            ssize_t n = recv(miner.fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    close_miner(fds[i].fd);
+                }
+                continue;
+            }
+            miner.inbuf.append(chunk, n);
+            if (miner.picker) {
+                if (!miner.close_after_send && miner.inbuf.find("\r\n\r\n") != std::string::npos) {
+                    handle_picker(miner);
+                }
+                continue;
+            }
+            size_t nl;
+            while ((nl = miner.inbuf.find('\n')) != std::string::npos) {
+                std::string line = miner.inbuf.substr(0, nl);
+                miner.inbuf.erase(0, nl + 1);
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                if (!line.empty()) {
+                    handle_line(miner, line);
+                }
+            }
+        }
+
+        std::vector<int> dead;
+        for (auto& entry : miners) {
+            Miner& miner = entry.second;
+            release_pending(miner);
+            while (!miner.outbuf.empty()) {
+                ssize_t n = send(miner.fd, miner.outbuf.data(), miner.outbuf.size(), MSG_NOSIGNAL);
+                if (n > 0) {
+                    miner.outbuf.erase(0, n);
+                } else {
+                    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                        dead.push_back(entry.first);
+                    }
+                    break;
+                }
+            }
+            if (miner.close_after_send && miner.pending.empty() && miner.outbuf.empty()) {
+                dead.push_back(entry.first);
+            }
+        }
+        for (int fd : dead) {
+            close_miner(fd);
+        }
+    }
+
+    print_stats();
+    while (!miners.empty()) {
+        close_miner(miners.begin()->first);
+    }
+    close(listen_fd);
+    if (picker_fd >= 0) {
+        close(picker_fd);
+    }
+    return 0;
+}
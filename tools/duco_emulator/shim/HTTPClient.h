@@ -0,0 +1,63 @@
+// HTTPClient for src/duino_client.cpp on the host. Only the pool picker's
+// GET goes through it. Built with -DDUCO_PICKER_PORT=N the GET goes, over
+// plain HTTP, to the duco_emulator started with -P N, which answers with
+// itself as the best pool (the real picker is HTTPS: its TLS handshake is not
+// part of the time). Without it every request fails and the client uses the
+// server it was built with (-DDUCO_SERVER_HOST), or the fallback.
+#pragma once
+
+#include <WiFi.h>
+
+#include <string>
+
+#define HTTP_CODE_OK 200
+
+class HTTPClient {
+public:
+    bool begin(WiFiClient& client, const char* url) {
+        (void)client;
+        std::string u = url;
+        size_t path = u.find('/', u.find("://") + 3);
+        path_ = path == std::string::npos ? "/" : u.substr(path);
+        return true;
+    }
+    void addHeader(const char* name, const char* value) { (void)name; (void)value; }
+    void setTimeout(uint16_t ms) { timeout_ms_ = ms; }
+
+    int GET() {
+#ifdef DUCO_PICKER_PORT
+        WiFiClient client;
+        if (!client.connect("127.0.0.1", DUCO_PICKER_PORT, timeout_ms_)) {
+            return -1;
+        }
+        std::string request = "GET " + path_ + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n";
+        client.write((const uint8_t*)request.data(), request.size());
+        std::string response;
+        char buf[512];
+        unsigned long start = millis();
+        while (client.connected() && millis() - start < timeout_ms_) {
+            int n = client.read((uint8_t*)buf, sizeof(buf));
+            if (n > 0) {
+                response.append(buf, n);
+            } else {
+                delay(1);
+            }
+        }
+        size_t header_end = response.find("\r\n\r\n");
+        if (response.compare(0, 9, "HTTP/1.1 ") != 0 || header_end == std::string::npos) {
+            return -1;
+        }
+        body_ = response.substr(header_end + 4);
+        return atoi(response.c_str() + 9);
+#else
+        return -1;
+#endif
+    }
+    String getString() { return body_; }
+    void end() {}
+
+private:
+    std::string path_;
+    std::string body_;
+    uint16_t timeout_ms_ = 5000;
+};
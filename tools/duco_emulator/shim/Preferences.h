@@ -0,0 +1,58 @@
+// Preferences (NVS) for the host: one in-memory store for the whole process,
+// so a value written by the client is read back until the tool exits.
+#pragma once
+
+#include <Arduino.h>
+
+#include <map>
+#include <string>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        (void)readOnly;
+        ns = name;
+        return true;
+    }
+    void end() {}
+
+    String getString(const char* key, const String& defaultValue = String()) {
+        auto it = store().find(ns + "/" + key);
+        return it == store().end() ? defaultValue : String(it->second);
+    }
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) { return getNumber(key, defaultValue); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return getNumber(key, defaultValue); }
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return getNumber(key, defaultValue); }
+
+    // Every key of the namespace
+    bool clear() {
+        std::string prefix = ns + "/";
+        for (auto it = store().begin(); it != store().end();) {
+            it = it->first.compare(0, prefix.size(), prefix) == 0 ? store().erase(it) : std::next(it);
+        }
+        return true;
+    }
+
+    size_t putString(const char* key, const char* value) { return put(key, value); }
+    size_t putUShort(const char* key, uint16_t value) { return put(key, std::to_string(value)) ? 2 : 0; }
+    size_t putUInt(const char* key, uint32_t value) { return put(key, std::to_string(value)) ? 4 : 0; }
+    size_t putUChar(const char* key, uint8_t value) { return put(key, std::to_string(value)) ? 1 : 0; }
+
+private:
+    static std::map<std::string, std::string>& store() {
+        static std::map<std::string, std::string> values;
+        return values;
+    }
+
+    uint32_t getNumber(const char* key, uint32_t defaultValue) {
+        auto it = store().find(ns + "/" + key);
+        return it == store().end() ? defaultValue : strtoul(it->second.c_str(), NULL, 10);
+    }
+
+    size_t put(const char* key, const std::string& value) {
+        store()[ns + "/" + key] = value;
+        return value.size();
+    }
+
+    std::string ns;
+};
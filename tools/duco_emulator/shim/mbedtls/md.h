@@ -0,0 +1,29 @@
+// mbedtls message digest (SHA-1 only) on top of tools/common/sha1.h
+#pragma once
+
+#include <sha1.h>           // tools/common
+
+typedef enum { MBEDTLS_MD_SHA1 = 4 } mbedtls_md_type_t;
+typedef struct { mbedtls_md_type_t type; } mbedtls_md_info_t;
+typedef Sha1 mbedtls_md_context_t;
+
+inline const mbedtls_md_info_t* mbedtls_md_info_from_type(mbedtls_md_type_t type) {
+    static const mbedtls_md_info_t sha1 = {MBEDTLS_MD_SHA1};
+    return type == MBEDTLS_MD_SHA1 ? &sha1 : nullptr;
+}
+inline void mbedtls_md_init(mbedtls_md_context_t* ctx) { ctx->reset(); }
+inline void mbedtls_md_free(mbedtls_md_context_t* ctx) { (void)ctx; }
+inline int mbedtls_md_setup(mbedtls_md_context_t* ctx, const mbedtls_md_info_t* info, int hmac) {
+    (void)ctx;
+    (void)hmac;
+    return info ? 0 : -1;
+}
+inline int mbedtls_md_starts(mbedtls_md_context_t* ctx) { ctx->reset(); return 0; }
+inline int mbedtls_md_update(mbedtls_md_context_t* ctx, const unsigned char* input, size_t len) {
+    ctx->update(input, len);
+    return 0;
+}
+inline int mbedtls_md_finish(mbedtls_md_context_t* ctx, unsigned char* output) {
+    ctx->finish(output);
+    return 0;
+}
@@ -0,0 +1,337 @@
+// Host test for the streaming getblocktemplate parser.
+//
+// Fetches a template from a bitcoind-compatible node (normally the local
+// node_emulator) and feeds the HTTP body to gbt_parser from src/gbt_parser.cpp
+// in fixed-size chunks, exactly as the board does. The result is checked
+// against a reference built the simple way: the whole body parsed with
+// mini_json and the complete merkle tree computed level by level. Then:
+//   - the same body is re-parsed with chunk sizes from 1 byte to 16 KB
+//   - the coinbase branch is checked against the full tree for several
+//     coinbase txids, and for every transaction count from 0 to 64
+//   - an RPC error response and truncated bodies must be rejected
+//   - heap allocations during streaming must be zero
+// It reports the parser's fixed memory next to the body size and the parse
+// throughput. The tool exits non-zero on any mismatch.
+//
+// Build: see README.md
+// Usage: gbt_bench [-h host] [-p port] [-c chunk_bytes]
+
+#include "../common/mini_json.h"
+#include "../common/sha256.h"
+#include "gbt_parser.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::string opt_host = "127.0.0.1";
+static int opt_port = 18443;
+static size_t opt_chunk = 1024;       // RPC_STREAM_CHUNK on the board
+
+static int failures = 0;
+
+// Every operator new while counting is on is an allocation the board would make
+static bool count_allocations = false;
+static uint64_t allocations = 0;
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    if (count_allocations) {
+        allocations++;
+    }
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("❌ %s\n", what);
+        failures++;
+    }
+}
+
+// POST one JSON-RPC call, return the HTTP status and the body
+static int rpc_post(const std::string& method, const std::string& params, std::string& body) {
+    struct addrinfo hints = {};
+    struct addrinfo* res = NULL;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(opt_host.c_str(), std::to_string(opt_port).c_str(), &hints, &res) != 0) {
+        return -1;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        freeaddrinfo(res);
+        close(fd);
+        return -1;
+    }
+    freeaddrinfo(res);
+
+    std::string payload = "{\"jsonrpc\":\"1.0\",\"id\":\"gbt_bench\",\"method\":\"" + method +
+                          "\",\"params\":" + params + "}";
+    std::string request = "POST / HTTP/1.0\r\nHost: " + opt_host + "\r\nContent-Type: application/json\r\n"
+                          "Content-Length: " + std::to_string(payload.size()) + "\r\n\r\n" + payload;
+    if (send(fd, request.data(), request.size(), 0) != (ssize_t)request.size()) {
+        close(fd);
+        return -1;
+    }
+
+    std::string response;
+    char chunk[16384];
+    ssize_t n;
+    while ((n = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+        response.append(chunk, n);
+    }
+    close(fd);
+
+    size_t split = response.find("\r\n\r\n");
+    if (split == std::string::npos || response.compare(0, 5, "HTTP/") != 0) {
+        return -1;
+    }
+    body = response.substr(split + 4);
+    return atoi(response.c_str() + response.find(' ') + 1);
+}
+
+// Reference: full merkle tree from every leaf, the way a node computes it
+static void full_tree(std::vector<std::vector<uint8_t>> level, std::vector<std::vector<uint8_t>>& branch,
+                      uint8_t root[32]) {
+    branch.clear();
+    while (level.size() > 1) {
+        if (level.size() & 1) {
+            level.push_back(level.back());
+        }
+        branch.push_back(level[1]);     // Sibling of the coinbase path (index 0)
+        std::vector<std::vector<uint8_t>> next;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            std::vector<uint8_t> parent(32);
+            merkle_hash_pair(level[i].data(), level[i + 1].data(), parent.data());
+            next.push_back(parent);
+        }
+        level.swap(next);
+    }
+    memcpy(root, level[0].data(), 32);
+}
+
+static bool parse_chunked(const std::string& body, size_t chunk, BitcoinBlockTemplate& tmpl, gbt_parser_t& parser) {
+    gbt_parser_init(&parser, &tmpl);
+    for (size_t pos = 0; pos < body.size(); pos += chunk) {
+        size_t len = std::min(chunk, body.size() - pos);
+        if (!gbt_parser_feed(&parser, body.data() + pos, len)) {
+            return false;
+        }
+    }
+    return gbt_parser_finish(&parser);
+}
+
+// Branch builder against the full tree for tx_count transactions and a given coinbase
+static bool branch_matches(const std::vector<std::vector<uint8_t>>& txids, const uint8_t coinbase[32]) {
+    merkle_branch_builder_t builder;
+    merkle_branch_init(&builder);
+    for (const auto& txid : txids) {
+        merkle_branch_add(&builder, txid.data());
+    }
+    int len = merkle_branch_finish(&builder);
+
+    std::vector<std::vector<uint8_t>> leaves;
+    leaves.push_back(std::vector<uint8_t>(coinbase, coinbase + 32));
+    leaves.insert(leaves.end(), txids.begin(), txids.end());
+    std::vector<std::vector<uint8_t>> branch;
+    uint8_t expected_root[32];
+    full_tree(leaves, branch, expected_root);
+
+    if (len != (int)branch.size()) {
+        return false;
+    }
+    for (int i = 0; i < len; i++) {
+        if (memcmp(builder.branch[i], branch[i].data(), 32) != 0) {
+            return false;
+        }
+    }
+    uint8_t root[32];
+    merkle_root_from_branch(coinbase, builder.branch, len, root);
+    return memcmp(root, expected_root, 32) == 0;
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:c:")) != -1) {
+        switch (opt) {
+            case 'h': opt_host = optarg; break;
+            case 'p': opt_port = atoi(optarg); break;
+            case 'c': opt_chunk = (size_t)atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-h host] [-p port] [-c chunk_bytes]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (opt_chunk == 0) {
+        fprintf(stderr, "Invalid chunk size\n");
+        return 1;
+    }
+
+    std::string body;
+    int status = rpc_post("getblocktemplate", "[{\"rules\":[\"segwit\"]}]", body);
+    if (status != 200) {
+        fprintf(stderr, "❌ getblocktemplate from %s:%d failed (HTTP %d)\n", opt_host.c_str(), opt_port, status);
+        return 1;
+    }
+    printf("📥 Template: %zu bytes\n", body.size());
+
+    // Reference: whole document in memory
+    auto t0 = std::chrono::steady_clock::now();
+    JsonValue doc;
+    if (!json_parse(body, doc) || doc["result"].type != JsonValue::OBJECT) {
+        fprintf(stderr, "❌ Reference parse failed\n");
+        return 1;
+    }
+    const JsonValue& result = doc["result"];
+    std::vector<std::vector<uint8_t>> txids;
+    for (size_t i = 0; i < result["transactions"].size(); i++) {
+        std::vector<uint8_t> txid(32);
+        gbt_hex_to_hash(result["transactions"][(int)i]["txid"].asString().c_str(), txid.data());
+        txids.push_back(txid);
+    }
+    uint8_t zero[32] = {0};
+    std::vector<std::vector<uint8_t>> leaves;
+    leaves.push_back(std::vector<uint8_t>(zero, zero + 32));
+    leaves.insert(leaves.end(), txids.begin(), txids.end());
+    std::vector<std::vector<uint8_t>> ref_branch;
+    uint8_t ref_root[32];
+    full_tree(leaves, ref_branch, ref_root);
+    double ref_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    // Streaming parse as on the board
+    static BitcoinBlockTemplate tmpl;
+    static gbt_parser_t parser;
+    count_allocations = true;
+    t0 = std::chrono::steady_clock::now();
+    bool ok = parse_chunked(body, opt_chunk, tmpl, parser);
+    double stream_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    count_allocations = false;
+    if (!ok) {
+        printf("❌ Streaming parse failed: %s\n", gbt_parser_error(&parser));
+        return 1;
+    }
+
+    check(tmpl.version == (uint32_t)result["version"].asNumber(), "version");
+    check(result["previousblockhash"].asString() == tmpl.previousblockhash, "previousblockhash");
+    check(tmpl.curtime == (uint32_t)result["curtime"].asNumber(), "curtime");
+    check(tmpl.bits == (uint32_t)strtoul(result["bits"].asString().c_str(), NULL, 16), "bits");
+    check(tmpl.height == (uint32_t)result["height"].asNumber(), "height");
+    check(tmpl.transactions_count == (int)txids.size(), "transaction count");
+    check(tmpl.merkle_branch_len == (int)ref_branch.size(), "merkle branch length");
+    bool branch_ok = tmpl.merkle_branch_len == (int)ref_branch.size();
+    for (int i = 0; branch_ok && i < tmpl.merkle_branch_len; i++) {
+        branch_ok = memcmp(tmpl.merkle_branch[i], ref_branch[i].data(), 32) == 0;
+    }
+    check(branch_ok, "merkle branch");
+    uint8_t root[32];
+    merkle_root_from_branch(zero, tmpl.merkle_branch, tmpl.merkle_branch_len, root);
+    check(memcmp(root, ref_root, 32) == 0, "merkle root from branch");
+    check(allocations == 0, "heap allocations while streaming");
+
+    // Chunk boundaries anywhere: inside keys, escapes, numbers, hex strings
+    static const size_t CHUNKS[] = {1, 2, 3, 7, 64, 1024, 1460, 4096, 16384};
+    for (size_t chunk : CHUNKS) {
+        static BitcoinBlockTemplate other;
+        static gbt_parser_t other_parser;
+        bool same = parse_chunked(body, chunk, other, other_parser) &&
+                    memcmp(&other, &tmpl, sizeof(tmpl)) == 0;
+        if (!same) {
+            printf("❌ Chunk size %zu gives a different template\n", chunk);
+            failures++;
+        }
+    }
+
+    // Branch builder on its own: every small tree shape and random coinbases
+    std::mt19937 rng(1);
+    int shapes_ok = 0;
+    for (int count = 0; count <= 64; count++) {
+        std::vector<std::vector<uint8_t>> small;
+        for (int i = 0; i < count; i++) {
+            std::vector<uint8_t> txid(32);
+            for (auto& b : txid) {
+                b = (uint8_t)rng();
+            }
+            small.push_back(txid);
+        }
+        uint8_t coinbase[32];
+        for (auto& b : coinbase) {
+            b = (uint8_t)rng();
+        }
+        shapes_ok += branch_matches(small, coinbase);
+    }
+    check(shapes_ok == 65, "branch for 0..64 transactions");
+    for (int i = 0; i < 4; i++) {
+        uint8_t coinbase[32];
+        for (auto& b : coinbase) {
+            b = (uint8_t)rng();
+        }
+        uint8_t expected[32];
+        leaves[0].assign(coinbase, coinbase + 32);
+        full_tree(leaves, ref_branch, expected);
+        merkle_root_from_branch(coinbase, tmpl.merkle_branch, tmpl.merkle_branch_len, root);
+        check(memcmp(root, expected, 32) == 0, "merkle root for a different coinbase");
+    }
+
+    // Failures the board must reject
+    {
+        static BitcoinBlockTemplate bad;
+        static gbt_parser_t bad_parser;
+        std::string error_body;
+        int error_status = rpc_post("getblocktemplate", "[]", error_body);
+        check(error_status == 500, "error response status");
+        check(!parse_chunked(error_body, opt_chunk, bad, bad_parser), "error response rejected");
+        printf("🧪 RPC error: %s\n", gbt_parser_error(&bad_parser));
+
+        size_t cuts[] = {body.size() / 3, body.size() - 2, body.size() - 1};
+        for (size_t cut : cuts) {
+            check(!parse_chunked(body.substr(0, cut), opt_chunk, bad, bad_parser), "truncated body rejected");
+        }
+        printf("🧪 Truncated body: %s\n", gbt_parser_error(&bad_parser));
+        check(!parse_chunked("{\"result\":{\"version\":1,}}", opt_chunk, bad, bad_parser), "malformed JSON rejected");
+    }
+
+    size_t fixed = sizeof(gbt_parser_t) + opt_chunk + sizeof(BitcoinBlockTemplate);
+    printf("┌─────────────────────────────────────────────────────┐\n");
+    printf("│ GBT STREAMING PARSER                                │\n");
+    printf("├─────────────────────────────────────────────────────┤\n");
+    printf("│ Body:          %9zu bytes                      │\n", body.size());
+    printf("│ Transactions:  %9d                            │\n", tmpl.transactions_count);
+    printf("│ Branch levels: %9d                            │\n", tmpl.merkle_branch_len);
+    printf("│ Parser state:  %9zu bytes                      │\n", sizeof(gbt_parser_t));
+    printf("│ Read chunk:    %9zu bytes                      │\n", opt_chunk);
+    printf("│ Template:      %9zu bytes                      │\n", sizeof(BitcoinBlockTemplate));
+    printf("│ Peak total:    %9zu bytes (%5.2f%% of body)     │\n", fixed, 100.0 * fixed / body.size());
+    printf("│ Heap allocs:   %9llu                            │\n", (unsigned long long)allocations);
+    printf("│ Streaming:     %9.1f ms (%6.1f MB/s)           │\n", stream_ms, body.size() / 1e3 / stream_ms);
+    printf("│ Full parse:    %9.1f ms (reference)             │\n", ref_ms);
+    printf("└─────────────────────────────────────────────────────┘\n");
+
+    if (failures) {
+        printf("❌ %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,357 @@
+// Host benchmark for the incremental merkle store (src/merkle_store.cpp).
+//
+// Replays a sequence of getblocktemplate results, normally recorded with
+// node_emulator -w (template.json, template.json.1, ...), as the board sees
+// them across refreshes. Every template is parsed by gbt_parser twice: with
+// the merkle store attached, which hashes only the paths above changed
+// transactions, and without it, which rebuilds the whole tree in the branch
+// builder. The branches must match. Timing and hash counts are also taken on
+// the transaction ids alone, without the JSON, to isolate the tree work.
+//
+// Without files the tool synthesizes a sequence: mempool arrivals appended at
+// the end, and every few refreshes a block that confirms the oldest half.
+// A randomized check then compares store and builder after random edits
+// (replace, insert, remove, append, truncate) and after a store overflow.
+// The tool exits non-zero on any mismatch.
+//
+// Build: see README.md
+// Usage: merkle_bench [-n transactions] [-r refreshes] [-s seed] [template.json ...]
+
+#include "../common/mini_json.h"
+#include "gbt_parser.h"
+#include "merkle_store.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define STORE_LEAVES 16384          // RPC_MERKLE_STORE_LEAVES on the board
+
+static int opt_transactions = 3000;
+static int opt_refreshes = 20;
+static unsigned opt_seed = 1;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("❌ %s\n", what);
+        failures++;
+    }
+}
+
+typedef std::vector<std::vector<uint8_t>> TxidList;
+
+// ---------------------------------------------------------------------------
+// Template sequence
+// ---------------------------------------------------------------------------
+
+static std::string to_hex(const uint8_t* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < len; i++) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 15];
+    }
+    return out;
+}
+
+// Minimal getblocktemplate answer around a list of txids (display order in the JSON)
+static std::string render(const TxidList& txids, uint32_t height) {
+    std::string body = "{\"result\":{\"version\":536870912,\"previousblockhash\":\"" + std::string(64, '0') +
+                       "\",\"transactions\":[";
+    for (size_t i = 0; i < txids.size(); i++) {
+        uint8_t display[32];
+        for (int b = 0; b < 32; b++) {
+            display[b] = txids[i][31 - b];
+        }
+        body += std::string(i ? "," : "") + "{\"txid\":\"" + to_hex(display, 32) + "\",\"fee\":1000}";
+    }
+    body += "],\"coinbasevalue\":312500000,\"curtime\":1700000000,\"bits\":\"207fffff\",\"height\":" +
+            std::to_string(height) + "},\"error\":null,\"id\":\"merkle_bench\"}";
+    return body;
+}
+
+static std::vector<uint8_t> random_txid(std::mt19937& rng) {
+    std::vector<uint8_t> txid(32);
+    for (auto& b : txid) {
+        b = (uint8_t)rng();
+    }
+    return txid;
+}
+
+// Mempool arrivals every refresh, a block every fifth
+static std::vector<std::string> synthesize(void) {
+    std::mt19937 rng(opt_seed);
+    TxidList txids;
+    for (int i = 0; i < opt_transactions; i++) {
+        txids.push_back(random_txid(rng));
+    }
+    std::vector<std::string> bodies;
+    uint32_t height = 800000;
+    for (int r = 0; r <= opt_refreshes; r++) {
+        if (r > 0 && r % 5 == 0) {
+            txids.erase(txids.begin(), txids.begin() + txids.size() / 2);
+            height++;
+        } else if (r > 0) {
+            size_t count = 1 + txids.size() / 50;
+            for (size_t i = 0; i < count; i++) {
+                txids.push_back(random_txid(rng));
+            }
+        }
+        bodies.push_back(render(txids, height));
+    }
+    return bodies;
+}
+
+static bool read_file(const char* path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    out = buffer.str();
+    // Recorded templates are the bare "result" object
+    if (out.find("\"result\"") == std::string::npos) {
+        out = "{\"result\":" + out + ",\"error\":null,\"id\":\"merkle_bench\"}";
+    }
+    return true;
+}
+
+static bool extract_txids(const std::string& body, TxidList& txids) {
+    JsonValue doc;
+    if (!json_parse(body, doc)) {
+        return false;
+    }
+    const JsonValue& txs = doc["result"]["transactions"];
+    txids.clear();
+    for (size_t i = 0; i < txs.size(); i++) {
+        std::vector<uint8_t> txid(32);
+        if (!gbt_hex_to_hash(txs[(int)i]["txid"].asString().c_str(), txid.data())) {
+            return false;
+        }
+        txids.push_back(txid);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Branches
+// ---------------------------------------------------------------------------
+
+static int builder_branch(const TxidList& txids, uint8_t (*branch)[32]) {
+    static merkle_branch_builder_t builder;
+    merkle_branch_init(&builder);
+    for (const auto& txid : txids) {
+        merkle_branch_add(&builder, txid.data());
+    }
+    int len = merkle_branch_finish(&builder);
+    memcpy(branch, builder.branch, sizeof(builder.branch));
+    return len;
+}
+
+static int store_branch(merkle_store_t* store, const TxidList& txids, uint8_t (*branch)[32]) {
+    merkle_store_begin(store);
+    for (const auto& txid : txids) {
+        if (!merkle_store_add(store, txid.data())) {
+            break;
+        }
+    }
+    return merkle_store_finish(store, branch);
+}
+
+static bool same_branch(int len_a, const uint8_t (*a)[32], int len_b, const uint8_t (*b)[32]) {
+    return len_a == len_b && memcmp(a, b, 32 * (len_a > 0 ? len_a : 0)) == 0;
+}
+
+// Whole template through gbt_parser, with or without the store
+static bool parse(const std::string& body, merkle_store_t* store, BitcoinBlockTemplate* tmpl, double* ms) {
+    static gbt_parser_t parser;
+    auto t0 = std::chrono::steady_clock::now();
+    gbt_parser_init(&parser, tmpl);
+    if (store) {
+        gbt_parser_set_merkle_store(&parser, store);
+    }
+    for (size_t pos = 0; pos < body.size(); pos += 1024) {
+        gbt_parser_feed(&parser, body.data() + pos, std::min<size_t>(1024, body.size() - pos));
+    }
+    bool ok = gbt_parser_finish(&parser);
+    *ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return ok;
+}
+
+// Random edits, checked against the builder after each one
+static void check_random_edits(merkle_store_t* store) {
+    std::mt19937 rng(opt_seed + 1);
+    TxidList txids;
+    merkle_store_reset(store);
+    uint8_t a[MERKLE_MAX_DEPTH][32];
+    uint8_t b[MERKLE_MAX_DEPTH][32];
+    for (int round = 0; round < 500; round++) {
+        int edit = rng() % 6;
+        size_t at = txids.empty() ? 0 : rng() % txids.size();
+        if (edit == 0 && !txids.empty()) {
+            txids[at] = random_txid(rng);
+        } else if (edit == 1) {
+            txids.insert(txids.begin() + at, random_txid(rng));
+        } else if (edit == 2 && !txids.empty()) {
+            txids.erase(txids.begin() + at);
+        } else if (edit == 3) {
+            for (int i = rng() % 40; i >= 0; i--) {
+                txids.push_back(random_txid(rng));
+            }
+        } else if (edit == 4) {
+            txids.resize(rng() % (txids.size() + 1));
+        }
+        // edit 5: same template again
+        int len_a = store_branch(store, txids, a);
+        int len_b = builder_branch(txids, b);
+        if (!same_branch(len_a, a, len_b, b)) {
+            printf("❌ Random edit %d (%zu transactions): branches differ\n", round, txids.size());
+            failures++;
+            return;
+        }
+    }
+
+    // A store too small: the parser falls back to the builder, the store starts over
+    static uint8_t small_buffer[8192];
+    merkle_store_t small;
+    check(merkle_store_init(&small, small_buffer, sizeof(small_buffer), 100), "small store init");
+    TxidList many;
+    for (int i = 0; i < 300; i++) {
+        many.push_back(random_txid(rng));
+    }
+    std::string body = render(many, 1);
+    static BitcoinBlockTemplate with_store;
+    static BitcoinBlockTemplate without;
+    double ms;
+    check(parse(body, &small, &with_store, &ms) && parse(body, NULL, &without, &ms) &&
+              same_branch(with_store.merkle_branch_len, with_store.merkle_branch, without.merkle_branch_len,
+                          without.merkle_branch),
+          "overflowing store falls back to the builder");
+    check(small.count == 0, "overflowing store is reset");
+    printf("🎲 500 random edits and a store overflow: %s\n", failures ? "FAILED" : "ok");
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:s:")) != -1) {
+        switch (opt) {
+            case 'n': opt_transactions = atoi(optarg); break;
+            case 'r': opt_refreshes = atoi(optarg); break;
+            case 's': opt_seed = (unsigned)atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-n transactions] [-r refreshes] [-s seed] [template.json ...]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+    if (opt_transactions < 0 || opt_refreshes < 0) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+
+    std::vector<std::string> bodies;
+    if (optind < argc) {
+        for (int i = optind; i < argc; i++) {
+            std::string body;
+            if (!read_file(argv[i], body)) {
+                fprintf(stderr, "❌ Cannot read %s\n", argv[i]);
+                return 1;
+            }
+            bodies.push_back(body);
+        }
+        printf("📂 Replaying %zu recorded templates\n", bodies.size());
+    } else {
+        bodies = synthesize();
+        printf("🧱 Synthesized %zu templates from %d transactions\n", bodies.size(), opt_transactions);
+    }
+
+    // Two stores fed the same sequence: one inside the parser, one on bare txids
+    size_t bytes = merkle_store_bytes(STORE_LEAVES);
+    std::vector<uint8_t> parser_buffer(bytes);
+    std::vector<uint8_t> tree_buffer(bytes);
+    merkle_store_t parser_store;
+    merkle_store_t tree_store;
+    merkle_store_init(&parser_store, parser_buffer.data(), bytes, STORE_LEAVES);
+    merkle_store_init(&tree_store, tree_buffer.data(), bytes, STORE_LEAVES);
+
+    printf("  #   txs   store hashes  full hashes   store ms   full ms   parse+store  parse\n");
+    double total_store_ms = 0, total_full_ms = 0;
+    uint64_t total_store_hashes = 0, total_full_hashes = 0;
+    size_t total_txs = 0;
+    static BitcoinBlockTemplate with_store;
+    static BitcoinBlockTemplate without;
+    for (size_t r = 0; r < bodies.size(); r++) {
+        TxidList txids;
+        if (!extract_txids(bodies[r], txids)) {
+            printf("❌ Template %zu does not parse\n", r);
+            return 1;
+        }
+
+        double parse_store_ms, parse_ms;
+        bool ok = parse(bodies[r], &parser_store, &with_store, &parse_store_ms) &&
+                  parse(bodies[r], NULL, &without, &parse_ms);
+        check(ok && same_branch(with_store.merkle_branch_len, with_store.merkle_branch, without.merkle_branch_len,
+                                without.merkle_branch),
+              "parser branch with the store");
+
+        uint8_t a[MERKLE_MAX_DEPTH][32];
+        uint8_t b[MERKLE_MAX_DEPTH][32];
+        auto t0 = std::chrono::steady_clock::now();
+        int len_a = store_branch(&tree_store, txids, a);
+        double store_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        t0 = std::chrono::steady_clock::now();
+        int len_b = builder_branch(txids, b);
+        double full_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        check(same_branch(len_a, a, len_b, b), "store branch against the builder");
+
+        // The builder hashes every pair off the coinbase path: one per internal node minus the path
+        uint32_t full_hashes = 0;
+        for (size_t size = txids.size() + 1; size > 1; size = (size + 1) / 2) {
+            full_hashes += (uint32_t)((size + 1) / 2 - 1);
+        }
+        printf("%3zu %6zu %13u %12u %10.3f %9.3f %12.2f %7.2f%s\n", r, txids.size(), tree_store.hashes,
+               full_hashes, store_ms, full_ms, parse_store_ms, parse_ms, r == 0 ? "  (first: full build)" : "");
+        if (r > 0) {
+            total_store_ms += store_ms;
+            total_full_ms += full_ms;
+            total_store_hashes += tree_store.hashes;
+            total_full_hashes += full_hashes;
+            total_txs += txids.size();
+        }
+    }
+
+    check_random_edits(&tree_store);
+
+    size_t refreshes = bodies.size() > 1 ? bodies.size() - 1 : 1;
+    printf("┌─────────────────────────────────────────────────────┐\n");
+    printf("│ INCREMENTAL MERKLE STORE                            │\n");
+    printf("├─────────────────────────────────────────────────────┤\n");
+    printf("│ Refreshes:     %9zu (after the first)         │\n", bodies.size() > 1 ? bodies.size() - 1 : 0);
+    printf("│ Transactions:  %9zu (average)                 │\n", total_txs / refreshes);
+    printf("│ Hashes store:  %9llu (average)                 │\n",
+           (unsigned long long)(total_store_hashes / refreshes));
+    printf("│ Hashes full:   %9llu (average)                 │\n",
+           (unsigned long long)(total_full_hashes / refreshes));
+    printf("│ Branch store:  %9.3f ms (average)              │\n", total_store_ms / refreshes);
+    printf("│ Branch full:   %9.3f ms (average)              │\n", total_full_ms / refreshes);
+    printf("│ Store size:    %9zu bytes (%d leaves)      │\n", bytes, STORE_LEAVES);
+    printf("└─────────────────────────────────────────────────────┘\n");
+
+    if (failures) {
+        printf("❌ %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All checks passed\n");
+    return 0;
+}
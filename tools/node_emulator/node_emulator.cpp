@@ -0,0 +1,1062 @@
+// Local bitcoind stand-in for testing the device's solo mining path.
+//
+// Serves JSON-RPC over HTTP the way bitcoind does: getblocktemplate,
+// submitblock, getblock (raw hex), getblockchaininfo, getnetworkinfo and
+// getbestblockhash, with Basic auth, HTTP 500 + error object on RPC errors,
+// batch requests (a JSON array of calls, answered with an array) and a
+// Content-Length on every response. HTTP/1.1 connections are kept alive and
+// closed after -k seconds idle, like bitcoind's rpcservertimeout; the
+// non-standard getemulatorstats reports connection and request counts so a
+// client can check how many connections it opened. The template is either generated at mainnet size (thousands of
+// transactions, megabytes of JSON) or replayed from a file recorded earlier
+// with -w, so the device and the host tools can be tested against the same
+// large template.
+//
+// submitblock checks a block the way a regtest node would: prevhash, bits,
+// proof of work, BIP34 height, coinbase amount, merkle root and witness
+// commitment, answering null or a BIP22 reject reason. The emulator cannot
+// parse its random transactions, so a block must carry either all of them in
+// template order or none. An accepted block becomes the new tip and the next
+// template builds on it, keeping the transactions the block did not include.
+//
+// getblocktemplate long-polls like Core: a request carrying the current
+// longpollid is held open until the template changes (a block accepted, or a
+// simulated network block every -b seconds), then answered with the new one.
+// With -L the template has no longpollid and the id is ignored, as on a
+// server without long-poll, so the device falls back to getbestblockhash.
+// -m appends new transactions to the mempool every few seconds, as the
+// template changes between blocks. With -w every template served is
+// recorded (file, file.1, file.2, ...), to replay a refresh sequence later.
+//
+// Two misbehaviours for testing a client's HTTP session: -C answers HTTP/1.1
+// requests with chunked transfer encoding instead of a Content-Length, as a
+// reverse proxy in front of the node may, and -x N closes a kept-alive
+// connection instead of answering every Nth request that arrives on it, as
+// when the node's idle close crosses the request on the wire. The
+// non-standard setemulatoroptions changes both at run time.
+//
+// Build: g++ -std=c++17 -O2 -Wall -o node_emulator node_emulator.cpp
+// Usage: node_emulator [-p port] [-a user:pass] [-n transactions] [-s avg_tx_bytes]
+//                      [-t template.json] [-w template.json] [-r seed] [-b block_seconds] [-L]
+//                      [-m mempool_seconds] [-k idle_seconds] [-C] [-x drop_every]
+
+#include "../common/mini_json.h"
+#include "../common/sha256.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Connection {
+    std::string address;
+    std::string inbuf;
+    std::string outbuf;
+    bool close_after_send = false;
+    bool keep_alive = false;        // Set per request: HTTP/1.1 without "Connection: close"
+    bool http10 = false;            // Set per request: HTTP/1.0 (never answered chunked)
+    uint64_t requests = 0;          // HTTP requests answered on this connection
+    time_t last_active = 0;
+    std::vector<std::string>* batch = nullptr;   // Replies collected while answering a batch
+    bool longpoll = false;          // Parked getblocktemplate waiting for a template change
+    JsonValue longpoll_id;          // JSON-RPC id to answer it with
+};
+
+// Options
+static uint16_t opt_port = 18443;
+static std::string opt_auth;            // "user:pass", empty = no auth
+static int opt_transactions = 3000;
+static int opt_tx_bytes = 400;
+static std::string opt_template_file;
+static std::string opt_record_file;
+static unsigned opt_seed = 1;
+static int opt_block_seconds = 0;       // A network block every N seconds (0 = never)
+static int opt_mempool_seconds = 0;     // New mempool transactions every N seconds (0 = never)
+static bool opt_longpoll = true;
+static int opt_idle_seconds = 30;       // Keep-alive connections idle this long are closed
+static bool opt_chunked = false;        // HTTP/1.1 responses with Transfer-Encoding: chunked
+static int opt_drop_every = 0;          // Drop every Nth request on a reused connection (0 = never)
+
+static std::map<int, Connection> connections;
+static volatile bool running = true;
+
+// Current template: its fields, and the "result" object as served
+struct TemplateTx {
+    std::string data;       // Raw transaction, hex
+    std::string txid;       // Display (RPC) order
+    std::string hash;       // wtxid, display order
+    uint64_t fee;
+};
+static std::vector<TemplateTx> template_txs;
+static std::string template_prevhash;
+static uint32_t template_height = 0;
+static uint32_t template_bits = 0x207fffff;         // Regtest
+static uint64_t template_subsidy = 312500000;
+static uint32_t template_mintime = 0;
+static std::string template_json;
+static uint32_t template_serial = 0;                // Bumped on every change, part of the longpollid
+
+// Statistics
+static uint64_t stat_connections = 0;
+static uint64_t stat_requests = 0;       // JSON-RPC calls, batched ones included
+static uint64_t stat_http_requests = 0;
+static uint64_t stat_batches = 0;
+static uint64_t stat_idle_closed = 0;
+static uint64_t stat_dropped = 0;
+static uint64_t stat_reused_requests = 0;  // Requests on a connection that had answered one
+static uint64_t stat_bytes_out = 0;
+static uint64_t stat_blocks_accepted = 0;
+static uint64_t stat_blocks_rejected = 0;
+static uint64_t stat_longpolls = 0;
+static uint64_t stat_network_blocks = 0;
+
+static std::string to_hex(const uint8_t* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(len * 2);
+    for (size_t i = 0; i < len; i++) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 15];
+    }
+    return out;
+}
+
+// Hash in RPC display order (reversed)
+static std::string hash_hex(const uint8_t hash[32]) {
+    uint8_t reversed[32];
+    for (int i = 0; i < 32; i++) {
+        reversed[i] = hash[31 - i];
+    }
+    return to_hex(reversed, 32);
+}
+
+static std::string base64_encode(const std::string& in) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    size_t i = 0;
+    while (i + 2 < in.size()) {
+        uint32_t v = ((uint8_t)in[i] << 16) | ((uint8_t)in[i + 1] << 8) | (uint8_t)in[i + 2];
+        out += table[v >> 18];
+        out += table[(v >> 12) & 63];
+        out += table[(v >> 6) & 63];
+        out += table[v & 63];
+        i += 3;
+    }
+    if (i + 1 == in.size()) {
+        uint32_t v = (uint8_t)in[i] << 16;
+        out += table[v >> 18];
+        out += table[(v >> 12) & 63];
+        out += "==";
+    } else if (i + 2 == in.size()) {
+        uint32_t v = ((uint8_t)in[i] << 16) | ((uint8_t)in[i + 1] << 8);
+        out += table[v >> 18];
+        out += table[(v >> 12) & 63];
+        out += table[(v >> 6) & 63];
+        out += '=';
+    }
+    return out;
+}
+
+static bool from_hex(const std::string& hex, std::vector<uint8_t>& out) {
+    if (hex.size() & 1) {
+        return false;
+    }
+    out.resize(hex.size() / 2);
+    for (size_t i = 0; i < out.size(); i++) {
+        char* end;
+        char pair[3] = {hex[i * 2], hex[i * 2 + 1], 0};
+        out[i] = (uint8_t)strtoul(pair, &end, 16);
+        if (end != pair + 2) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Display-order hash -> internal byte order
+static void hash_from_hex(const std::string& hex, uint8_t out[32]) {
+    std::vector<uint8_t> bytes;
+    from_hex(hex, bytes);
+    bytes.resize(32);
+    for (int i = 0; i < 32; i++) {
+        out[i] = bytes[31 - i];
+    }
+}
+
+// Merkle root of a list of hashes (internal order), odd levels duplicate the last node
+static void merkle_root(std::vector<std::vector<uint8_t>> level, uint8_t root[32]) {
+    while (level.size() > 1) {
+        if (level.size() & 1) {
+            level.push_back(level.back());
+        }
+        std::vector<std::vector<uint8_t>> next;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            uint8_t pair[64];
+            memcpy(pair, level[i].data(), 32);
+            memcpy(pair + 32, level[i + 1].data(), 32);
+            std::vector<uint8_t> parent(32);
+            sha256d(pair, 64, parent.data());
+            next.push_back(parent);
+        }
+        level.swap(next);
+    }
+    memcpy(root, level[0].data(), 32);
+}
+
+// BIP141 commitment over the wtxids (coinbase = 0) of the first tx_count
+// template transactions, with the given witness reserved value
+static void witness_commitment(size_t tx_count, const uint8_t reserved[32], uint8_t out[32]) {
+    std::vector<std::vector<uint8_t>> leaves(1, std::vector<uint8_t>(32, 0));
+    for (size_t i = 0; i < tx_count; i++) {
+        std::vector<uint8_t> wtxid(32);
+        hash_from_hex(template_txs[i].hash, wtxid.data());
+        leaves.push_back(wtxid);
+    }
+    uint8_t data[64];
+    merkle_root(leaves, data);
+    memcpy(data + 32, reserved, 32);
+    sha256d(data, 64, out);
+}
+
+// Rebuild the served JSON from the template fields
+static void render_template(void) {
+    uint64_t fees = 0;
+    std::string txs;
+    for (size_t t = 0; t < template_txs.size(); t++) {
+        const TemplateTx& tx = template_txs[t];
+        fees += tx.fee;
+        char fields[160];
+        snprintf(fields, sizeof(fields), "\"depends\":[],\"fee\":%llu,\"sigops\":4,\"weight\":%zu}",
+                 (unsigned long long)tx.fee, tx.data.size() * 2);
+        if (t > 0) {
+            txs += ",";
+        }
+        txs += "{\"data\":\"" + tx.data + "\",\"txid\":\"" + tx.txid + "\",\"hash\":\"" + tx.hash + "\"," + fields;
+    }
+
+    static const uint8_t zero[32] = {0};
+    uint8_t commitment[32];
+    witness_commitment(template_txs.size(), zero, commitment);
+
+    char head[1024];
+    snprintf(head, sizeof(head),
+             "{\"capabilities\":[\"proposal\"],\"version\":536870912,\"rules\":[\"csv\",\"!segwit\",\"taproot\"],"
+             "\"vbavailable\":{},\"vbrequired\":0,\"previousblockhash\":\"%s\",\"transactions\":[",
+             template_prevhash.c_str());
+    char longpoll[128] = "";
+    if (opt_longpoll) {
+        snprintf(longpoll, sizeof(longpoll), "\"longpollid\":\"%s%u\",", template_prevhash.c_str(), template_serial);
+    }
+    char tail[1024];
+    snprintf(tail, sizeof(tail),
+             "],\"coinbaseaux\":{},\"coinbasevalue\":%llu,%s"
+             "\"target\":\"7fffff0000000000000000000000000000000000000000000000000000000000\","
+             "\"mintime\":%u,\"mutable\":[\"time\",\"transactions\",\"prevblock\"],\"noncerange\":\"00000000ffffffff\","
+             "\"sigoplimit\":80000,\"sizelimit\":4000000,\"weightlimit\":4000000,\"curtime\":%ld,"
+             "\"bits\":\"%08x\",\"height\":%u,\"default_witness_commitment\":\"6a24aa21a9ed%s\"}",
+             (unsigned long long)(template_subsidy + fees), longpoll,
+             template_mintime, (long)time(NULL), template_bits, template_height, to_hex(commitment, 32).c_str());
+    template_json = head + txs + tail;
+}
+
+// Mainnet-sized template with random (structurally plausible) transactions
+// Random (structurally plausible) transaction, about opt_tx_bytes long
+static TemplateTx random_tx(std::mt19937& rng) {
+    size_t size = 150 + rng() % (2 * opt_tx_bytes > 150 ? 2 * opt_tx_bytes - 150 : 1);
+    std::vector<uint8_t> data(size);
+    for (auto& b : data) {
+        b = (uint8_t)rng();
+    }
+    uint8_t txid[32];
+    sha256d(data.data(), data.size(), txid);
+    TemplateTx tx;
+    tx.data = to_hex(data.data(), data.size());
+    tx.txid = hash_hex(txid);
+    tx.hash = tx.txid;          // No witness data
+    tx.fee = 1000 + rng() % 50000;
+    return tx;
+}
+
+static void generate_template(void) {
+    std::mt19937 rng(opt_seed);
+    uint8_t prev[32];
+    for (int i = 0; i < 32; i++) {
+        prev[i] = (uint8_t)rng();
+    }
+    template_prevhash = hash_hex(prev);
+    template_height = 800000 + rng() % 100000;
+    template_mintime = (uint32_t)time(NULL) - 600;
+
+    template_txs.clear();
+    for (int t = 0; t < opt_transactions; t++) {
+        template_txs.push_back(random_tx(rng));
+    }
+    render_template();
+}
+
+static bool load_template(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    JsonValue value;
+    if (!json_parse(buffer.str(), value) || value.type != JsonValue::OBJECT) {
+        return false;
+    }
+    template_height = (uint32_t)value["height"].asNumber();
+    template_prevhash = value["previousblockhash"].asString();
+    template_bits = (uint32_t)strtoul(value["bits"].asString().c_str(), NULL, 16);
+    template_mintime = (uint32_t)value["mintime"].asNumber();
+    uint64_t fees = 0;
+    template_txs.clear();
+    const JsonValue& txs = value["transactions"];
+    for (size_t i = 0; i < txs.size(); i++) {
+        TemplateTx tx;
+        tx.data = txs[(int)i]["data"].asString();
+        tx.txid = txs[(int)i]["txid"].asString();
+        tx.hash = txs[(int)i]["hash"].asString();
+        tx.fee = (uint64_t)txs[(int)i]["fee"].asNumber();
+        fees += tx.fee;
+        template_txs.push_back(tx);
+    }
+    template_subsidy = (uint64_t)value["coinbasevalue"].asNumber() - fees;
+    render_template();
+    return true;
+}
+
+// Sequential reader over a serialized block
+struct Reader {
+    const std::vector<uint8_t>* buf;
+    size_t pos = 0;
+    bool ok = true;
+
+    const uint8_t* take(size_t n) {
+        if (!ok || pos + n > buf->size()) {
+            ok = false;
+            return NULL;
+        }
+        pos += n;
+        return buf->data() + pos - n;
+    }
+    uint64_t le(int n) {
+        const uint8_t* p = take(n);
+        uint64_t v = 0;
+        for (int i = 0; p && i < n; i++) {
+            v |= (uint64_t)p[i] << (8 * i);
+        }
+        return v;
+    }
+    uint64_t varint() {
+        uint64_t v = le(1);
+        return v == 0xfd ? le(2) : v == 0xfe ? le(4) : v == 0xff ? le(8) : v;
+    }
+};
+
+// Push of the height as Bitcoin Core writes it (CScript() << height)
+static std::vector<uint8_t> height_push(uint32_t height) {
+    if (height == 0) return {0x00};
+    if (height <= 16) return {(uint8_t)(0x50 + height)};
+    std::vector<uint8_t> num;
+    for (uint32_t h = height; h; h >>= 8) {
+        num.push_back(h & 0xff);
+    }
+    if (num.back() & 0x80) {
+        num.push_back(0);
+    }
+    num.insert(num.begin(), (uint8_t)num.size());
+    return num;
+}
+
+static std::map<std::string, std::string> accepted_blocks;     // Hash -> raw block hex, for getblock
+
+// Validate a submitted block: "" if valid, else the BIP22 reject reason
+// ("decode" = not a block at all)
+static std::string check_block(const std::vector<uint8_t>& block, uint8_t block_hash[32], size_t* included_txs) {
+    Reader r;
+    r.buf = &block;
+    const uint8_t* header = r.take(80);
+    if (!header) {
+        return "decode";
+    }
+    sha256d(header, 80, block_hash);
+    if (accepted_blocks.count(hash_hex(block_hash))) {
+        return "duplicate";
+    }
+    uint8_t prev[32];
+    hash_from_hex(template_prevhash, prev);
+    if (memcmp(header + 4, prev, 32) != 0) {
+        return "bad-prevblk";
+    }
+    uint32_t time_field = header[68] | header[69] << 8 | header[70] << 16 | (uint32_t)header[71] << 24;
+    uint32_t bits = header[72] | header[73] << 8 | header[74] << 16 | (uint32_t)header[75] << 24;
+    if (bits != template_bits) {
+        return "bad-diffbits";
+    }
+    if (time_field < template_mintime) {
+        return "time-too-old";
+    }
+    uint8_t target[32] = {0};
+    int exponent = bits >> 24;
+    for (int i = 0; i < 3; i++) {
+        if (exponent - 3 + i >= 0 && exponent - 3 + i < 32) {
+            target[exponent - 3 + i] = (uint8_t)(bits >> (8 * i));
+        }
+    }
+    for (int i = 31; i >= 0; i--) {
+        if (block_hash[i] != target[i]) {
+            if (block_hash[i] > target[i]) {
+                return "high-hash";
+            }
+            break;
+        }
+    }
+
+    uint64_t tx_count = r.varint();
+    if (!r.ok || tx_count == 0) {
+        return "decode";
+    }
+
+    // Coinbase: non-witness serialization rebuilt for its txid
+    std::vector<uint8_t> stripped;
+    size_t cb_start = r.pos;
+    r.le(4);
+    bool segwit = r.ok && r.pos + 2 <= block.size() && block[r.pos] == 0 && block[r.pos + 1] == 1;
+    stripped.insert(stripped.end(), block.begin() + cb_start, block.begin() + r.pos);
+    if (segwit) {
+        r.take(2);
+    }
+    size_t body_start = r.pos;
+    if (r.varint() != 1) {
+        return "bad-cb-missing";
+    }
+    const uint8_t* prevout = r.take(36);
+    static const uint8_t null_prevout[36] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                             0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 0xff, 0xff};
+    if (!prevout || memcmp(prevout, null_prevout, 36) != 0) {
+        return "bad-cb-missing";
+    }
+    uint64_t script_sig_len = r.varint();
+    const uint8_t* script_sig = r.take(script_sig_len);
+    r.le(4);
+    uint64_t outputs = r.varint();
+    uint64_t total_out = 0;
+    int commitment_output = -1;
+    std::vector<uint8_t> commitment_script;
+    std::vector<uint8_t> payout_script;
+    for (uint64_t i = 0; r.ok && i < outputs; i++) {
+        total_out += r.le(8);
+        uint64_t len = r.varint();
+        const uint8_t* script = r.take(len);
+        if (script && len >= 38 && memcmp(script, "\x6a\x24\xaa\x21\xa9\xed", 6) == 0) {
+            commitment_output = (int)i;
+            commitment_script.assign(script, script + len);
+        } else if (script && payout_script.empty()) {
+            payout_script.assign(script, script + len);
+        }
+    }
+    stripped.insert(stripped.end(), block.begin() + body_start, block.begin() + r.pos);
+    std::vector<std::vector<uint8_t>> witness;
+    if (segwit) {
+        uint64_t items = r.varint();
+        for (uint64_t i = 0; r.ok && i < items; i++) {
+            uint64_t len = r.varint();
+            const uint8_t* item = r.take(len);
+            if (item) {
+                witness.push_back(std::vector<uint8_t>(item, item + len));
+            }
+        }
+    }
+    size_t locktime_start = r.pos;
+    r.le(4);
+    if (!r.ok) {
+        return "decode";
+    }
+    stripped.insert(stripped.end(), block.begin() + locktime_start, block.begin() + r.pos);
+
+    if (script_sig_len < 2 || script_sig_len > 100) {
+        return "bad-cb-length";
+    }
+    std::vector<uint8_t> expected_height = height_push(template_height);
+    if (script_sig_len < expected_height.size() ||
+        memcmp(script_sig, expected_height.data(), expected_height.size()) != 0) {
+        return "bad-cb-height";
+    }
+
+    // Template transactions: all of them in order, or none
+    size_t included = (size_t)(tx_count - 1);
+    uint64_t fees = 0;
+    if (included != 0) {
+        if (included != template_txs.size()) {
+            return "bad-txns-template";
+        }
+        for (const auto& tx : template_txs) {
+            std::vector<uint8_t> data;
+            from_hex(tx.data, data);
+            const uint8_t* got = r.take(data.size());
+            if (!got || memcmp(got, data.data(), data.size()) != 0) {
+                return "bad-txns-template";
+            }
+            fees += tx.fee;
+        }
+    }
+    if (r.pos != block.size()) {
+        return "bad-blk-length";
+    }
+    if (total_out > template_subsidy + fees) {
+        return "bad-cb-amount";
+    }
+
+    std::vector<std::vector<uint8_t>> leaves(1, std::vector<uint8_t>(32));
+    sha256d(stripped.data(), stripped.size(), leaves[0].data());
+    for (size_t i = 0; i < included; i++) {
+        std::vector<uint8_t> txid(32);
+        hash_from_hex(template_txs[i].txid, txid.data());
+        leaves.push_back(txid);
+    }
+    uint8_t root[32];
+    merkle_root(leaves, root);
+    if (memcmp(root, header + 36, 32) != 0) {
+        return "bad-txnmrklroot";
+    }
+
+    // BIP141: with a commitment the coinbase witness is the 32-byte reserved value
+    if (commitment_output >= 0) {
+        if (witness.size() != 1 || witness[0].size() != 32) {
+            return "bad-witness-nonce-size";
+        }
+        uint8_t commitment[32];
+        witness_commitment(included, witness[0].data(), commitment);
+        if (memcmp(commitment_script.data() + 6, commitment, 32) != 0) {
+            return "bad-witness-merkle-match";
+        }
+    } else {
+        bool any_witness = segwit;
+        for (size_t i = 0; i < included; i++) {
+            any_witness |= template_txs[i].hash != template_txs[i].txid;
+        }
+        if (any_witness) {
+            return "unexpected-witness";
+        }
+    }
+
+    *included_txs = included;
+    printf("💰 Coinbase: %llu sat to %s, scriptSig %s\n", (unsigned long long)total_out,
+           to_hex(payout_script.data(), payout_script.size()).c_str(), to_hex(script_sig, script_sig_len).c_str());
+    return "";
+}
+
+static void send_http(Connection& conn, int status, const std::string& body) {
+    const char* reason = status == 200 ? "OK" : status == 401 ? "Unauthorized" : status == 404 ? "Not Found"
+                       : status == 500 ? "Internal Server Error" : "Bad Request";
+    char head[256];
+    if (opt_chunked && !conn.http10) {
+        // The body in chunks of at most 8 KB, as a proxy streams it
+        snprintf(head, sizeof(head),
+                 "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nTransfer-Encoding: chunked\r\n"
+                 "Connection: %s\r\n\r\n",
+                 status, reason, conn.keep_alive ? "keep-alive" : "close");
+        conn.outbuf += head;
+        for (size_t pos = 0; pos < body.size(); pos += 8192) {
+            size_t len = std::min(body.size() - pos, (size_t)8192);
+            char size_line[16];
+            snprintf(size_line, sizeof(size_line), "%zx\r\n", len);
+            conn.outbuf += size_line;
+            conn.outbuf.append(body, pos, len);
+            conn.outbuf += "\r\n";
+        }
+        conn.outbuf += "0\r\n\r\n";
+    } else {
+        snprintf(head, sizeof(head),
+                 "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\nConnection: %s\r\n\r\n",
+                 status, reason, body.size(), conn.keep_alive ? "keep-alive" : "close");
+        conn.outbuf += head;
+        conn.outbuf += body;
+    }
+    conn.close_after_send = !conn.keep_alive;
+}
+
+// Inside a batch the reply joins the array; otherwise it is the whole response
+static void send_result(Connection& conn, const JsonValue& id, const std::string& result) {
+    std::string reply = "{\"result\":" + result + ",\"error\":null,\"id\":" + id.dump() + "}";
+    if (conn.batch) {
+        conn.batch->push_back(reply);
+    } else {
+        send_http(conn, 200, reply);
+    }
+}
+
+static void send_error(Connection& conn, const JsonValue& id, int code, const std::string& message) {
+    std::string reply = "{\"result\":null,\"error\":{\"code\":" + std::to_string(code) +
+                        ",\"message\":" + json_quote(message) + "},\"id\":" + id.dump() + "}";
+    if (conn.batch) {
+        conn.batch->push_back(reply);
+    } else {
+        send_http(conn, code == -32601 ? 404 : 500, reply);
+    }
+}
+
+static std::string current_longpollid(void) {
+    return template_prevhash + std::to_string(template_serial);
+}
+
+static void record_template(void) {
+    if (opt_record_file.empty()) {
+        return;
+    }
+    std::string path = opt_record_file;
+    if (template_serial > 0) {
+        path += "." + std::to_string(template_serial);
+    }
+    std::ofstream out(path, std::ios::binary);
+    out << template_json;
+    printf("💾 Recorded template to %s\n", path.c_str());
+}
+
+// New template: answer every parked long-poll with it
+static void template_changed(void) {
+    template_serial++;
+    render_template();
+    record_template();
+    int answered = 0;
+    for (auto& entry : connections) {
+        Connection& conn = entry.second;
+        if (conn.longpoll) {
+            conn.longpoll = false;
+            send_result(conn, conn.longpoll_id, template_json);
+            answered++;
+        }
+    }
+    if (answered) {
+        printf("🔔 Long-poll: new template sent to %d waiting client(s)\n", answered);
+    }
+}
+
+// Another miner found a block: new random tip, half the mempool confirmed
+static void network_block(void) {
+    static std::mt19937 rng(opt_seed + 1);
+    uint8_t hash[32];
+    for (int i = 0; i < 32; i++) {
+        hash[i] = (uint8_t)rng();
+    }
+    hash[31] = 0;
+    template_prevhash = hash_hex(hash);
+    template_height++;
+    template_mintime = (uint32_t)time(NULL);
+    template_txs.erase(template_txs.begin(), template_txs.begin() + template_txs.size() / 2);
+    stat_network_blocks++;
+    printf("🌐 Network block %u: %s (%zu transactions left)\n", template_height - 1, template_prevhash.c_str(),
+           template_txs.size());
+    template_changed();
+}
+
+// New transactions reach the mempool: about 2% more, appended in arrival order
+static void mempool_arrivals(void) {
+    static std::mt19937 rng(opt_seed + 2);
+    size_t count = 1 + template_txs.size() / 50;
+    for (size_t i = 0; i < count; i++) {
+        template_txs.push_back(random_tx(rng));
+    }
+    printf("📥 Mempool: %zu new transactions (%zu in the template)\n", count, template_txs.size());
+    template_changed();
+}
+
+static void handle_rpc(Connection& conn, const JsonValue& request) {
+    const JsonValue& id = request["id"];
+    const std::string& method = request["method"].asString();
+    const JsonValue& params = request["params"];
+    stat_requests++;
+
+    if (method == "getblocktemplate") {
+        bool segwit = false;
+        const JsonValue& rules = params[0]["rules"];
+        for (size_t i = 0; i < rules.size(); i++) {
+            segwit |= rules[(int)i].asString() == "segwit";
+        }
+        if (!segwit) {
+            send_error(conn, id, -8,
+                       "getblocktemplate must be called with the segwit rule set (call with {\"rules\": [\"segwit\"]})");
+            return;
+        }
+        // Long-poll on the current template: answered by template_changed(). Not inside a batch.
+        const JsonValue& longpollid = params[0]["longpollid"];
+        if (opt_longpoll && !conn.batch && longpollid.type == JsonValue::STRING &&
+            longpollid.asString() == current_longpollid()) {
+            conn.longpoll = true;
+            conn.longpoll_id = id;
+            stat_longpolls++;
+            printf("⏳ %s: long-poll waiting for a new template\n", conn.address.c_str());
+            return;
+        }
+        send_result(conn, id, template_json);
+        printf("📤 %s: getblocktemplate (%zu bytes)\n", conn.address.c_str(), template_json.size());
+    } else if (method == "submitblock") {
+        std::vector<uint8_t> block;
+        if (params[0].type != JsonValue::STRING || !from_hex(params[0].asString(), block)) {
+            send_error(conn, id, -22, "Block decode failed");
+            return;
+        }
+        uint8_t hash[32];
+        size_t included = 0;
+        std::string reason = check_block(block, hash, &included);
+        if (reason == "decode") {
+            stat_blocks_rejected++;
+            send_error(conn, id, -22, "Block decode failed");
+            printf("❌ %s: submitblock (%zu bytes) does not decode\n", conn.address.c_str(), block.size());
+            return;
+        }
+        if (!reason.empty()) {
+            stat_blocks_rejected++;
+            send_result(conn, id, json_quote(reason));
+            printf("❌ %s: block rejected: %s\n", conn.address.c_str(), reason.c_str());
+            return;
+        }
+
+        // New tip: the next template builds on it, without the transactions this block confirmed
+        stat_blocks_accepted++;
+        send_result(conn, id, "null");
+        printf("✅ %s: block %u accepted (%zu bytes, %zu transactions): %s\n", conn.address.c_str(), template_height,
+               block.size(), included, hash_hex(hash).c_str());
+        accepted_blocks[hash_hex(hash)] = params[0].asString();
+        template_prevhash = hash_hex(hash);
+        template_height++;
+        template_mintime = (uint32_t)time(NULL);
+        template_txs.erase(template_txs.begin(), template_txs.begin() + included);
+        template_changed();
+    } else if (method == "getblockchaininfo") {
+        char info[512];
+        snprintf(info, sizeof(info), "{\"chain\":\"regtest\",\"blocks\":%u,\"headers\":%u,\"bestblockhash\":\"%s\"}",
+                 template_height - 1, template_height - 1, template_prevhash.c_str());
+        send_result(conn, id, info);
+    } else if (method == "getnetworkinfo") {
+        send_result(conn, id, "{\"version\":270000,\"subversion\":\"/node_emulator:0.1/\",\"protocolversion\":70016}");
+    } else if (method == "getemulatorstats") {
+        // Not a Core RPC: lets a test count the connections it opened
+        char info[256];
+        snprintf(info, sizeof(info),
+                 "{\"connections\":%llu,\"http_requests\":%llu,\"requests\":%llu,\"batches\":%llu,"
+                 "\"idle_closed\":%llu,\"idle_timeout\":%d,\"dropped\":%llu}",
+                 (unsigned long long)stat_connections, (unsigned long long)stat_http_requests,
+                 (unsigned long long)stat_requests, (unsigned long long)stat_batches,
+                 (unsigned long long)stat_idle_closed, opt_idle_seconds, (unsigned long long)stat_dropped);
+        send_result(conn, id, info);
+    } else if (method == "setemulatoroptions") {
+        // Not a Core RPC either: {"chunked": bool, "drop_every": N}, the fields given change
+        const JsonValue& options = params[0];
+        if (options["chunked"].type == JsonValue::BOOL) {
+            opt_chunked = options["chunked"].boolean;
+        }
+        if (options["drop_every"].type == JsonValue::NUMBER) {
+            opt_drop_every = std::max(0, (int)options["drop_every"].asNumber());
+        }
+        printf("🔧 %s: chunked %s, drop every %d\n", conn.address.c_str(), opt_chunked ? "on" : "off",
+               opt_drop_every);
+        send_result(conn, id,
+                    std::string("{\"chunked\":") + (opt_chunked ? "true" : "false") +
+                        ",\"drop_every\":" + std::to_string(opt_drop_every) + "}");
+    } else if (method == "getblock") {
+        // Verbosity 0 only: the block as submitted, to compare byte for byte
+        auto it = accepted_blocks.find(params[0].asString());
+        if (it == accepted_blocks.end()) {
+            send_error(conn, id, -5, "Block not found");
+        } else if (params.size() > 1 && params[1].asNumber() != 0) {
+            send_error(conn, id, -8, "Only verbosity 0 is supported");
+        } else {
+            send_result(conn, id, json_quote(it->second));
+        }
+    } else if (method == "getbestblockhash") {
+        send_result(conn, id, json_quote(template_prevhash));
+    } else {
+        send_error(conn, id, -32601, "Method not found");
+    }
+}
+
+// Complete HTTP request in the input buffer: check auth, dispatch the JSON-RPC body
+static bool handle_http(Connection& conn) {
+    size_t header_end = conn.inbuf.find("\r\n\r\n");
+    if (header_end == std::string::npos) {
+        return false;
+    }
+    std::string headers = conn.inbuf.substr(0, header_end);
+    std::string lower = headers;
+    for (auto& c : lower) {
+        c = (char)tolower((unsigned char)c);
+    }
+    size_t content_length = 0;
+    size_t pos = lower.find("content-length:");
+    if (pos != std::string::npos) {
+        content_length = strtoul(lower.c_str() + pos + 15, NULL, 10);
+    }
+    if (conn.inbuf.size() < header_end + 4 + content_length) {
+        return false;
+    }
+    std::string body = conn.inbuf.substr(header_end + 4, content_length);
+    conn.inbuf.erase(0, header_end + 4 + content_length);
+    stat_http_requests++;
+
+    // Keep-alive is the default from HTTP/1.1 on; HTTP/1.0 has to ask for it
+    size_t line_end = lower.find("\r\n");
+    bool http10 = lower.rfind("http/1.0", line_end) != std::string::npos;
+    bool close_requested = lower.find("connection: close") != std::string::npos;
+    conn.keep_alive = !close_requested && (!http10 || lower.find("connection: keep-alive") != std::string::npos);
+    conn.http10 = http10;
+
+    // -x: the connection closes under a request that arrived on it after another one
+    if (opt_drop_every > 0 && conn.requests > 0 && ++stat_reused_requests % opt_drop_every == 0) {
+        stat_dropped++;
+        conn.inbuf.clear();
+        conn.close_after_send = true;
+        printf("✂️  %s: request dropped, connection closed\n", conn.address.c_str());
+        return true;
+    }
+    conn.requests++;
+
+    if (!opt_auth.empty() && headers.find("Basic " + base64_encode(opt_auth)) == std::string::npos) {
+        send_http(conn, 401, "");
+        printf("🔒 %s: unauthorized\n", conn.address.c_str());
+        return true;
+    }
+
+    JsonValue request;
+    if (!json_parse(body, request) || (request.type != JsonValue::OBJECT && request.type != JsonValue::ARRAY)) {
+        send_error(conn, JsonValue(), -32700, "Parse error");
+        return true;
+    }
+    if (request.type == JsonValue::OBJECT) {
+        handle_rpc(conn, request);
+        return true;
+    }
+
+    // Batch: every call answered in order, in one array with HTTP 200
+    std::vector<std::string> replies;
+    conn.batch = &replies;
+    for (size_t i = 0; i < request.size(); i++) {
+        if (request[(int)i].type == JsonValue::OBJECT) {
+            handle_rpc(conn, request[(int)i]);
+        } else {
+            send_error(conn, JsonValue(), -32600, "Invalid Request object");
+        }
+    }
+    conn.batch = nullptr;
+    stat_batches++;
+    std::string array = "[";
+    for (size_t i = 0; i < replies.size(); i++) {
+        array += (i ? "," : "") + replies[i];
+    }
+    send_http(conn, 200, array + "]");
+    printf("📦 %s: batch of %zu calls\n", conn.address.c_str(), replies.size());
+    return true;
+}
+
+static void close_connection(int fd) {
+    close(fd);
+    connections.erase(fd);
+}
+
+static void print_stats(void) {
+    printf("┌──────────────── Node emulator stats ────────────────┐\n");
+    printf("│ Connections: %-8llu Requests: %-8llu            │\n", (unsigned long long)stat_connections,
+           (unsigned long long)stat_requests);
+    printf("│ HTTP requests: %-8llu Batches: %-8llu           │\n", (unsigned long long)stat_http_requests,
+           (unsigned long long)stat_batches);
+    printf("│ Idle connections closed: %-8llu                   │\n", (unsigned long long)stat_idle_closed);
+    printf("│ Requests dropped (-x):   %-8llu                   │\n", (unsigned long long)stat_dropped);
+    printf("│ Bytes out: %-12llu                             │\n", (unsigned long long)stat_bytes_out);
+    printf("│ Blocks accepted: %-8llu Rejected: %-8llu        │\n", (unsigned long long)stat_blocks_accepted,
+           (unsigned long long)stat_blocks_rejected);
+    printf("│ Long-polls: %-8llu Network blocks: %-8llu       │\n", (unsigned long long)stat_longpolls,
+           (unsigned long long)stat_network_blocks);
+    printf("└─────────────────────────────────────────────────────┘\n");
+}
+
+static void on_signal(int) {
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "p:a:n:s:t:w:r:b:Lm:k:Cx:")) != -1) {
+        switch (opt) {
+            case 'p': opt_port = (uint16_t)atoi(optarg); break;
+            case 'a': opt_auth = optarg; break;
+            case 'n': opt_transactions = atoi(optarg); break;
+            case 's': opt_tx_bytes = atoi(optarg); break;
+            case 't': opt_template_file = optarg; break;
+            case 'w': opt_record_file = optarg; break;
+            case 'r': opt_seed = (unsigned)atoi(optarg); break;
+            case 'b': opt_block_seconds = atoi(optarg); break;
+            case 'L': opt_longpoll = false; break;
+            case 'm': opt_mempool_seconds = atoi(optarg); break;
+            case 'k': opt_idle_seconds = atoi(optarg); break;
+            case 'C': opt_chunked = true; break;
+            case 'x': opt_drop_every = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-p port] [-a user:pass] [-n transactions] [-s avg_tx_bytes]\n"
+                                "       [-t template.json] [-w template.json] [-r seed] [-b block_seconds] [-L]\n"
+                                "       [-m mempool_seconds] [-k idle_seconds] [-C] [-x drop_every]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+    if (opt_transactions < 0 || opt_tx_bytes <= 0 || opt_block_seconds < 0 || opt_mempool_seconds < 0 ||
+        opt_idle_seconds < 1 || opt_drop_every < 0) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+
+    if (!opt_template_file.empty()) {
+        if (!load_template(opt_template_file)) {
+            fprintf(stderr, "❌ Cannot load template %s\n", opt_template_file.c_str());
+            return 1;
+        }
+        printf("📂 Replaying %s (%zu bytes, height %u)\n", opt_template_file.c_str(), template_json.size(),
+               template_height);
+    } else {
+        generate_template();
+        printf("🧱 Generated template: %d transactions, %zu bytes, height %u\n", opt_transactions,
+               template_json.size(), template_height);
+    }
+    record_template();
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(opt_port);
+    if (bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, 64) < 0) {
+        fprintf(stderr, "❌ Cannot listen on port %u: %s\n", opt_port, strerror(errno));
+        return 1;
+    }
+    fcntl(listen_fd, F_SETFL, O_NONBLOCK);
+    printf("🟠 Node emulator on :%u%s%s\n", opt_port, opt_auth.empty() ? "" : " (Basic auth)",
+           opt_longpoll ? "" : " (no long-poll)");
+
+    time_t last_block = time(NULL);
+    time_t last_arrivals = time(NULL);
+    while (running) {
+        if (opt_block_seconds > 0 && time(NULL) - last_block >= opt_block_seconds) {
+            last_block = time(NULL);
+            network_block();
+        }
+        if (opt_mempool_seconds > 0 && time(NULL) - last_arrivals >= opt_mempool_seconds) {
+            last_arrivals = time(NULL);
+            mempool_arrivals();
+        }
+
+        std::vector<struct pollfd> fds;
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (auto& entry : connections) {
+            fds.push_back({entry.first, (short)(POLLIN | (entry.second.outbuf.empty() ? 0 : POLLOUT)), 0});
+        }
+        if (poll(fds.data(), fds.size(), 100) < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+
+        for (size_t i = 0; i < fds.size(); i++) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            if (fds[i].fd == listen_fd) {
+                struct sockaddr_in peer;
+                socklen_t len = sizeof(peer);
+                int fd;
+                while ((fd = accept(listen_fd, (struct sockaddr*)&peer, &len)) >= 0) {
+                    fcntl(fd, F_SETFL, O_NONBLOCK);
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    char buf[32];
+                    snprintf(buf, sizeof(buf), "%s:%u", inet_ntoa(peer.sin_addr), ntohs(peer.sin_port));
+                    connections[fd].address = buf;
+                    connections[fd].last_active = time(NULL);
+                    stat_connections++;
+                    len = sizeof(peer);
+                }
+                continue;
+            }
+
+            auto it = connections.find(fds[i].fd);
+            if (it == connections.end()) {
+                continue;
+            }
+            Connection& conn = it->second;
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                char chunk[16384];
+                ssize_t n = recv(fds[i].fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                        close_connection(fds[i].fd);
+                    }
+                    continue;
+                }
+                conn.inbuf.append(chunk, n);
+                conn.last_active = time(NULL);
+                while (!conn.close_after_send && !conn.longpoll && handle_http(conn)) {
+                }
+            }
+        }
+
+        std::vector<int> done;
+        for (auto& entry : connections) {
+            Connection& conn = entry.second;
+            while (!conn.outbuf.empty()) {
+                ssize_t n = send(entry.first, conn.outbuf.data(), conn.outbuf.size(), MSG_NOSIGNAL);
+                if (n > 0) {
+                    stat_bytes_out += n;
+                    conn.outbuf.erase(0, n);
+                    conn.last_active = time(NULL);
+                } else {
+                    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                        done.push_back(entry.first);
+                    }
+                    break;
+                }
+            }
+            if (conn.outbuf.empty() && conn.close_after_send) {
+                done.push_back(entry.first);
+            } else if (conn.outbuf.empty() && !conn.longpoll && conn.inbuf.empty() &&
+                       time(NULL) - conn.last_active >= opt_idle_seconds) {
+                // Idle keep-alive connection: closed as bitcoind does after rpcservertimeout
+                stat_idle_closed++;
+                done.push_back(entry.first);
+            }
+        }
+        for (int fd : done) {
+            if (connections.count(fd)) {
+                close_connection(fd);
+            }
+        }
+    }
+
+    print_stats();
+    while (!connections.empty()) {
+        close_connection(connections.begin()->first);
+    }
+    close(listen_fd);
+    return 0;
+}
@@ -0,0 +1,180 @@
+// Host harness for the device's pool mining path.
+//
+// Compiles src/mining_task.cpp, the Stratum clients and src/pool_manager.cpp
+// as they are, against a small Arduino/FreeRTOS/WiFi shim (shim/) and the real
+// ArduinoJson, and runs them against a local pool_emulator: the mining task in
+// pool mode, on its own thread, exactly as on the board. It connects,
+// subscribes, authorizes, hashes every job it is sent, submits the shares it
+// finds and reconnects when the emulator drops it.
+//
+// On the board a share needs 8 leading zero hex digits, about 2^32 hashes,
+// which the host does not reach in a run. The bench is therefore built with
+// -DMINING_HOST_SHARE_ZEROS=N, which lowers the mining task's own share test
+// to N zero digits (4: a share every ~65k hashes). The emulator must run with
+// -d 1e-10 so that it accepts them.
+//
+// Measured, all on the device path:
+//   - connect -> first hash for every session of the mining task, from the
+//     line it prints when the first hash is done (the same figure as
+//     MiningStats.connect_to_first_hash_ms)
+//   - notify -> switch as MiningStats reports it (mining.notify parsed ->
+//     first hash on the new job), read every millisecond like the display
+//   - the shares the mining task submitted, and the accepted, rejected and
+//     stale counts of its StratumClient (PoolSessionStats)
+//   - share round trip: every "Share accepted! (N ms)" the client logs, and
+//     the average it keeps (MiningStats.share_rtt_ms)
+// The tool exits non-zero if the mining task never hashed a pool job or none
+// of its shares was answered.
+//
+// Build: see README.md
+// Usage: mining_bench [-h host] [-p port] [-t seconds] [-v]
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bitcoin_rpc.h"
+#include "mining_task.h"
+
+#ifndef MINING_HOST_SHARE_ZEROS
+#error "Build with -DMINING_HOST_SHARE_ZEROS=N (see README.md)"
+#endif
+
+static const char* opt_host = "127.0.0.1";
+static int opt_port = 3333;
+static int opt_seconds = 30;
+
+// ---------------------------------------------------------------------------
+// Stand-ins for the board (the rest is in shim/board.cpp)
+// ---------------------------------------------------------------------------
+
+// No Bitcoin node: the harness only runs pool mode
+bool bitcoin_rpc_init(const char*, uint16_t, const char*, const char*) { return false; }
+bool bitcoin_rpc_test_connection(void) { return false; }
+bool bitcoin_rpc_get_block_template(BitcoinBlockTemplate*) { return false; }
+bool bitcoin_rpc_submit_block(const uint8_t*, const solo_coinbase_t*, const BitcoinBlockTemplate*) { return false; }
+void bitcoin_rpc_longpoll_start(void) {}
+void bitcoin_rpc_longpoll_stop(void) {}
+uint32_t bitcoin_rpc_template_generation(void) { return 0; }
+unsigned long bitcoin_rpc_template_changed_ms(void) { return 0; }
+bool bitcoin_rpc_tip_changed(const char*) { return false; }
+
+// ---------------------------------------------------------------------------
+// Device log
+// ---------------------------------------------------------------------------
+
+// What the mining task prints, read as it is printed (on the mining thread)
+static std::mutex log_mutex;
+static std::vector<double> first_hash_ms;   // "primo hash N ms dopo la connessione"
+static std::vector<double> share_rtt_ms;    // "Share accepted! (N ms)"
+
+static void on_device_log(const char* text, size_t len) {
+    std::string line(text, len);
+    std::lock_guard<std::mutex> lock(log_mutex);
+    size_t pos;
+    if ((pos = line.find("primo hash ")) != std::string::npos) {
+        first_hash_ms.push_back(atof(line.c_str() + pos + strlen("primo hash ")));
+    } else if ((pos = line.find("Share accepted! (")) != std::string::npos) {
+        share_rtt_ms.push_back(atof(line.c_str() + pos + strlen("Share accepted! (")));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Main
+// ---------------------------------------------------------------------------
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+static void usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -h <host>     pool_emulator host (default 127.0.0.1)\n"
+            "  -p <port>     pool_emulator port (default 3333)\n"
+            "  -t <seconds>  run time (default 30)\n"
+            "  -v            print the device's serial output\n",
+            name);
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:t:v")) != -1) {
+        switch (opt) {
+            case 'h': opt_host = optarg; break;
+            case 'p': opt_port = atoi(optarg); break;
+            case 't': opt_seconds = atoi(optarg); break;
+            case 'v': Serial.echo = true; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (opt_port <= 0 || opt_port > 65535 || opt_seconds <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("⛏️  Mining bench: pool %s:%d, %d s, shares at %d zero digits\n", opt_host, opt_port, opt_seconds,
+           MINING_HOST_SHARE_ZEROS);
+
+    // The mining task, configured like the board in pool mode
+    Serial.tap = on_device_log;
+    mining_set_pool(opt_host, (uint16_t)opt_port, "bench", "miner");
+    mining_set_mode(MINING_MODE_POOL);
+    mining_task_start();
+
+    uint32_t notify_max = 0;
+    unsigned long end = millis() + opt_seconds * 1000UL;
+    while ((long)(end - millis()) > 0) {
+        notify_max = std::max(notify_max, mining_get_stats().notify_to_switch_ms);
+        delay(1);
+    }
+
+    MiningStats stats = mining_get_stats();
+    PoolSessionStats session = {};
+    bool has_session = mining_get_session_stats(0, &session);
+    mining_task_stop();
+    Serial.tap = nullptr;
+
+    uint32_t answered = session.shares_accepted + session.shares_rejected;
+    uint32_t lost = session.shares_submitted > answered ? session.shares_submitted - answered : 0;
+    double stale_ratio = answered ? 100.0 * session.shares_stale / answered : 0.0;
+    double reject_ratio = answered ? 100.0 * session.shares_rejected / answered : 0.0;
+
+    std::lock_guard<std::mutex> lock(log_mutex);
+    printf("┌─────────────────── Mining bench ────────────────────┐\n");
+    printf("│ Mining task: %10u hashes  %8u H/s        │\n", stats.total_hashes, stats.hashes_per_second);
+    printf("│ Connect -> first hash  p50 %6.0f ms  max %6.0f ms │\n", percentile(first_hash_ms, 50),
+           percentile(first_hash_ms, 100));
+    printf("│   sessions: %-6zu                                  │\n", first_hash_ms.size());
+    printf("│ Notify -> switch      last %6u ms  max %6u ms │\n", stats.notify_to_switch_ms, notify_max);
+    printf("│ Shares submitted %-6u  unanswered %-6u          │\n", session.shares_submitted, lost);
+    printf("│   accepted %-7u rejected %-7u stale %-7u   │\n", session.shares_accepted, session.shares_rejected,
+           session.shares_stale);
+    printf("│   stale %6.2f %%    reject %6.2f %%                 │\n", stale_ratio, reject_ratio);
+    printf("│ Share RTT              p50 %6.0f ms  p99 %6.0f ms │\n", percentile(share_rtt_ms, 50),
+           percentile(share_rtt_ms, 99));
+    printf("│   average (MiningStats)    %6u ms                │\n", stats.share_rtt_ms);
+    printf("└─────────────────────────────────────────────────────┘\n");
+
+    if (first_hash_ms.empty() || stats.total_hashes == 0 || !has_session) {
+        fprintf(stderr, "❌ The mining task never hashed a pool job\n");
+        return 1;
+    }
+    if (answered == 0) {
+        fprintf(stderr, "❌ None of the mining task's shares was answered\n");
+        return 1;
+    }
+    return 0;
+}
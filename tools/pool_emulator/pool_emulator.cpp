@@ -0,0 +1,636 @@
+// Local Stratum V1 pool emulator for testing the device without a live pool.
+//
+// Implements mining.subscribe, mining.authorize, mining.set_difficulty,
+// mining.notify (clean and non-clean jobs) and mining.submit. Shares are
+// verified like a real pool does: the coinbase is rebuilt from
+// coinb1 + extranonce1 + extranonce2 + coinb2, the merkle root is folded with
+// the branch, and the double SHA-256 of the 80-byte header must meet the
+// share target derived from the difficulty. Stale jobs (error 21),
+// duplicates (22) and low difficulty shares (23) are rejected with the usual
+// Stratum error codes. Disconnects and rejects can be scripted to exercise
+// the device's failover and accounting paths.
+//
+// Build: g++ -std=c++17 -O2 -Wall -o pool_emulator pool_emulator.cpp
+// Usage: pool_emulator [options]  (see usage() below)
+
+#include "../common/mini_json.h"
+#include "../common/sha256.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#define EMU_EXTRANONCE2_SIZE 4
+#define EMU_MAX_JOBS         8       // Jobs of the current block still accepted for submits
+#define EMU_STATS_INTERVAL_MS 10000
+
+// Stratum error codes
+#define ERR_OTHER      20
+#define ERR_STALE      21
+#define ERR_DUPLICATE  22
+#define ERR_LOW_DIFF   23
+#define ERR_UNAUTH     24
+#define ERR_NOT_SUBSCRIBED 25
+
+// Job as sent in mining.notify
+struct Job {
+    std::string id;
+    std::string prev_hash;          // Stratum form (4-byte words byte-swapped)
+    std::string coinb1;
+    std::string coinb2;
+    std::vector<std::string> branch;
+    std::string version;
+    std::string nbits;
+    std::string ntime;
+    bool clean;
+    uint64_t sent_ms;
+};
+
+// Miner connection
+struct Miner {
+    int fd = -1;
+    std::string address;
+    std::string inbuf;
+    std::string outbuf;
+    std::string extranonce1;
+    bool subscribed = false;
+    bool authorized = false;
+    uint64_t connected_ms = 0;
+    uint64_t first_share_ms = 0;    // 0 = no share yet
+    uint32_t accepted = 0;
+    uint32_t rejected = 0;
+    uint32_t stale = 0;
+    std::set<std::string> seen;     // Duplicate detection (job:en2:ntime:nonce)
+};
+
+// Emulator options
+static uint16_t opt_port = 3333;
+static double opt_difficulty = 0.001;
+static int opt_notify_interval_s = 30;
+static int opt_clean_every = 3;      // Every Nth notify is clean (1 = always)
+static int opt_disconnect_every_s = 0;
+static int opt_reject_every = 0;     // Force a reject on every Nth valid share (0 = off)
+static int opt_branches = 2;
+
+// Emulator state
+static std::map<int, Miner> miners;
+static std::vector<Job> jobs;        // Oldest first; cleared on clean notify
+static uint32_t next_job_id = 1;
+static uint32_t next_extranonce1 = 0x10000000;
+static std::string current_prev_hash;
+static uint32_t block_height = 800000;
+static uint64_t valid_shares = 0;
+static volatile bool running = true;
+static std::mt19937_64 rng(12345);
+
+// Statistics
+static uint64_t stat_notifies = 0;
+static uint64_t stat_accepted = 0;
+static uint64_t stat_stale = 0;
+static uint64_t stat_low_diff = 0;
+static uint64_t stat_duplicate = 0;
+static uint64_t stat_scripted_rejects = 0;
+static uint64_t stat_disconnects = 0;
+static uint64_t stat_share_latency_total = 0;   // notify -> share on that job
+static uint64_t stat_share_latency_count = 0;
+static uint64_t stat_bytes_in = 0;
+static uint64_t stat_bytes_out = 0;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static std::string random_hex(size_t bytes) {
+    static const char* digits = "0123456789abcdef";
+    std::string hex;
+    for (size_t i = 0; i < bytes; i++) {
+        uint8_t b = (uint8_t)rng();
+        hex += digits[b >> 4];
+        hex += digits[b & 0x0F];
+    }
+    return hex;
+}
+
+static std::string u32_hex(uint32_t value) {
+    char buf[9];
+    snprintf(buf, sizeof(buf), "%08x", value);
+    return buf;
+}
+
+static bool hex_to_bytes(const std::string& hex, std::vector<uint8_t>& out) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        char* end = NULL;
+        std::string pair = hex.substr(i, 2);
+        unsigned long b = strtoul(pair.c_str(), &end, 16);
+        if (*end != '\0') {
+            return false;
+        }
+        out.push_back((uint8_t)b);
+    }
+    return true;
+}
+
+static void put_u32_le(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back((uint8_t)(value >> (i * 8)));
+    }
+}
+
+static void send_line(Miner& miner, const std::string& line) {
+    miner.outbuf += line;
+    miner.outbuf += "\n";
+}
+
+static void send_result(Miner& miner, const std::string& id, const char* result) {
+    send_line(miner, "{\"id\":" + id + ",\"result\":" + result + ",\"error\":null}");
+}
+
+static void send_error(Miner& miner, const std::string& id, int code, const char* message) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", code);
+    send_line(miner, "{\"id\":" + id + ",\"result\":null,\"error\":[" + buf + "," + json_quote(message) + ",null]}");
+}
+
+static std::string notify_line(const Job& job) {
+    std::string branch = "[";
+    for (size_t i = 0; i < job.branch.size(); i++) {
+        if (i > 0) branch += ",";
+        branch += json_quote(job.branch[i]);
+    }
+    branch += "]";
+    return "{\"id\":null,\"method\":\"mining.notify\",\"params\":[" + json_quote(job.id) + "," +
+           json_quote(job.prev_hash) + "," + json_quote(job.coinb1) + "," + json_quote(job.coinb2) + "," +
+           branch + "," + json_quote(job.version) + "," + json_quote(job.nbits) + "," +
+           json_quote(job.ntime) + "," + (job.clean ? "true" : "false") + "]}";
+}
+
+static std::string difficulty_line(void) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.8g", opt_difficulty);
+    return std::string("{\"id\":null,\"method\":\"mining.set_difficulty\",\"params\":[") + buf + "]}";
+}
+
+// Build a new job; clean jobs move to a new previous block
+static void make_job(bool clean) {
+    if (clean || current_prev_hash.empty()) {
+        current_prev_hash = random_hex(32);
+        block_height++;
+        jobs.clear();
+    }
+
+    Job job;
+    char id_buf[16];
+    snprintf(id_buf, sizeof(id_buf), "%x", next_job_id++);
+    job.id = id_buf;
+    job.prev_hash = current_prev_hash;
+
+    // Coinbase: version, 1 input (null outpoint), scriptSig = BIP34 height + extranonce1 + extranonce2
+    std::string height_le;
+    char b[3];
+    for (int i = 0; i < 3; i++) {
+        snprintf(b, sizeof(b), "%02x", (block_height >> (i * 8)) & 0xFF);
+        height_le += b;
+    }
+    int script_len = 1 + 3 + 4 + EMU_EXTRANONCE2_SIZE;
+    snprintf(b, sizeof(b), "%02x", script_len);
+    job.coinb1 = "01000000" "01" + std::string(64, '0') + "ffffffff" + b + "03" + height_le;
+    // 1 output: 6.25 BTC to a P2PKH script, locktime 0
+    job.coinb2 = "ffffffff" "01" "40be402500000000" "19" "76a914" + random_hex(20) + "88ac" "00000000";
+
+    for (int i = 0; i < opt_branches; i++) {
+        job.branch.push_back(random_hex(32));
+    }
+    job.version = "20000000";
+    job.nbits = "1705ae3a";
+    job.ntime = u32_hex((uint32_t)time(NULL));
+    job.clean = clean;
+    job.sent_ms = now_ms();
+
+    jobs.push_back(job);
+    if (jobs.size() > EMU_MAX_JOBS) {
+        jobs.erase(jobs.begin());
+    }
+}
+
+static void broadcast_job(void) {
+    std::string line = notify_line(jobs.back());
+    for (auto& entry : miners) {
+        if (entry.second.authorized) {
+            send_line(entry.second, line);
+        }
+    }
+    stat_notifies++;
+    printf("📬 Notify job %s (%s, %zu miners)\n", jobs.back().id.c_str(),
+           jobs.back().clean ? "clean" : "non-clean", miners.size());
+}
+
+static const Job* find_job(const std::string& id) {
+    for (const Job& job : jobs) {
+        if (job.id == id) {
+            return &job;
+        }
+    }
+    return NULL;
+}
+
+// Difficulty of a header hash, as pools compute it (diff1 target / hash)
+static double hash_difficulty(const uint8_t hash[32]) {
+    // The hash is a little-endian 256-bit number
+    long double value = 0;
+    for (int i = 31; i >= 0; i--) {
+        value = value * 256.0L + hash[i];
+    }
+    if (value == 0) {
+        return INFINITY;
+    }
+    long double diff1 = 65535.0L * powl(2.0L, 208);
+    return (double)(diff1 / value);
+}
+
+// Rebuild the header from a submit and return its share difficulty (-1 = malformed)
+static double verify_share(const Miner& miner, const Job& job, const std::string& extranonce2,
+                           const std::string& ntime, const std::string& nonce) {
+    std::vector<uint8_t> coinbase;
+    if (!hex_to_bytes(job.coinb1, coinbase) || !hex_to_bytes(miner.extranonce1, coinbase) ||
+        !hex_to_bytes(extranonce2, coinbase) || !hex_to_bytes(job.coinb2, coinbase)) {
+        return -1;
+    }
+
+    uint8_t root[32];
+    sha256d(coinbase.data(), coinbase.size(), root);
+    for (const std::string& branch_hex : job.branch) {
+        std::vector<uint8_t> node(root, root + 32);
+        if (!hex_to_bytes(branch_hex, node)) {
+            return -1;
+        }
+        sha256d(node.data(), node.size(), root);
+    }
+
+    std::vector<uint8_t> prev;
+    if (!hex_to_bytes(job.prev_hash, prev) || prev.size() != 32) {
+        return -1;
+    }
+
+    std::vector<uint8_t> header;
+    put_u32_le(header, (uint32_t)strtoul(job.version.c_str(), NULL, 16));
+    // Stratum sends prevhash as 8 words with their bytes swapped
+    for (int word = 0; word < 8; word++) {
+        for (int i = 3; i >= 0; i--) {
+            header.push_back(prev[word * 4 + i]);
+        }
+    }
+    header.insert(header.end(), root, root + 32);
+    put_u32_le(header, (uint32_t)strtoul(ntime.c_str(), NULL, 16));
+    put_u32_le(header, (uint32_t)strtoul(job.nbits.c_str(), NULL, 16));
+    put_u32_le(header, (uint32_t)strtoul(nonce.c_str(), NULL, 16));
+
+    uint8_t hash[32];
+    sha256d(header.data(), header.size(), hash);
+    return hash_difficulty(hash);
+}
+
+static void handle_submit(Miner& miner, const std::string& id, const JsonValue& params) {
+    if (!miner.authorized) {
+        send_error(miner, id, ERR_UNAUTH, "Unauthorized worker");
+        miner.rejected++;
+        return;
+    }
+    if (params.size() < 5) {
+        send_error(miner, id, ERR_OTHER, "Invalid params");
+        miner.rejected++;
+        return;
+    }
+
+    const std::string& job_id = params[1].asString();
+    const std::string& extranonce2 = params[2].asString();
+    const std::string& ntime = params[3].asString();
+    const std::string& nonce = params[4].asString();
+
+    if (miner.first_share_ms == 0) {
+        miner.first_share_ms = now_ms();
+        printf("⏱️  %s: first share %llu ms after connect\n", miner.address.c_str(),
+               (unsigned long long)(miner.first_share_ms - miner.connected_ms));
+    }
+
+    const Job* job = find_job(job_id);
+    if (!job) {
+        send_error(miner, id, ERR_STALE, "Job not found");
+        miner.rejected++;
+        miner.stale++;
+        stat_stale++;
+        return;
+    }
+
+    stat_share_latency_total += now_ms() - job->sent_ms;
+    stat_share_latency_count++;
+
+    if (extranonce2.size() != EMU_EXTRANONCE2_SIZE * 2 || ntime.size() != 8 || nonce.size() != 8) {
+        send_error(miner, id, ERR_OTHER, "Invalid share format");
+        miner.rejected++;
+        return;
+    }
+
+    std::string key = job_id + ":" + extranonce2 + ":" + ntime + ":" + nonce;
+    if (!miner.seen.insert(key).second) {
+        send_error(miner, id, ERR_DUPLICATE, "Duplicate share");
+        miner.rejected++;
+        stat_duplicate++;
+        return;
+    }
+
+    double share_diff = verify_share(miner, *job, extranonce2, ntime, nonce);
+    if (share_diff < 0) {
+        send_error(miner, id, ERR_OTHER, "Invalid hex");
+        miner.rejected++;
+        return;
+    }
+    if (share_diff < opt_difficulty) {
+        printf("❌ %s: low difficulty share %.6g < %.6g (job %s)\n", miner.address.c_str(), share_diff,
+               opt_difficulty, job_id.c_str());
+        send_error(miner, id, ERR_LOW_DIFF, "Low difficulty share");
+        miner.rejected++;
+        stat_low_diff++;
+        return;
+    }
+
+    valid_shares++;
+    if (opt_reject_every > 0 && valid_shares % opt_reject_every == 0) {
+        send_error(miner, id, ERR_OTHER, "Scripted reject");
+        miner.rejected++;
+        stat_scripted_rejects++;
+        return;
+    }
+
+    send_result(miner, id, "true");
+    miner.accepted++;
+    stat_accepted++;
+    printf("✅ %s: share accepted (diff %.6g, job %s)\n", miner.address.c_str(), share_diff, job_id.c_str());
+}
+
+static void handle_line(Miner& miner, const std::string& line) {
+    JsonValue msg;
+    if (!json_parse(line, msg) || msg.type != JsonValue::OBJECT) {
+        printf("⚠️  %s: invalid JSON\n", miner.address.c_str());
+        return;
+    }
+
+    std::string id = msg["id"].dump();
+    const std::string& method = msg["method"].asString();
+
+    if (method == "mining.subscribe") {
+        miner.extranonce1 = u32_hex(next_extranonce1++);
+        miner.subscribed = true;
+        char size_buf[8];
+        snprintf(size_buf, sizeof(size_buf), "%d", EMU_EXTRANONCE2_SIZE);
+        send_line(miner, "{\"id\":" + id + ",\"result\":[[[\"mining.set_difficulty\",\"1\"],"
+                         "[\"mining.notify\",\"1\"]]," + json_quote(miner.extranonce1) + "," + size_buf +
+                         "],\"error\":null}");
+    } else if (method == "mining.authorize") {
+        if (!miner.subscribed) {
+            send_error(miner, id, ERR_NOT_SUBSCRIBED, "Not subscribed");
+            return;
+        }
+        miner.authorized = true;
+        send_result(miner, id, "true");
+        printf("🔑 %s authorized as %s\n", miner.address.c_str(), msg["params"][0].asString().c_str());
+        send_line(miner, difficulty_line());
+        if (!jobs.empty()) {
+            send_line(miner, notify_line(jobs.back()));
+        }
+    } else if (method == "mining.submit") {
+        handle_submit(miner, id, msg["params"]);
+    } else if (!msg["id"].isNull()) {
+        send_error(miner, id, ERR_OTHER, "Unsupported method");
+    }
+}
+
+static void close_miner(int fd) {
+    auto it = miners.find(fd);
+    if (it == miners.end()) {
+        return;
+    }
+    printf("➖ %s disconnected (%u accepted, %u rejected, %u stale)\n", it->second.address.c_str(),
+           it->second.accepted, it->second.rejected, it->second.stale);
+    close(fd);
+    miners.erase(it);
+}
+
+static void print_stats(void) {
+    uint64_t rejected = stat_stale + stat_low_diff + stat_duplicate + stat_scripted_rejects;
+    uint64_t total = stat_accepted + rejected;
+    printf("┌──────────────── Emulator stats ────────────────┐\n");
+    printf("│ Miners: %-4zu Notifies: %-6llu Disconnects: %-5llu │\n", miners.size(),
+           (unsigned long long)stat_notifies, (unsigned long long)stat_disconnects);
+    printf("│ Accepted: %-6llu Stale: %-5llu LowDiff: %-5llu     │\n", (unsigned long long)stat_accepted,
+           (unsigned long long)stat_stale, (unsigned long long)stat_low_diff);
+    printf("│ Duplicate: %-5llu Scripted: %-5llu Reject: %5.1f%% │\n", (unsigned long long)stat_duplicate,
+           (unsigned long long)stat_scripted_rejects, total ? 100.0 * rejected / total : 0.0);
+    printf("│ Notify -> share avg: %-8llu ms               │\n",
+           (unsigned long long)(stat_share_latency_count ? stat_share_latency_total / stat_share_latency_count : 0));
+    printf("│ Bytes in: %-10llu Bytes out: %-10llu    │\n", (unsigned long long)stat_bytes_in,
+           (unsigned long long)stat_bytes_out);
+    printf("└────────────────────────────────────────────────┘\n");
+}
+
+static void usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -p <port>        listen port (default 3333)\n"
+            "  -d <difficulty>  share difficulty sent with set_difficulty (default 0.001)\n"
+            "  -n <seconds>     notify interval (default 30)\n"
+            "  -c <N>           every Nth notify is clean, others are non-clean (default 3)\n"
+            "  -x <seconds>     drop all miners every N seconds (default 0 = never)\n"
+            "  -r <N>           reject every Nth valid share (default 0 = never)\n"
+            "  -b <N>           merkle branch length (default 2)\n",
+            name);
+}
+
+static void on_signal(int) {
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "p:d:n:c:x:r:b:h")) != -1) {
+        switch (opt) {
+            case 'p': opt_port = (uint16_t)atoi(optarg); break;
+            case 'd': opt_difficulty = atof(optarg); break;
+            case 'n': opt_notify_interval_s = atoi(optarg); break;
+            case 'c': opt_clean_every = atoi(optarg); break;
+            case 'x': opt_disconnect_every_s = atoi(optarg); break;
+            case 'r': opt_reject_every = atoi(optarg); break;
+            case 'b': opt_branches = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (opt_difficulty <= 0 || opt_notify_interval_s <= 0 || opt_clean_every <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(opt_port);
+    if (bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, 128) < 0) {
+        fprintf(stderr, "❌ Cannot listen on port %u: %s\n", opt_port, strerror(errno));
+        return 1;
+    }
+    fcntl(listen_fd, F_SETFL, O_NONBLOCK);
+
+    printf("🏊 Pool emulator on :%u (difficulty %g, notify every %d s, clean every %d)\n", opt_port,
+           opt_difficulty, opt_notify_interval_s, opt_clean_every);
+
+    make_job(true);
+    uint64_t last_notify = now_ms();
+    uint64_t last_disconnect = now_ms();
+    uint64_t last_stats = now_ms();
+
+    while (running) {
+        uint64_t now = now_ms();
+
+        // Scripted events
+        if (now - last_notify >= (uint64_t)opt_notify_interval_s * 1000) {
+            last_notify = now;
+            make_job(stat_notifies % opt_clean_every == (uint64_t)(opt_clean_every - 1));
+            broadcast_job();
+        }
+        if (opt_disconnect_every_s > 0 && now - last_disconnect >= (uint64_t)opt_disconnect_every_s * 1000) {
+            last_disconnect = now;
+            if (!miners.empty()) {
+                printf("✂️  Scripted disconnect of %zu miners\n", miners.size());
+                stat_disconnects++;
+                while (!miners.empty()) {
+                    close_miner(miners.begin()->first);
+                }
+            }
+        }
+        if (now - last_stats >= EMU_STATS_INTERVAL_MS) {
+            last_stats = now;
+            print_stats();
+        }
+
+        std::vector<struct pollfd> fds;
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (auto& entry : miners) {
+            fds.push_back({entry.first, (short)(POLLIN | (entry.second.outbuf.empty() ? 0 : POLLOUT)), 0});
+        }
+        if (poll(fds.data(), fds.size(), 200) < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+
+        for (size_t i = 0; i < fds.size(); i++) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            if (fds[i].fd == listen_fd) {
+                struct sockaddr_in peer;
+                socklen_t len = sizeof(peer);
+                int fd;
+                while ((fd = accept(listen_fd, (struct sockaddr*)&peer, &len)) >= 0) {
+                    fcntl(fd, F_SETFL, O_NONBLOCK);
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    Miner& miner = miners[fd];
+                    miner.fd = fd;
+                    char buf[32];
+                    snprintf(buf, sizeof(buf), "%s:%u", inet_ntoa(peer.sin_addr), ntohs(peer.sin_port));
+                    miner.address = buf;
+                    miner.connected_ms = now_ms();
+                    printf("➕ %s connected\n", buf);
+                    len = sizeof(peer);
+                }
+                continue;
+            }
+
+            auto it = miners.find(fds[i].fd);
+            if (it == miners.end()) {
+                continue;
+            }
+            Miner& miner = it->second;
+            bool ok = true;
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                char chunk[4096];
+                ssize_t n = recv(miner.fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    ok = n < 0 && (errno == EAGAIN || errno == EINTR);
+                } else {
+                    stat_bytes_in += n;
+                    miner.inbuf.append(chunk, n);
+                    size_t nl;
+                    while ((nl = miner.inbuf.find('\n')) != std::string::npos) {
+                        std::string line = miner.inbuf.substr(0, nl);
+                        miner.inbuf.erase(0, nl + 1);
+                        if (!line.empty() && line.back() == '\r') {
+                            line.pop_back();
+                        }
+                        if (!line.empty()) {
+                            handle_line(miner, line);
+                        }
+                    }
+                }
+            }
+            if (!ok) {
+                close_miner(fds[i].fd);
+            }
+        }
+
+        // Flush replies and notifies
+        std::vector<int> dead;
+        for (auto& entry : miners) {
+            Miner& miner = entry.second;
+            while (!miner.outbuf.empty()) {
+                ssize_t n = send(miner.fd, miner.outbuf.data(), miner.outbuf.size(), MSG_NOSIGNAL);
+                if (n > 0) {
+                    stat_bytes_out += n;
+                    miner.outbuf.erase(0, n);
+                } else {
+                    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                        dead.push_back(entry.first);
+                    }
+                    break;
+                }
+            }
+        }
+        for (int fd : dead) {
+            close_miner(fd);
+        }
+    }
+
+    print_stats();
+    while (!miners.empty()) {
+        close_miner(miners.begin()->first);
+    }
+    close(listen_fd);
+    return 0;
+}
@@ -0,0 +1,595 @@
+// Stratum V1 against Stratum V2 through the device's own clients.
+//
+// Compiles src/stratum_client.cpp and src/stratum_v2_client.cpp as they are,
+// against the shim in shim/, and plays the same pool script to both over
+// loopback: the same jobs, built the way pool_emulator builds them, and the
+// same shares, each answered as accepted. A V2 pool sends each job on a
+// standard channel as the merkle root of that same coinbase and branch,
+// and a new block as a future job plus SetNewPrevHash.
+//
+// For every job of the sequence it prints, side by side for V1 and V2:
+//   - bytes received (the job's messages and the share answers)
+//   - bytes sent (the shares)
+//   - parse time, from the client's own counter (PoolClient::getParseTimeUs),
+//     averaged over the rounds (host CPU time, not the ESP32's).
+// The connection setup (subscribe/authorize, SetupConnection/OpenChannel)
+// is shown on its own line. Every job must reach both clients unchanged and
+// every share must be answered, or the tool exits non-zero.
+//
+// Build: see README.md
+// Usage: protocol_bench [-n jobs] [-b branches] [-c clean_every] [-s shares] [-r rounds]
+
+#include "../common/mini_json.h"
+#include "../common/sha256.h"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "stratum_client.h"
+#include "stratum_v2_client.h"
+
+#define SV2_HEADER_SIZE     6
+#define SV2_CHANNEL_MSG_BIT 0x8000
+
+#define SV2_SETUP_CONNECTION_SUCCESS          0x01
+#define SV2_OPEN_STANDARD_MINING_CHANNEL_OK   0x11
+#define SV2_NEW_MINING_JOB                    0x15
+#define SV2_SUBMIT_SHARES_SUCCESS             0x1c
+#define SV2_SET_NEW_PREV_HASH                 0x20
+
+#define EXTRANONCE1 "2a000001"
+#define EXTRANONCE2_SIZE 4
+#define PUMP_TIMEOUT_MS 2000
+
+typedef std::vector<uint8_t> Bytes;
+
+static int opt_jobs = 10;
+static int opt_branches = 12;
+static int opt_clean_every = 3;
+static int opt_shares = 2;
+static int opt_rounds = 200;
+
+// One job of the script, in both encodings
+struct BenchJob {
+    std::string id;                 // V1 job id
+    uint32_t v2_id;
+    std::string prev_hash;          // V1: 8 words with their bytes swapped
+    uint8_t prev_hash_raw[32];      // V2: header byte order
+    std::string coinb1;
+    std::string coinb2;
+    std::vector<std::string> branch;
+    uint32_t version;
+    uint32_t nbits;
+    uint32_t ntime;
+    bool clean;
+    uint8_t merkle_root[32];        // What a V2 pool sends for the same coinbase and branch
+};
+
+// Totals of one job (or of the setup) for one protocol
+struct Cost {
+    uint32_t bytes_in = 0;
+    uint32_t bytes_out = 0;
+    uint64_t parse_us = 0;
+};
+
+static std::mt19937 rng(42);
+
+// ---------------------------------------------------------------------------
+// Script
+// ---------------------------------------------------------------------------
+
+static std::string random_hex(int bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (int i = 0; i < bytes * 2; i++) {
+        out += digits[rng() & 15];
+    }
+    return out;
+}
+
+static void hex_to_bytes(const std::string& hex, Bytes& out) {
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back((uint8_t)strtoul(hex.substr(i, 2).c_str(), NULL, 16));
+    }
+}
+
+static std::string u32_hex(uint32_t v) {
+    char buf[9];
+    snprintf(buf, sizeof(buf), "%08x", v);
+    return buf;
+}
+
+static std::vector<BenchJob> make_jobs(void) {
+    std::vector<BenchJob> jobs;
+    std::string prev_hash;
+    uint32_t height = 840000;
+    for (int n = 0; n < opt_jobs; n++) {
+        BenchJob job;
+        job.clean = n % opt_clean_every == 0;
+        if (job.clean) {
+            prev_hash = random_hex(32);
+            height++;
+        }
+        char id_buf[16];
+        snprintf(id_buf, sizeof(id_buf), "%x", n + 1);
+        job.id = id_buf;
+        job.v2_id = n + 1;
+        job.prev_hash = prev_hash;
+        Bytes prev;
+        hex_to_bytes(prev_hash, prev);
+        for (int word = 0; word < 8; word++) {
+            for (int i = 0; i < 4; i++) {
+                job.prev_hash_raw[word * 4 + i] = prev[word * 4 + 3 - i];
+            }
+        }
+
+        // Same coinbase layout as pool_emulator: BIP34 height, extranonce1 + extranonce2, one P2PKH output
+        char b[3];
+        std::string height_le;
+        for (int i = 0; i < 3; i++) {
+            snprintf(b, sizeof(b), "%02x", (height >> (i * 8)) & 0xFF);
+            height_le += b;
+        }
+        snprintf(b, sizeof(b), "%02x", 1 + 3 + 4 + EXTRANONCE2_SIZE);
+        job.coinb1 = "01000000" "01" + std::string(64, '0') + "ffffffff" + b + "03" + height_le;
+        job.coinb2 = "ffffffff" "01" "40be402500000000" "19" "76a914" + random_hex(20) + "88ac" "00000000";
+        for (int i = 0; i < opt_branches; i++) {
+            job.branch.push_back(random_hex(32));
+        }
+        job.version = 0x20000000;
+        job.nbits = 0x1705ae3a;
+        job.ntime = 0x66000000 + n;
+
+        // Merkle root with extranonce2 = 0, as the pool fixes it for a standard channel
+        Bytes coinbase;
+        hex_to_bytes(job.coinb1 + EXTRANONCE1 + std::string(EXTRANONCE2_SIZE * 2, '0') + job.coinb2, coinbase);
+        sha256d(coinbase.data(), coinbase.size(), job.merkle_root);
+        for (const std::string& branch_hex : job.branch) {
+            Bytes node(job.merkle_root, job.merkle_root + 32);
+            hex_to_bytes(branch_hex, node);
+            sha256d(node.data(), node.size(), job.merkle_root);
+        }
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+static std::string notify_line(const BenchJob& job) {
+    std::string branch = "[";
+    for (size_t i = 0; i < job.branch.size(); i++) {
+        if (i > 0) branch += ",";
+        branch += json_quote(job.branch[i]);
+    }
+    branch += "]";
+    return "{\"id\":null,\"method\":\"mining.notify\",\"params\":[" + json_quote(job.id) + "," +
+           json_quote(job.prev_hash) + "," + json_quote(job.coinb1) + "," + json_quote(job.coinb2) + "," +
+           branch + "," + json_quote(u32_hex(job.version)) + "," + json_quote(u32_hex(job.nbits)) + "," +
+           json_quote(u32_hex(job.ntime)) + "," + (job.clean ? "true" : "false") + "]}\n";
+}
+
+static void put_u16(Bytes& b, uint16_t v) { b.push_back(v & 0xFF); b.push_back(v >> 8); }
+static void put_u32(Bytes& b, uint32_t v) { for (int i = 0; i < 4; i++) b.push_back((v >> (i * 8)) & 0xFF); }
+static void put_bytes(Bytes& b, const uint8_t* p, size_t n) { b.insert(b.end(), p, p + n); }
+static uint32_t get_u32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+static Bytes frame(uint16_t extension_type, uint8_t msg_type, const Bytes& payload) {
+    Bytes out;
+    put_u16(out, extension_type);
+    out.push_back(msg_type);
+    out.push_back(payload.size() & 0xFF);
+    out.push_back((payload.size() >> 8) & 0xFF);
+    out.push_back((payload.size() >> 16) & 0xFF);
+    put_bytes(out, payload.data(), payload.size());
+    return out;
+}
+
+// Clean job: future NewMiningJob + SetNewPrevHash. Otherwise an immediate NewMiningJob.
+static Bytes job_frames(const BenchJob& job) {
+    Bytes p;
+    put_u32(p, 1);                  // channel_id
+    put_u32(p, job.v2_id);
+    if (job.clean) {
+        p.push_back(0);
+    } else {
+        p.push_back(1);
+        put_u32(p, job.ntime);
+    }
+    put_u32(p, job.version);
+    put_bytes(p, job.merkle_root, 32);
+    Bytes out = frame(SV2_CHANNEL_MSG_BIT, SV2_NEW_MINING_JOB, p);
+    if (job.clean) {
+        Bytes q;
+        put_u32(q, 1);
+        put_u32(q, job.v2_id);
+        put_bytes(q, job.prev_hash_raw, 32);
+        put_u32(q, job.ntime);
+        put_u32(q, job.nbits);
+        Bytes prev = frame(SV2_CHANNEL_MSG_BIT, SV2_SET_NEW_PREV_HASH, q);
+        out.insert(out.end(), prev.begin(), prev.end());
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Pool side of the loopback connection
+// ---------------------------------------------------------------------------
+
+static int listen_fd = -1;
+static uint16_t listen_port = 0;
+
+static bool open_listener(void) {
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (listen_fd < 0 || bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, 4) < 0 ||
+        getsockname(listen_fd, (struct sockaddr*)&addr, &len) < 0) {
+        return false;
+    }
+    listen_port = ntohs(addr.sin_port);
+    return true;
+}
+
+// The pool answers at once, like pool_emulator
+static int accept_client(void) {
+    int fd = accept(listen_fd, NULL, NULL);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+static bool send_all(int fd, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    while (len > 0) {
+        ssize_t n = ::send(fd, p, len, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+static bool recv_exact(int fd, uint8_t* out, size_t len) {
+    while (len > 0) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, PUMP_TIMEOUT_MS) != 1) {
+            return false;
+        }
+        ssize_t n = ::recv(fd, out, len, 0);
+        if (n <= 0) {
+            return false;
+        }
+        out += n;
+        len -= n;
+    }
+    return true;
+}
+
+static bool recv_line(int fd, std::string& line) {
+    line.clear();
+    uint8_t c;
+    while (recv_exact(fd, &c, 1)) {
+        if (c == '\n') {
+            return true;
+        }
+        line += (char)c;
+    }
+    return false;
+}
+
+static bool recv_frame(int fd, uint8_t& msg_type, Bytes& payload) {
+    uint8_t header[SV2_HEADER_SIZE];
+    if (!recv_exact(fd, header, sizeof(header))) {
+        return false;
+    }
+    msg_type = header[2];
+    payload.resize(header[3] | (header[4] << 8) | (header[5] << 16));
+    return payload.empty() || recv_exact(fd, payload.data(), payload.size());
+}
+
+// ---------------------------------------------------------------------------
+// Device side
+// ---------------------------------------------------------------------------
+
+struct Received {
+    stratum_job_t job;
+    uint32_t jobs = 0;
+};
+
+static void on_job(stratum_job_t* job, void* arg) {
+    Received* received = (Received*)arg;
+    received->job = *job;
+    received->jobs++;
+}
+
+// Run the client's loop until done() or the timeout
+template <typename Done>
+static bool pump(PoolClient& client, Done done) {
+    unsigned long start = millis();
+    while (!done()) {
+        client.loop();
+        if (millis() - start > PUMP_TIMEOUT_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static Cost snapshot(const PoolClient& client) {
+    Cost cost;
+    cost.bytes_in = client.getBytesReceived();
+    cost.bytes_out = client.getBytesSent();
+    cost.parse_us = client.getParseTimeUs();
+    return cost;
+}
+
+static void add_delta(Cost& total, const Cost& before, const PoolClient& client) {
+    Cost after = snapshot(client);
+    total.bytes_in += after.bytes_in - before.bytes_in;
+    total.bytes_out += after.bytes_out - before.bytes_out;
+    total.parse_us += after.parse_us - before.parse_us;
+}
+
+static bool same_job_v1(const stratum_job_t& got, const BenchJob& job) {
+    if (got.job_id != job.id.c_str() || got.prev_hash != job.prev_hash.c_str() || got.coinb1 != job.coinb1.c_str() ||
+        got.coinb2 != job.coinb2.c_str() || got.merkle_branch.size() != job.branch.size() ||
+        got.clean_jobs != job.clean || got.extranonce1 != EXTRANONCE1) {
+        return false;
+    }
+    for (size_t i = 0; i < job.branch.size(); i++) {
+        if (got.merkle_branch[i] != job.branch[i].c_str()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool same_job_v2(const stratum_job_t& got, const BenchJob& job) {
+    return got.has_merkle_root && memcmp(got.merkle_root, job.merkle_root, 32) == 0 &&
+           memcmp(got.prev_hash_raw, job.prev_hash_raw, 32) == 0 && got.clean_jobs == job.clean &&
+           got.ntime == u32_hex(job.ntime).c_str() && got.version == u32_hex(job.version).c_str();
+}
+
+// Share n of a job: the same values on both protocols
+static void share_values(int n, char* extranonce2, char* nonce) {
+    snprintf(extranonce2, 9, "%08x", n);
+    snprintf(nonce, 9, "%08x", 0x1000 + n * 7919);
+}
+
+static bool run_v1(const std::vector<BenchJob>& jobs, Cost& setup, std::vector<Cost>& costs) {
+    StratumClient client;
+    Received received;
+    client.setJobCallback(on_job, &received);
+    client.init("127.0.0.1", listen_port, "bench", "v1");
+    if (!client.connect()) {
+        return false;
+    }
+    int fd = accept_client();
+    std::string line;
+    JsonValue msg;
+
+    // mining.subscribe, mining.authorize and the difficulty
+    if (!recv_line(fd, line) || !json_parse(line, msg)) {
+        return false;
+    }
+    std::string reply = "{\"id\":" + msg["id"].dump() +
+                        ",\"result\":[[[\"mining.set_difficulty\",\"1\"],[\"mining.notify\",\"1\"]],\"" EXTRANONCE1
+                        "\",4],\"error\":null}\n";
+    send_all(fd, reply.data(), reply.size());
+    if (!pump(client, [&] { return client.getBytesSent() > line.size() + 1; }) || !recv_line(fd, line) ||
+        !json_parse(line, msg)) {
+        return false;
+    }
+    reply = "{\"id\":" + msg["id"].dump() + ",\"result\":true,\"error\":null}\n"
+            "{\"id\":null,\"method\":\"mining.set_difficulty\",\"params\":[512]}\n";
+    send_all(fd, reply.data(), reply.size());
+    if (!pump(client, [&] { return client.getDifficulty() != 0; })) {
+        return false;
+    }
+    setup = snapshot(client);
+
+    bool ok = true;
+    for (int round = 0; round < opt_rounds && ok; round++) {
+        for (size_t j = 0; j < jobs.size() && ok; j++) {
+            Cost before = snapshot(client);
+            uint32_t expected = received.jobs + 1;
+            std::string notify = notify_line(jobs[j]);
+            send_all(fd, notify.data(), notify.size());
+            ok = pump(client, [&] { return received.jobs == expected; }) && same_job_v1(received.job, jobs[j]);
+
+            for (int s = 0; s < opt_shares && ok; s++) {
+                char extranonce2[9], nonce[9];
+                share_values(s, extranonce2, nonce);
+                uint32_t answered = client.getSharesAccepted() + 1;
+                ok = client.submitShare(received.job.job_id.c_str(), extranonce2, received.job.ntime.c_str(), nonce) &&
+                     recv_line(fd, line) && json_parse(line, msg);
+                if (ok) {
+                    reply = "{\"id\":" + msg["id"].dump() + ",\"result\":true,\"error\":null}\n";
+                    send_all(fd, reply.data(), reply.size());
+                    ok = pump(client, [&] { return client.getSharesAccepted() == answered; });
+                }
+            }
+            add_delta(costs[j], before, client);
+        }
+    }
+    client.disconnect();
+    close(fd);
+    return ok;
+}
+
+static bool run_v2(const std::vector<BenchJob>& jobs, Cost& setup, std::vector<Cost>& costs) {
+    StratumV2Client client;
+    Received received;
+    client.setJobCallback(on_job, &received);
+    client.init("127.0.0.1", listen_port, "bench", "v2");
+    if (!client.connect()) {
+        return false;
+    }
+    int fd = accept_client();
+    uint8_t msg_type;
+    Bytes payload;
+
+    // SetupConnection and OpenStandardMiningChannel
+    if (!recv_frame(fd, msg_type, payload)) {
+        return false;
+    }
+    Bytes p;
+    put_u16(p, 2);
+    put_u32(p, 0);
+    Bytes out = frame(0, SV2_SETUP_CONNECTION_SUCCESS, p);
+    send_all(fd, out.data(), out.size());
+    uint32_t sent = client.getBytesSent();
+    if (!pump(client, [&] { return client.getBytesSent() > sent; }) || !recv_frame(fd, msg_type, payload) ||
+        payload.size() < 4) {
+        return false;
+    }
+    p.clear();
+    put_u32(p, get_u32(payload.data()));    // request_id
+    put_u32(p, 1);                          // channel_id
+    uint8_t target[32];
+    memset(target, 0, sizeof(target));
+    target[26] = 0x7f;                      // About difficulty 512
+    put_bytes(p, target, 32);
+    p.push_back(4);
+    hex_to_bytes(EXTRANONCE1, p);
+    put_u32(p, 0);
+    out = frame(0, SV2_OPEN_STANDARD_MINING_CHANNEL_OK, p);
+    send_all(fd, out.data(), out.size());
+    if (!pump(client, [&] { return client.getDifficulty() != 0; })) {
+        return false;
+    }
+    setup = snapshot(client);
+
+    bool ok = true;
+    for (int round = 0; round < opt_rounds && ok; round++) {
+        for (size_t j = 0; j < jobs.size() && ok; j++) {
+            Cost before = snapshot(client);
+            uint32_t expected = received.jobs + 1;
+            out = job_frames(jobs[j]);
+            send_all(fd, out.data(), out.size());
+            ok = pump(client, [&] { return received.jobs == expected; }) && same_job_v2(received.job, jobs[j]);
+
+            for (int s = 0; s < opt_shares && ok; s++) {
+                char extranonce2[9], nonce[9];
+                share_values(s, extranonce2, nonce);
+                uint32_t answered = client.getSharesAccepted() + 1;
+                ok = client.submitShare(received.job.job_id.c_str(), extranonce2, received.job.ntime.c_str(), nonce) &&
+                     recv_frame(fd, msg_type, payload) && payload.size() >= 8;
+                if (ok) {
+                    // channel_id, last_sequence_number, new_submits_accepted_count, new_shares_sum
+                    p.clear();
+                    put_u32(p, 1);
+                    put_u32(p, get_u32(payload.data() + 4));
+                    put_u32(p, 1);
+                    put_u32(p, 512);
+                    put_u32(p, 0);
+                    out = frame(SV2_CHANNEL_MSG_BIT, SV2_SUBMIT_SHARES_SUCCESS, p);
+                    send_all(fd, out.data(), out.size());
+                    ok = pump(client, [&] { return client.getSharesAccepted() == answered; });
+                }
+            }
+            add_delta(costs[j], before, client);
+        }
+    }
+    client.disconnect();
+    close(fd);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Main
+// ---------------------------------------------------------------------------
+
+static void usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -n <jobs>     jobs in the sequence (default 10)\n"
+            "  -b <N>        merkle branch length (default 12)\n"
+            "  -c <N>        every Nth job is clean, a new block (default 3)\n"
+            "  -s <N>        shares submitted per job (default 2)\n"
+            "  -r <rounds>   times the sequence is played, for the parse times (default 200)\n",
+            name);
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "n:b:c:s:r:")) != -1) {
+        switch (opt) {
+            case 'n': opt_jobs = atoi(optarg); break;
+            case 'b': opt_branches = atoi(optarg); break;
+            case 'c': opt_clean_every = atoi(optarg); break;
+            case 's': opt_shares = atoi(optarg); break;
+            case 'r': opt_rounds = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (opt_jobs <= 0 || opt_branches < 0 || opt_branches > 16 || opt_clean_every <= 0 || opt_shares < 0 ||
+        opt_rounds <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!open_listener()) {
+        perror("listen");
+        return 1;
+    }
+
+    std::vector<BenchJob> jobs = make_jobs();
+    Cost v1_setup, v2_setup;
+    std::vector<Cost> v1(jobs.size()), v2(jobs.size());
+    if (!run_v1(jobs, v1_setup, v1)) {
+        fprintf(stderr, "❌ Stratum V1: a job or a share answer did not arrive unchanged\n");
+        return 1;
+    }
+    if (!run_v2(jobs, v2_setup, v2)) {
+        fprintf(stderr, "❌ Stratum V2: a job or a share answer did not arrive unchanged\n");
+        return 1;
+    }
+
+    printf("%d jobs (%d-deep branch, every %d clean), %d shares per job, %d rounds\n", opt_jobs, opt_branches,
+           opt_clean_every, opt_shares, opt_rounds);
+    printf("┌──────────────┬─────────────────────────┬─────────────────────────┐\n");
+    printf("│              │  V1 bytes in/out  parse │  V2 bytes in/out  parse │\n");
+    printf("├──────────────┼─────────────────────────┼─────────────────────────┤\n");
+    printf("│ setup        │  %6u %5u %6u µs │  %6u %5u %6u µs │\n", v1_setup.bytes_in, v1_setup.bytes_out,
+           (unsigned)v1_setup.parse_us, v2_setup.bytes_in, v2_setup.bytes_out, (unsigned)v2_setup.parse_us);
+    Cost v1_total, v2_total;
+    for (size_t j = 0; j < jobs.size(); j++) {
+        printf("│ job %2zu %-5s │  %6u %5u %6.2f µs │  %6u %5u %6.2f µs │\n", j + 1, jobs[j].clean ? "clean" : "",
+               v1[j].bytes_in / opt_rounds, v1[j].bytes_out / opt_rounds, (double)v1[j].parse_us / opt_rounds,
+               v2[j].bytes_in / opt_rounds, v2[j].bytes_out / opt_rounds, (double)v2[j].parse_us / opt_rounds);
+        v1_total.bytes_in += v1[j].bytes_in;
+        v1_total.bytes_out += v1[j].bytes_out;
+        v1_total.parse_us += v1[j].parse_us;
+        v2_total.bytes_in += v2[j].bytes_in;
+        v2_total.bytes_out += v2[j].bytes_out;
+        v2_total.parse_us += v2[j].parse_us;
+    }
+    double per_job = (double)opt_rounds * jobs.size();
+    printf("├──────────────┼─────────────────────────┼─────────────────────────┤\n");
+    printf("│ per job      │  %6.0f %5.0f %6.2f µs │  %6.0f %5.0f %6.2f µs │\n", v1_total.bytes_in / per_job,
+           v1_total.bytes_out / per_job, v1_total.parse_us / per_job, v2_total.bytes_in / per_job,
+           v2_total.bytes_out / per_job, v2_total.parse_us / per_job);
+    printf("└──────────────┴─────────────────────────┴─────────────────────────┘\n");
+    printf("V2/V1: %.0f %% of the bytes received, %.0f %% of the bytes sent, %.0f %% of the parse time\n",
+           100.0 * v2_total.bytes_in / v1_total.bytes_in, 100.0 * v2_total.bytes_out / std::max(1u, v1_total.bytes_out),
+           100.0 * v2_total.parse_us / std::max<uint64_t>(1, v1_total.parse_us));
+    close(listen_fd);
+    return 0;
+}
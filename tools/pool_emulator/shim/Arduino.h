@@ -0,0 +1,189 @@
+// Just enough of Arduino.h to compile the device's pool mining code
+// (src/mining_task.cpp, the Stratum clients, src/pool_manager.cpp), the
+// Duino-Coin client (tools/duco_emulator) and the Bitcoin RPC client
+// (tools/rpc_bench) on the host. The clock, the random numbers and Serial are
+// in board.cpp. Serial output goes to stdout only when Serial.echo is set,
+// and to Serial.tap when the tool wants to read it.
+//
+// The tools build against the real ArduinoJson from PlatformIO's libdeps (see
+// the READMEs), with Arduino String and Print support like on the board.
+#pragma once
+
+#ifndef ARDUINOJSON_ENABLE_ARDUINO_STRING
+#define ARDUINOJSON_ENABLE_ARDUINO_STRING 1
+#endif
+#ifndef ARDUINOJSON_ENABLE_ARDUINO_PRINT
+#define ARDUINOJSON_ENABLE_ARDUINO_PRINT 1
+#endif
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+class String {
+public:
+    String(const char* s = "") : s_(s ? s : "") {}
+    String(const std::string& s) : s_(s) {}
+    String(char c) : s_(1, c) {}
+    String(int v) : s_(std::to_string(v)) {}
+    String(unsigned int v) : s_(std::to_string(v)) {}
+    String(long v) : s_(std::to_string(v)) {}
+    String(unsigned long v) : s_(std::to_string(v)) {}
+
+    const char* c_str() const { return s_.c_str(); }
+    unsigned int length() const { return (unsigned int)s_.size(); }
+    void reserve(unsigned int size) { s_.reserve(size); }
+    bool concat(const char* s) {
+        if (!s) {
+            return false;
+        }
+        s_ += s;
+        return true;
+    }
+
+    bool startsWith(const String& prefix) const { return s_.compare(0, prefix.s_.size(), prefix.s_) == 0; }
+    int indexOf(char c, unsigned int from = 0) const { return found(s_.find(c, from)); }
+    int lastIndexOf(char c) const { return found(s_.rfind(c)); }
+    String substring(unsigned int from) const { return from < s_.size() ? s_.substr(from) : std::string(); }
+    String substring(unsigned int from, unsigned int to) const {
+        return from < s_.size() && to > from ? s_.substr(from, to - from) : std::string();
+    }
+    long toInt() const { return strtol(s_.c_str(), NULL, 10); }
+    void trim() {
+        size_t start = s_.find_first_not_of(" \t\r\n");
+        size_t end = s_.find_last_not_of(" \t\r\n");
+        s_ = start == std::string::npos ? std::string() : s_.substr(start, end - start + 1);
+    }
+
+    String& operator+=(const String& other) { s_ += other.s_; return *this; }
+    String& operator+=(const char* other) { s_ += other; return *this; }
+    String& operator+=(char c) { s_ += c; return *this; }
+    friend String operator+(const String& a, const String& b) { return a.s_ + b.s_; }
+    friend String operator+(const String& a, const char* b) { return a.s_ + b; }
+    friend String operator+(const char* a, const String& b) { return a + b.s_; }
+    bool operator==(const String& other) const { return s_ == other.s_; }
+    bool operator==(const char* other) const { return s_ == other; }
+    bool operator!=(const String& other) const { return s_ != other.s_; }
+
+private:
+    static int found(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+
+    std::string s_;
+};
+
+// What String + String returns on Arduino; ArduinoJson adapts it like String
+class StringSumHelper : public String {
+public:
+    using String::String;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size) {
+        size_t n = 0;
+        while (n < size && write(buf[n])) {
+            n++;
+        }
+        return n;
+    }
+
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t println(const char* s = "") { return print(s) + print("\r\n"); }
+    size_t println(const String& s) { return println(s.c_str()); }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[512];
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        if (n < 0) {
+            return 0;
+        }
+        return write((const uint8_t*)buf, (size_t)n < sizeof(buf) ? n : sizeof(buf) - 1);
+    }
+
+    virtual void flush() {}
+};
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+long random(long min, long max);
+uint32_t esp_random();
+
+// PSRAM is plain heap here
+bool psramFound();
+void* ps_malloc(size_t size);
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long ms) { timeout_ms = ms; }
+
+    // Like Arduino: up to length bytes, giving up after the timeout
+    virtual size_t readBytes(char* buffer, size_t length) {
+        size_t n = 0;
+        unsigned long start = millis();
+        while (n < length && millis() - start < timeout_ms) {
+            if (available() <= 0) {
+                delay(1);
+                continue;
+            }
+            int c = read();
+            if (c < 0) {
+                break;
+            }
+            buffer[n++] = (char)c;
+            start = millis();
+        }
+        return n;
+    }
+
+    // Like Arduino: gives up after the timeout and returns what it has
+    String readStringUntil(char terminator) {
+        std::string line;
+        unsigned long start = millis();
+        while (millis() - start < timeout_ms) {
+            if (available() <= 0) {
+                delay(1);
+                continue;
+            }
+            int c = read();
+            if (c < 0 || c == terminator) {
+                break;
+            }
+            line += (char)c;
+            start = millis();
+        }
+        return line;
+    }
+
+protected:
+    unsigned long timeout_ms = 1000;
+};
+
+class HardwareSerial : public Print {
+public:
+    bool echo = false;
+    void (*tap)(const char* text, size_t len) = nullptr;   // One call per print/printf
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) override {
+        if (tap) {
+            tap((const char*)buf, size);
+        }
+        return echo ? fwrite(buf, 1, size, stdout) : size;
+    }
+};
+extern HardwareSerial Serial;
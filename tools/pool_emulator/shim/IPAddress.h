@@ -0,0 +1,34 @@
+// IPv4 address as the device code uses it: parsed, printed and compared
+#pragma once
+
+#include <Arduino.h>
+
+#include <arpa/inet.h>
+
+class IPAddress {
+public:
+    IPAddress() : addr_(0) {}
+
+    bool fromString(const char* s) {
+        struct in_addr in;
+        if (!s || inet_pton(AF_INET, s, &in) != 1) {
+            return false;
+        }
+        addr_ = in.s_addr;
+        return true;
+    }
+
+    String toString() const {
+        char buf[INET_ADDRSTRLEN];
+        struct in_addr in;
+        in.s_addr = addr_;
+        inet_ntop(AF_INET, &in, buf, sizeof(buf));
+        return String(buf);
+    }
+
+    uint32_t raw() const { return addr_; }
+    void setRaw(uint32_t addr) { addr_ = addr; }
+
+private:
+    uint32_t addr_;                    // Network byte order
+};
@@ -0,0 +1,201 @@
+// Just enough of WiFi.h for the device's pool code on the host: a
+// WiFiClient over a POSIX socket and a WiFi that is always connected and
+// resolves names with getaddrinfo().
+#pragma once
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+
+class WiFiClient : public Stream {
+public:
+    WiFiClient() {}
+    virtual ~WiFiClient() { close_fd(); }
+    WiFiClient(const WiFiClient&) = delete;
+    WiFiClient& operator=(const WiFiClient&) = delete;
+
+    virtual int connect(IPAddress ip, uint16_t port) { return connect(ip, port, 3000); }
+
+    virtual int connect(IPAddress ip, uint16_t port, int32_t timeout) {
+        stop();
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return 0;
+        }
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = ip.raw();
+
+        // Non-blocking connect, to honour the timeout
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        if (::connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            struct pollfd pfd = {fd, POLLOUT, 0};
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (errno != EINPROGRESS || poll(&pfd, 1, timeout) != 1 ||
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0) {
+                ::close(fd);
+                return 0;
+            }
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fd_ = fd;
+        return 1;
+    }
+
+    virtual int connect(const char* host, uint16_t port) { return connect(host, port, 3000); }
+
+    virtual int connect(const char* host, uint16_t port, int32_t timeout) {
+        IPAddress ip;
+        if (!ip.fromString(host) && !resolve(host, ip)) {
+            return 0;
+        }
+        return connect(ip, port, timeout);
+    }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+
+    size_t write(const uint8_t* buf, size_t size) override {
+        size_t sent = 0;
+        while (fd_ >= 0 && sent < size) {
+            ssize_t n = ::send(fd_, buf + sent, size - sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                sent += n;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                struct pollfd pfd = {fd_, POLLOUT, 0};
+                poll(&pfd, 1, 100);
+            } else {
+                close_fd();
+            }
+        }
+        return sent;
+    }
+
+    int available() override {
+        fill();
+        return (int)(rx_len_ - rx_pos_);
+    }
+
+    int read() override {
+        uint8_t c;
+        return read(&c, 1) == 1 ? c : -1;
+    }
+
+    virtual int read(uint8_t* buf, size_t size) {
+        if (available() <= 0) {
+            return -1;
+        }
+        size_t n = rx_len_ - rx_pos_;
+        if (n > size) {
+            n = size;
+        }
+        memcpy(buf, rx_buf_ + rx_pos_, n);
+        rx_pos_ += n;
+        return (int)n;
+    }
+
+    int peek() override { return available() > 0 ? rx_buf_[rx_pos_] : -1; }
+
+    // Whole blocks from the receive buffer, not a byte at a time
+    size_t readBytes(char* buffer, size_t length) override {
+        size_t n = 0;
+        unsigned long start = millis();
+        while (n < length && millis() - start < timeout_ms) {
+            int got = read((uint8_t*)buffer + n, length - n);
+            if (got > 0) {
+                n += got;
+                start = millis();
+            } else if (!connected()) {
+                break;
+            } else {
+                delay(1);
+            }
+        }
+        return n;
+    }
+
+    void flush() override {}
+
+    virtual void stop() {
+        close_fd();
+        rx_pos_ = rx_len_ = 0;
+    }
+
+    // Like the ESP32 client: still "connected" while received data is unread
+    virtual uint8_t connected() {
+        fill();
+        return fd_ >= 0 || rx_pos_ < rx_len_;
+    }
+
+    static bool resolve(const char* host, IPAddress& ip) {
+        struct addrinfo hints;
+        struct addrinfo* res = NULL;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(host, NULL, &hints, &res) != 0 || !res) {
+            return false;
+        }
+        ip.setRaw(((struct sockaddr_in*)res->ai_addr)->sin_addr.s_addr);
+        freeaddrinfo(res);
+        return true;
+    }
+
+private:
+    // Pull whatever the socket has without blocking
+    void fill() {
+        if (fd_ < 0) {
+            return;
+        }
+        if (rx_pos_ == rx_len_) {
+            rx_pos_ = rx_len_ = 0;
+        }
+        if (rx_len_ == sizeof(rx_buf_)) {
+            return;
+        }
+        ssize_t n = ::recv(fd_, rx_buf_ + rx_len_, sizeof(rx_buf_) - rx_len_, MSG_DONTWAIT);
+        if (n > 0) {
+            rx_len_ += n;
+        } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            close_fd();
+        }
+    }
+
+    void close_fd() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    int fd_ = -1;
+    uint8_t rx_buf_[4096];
+    size_t rx_pos_ = 0;
+    size_t rx_len_ = 0;
+};
+
+class WiFiClass {
+public:
+    wl_status_t status() { return WL_CONNECTED; }
+    int hostByName(const char* host, IPAddress& ip) { return WiFiClient::resolve(host, ip); }
+    IPAddress localIP() {
+        IPAddress ip;
+        ip.fromString("127.0.0.1");
+        return ip;
+    }
+};
+extern WiFiClass WiFi;
@@ -0,0 +1,76 @@
+// Stand-ins for the board shared by the host tools built on this shim:
+// Serial, WiFi, the clock, the random numbers, PSRAM and a TlsClient that never
+// connects (TLS is not built on the host, stratum+ssl:// pools fail).
+
+#include <chrono>
+#include <thread>
+
+#include "tls_transport.h"
+
+HardwareSerial Serial;
+WiFiClass WiFi;
+
+// The clock starts at 1 s: on the board WiFi has been up for a while when
+// mining starts, and the mining task takes a 0 timestamp as "not set"
+static const auto start_time = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+
+unsigned long millis() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                start_time)
+        .count();
+}
+
+unsigned long micros() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                start_time)
+        .count();
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+long random(long min, long max) {
+    return min + (long)(esp_random() % (uint32_t)(max - min));
+}
+
+uint32_t esp_random() {
+    static uint32_t state = 1;
+    state = state * 1103515245 + 12345;
+    return state >> 8;
+}
+
+bool psramFound() {
+    return true;
+}
+
+void* ps_malloc(size_t size) {
+    return malloc(size);
+}
+
+TlsClient::TlsClient() : caPem(nullptr), handshakeTimeoutMs(TLS_HANDSHAKE_TIMEOUT_MS), open(false), setup(false),
+                         peeked(-1), lastResumed(false), lastHandshakeMs(0) {
+    serverName[0] = '\0';
+}
+TlsClient::~TlsClient() {}
+void TlsClient::setServerName(const char*) {}
+void TlsClient::setCACert(const char* pem) { caPem = pem; }
+int TlsClient::connect(IPAddress, uint16_t) { return 0; }
+int TlsClient::connect(IPAddress, uint16_t, int32_t) { return 0; }
+int TlsClient::connect(const char*, uint16_t) { return 0; }
+int TlsClient::connect(const char*, uint16_t, int32_t) { return 0; }
+size_t TlsClient::write(uint8_t) { return 0; }
+size_t TlsClient::write(const uint8_t*, size_t) { return 0; }
+int TlsClient::available() { return 0; }
+int TlsClient::read() { return -1; }
+int TlsClient::read(uint8_t*, size_t) { return -1; }
+int TlsClient::peek() { return -1; }
+void TlsClient::flush() {}
+void TlsClient::stop() {}
+uint8_t TlsClient::connected() { return 0; }
+
+void tls_get_stats(TlsStats* out) {
+    memset(out, 0, sizeof(*out));
+}
+
+void tls_forget_sessions(void) {}
@@ -0,0 +1,14 @@
+// ESP-IDF logging at the default INFO level. On the board it goes to the same
+// UART as Serial, so here it goes through Serial too: -v shows it and the
+// tools read it through Serial.tap.
+#pragma once
+
+#include <Arduino.h>
+
+#define ESP_LOG_LINE(level, tag, format, ...) \
+    Serial.printf(level " (%lu) %s: " format "\n", millis(), tag, ##__VA_ARGS__)
+
+#define ESP_LOGE(tag, format, ...) ESP_LOG_LINE("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_LOG_LINE("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_LOG_LINE("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ((void)(tag))
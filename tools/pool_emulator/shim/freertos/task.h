@@ -0,0 +1,30 @@
+// Tasks are detached threads. vTaskDelete(NULL) is a no-op: every task in
+// the device code returns right after it.
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+#include <chrono>
+#include <thread>
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stack, void* arg,
+                                          UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    (void)name; (void)stack; (void)priority; (void)core;
+    static int next_task = 0;
+    if (handle) {
+        *handle = (TaskHandle_t)(intptr_t)++next_task;
+    }
+    std::thread(task, arg).detach();
+    return pdPASS;
+}
+
+inline void vTaskDelete(TaskHandle_t task) {
+    (void)task;
+}
+
+inline void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
@@ -0,0 +1,18 @@
+// mbedtls SHA-256 on top of tools/common/sha256.h
+#pragma once
+
+#include <sha256.h>         // tools/common
+
+typedef Sha256 mbedtls_sha256_context;
+
+inline void mbedtls_sha256_init(mbedtls_sha256_context* ctx) { ctx->reset(); }
+inline void mbedtls_sha256_free(mbedtls_sha256_context* ctx) { (void)ctx; }
+inline int mbedtls_sha256_starts(mbedtls_sha256_context* ctx, int is224) { (void)is224; ctx->reset(); return 0; }
+inline int mbedtls_sha256_update(mbedtls_sha256_context* ctx, const unsigned char* input, size_t len) {
+    ctx->update(input, len);
+    return 0;
+}
+inline int mbedtls_sha256_finish(mbedtls_sha256_context* ctx, unsigned char output[32]) {
+    ctx->finish(output);
+    return 0;
+}
@@ -0,0 +1,5 @@
+// Only the types tls_transport.h declares: TLS is not built on the host
+#pragma once
+
+typedef struct { int unused; } mbedtls_ssl_context;
+typedef struct { int unused; } mbedtls_ssl_config;
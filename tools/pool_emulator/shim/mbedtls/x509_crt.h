@@ -0,0 +1,4 @@
+// Only the type tls_transport.h declares: TLS is not built on the host
+#pragma once
+
+typedef struct { int unused; } mbedtls_x509_crt;
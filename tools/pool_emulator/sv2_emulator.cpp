@@ -0,0 +1,517 @@
+// Local Stratum V2 pool stand-in (standard mining channel, unencrypted).
+//
+// Speaks the binary framing used by src/stratum_v2_client.cpp:
+// SetupConnection, OpenStandardMiningChannel, NewMiningJob (future and
+// immediate), SetNewPrevHash, SetTarget and SubmitSharesStandard. Shares are
+// verified against the channel target by hashing the 80-byte header built
+// from the job's version, prev hash and merkle root. Bytes on the wire are
+// counted so runs can be compared with pool_emulator (Stratum V1).
+//
+// Build: g++ -std=c++17 -O2 -Wall -o sv2_emulator sv2_emulator.cpp
+// Usage: sv2_emulator [-p port] [-d difficulty] [-n notify_s] [-c clean_every]
+
+#include "../common/sha256.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#define SV2_HEADER_SIZE     6
+#define SV2_CHANNEL_MSG_BIT 0x8000
+#define SV2_MAX_PAYLOAD     (1 << 16)
+#define EMU_MAX_JOBS        8
+#define EMU_STATS_INTERVAL_MS 10000
+
+// Mining Protocol message types
+#define SV2_SETUP_CONNECTION                  0x00
+#define SV2_SETUP_CONNECTION_SUCCESS          0x01
+#define SV2_SETUP_CONNECTION_ERROR            0x02
+#define SV2_OPEN_STANDARD_MINING_CHANNEL      0x10
+#define SV2_OPEN_STANDARD_MINING_CHANNEL_OK   0x11
+#define SV2_NEW_MINING_JOB                    0x15
+#define SV2_SUBMIT_SHARES_STANDARD            0x1a
+#define SV2_SUBMIT_SHARES_SUCCESS             0x1c
+#define SV2_SUBMIT_SHARES_ERROR               0x1d
+#define SV2_SET_NEW_PREV_HASH                 0x20
+#define SV2_SET_TARGET                        0x21
+
+typedef std::vector<uint8_t> Bytes;
+
+struct Job {
+    uint32_t id;
+    uint32_t version;
+    uint8_t merkle_root[32];
+    uint64_t sent_ms;
+};
+
+struct Miner {
+    int fd = -1;
+    std::string address;
+    Bytes inbuf;
+    Bytes outbuf;
+    bool setup = false;
+    uint32_t channel_id = 0;        // 0 = no channel yet
+    uint32_t accepted = 0;
+    uint32_t rejected = 0;
+    std::set<std::string> seen;
+};
+
+// Options
+static uint16_t opt_port = 3334;
+static double opt_difficulty = 0.001;
+static int opt_notify_interval_s = 30;
+static int opt_clean_every = 3;
+
+// State
+static std::map<int, Miner> miners;
+static std::vector<Job> jobs;
+static uint8_t prev_hash[32];
+static uint32_t prev_nbits = 0x1705ae3a;
+static uint32_t prev_ntime = 0;
+static uint32_t next_job_id = 1;
+static uint32_t next_channel_id = 1;
+static uint8_t target[32];
+static volatile bool running = true;
+static std::mt19937_64 rng(12345);
+
+// Statistics
+static uint64_t stat_bytes_in = 0;
+static uint64_t stat_bytes_out = 0;
+static uint64_t stat_frames_in = 0;
+static uint64_t stat_frames_out = 0;
+static uint64_t stat_accepted = 0;
+static uint64_t stat_stale = 0;
+static uint64_t stat_low_diff = 0;
+static uint64_t stat_duplicate = 0;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void put_u16(Bytes& b, uint16_t v) { b.push_back(v & 0xFF); b.push_back(v >> 8); }
+static void put_u32(Bytes& b, uint32_t v) { for (int i = 0; i < 4; i++) b.push_back((v >> (i * 8)) & 0xFF); }
+static void put_u64(Bytes& b, uint64_t v) { for (int i = 0; i < 8; i++) b.push_back((v >> (i * 8)) & 0xFF); }
+static void put_bytes(Bytes& b, const uint8_t* p, size_t n) { b.insert(b.end(), p, p + n); }
+static void put_str(Bytes& b, const std::string& s) { b.push_back((uint8_t)s.size()); put_bytes(b, (const uint8_t*)s.data(), s.size()); }
+static uint32_t get_u32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+static void send_frame(Miner& miner, uint16_t extension_type, uint8_t msg_type, const Bytes& payload) {
+    Bytes& out = miner.outbuf;
+    put_u16(out, extension_type);
+    out.push_back(msg_type);
+    out.push_back(payload.size() & 0xFF);
+    out.push_back((payload.size() >> 8) & 0xFF);
+    out.push_back((payload.size() >> 16) & 0xFF);
+    put_bytes(out, payload.data(), payload.size());
+    stat_frames_out++;
+}
+
+// Share target as U256 little endian (diff1 target / difficulty)
+static void make_target(double difficulty, uint8_t out[32]) {
+    long double value = 65535.0L * powl(2.0L, 208) / difficulty;
+    for (int i = 31; i >= 0; i--) {
+        long double unit = powl(256.0L, i);
+        long double digit = floorl(value / unit);
+        if (digit > 255) digit = 255;
+        out[i] = (uint8_t)digit;
+        value -= digit * unit;
+    }
+}
+
+// Compare two U256 little endian numbers: true when a <= b
+static bool u256_le_or_equal(const uint8_t* a, const uint8_t* b) {
+    for (int i = 31; i >= 0; i--) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i];
+        }
+    }
+    return true;
+}
+
+static Bytes new_job_payload(uint32_t channel_id, const Job& job, bool future) {
+    Bytes p;
+    put_u32(p, channel_id);
+    put_u32(p, job.id);
+    if (future) {
+        p.push_back(0);             // min_ntime: none (future job)
+    } else {
+        p.push_back(1);
+        put_u32(p, prev_ntime);
+    }
+    put_u32(p, job.version);
+    put_bytes(p, job.merkle_root, 32);
+    return p;
+}
+
+static Bytes prev_hash_payload(uint32_t channel_id, uint32_t job_id) {
+    Bytes p;
+    put_u32(p, channel_id);
+    put_u32(p, job_id);
+    put_bytes(p, prev_hash, 32);
+    put_u32(p, prev_ntime);
+    put_u32(p, prev_nbits);
+    return p;
+}
+
+static Job make_job(void) {
+    Job job;
+    job.id = next_job_id++;
+    job.version = 0x20000000;
+    for (int i = 0; i < 32; i++) {
+        job.merkle_root[i] = (uint8_t)rng();
+    }
+    job.sent_ms = now_ms();
+    jobs.push_back(job);
+    if (jobs.size() > EMU_MAX_JOBS) {
+        jobs.erase(jobs.begin());
+    }
+    return job;
+}
+
+// New block: future job followed by SetNewPrevHash activating it
+static void new_block(void) {
+    for (int i = 0; i < 32; i++) {
+        prev_hash[i] = (uint8_t)rng();
+    }
+    prev_ntime = (uint32_t)time(NULL);
+    jobs.clear();
+    Job job = make_job();
+    for (auto& entry : miners) {
+        Miner& miner = entry.second;
+        if (miner.channel_id != 0) {
+            send_frame(miner, SV2_CHANNEL_MSG_BIT, SV2_NEW_MINING_JOB, new_job_payload(miner.channel_id, job, true));
+            send_frame(miner, SV2_CHANNEL_MSG_BIT, SV2_SET_NEW_PREV_HASH, prev_hash_payload(miner.channel_id, job.id));
+        }
+    }
+    printf("📬 New block, job %u (clean, %zu miners)\n", job.id, miners.size());
+}
+
+// Same block, new job usable immediately
+static void new_job(void) {
+    Job job = make_job();
+    for (auto& entry : miners) {
+        Miner& miner = entry.second;
+        if (miner.channel_id != 0) {
+            send_frame(miner, SV2_CHANNEL_MSG_BIT, SV2_NEW_MINING_JOB, new_job_payload(miner.channel_id, job, false));
+        }
+    }
+    printf("📬 Job %u (non-clean, %zu miners)\n", job.id, miners.size());
+}
+
+static void share_error(Miner& miner, uint32_t sequence, const char* code) {
+    Bytes p;
+    put_u32(p, miner.channel_id);
+    put_u32(p, sequence);
+    put_str(p, code);
+    send_frame(miner, SV2_CHANNEL_MSG_BIT, SV2_SUBMIT_SHARES_ERROR, p);
+    miner.rejected++;
+}
+
+static void handle_submit(Miner& miner, const uint8_t* p, uint32_t len) {
+    if (len < 24 || get_u32(p) != miner.channel_id) {
+        return;
+    }
+    uint32_t sequence = get_u32(p + 4);
+    uint32_t job_id = get_u32(p + 8);
+    uint32_t nonce = get_u32(p + 12);
+    uint32_t ntime = get_u32(p + 16);
+    uint32_t version = get_u32(p + 20);
+
+    const Job* job = NULL;
+    for (const Job& j : jobs) {
+        if (j.id == job_id) {
+            job = &j;
+        }
+    }
+    if (!job) {
+        share_error(miner, sequence, "stale-share");
+        stat_stale++;
+        return;
+    }
+
+    char key[64];
+    snprintf(key, sizeof(key), "%u:%08x:%08x:%08x", job_id, nonce, ntime, version);
+    if (!miner.seen.insert(key).second) {
+        share_error(miner, sequence, "duplicate-share");
+        stat_duplicate++;
+        return;
+    }
+
+    Bytes header;
+    put_u32(header, version);
+    put_bytes(header, prev_hash, 32);
+    put_bytes(header, job->merkle_root, 32);
+    put_u32(header, ntime);
+    put_u32(header, prev_nbits);
+    put_u32(header, nonce);
+    uint8_t hash[32];
+    sha256d(header.data(), header.size(), hash);
+
+    if (!u256_le_or_equal(hash, target)) {
+        share_error(miner, sequence, "difficulty-too-low");
+        stat_low_diff++;
+        printf("❌ %s: low difficulty share (job %u)\n", miner.address.c_str(), job_id);
+        return;
+    }
+
+    Bytes ok;
+    put_u32(ok, miner.channel_id);
+    put_u32(ok, sequence);
+    put_u32(ok, 1);
+    put_u64(ok, (uint64_t)opt_difficulty);
+    send_frame(miner, SV2_CHANNEL_MSG_BIT, SV2_SUBMIT_SHARES_SUCCESS, ok);
+    miner.accepted++;
+    stat_accepted++;
+    printf("✅ %s: share accepted (job %u, %llu ms after the job)\n", miner.address.c_str(), job_id,
+           (unsigned long long)(now_ms() - job->sent_ms));
+}
+
+static void handle_frame(Miner& miner, uint8_t msg_type, const uint8_t* p, uint32_t len) {
+    stat_frames_in++;
+    switch (msg_type) {
+        case SV2_SETUP_CONNECTION: {
+            Bytes out;
+            if (len < 1 || p[0] != 0) {
+                put_u32(out, 0);
+                put_str(out, "unsupported-protocol");
+                send_frame(miner, 0, SV2_SETUP_CONNECTION_ERROR, out);
+                break;
+            }
+            miner.setup = true;
+            put_u16(out, 2);
+            put_u32(out, 0);
+            send_frame(miner, 0, SV2_SETUP_CONNECTION_SUCCESS, out);
+            break;
+        }
+        case SV2_OPEN_STANDARD_MINING_CHANNEL: {
+            if (!miner.setup || len < 4) {
+                break;
+            }
+            miner.channel_id = next_channel_id++;
+            Bytes out;
+            put_u32(out, get_u32(p));       // request_id
+            put_u32(out, miner.channel_id);
+            put_bytes(out, target, 32);
+            out.push_back(4);               // extranonce_prefix (B0_32)
+            put_u32(out, miner.channel_id);
+            put_u32(out, 0);                // group_channel_id
+            send_frame(miner, 0, SV2_OPEN_STANDARD_MINING_CHANNEL_OK, out);
+
+            // Current block: future job + prev hash, like a fresh block
+            if (!jobs.empty()) {
+                const Job& job = jobs.back();
+                send_frame(miner, SV2_CHANNEL_MSG_BIT, SV2_NEW_MINING_JOB, new_job_payload(miner.channel_id, job, true));
+                send_frame(miner, SV2_CHANNEL_MSG_BIT, SV2_SET_NEW_PREV_HASH, prev_hash_payload(miner.channel_id, job.id));
+            }
+            printf("🔑 %s opened channel %u\n", miner.address.c_str(), miner.channel_id);
+            break;
+        }
+        case SV2_SUBMIT_SHARES_STANDARD:
+            handle_submit(miner, p, len);
+            break;
+        default:
+            printf("⚠️  %s: unhandled message 0x%02x\n", miner.address.c_str(), msg_type);
+            break;
+    }
+}
+
+static void print_stats(void) {
+    printf("┌──────────────── SV2 emulator stats ────────────────┐\n");
+    printf("│ Miners: %-4zu Accepted: %-6llu Stale: %-5llu          │\n", miners.size(),
+           (unsigned long long)stat_accepted, (unsigned long long)stat_stale);
+    printf("│ LowDiff: %-5llu Duplicate: %-5llu                     │\n", (unsigned long long)stat_low_diff,
+           (unsigned long long)stat_duplicate);
+    printf("│ In: %-8llu B / %-6llu frames                      │\n", (unsigned long long)stat_bytes_in,
+           (unsigned long long)stat_frames_in);
+    printf("│ Out: %-8llu B / %-6llu frames                     │\n", (unsigned long long)stat_bytes_out,
+           (unsigned long long)stat_frames_out);
+    printf("└────────────────────────────────────────────────────┘\n");
+}
+
+static void close_miner(int fd) {
+    auto it = miners.find(fd);
+    if (it == miners.end()) {
+        return;
+    }
+    printf("➖ %s disconnected (%u accepted, %u rejected)\n", it->second.address.c_str(), it->second.accepted,
+           it->second.rejected);
+    close(fd);
+    miners.erase(it);
+}
+
+static void on_signal(int) {
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "p:d:n:c:")) != -1) {
+        switch (opt) {
+            case 'p': opt_port = (uint16_t)atoi(optarg); break;
+            case 'd': opt_difficulty = atof(optarg); break;
+            case 'n': opt_notify_interval_s = atoi(optarg); break;
+            case 'c': opt_clean_every = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-p port] [-d difficulty] [-n notify_s] [-c clean_every]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (opt_difficulty <= 0 || opt_notify_interval_s <= 0 || opt_clean_every <= 0) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    make_target(opt_difficulty, target);
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(opt_port);
+    if (bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, 128) < 0) {
+        fprintf(stderr, "❌ Cannot listen on port %u: %s\n", opt_port, strerror(errno));
+        return 1;
+    }
+    fcntl(listen_fd, F_SETFL, O_NONBLOCK);
+    printf("🏊 SV2 emulator on :%u (difficulty %g, job every %d s, clean every %d)\n", opt_port, opt_difficulty,
+           opt_notify_interval_s, opt_clean_every);
+
+    new_block();
+    uint64_t notifies = 1;
+    uint64_t last_notify = now_ms();
+    uint64_t last_stats = now_ms();
+
+    while (running) {
+        uint64_t now = now_ms();
+        if (now - last_notify >= (uint64_t)opt_notify_interval_s * 1000) {
+            last_notify = now;
+            if (notifies++ % opt_clean_every == 0) {
+                new_block();
+            } else {
+                new_job();
+            }
+        }
+        if (now - last_stats >= EMU_STATS_INTERVAL_MS) {
+            last_stats = now;
+            print_stats();
+        }
+
+        std::vector<struct pollfd> fds;
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (auto& entry : miners) {
+            fds.push_back({entry.first, (short)(POLLIN | (entry.second.outbuf.empty() ? 0 : POLLOUT)), 0});
+        }
+        if (poll(fds.data(), fds.size(), 200) < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+
+        for (size_t i = 0; i < fds.size(); i++) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            if (fds[i].fd == listen_fd) {
+                struct sockaddr_in peer;
+                socklen_t len = sizeof(peer);
+                int fd;
+                while ((fd = accept(listen_fd, (struct sockaddr*)&peer, &len)) >= 0) {
+                    fcntl(fd, F_SETFL, O_NONBLOCK);
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    Miner& miner = miners[fd];
+                    miner.fd = fd;
+                    char buf[32];
+                    snprintf(buf, sizeof(buf), "%s:%u", inet_ntoa(peer.sin_addr), ntohs(peer.sin_port));
+                    miner.address = buf;
+                    printf("➕ %s connected\n", buf);
+                    len = sizeof(peer);
+                }
+                continue;
+            }
+
+            auto it = miners.find(fds[i].fd);
+            if (it == miners.end() || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            Miner& miner = it->second;
+            uint8_t chunk[4096];
+            ssize_t n = recv(miner.fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    close_miner(fds[i].fd);
+                }
+                continue;
+            }
+            stat_bytes_in += n;
+            miner.inbuf.insert(miner.inbuf.end(), chunk, chunk + n);
+
+            // Consume complete frames
+            while (miner.inbuf.size() >= SV2_HEADER_SIZE) {
+                uint32_t len = miner.inbuf[3] | (miner.inbuf[4] << 8) | (miner.inbuf[5] << 16);
+                if (len > SV2_MAX_PAYLOAD) {
+                    close_miner(fds[i].fd);
+                    break;
+                }
+                if (miner.inbuf.size() < SV2_HEADER_SIZE + len) {
+                    break;
+                }
+                Bytes frame(miner.inbuf.begin(), miner.inbuf.begin() + SV2_HEADER_SIZE + len);
+                miner.inbuf.erase(miner.inbuf.begin(), miner.inbuf.begin() + SV2_HEADER_SIZE + len);
+                handle_frame(miner, frame[2], frame.data() + SV2_HEADER_SIZE, len);
+            }
+        }
+
+        std::vector<int> dead;
+        for (auto& entry : miners) {
+            Miner& miner = entry.second;
+            while (!miner.outbuf.empty()) {
+                ssize_t n = send(miner.fd, miner.outbuf.data(), miner.outbuf.size(), MSG_NOSIGNAL);
+                if (n > 0) {
+                    stat_bytes_out += n;
+                    miner.outbuf.erase(miner.outbuf.begin(), miner.outbuf.begin() + n);
+                } else {
+                    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                        dead.push_back(entry.first);
+                    }
+                    break;
+                }
+            }
+        }
+        for (int fd : dead) {
+            close_miner(fd);
+        }
+    }
+
+    print_stats();
+    while (!miners.empty()) {
+        close_miner(miners.begin()->first);
+    }
+    close(listen_fd);
+    return 0;
+}
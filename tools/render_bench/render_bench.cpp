@@ -0,0 +1,244 @@
+// Host benchmark for the page rendering in src/display.cpp.
+//
+// Compiles display.cpp as it is, against a small Arduino.h (shim/) and
+// stand-ins for the panel driver and the mining tasks, and renders every
+// page into the RAM framebuffer:
+//
+//   logo            idle logo page
+//   animation       star field with the scrolling "The answer is 42"
+//   mining idle     mining page, not mining
+//   mining BTC      mining page with Bitcoin statistics
+//   mining DUCO     mining page with Duino-Coin statistics
+//   setup           setup page, WiFi off
+//   setup AP        setup page, WiFi access point on
+//   text            only the text of the pages: labels, clock and a hashrate
+//                   that changes twice a second
+//
+// Each scene is drawn for a number of frames, with the clock moving 20 ms per
+// frame as on the board. Only the drawing is timed: the flush goes to a driver
+// stand-in that does nothing. A checksum of every frame is printed per scene,
+// so the output of two versions of display.cpp can be compared pixel for
+// pixel (see README.md).
+//
+// Build: see README.md
+// Usage: render_bench [-f frames]
+
+#include <rm67162.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "display.h"
+#include "duino_task.h"
+#include "mining_task.h"
+#include "wifi_config.h"
+
+#define WIDTH 536
+#define HEIGHT 240
+#define FRAME_MS 20
+
+extern uint16_t* framebuffer;
+
+static int opt_frames = 500;
+
+// ---------------------------------------------------------------------------
+// Stand-ins for the board
+// ---------------------------------------------------------------------------
+
+HostSerial Serial;
+WifiConfig config;
+
+static unsigned long clock_ms = 0;
+static uint32_t random_state = 1;
+
+unsigned long millis() {
+    return clock_ms;
+}
+
+unsigned long micros() {
+    static auto start = std::chrono::steady_clock::now();
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                start)
+        .count();
+}
+
+uint32_t esp_random() {
+    random_state = random_state * 1103515245 + 12345;
+    return random_state >> 8;
+}
+
+void* ps_malloc(size_t size) {
+    return malloc(size);
+}
+
+void rm67162_init(void) {}
+void lcd_setRotation(uint8_t) {}
+void lcd_PushRect(uint16_t, uint16_t, uint16_t, uint16_t, const uint16_t*, uint16_t) {}
+bool lcd_PushRectAsync(uint16_t, uint16_t, uint16_t, uint16_t, const uint16_t*, uint16_t, lcd_flush_cb_t, void*) {
+    return false;
+}
+void lcd_wait_flush(void) {}
+void lcd_get_flush_stats(lcd_flush_stats_t* out) {
+    memset(out, 0, sizeof(*out));
+}
+
+static bool found_block = false;
+
+MiningStats mining_get_stats(void) {
+    MiningStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.hashes_per_second = 12345;
+    stats.total_hashes = 987654321;
+    stats.best_difficulty = 4096;
+    stats.shares_accepted = 12;
+    stats.shares_rejected = 1;
+    return stats;
+}
+
+bool mining_has_found_block(void) {
+    return found_block;
+}
+
+bool mining_is_educational_fallback(void) {
+    return false;
+}
+
+DuinoStats duino_get_stats(void) {
+    DuinoStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.hashes_per_second = 5700;
+    stats.total_hashes = 123456789;
+    stats.difficulty = 8.5f;
+    stats.shares_accepted = 321;
+    stats.shares_rejected = 2;
+    return stats;
+}
+
+bool duino_has_found_share(void) {
+    return found_block;
+}
+
+// ---------------------------------------------------------------------------
+// Scenes
+// ---------------------------------------------------------------------------
+
+enum Scene { LOGO, ANIMATION, MINING_IDLE, MINING_BTC, MINING_DUCO, SETUP, SETUP_AP, TEXT };
+
+static const char* scene_names[] = {"logo", "animation", "mining idle", "mining BTC", "mining DUCO", "setup",
+                                    "setup AP", "text"};
+
+static void draw_text(const char* timeStr) {
+    char hashrate[32];
+    snprintf(hashrate, sizeof(hashrate), "Hashrate: %lu H/s", 12000 + (clock_ms / 500) % 1000);
+    drawText(timeStr, 10, 14, 0xFFFF, 2, false);
+    drawText("TzCoinMiner", 0, 60, 0xFFFF, 4, true);
+    drawText("Start", 40, 110, 0xFD20, 2, false);
+    drawText("Mining", 32, 132, 0xFD20, 2, false);
+    drawText("Status: Mining", 200, 100, 0xFFFF, 2, false);
+    drawText(hashrate, 200, 124, 0xFFFF, 2, false);
+    drawText("EDUCATIONAL", 40, 200, 0xF81F, 2, false);
+    drawText("42", 0, 160, 0xFFFF, 6, true);
+}
+
+static void draw(Scene scene, const char* timeStr) {
+    switch (scene) {
+        case LOGO:
+        case ANIMATION:
+            display_page_logo(true, timeStr, true, false, false);
+            break;
+        case MINING_IDLE:
+            display_page_mining(false, true, timeStr, false, false);
+            break;
+        case MINING_BTC:
+            display_page_mining(true, true, timeStr, false, false);
+            break;
+        case MINING_DUCO:
+            display_page_mining(true, true, timeStr, false, true);
+            break;
+        case SETUP:
+            display_page_setup(false, true, timeStr, true, false, false);
+            break;
+        case SETUP_AP:
+            display_page_setup(true, true, timeStr, true, false, false);
+            break;
+        case TEXT:
+            draw_text(timeStr);
+            break;
+    }
+}
+
+static uint64_t fnv1a(uint64_t hash, const uint16_t* pixels, size_t count) {
+    const uint8_t* bytes = (const uint8_t*)pixels;
+    for (size_t i = 0; i < count * sizeof(uint16_t); i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "f:")) != -1) {
+        switch (opt) {
+            case 'f': opt_frames = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-f frames]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (opt_frames < 1) {
+        fprintf(stderr, "frames must be >= 1\n");
+        return 2;
+    }
+
+    display_init();
+    if (!framebuffer) {
+        fprintf(stderr, "display_init failed\n");
+        return 1;
+    }
+
+    printf("🖥️  %dx%d framebuffer, %d frames per scene\n\n", WIDTH, HEIGHT, opt_frames);
+    printf("┌──────────────┬──────────────┬──────────────────────┐\n");
+    printf("│ Scene        │ us per frame │ Checksum             │\n");
+    printf("├──────────────┼──────────────┼──────────────────────┤\n");
+    double total_us = 0;
+    for (int s = LOGO; s <= TEXT; s++) {
+        Scene scene = (Scene)s;
+
+        // Same state at the start of every scene, whatever ran before
+        random_state = 1;
+        display_reset_animation();
+        if (scene == ANIMATION) {
+            clock_ms += 6000;  // Past the inactivity timeout: the animation starts
+        }
+
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        double us = 0;
+        for (int frame = 0; frame < opt_frames; frame++) {
+            char timeStr[32];
+            unsigned long seconds = clock_ms / 1000;
+            snprintf(timeStr, sizeof(timeStr), "18/10/26 - %02lu:%02lu:%02lu", (seconds / 3600) % 24,
+                     (seconds / 60) % 60, seconds % 60);
+
+            auto start = std::chrono::steady_clock::now();
+            draw(scene, timeStr);
+            us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+            hash = fnv1a(hash, framebuffer, WIDTH * HEIGHT);
+            clock_ms += FRAME_MS;
+        }
+        total_us += us;
+        printf("│ %-12s │ %12.1f │ %016llx     │\n", scene_names[s], us / opt_frames, (unsigned long long)hash);
+    }
+    printf("├──────────────┼──────────────┼──────────────────────┤\n");
+    printf("│ %-12s │ %12.1f │                      │\n", "average", total_us / opt_frames / (TEXT + 1));
+    printf("└──────────────┴──────────────┴──────────────────────┘\n");
+
+    DisplayStats stats;
+    display_get_stats(&stats);
+    printf("\nText cache: %lu hits, %lu misses\n", (unsigned long)stats.text_hits, (unsigned long)stats.text_misses);
+    return 0;
+}
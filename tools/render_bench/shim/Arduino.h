@@ -0,0 +1,32 @@
+// Just enough of Arduino.h to compile src/display.cpp on the host.
+// millis() is a clock the benchmark moves by hand, so animations play
+// frame by frame. Serial output is dropped.
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+class String {
+public:
+    String(const char* s = "") : s_(s) {}
+    const char* c_str() const { return s_.c_str(); }
+
+private:
+    std::string s_;
+};
+
+struct HostSerial {
+    void println(const char*) {}
+    void printf(const char*, ...) {}
+};
+extern HostSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+uint32_t esp_random();
+void* ps_malloc(size_t size);
@@ -0,0 +1,509 @@
+// Host test of the board's JSON-RPC client against a local node, normally
+// node_emulator. src/bitcoin_rpc.cpp is compiled as it is, against the
+// HTTPClient in shim/ and the Arduino, WiFi and FreeRTOS shim of
+// tools/pool_emulator, and driven through its public functions:
+//   - batch bodies from rpc_batch_request() and batch replies read with the
+//     streaming reader of src/rpc_batch.cpp, fed in chunks from 1 byte up and
+//     checked against mini_json. Errors inside a batch, replies out of order,
+//     missing or extra, a whole-request error and malformed JSON. Then the
+//     same batch through bitcoin_rpc_batch()
+//   - bitcoin_rpc_call() sends its params (getblocktemplate needs them)
+//   - the keep-alive session: N calls on one connection, a batch against the
+//     same calls one by one, and the HTTP/1.0 fallback after a chunked
+//     answer, one connection per call
+//   - a connection the node closed while idle (rpcservertimeout), noticed
+//     before sending, and requests the node drops on a reused connection,
+//     each retried once on a new one
+// Connections are counted twice: by the client (bitcoin_rpc_get_stats) and
+// by the node (getemulatorstats). The node's counters and options are read
+// and set on HTTP/1.0 connections of its own, outside the client under test.
+// The tool exits non-zero on any mismatch.
+//
+// Build: see README.md
+// Usage: rpc_bench [-h host] [-p port] [-a user:pass] [-n calls] [-v]
+
+#include "../common/mini_json.h"
+#include "bitcoin_rpc.h"
+#include "rpc_batch.h"
+
+#include <WiFi.h>
+#include <base64.h>
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string opt_host = "127.0.0.1";
+static int opt_port = 18443;
+static int opt_calls = 200;
+static std::string opt_user;
+static std::string opt_pass;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("❌ %s\n", what);
+        failures++;
+    }
+}
+
+static double now_ms(void) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------------------------------------------------------------------------
+// The node's side: one HTTP/1.0 request per connection, not through the
+// client under test (each one counts as a connection, a request and a call)
+// ---------------------------------------------------------------------------
+
+static bool node_post(const std::string& payload, std::string& body) {
+    std::string request = "POST / HTTP/1.0\r\nHost: " + opt_host + "\r\nContent-Type: application/json\r\n";
+    if (!opt_user.empty()) {
+        String auth = base64::encode(String((opt_user + ":" + opt_pass).c_str()));
+        request += std::string("Authorization: Basic ") + auth.c_str() + "\r\n";
+    }
+    request += "Connection: close\r\nContent-Length: " + std::to_string(payload.size()) + "\r\n\r\n" + payload;
+
+    WiFiClient client;
+    if (!client.connect(opt_host.c_str(), opt_port) ||
+        client.write((const uint8_t*)request.data(), request.size()) != request.size()) {
+        return false;
+    }
+    std::string response;
+    char buf[4096];
+    unsigned long last = millis();
+    while (client.connected() && millis() - last < 5000) {
+        int n = client.read((uint8_t*)buf, sizeof(buf));
+        if (n > 0) {
+            response.append(buf, n);
+            last = millis();
+        } else {
+            delay(1);
+        }
+    }
+    size_t header_end = response.find("\r\n\r\n");
+    if (response.compare(0, 5, "HTTP/") != 0 || header_end == std::string::npos) {
+        return false;
+    }
+    body = response.substr(header_end + 4);
+    return true;
+}
+
+static bool node_call(const char* method, const std::string& params, JsonValue& result) {
+    std::string body;
+    JsonValue doc;
+    if (!node_post(std::string("{\"jsonrpc\":\"1.0\",\"id\":\"rpc_bench\",\"method\":\"") + method +
+                       "\",\"params\":" + params + "}",
+                   body) ||
+        !json_parse(body, doc)) {
+        return false;
+    }
+    result = doc["result"];
+    return true;
+}
+
+struct NodeStats {
+    uint64_t connections = 0;
+    uint64_t http_requests = 0;
+    uint64_t requests = 0;
+    uint64_t idle_closed = 0;
+    uint64_t dropped = 0;
+    int idle_timeout = 0;
+};
+
+static bool node_stats(NodeStats& out) {
+    JsonValue result;
+    if (!node_call("getemulatorstats", "[]", result) || result.type != JsonValue::OBJECT) {
+        return false;
+    }
+    out.connections = (uint64_t)result["connections"].asNumber();
+    out.http_requests = (uint64_t)result["http_requests"].asNumber();
+    out.requests = (uint64_t)result["requests"].asNumber();
+    out.idle_closed = (uint64_t)result["idle_closed"].asNumber();
+    out.dropped = (uint64_t)result["dropped"].asNumber();
+    out.idle_timeout = (int)result["idle_timeout"].asNumber();
+    return true;
+}
+
+static bool node_options(bool chunked, int drop_every) {
+    JsonValue result;
+    std::string params = std::string("[{\"chunked\":") + (chunked ? "true" : "false") +
+                         ",\"drop_every\":" + std::to_string(drop_every) + "}]";
+    return node_call("setemulatoroptions", params, result) && result["chunked"].asBool() == chunked;
+}
+
+// Connections the client opened between two snapshots: the second
+// getemulatorstats and every option change in between are the tool's own
+struct Window {
+    NodeStats before;
+    NodeStats after;
+    BitcoinRpcStats client_before;
+    BitcoinRpcStats client_after;
+    int own = 1;
+
+    void start(void) {
+        node_stats(before);
+        bitcoin_rpc_get_stats(&client_before);
+        own = 1;
+    }
+    void stop(void) {
+        bitcoin_rpc_get_stats(&client_after);
+        node_stats(after);
+    }
+    uint64_t node_connections(void) const { return after.connections - before.connections - own; }
+    uint64_t node_http_requests(void) const { return after.http_requests - before.http_requests - own; }
+    uint64_t node_requests(void) const { return after.requests - before.requests - own; }
+    uint32_t connections(void) const { return client_after.connections - client_before.connections; }
+    uint32_t calls(void) const { return client_after.calls - client_before.calls; }
+    uint32_t retries(void) const { return client_after.retries - client_before.retries; }
+};
+
+// A fresh session on the node: the connection left open by the previous step is closed
+static void client_reset(void) {
+    bitcoin_rpc_init(opt_host.c_str(), opt_port, opt_user.c_str(), opt_pass.c_str());
+}
+
+static double timed_calls(const char* method, int count, const char* what) {
+    double start = now_ms();
+    for (int i = 0; i < count; i++) {
+        JsonDocument response;
+        check(bitcoin_rpc_call(method, NULL, response), what);
+    }
+    return (now_ms() - start) / count;
+}
+
+// ---------------------------------------------------------------------------
+// Batch reader against mini_json
+// ---------------------------------------------------------------------------
+
+// Every scalar of a result as "path=type:value", in document order
+struct Flat {
+    std::vector<std::string> calls[RPC_BATCH_MAX];
+    std::string pending;        // Long string arriving in pieces
+};
+
+static void flatten(const JsonValue& v, const std::string& path, std::vector<std::string>& out) {
+    switch (v.type) {
+        case JsonValue::ARRAY:
+            for (size_t i = 0; i < v.size(); i++) {
+                flatten(v[(int)i], path + "[" + std::to_string(i) + "]", out);
+            }
+            break;
+        case JsonValue::OBJECT:
+            for (const auto& member : v.members) {
+                flatten(member.second, path + "." + member.first, out);
+            }
+            break;
+        case JsonValue::STRING: out.push_back(path + "=s:" + v.text); break;
+        case JsonValue::NUMBER: out.push_back(path + "=n:" + v.text); break;
+        case JsonValue::BOOL:   out.push_back(path + "=b:" + (v.boolean ? "true" : "false")); break;
+        default:                out.push_back(path + "=null"); break;
+    }
+}
+
+static void on_result(int call, json_stream_t* js, json_event_t event, const char* value, size_t len, void* arg) {
+    Flat* flat = (Flat*)arg;
+    std::string path;
+    for (int level = 2; level < js->depth; level++) {
+        path += js->levels[level].is_array ? "[" + std::to_string(json_stream_index(js, level)) + "]"
+                                           : "." + std::string(json_stream_key(js, level));
+    }
+    switch (event) {
+        case JSON_EVENT_STRING_PART: flat->pending.append(value, len); break;
+        case JSON_EVENT_STRING:
+            flat->calls[call].push_back(path + "=s:" + flat->pending + std::string(value, len));
+            flat->pending.clear();
+            break;
+        case JSON_EVENT_NUMBER: flat->calls[call].push_back(path + "=n:" + value); break;
+        case JSON_EVENT_TRUE:   flat->calls[call].push_back(path + "=b:true"); break;
+        case JSON_EVENT_FALSE:  flat->calls[call].push_back(path + "=b:false"); break;
+        case JSON_EVENT_NULL:   flat->calls[call].push_back(path + "=null"); break;
+        default: break;
+    }
+}
+
+static bool read_batch(const std::string& body, int count, size_t chunk, rpc_batch_reader_t* reader, Flat* flat) {
+    rpc_batch_reader_init(reader, count, on_result, flat);
+    for (size_t pos = 0; pos < body.size(); pos += chunk) {
+        if (!rpc_batch_reader_feed(reader, body.data() + pos, std::min(chunk, body.size() - pos))) {
+            return false;
+        }
+    }
+    return rpc_batch_reader_finish(reader);
+}
+
+static void check_reader_rejects(const char* body, int count, const char* expected_error, const char* what) {
+    static rpc_batch_reader_t reader;
+    Flat flat;
+    bool ok = read_batch(body, count, 3, &reader, &flat);
+    const char* error = rpc_batch_reader_error(&reader);
+    if (ok || strstr(error, expected_error) == NULL) {
+        printf("❌ %s: %s\n", what, ok ? "accepted" : error);
+        failures++;
+    }
+}
+
+static void check_batch_reader(const rpc_call_t* calls, int count, const std::string& reply) {
+    JsonValue doc;
+    check(json_parse(reply, doc) && doc.size() == (size_t)count, "batch reply is an array with one reply per call");
+
+    static const size_t chunks[] = {1, 2, 3, 7, 64, 1024, 1 << 20};
+    for (size_t chunk : chunks) {
+        static rpc_batch_reader_t reader;
+        Flat flat;
+        if (!read_batch(reply, count, chunk, &reader, &flat)) {
+            printf("❌ batch reply rejected with %zu-byte chunks: %s\n", chunk, rpc_batch_reader_error(&reader));
+            failures++;
+            continue;
+        }
+        for (int i = 0; i < count; i++) {
+            const JsonValue& element = doc[i];
+            std::vector<std::string> expected;
+            if (!element["result"].isNull()) {
+                flatten(element["result"], "", expected);
+            } else {
+                expected.push_back("=null");
+            }
+            check(flat.calls[i] == expected, "result values match mini_json");
+            check(reader.replies[i].error == !element["error"].isNull(), "error flag matches");
+            check(element["error"].isNull() || element["error"]["message"].asString() == reader.replies[i].message,
+                  "error message matches");
+        }
+        if (chunk == 1) {
+            for (int i = 0; i < count; i++) {
+                printf("   %-18s %s\n", calls[i].method,
+                       reader.replies[i].error ? reader.replies[i].message
+                                               : (std::to_string(flat.calls[i].size()) + " values").c_str());
+            }
+        }
+    }
+
+    check_reader_rejects("[{\"result\":1,\"error\":null,\"id\":1},{\"result\":2,\"error\":null,\"id\":0}]", 2,
+                         "ordine", "replies out of order");
+    check_reader_rejects("[{\"result\":1,\"error\":null,\"id\":0}]", 2, "mancanti", "missing reply");
+    check_reader_rejects("[{\"result\":1,\"error\":null,\"id\":0},{\"result\":2,\"error\":null,\"id\":1}]", 1,
+                         "ordine", "extra reply");
+    check_reader_rejects("[{\"result\":1,\"error\":null}]", 1, "ordine", "reply without id");
+    check_reader_rejects("{\"result\":null,\"error\":{\"code\":-32700,\"message\":\"Parse error\"},\"id\":null}", 1,
+                         "Parse error", "whole-request error");
+    check_reader_rejects("[{\"result\":1,\"error\":null,\"id\":0}", 1, "troncata", "truncated reply");
+    check_reader_rejects("[{\"result\":1,]", 1, "", "malformed reply");
+}
+
+static void check_batch_request(void) {
+    static const rpc_call_t calls[] = {{"getblockchaininfo", NULL}, {"getblock", "[\"00\",0]"}};
+    char out[256];
+    size_t len = rpc_batch_request(out, sizeof(out), calls, 2);
+    JsonValue doc;
+    check(len == strlen(out) && json_parse(out, doc) && doc.size() == 2, "batch request is a JSON array");
+    check(doc[0]["method"].asString() == "getblockchaininfo" && doc[0]["params"].type == JsonValue::ARRAY &&
+              doc[0]["id"].asNumber() == 0 && doc[1]["id"].asNumber() == 1 && doc[1]["params"].size() == 2,
+          "batch request methods, params and ids");
+    check(rpc_batch_request(out, len, calls, 2) == 0 && out[0] == 0, "batch request that does not fit");
+    check(rpc_batch_request(out, len + 1, calls, 2) == len, "batch request that just fits");
+    check(rpc_batch_request(out, sizeof(out), calls, 0) == 0, "empty batch");
+}
+
+// ---------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:a:n:v")) != -1) {
+        switch (opt) {
+            case 'h': opt_host = optarg; break;
+            case 'p': opt_port = atoi(optarg); break;
+            case 'a': {
+                std::string auth = optarg;
+                size_t colon = auth.find(':');
+                opt_user = auth.substr(0, colon);
+                opt_pass = colon == std::string::npos ? "" : auth.substr(colon + 1);
+                break;
+            }
+            case 'n': opt_calls = atoi(optarg); break;
+            case 'v': Serial.echo = true; break;
+            default:
+                fprintf(stderr, "Usage: %s [-h host] [-p port] [-a user:pass] [-n calls] [-v]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (opt_calls <= 0) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+
+    check_batch_request();
+    NodeStats initial;
+    if (!node_stats(initial) || !node_options(false, 0)) {
+        fprintf(stderr, "❌ No node_emulator on %s:%d (getemulatorstats)\n", opt_host.c_str(), opt_port);
+        return 1;
+    }
+    client_reset();
+
+    // 1. A real batch reply, with errors in place of two results: the reader
+    //    on its own, then the client's bitcoin_rpc_batch() on the same calls
+    static const rpc_call_t calls[] = {
+        {"getblockchaininfo", NULL},
+        {"getnetworkinfo", NULL},
+        {"getbestblockhash", NULL},
+        {"nosuchmethod", NULL},
+        {"getblock", "[\"0000000000000000000000000000000000000000000000000000000000000000\",0]"},
+    };
+    const int batch_count = sizeof(calls) / sizeof(calls[0]);
+    char batch_body[512];
+    check(rpc_batch_request(batch_body, sizeof(batch_body), calls, batch_count) > 0, "batch request built");
+    std::string reply;
+    check(node_post(batch_body, reply), "batch answered");
+    printf("📦 Batch of %d calls, %zu bytes back:\n", batch_count, reply.size());
+    check_batch_reader(calls, batch_count, reply);
+
+    JsonValue doc;
+    json_parse(reply, doc);
+    Flat flat;
+    check(!bitcoin_rpc_batch(calls, batch_count, on_result, &flat), "bitcoin_rpc_batch() fails on the errors in it");
+    for (int i = 0; i < batch_count; i++) {
+        std::vector<std::string> expected;
+        if (doc[i]["error"].isNull()) {
+            flatten(doc[i]["result"], "", expected);
+        } else {
+            expected.push_back("=null");
+        }
+        // getnetworkinfo carries the node's time offset and connection count: same shape is enough
+        check(i == 1 ? flat.calls[i].size() == expected.size() : flat.calls[i] == expected,
+              "bitcoin_rpc_batch() values match mini_json");
+    }
+
+    // 2. Params reach the node: getblocktemplate without the segwit rule is an error
+    {
+        JsonDocument response;
+        check(bitcoin_rpc_call("getblocktemplate", "[{\"rules\":[\"segwit\"]}]", response) &&
+                  !response["result"]["previousblockhash"].isNull(),
+              "getblocktemplate with params");
+        JsonDocument rejected;
+        check(!bitcoin_rpc_call("getblocktemplate", NULL, rejected), "getblocktemplate without params rejected");
+    }
+
+    // 3. The same call on the keep-alive session: one connection for all
+    Window w;
+    client_reset();
+    w.start();
+    double kept_ms = timed_calls("getbestblockhash", opt_calls, "getbestblockhash (keep-alive)");
+    w.stop();
+    uint32_t kept_connections = w.connections();
+    check(w.connections() == 1 && w.node_connections() == 1 && w.calls() == (uint32_t)opt_calls &&
+              w.node_http_requests() == (uint64_t)opt_calls,
+          "one connection for every call with keep-alive");
+
+    // 4. Batch against the same calls one by one, on the open session
+    double single_ms = 0;
+    double batch_ms = 0;
+    int rounds = std::max(1, opt_calls / 10);
+    w.start();
+    for (int r = 0; r < rounds; r++) {
+        double t0 = now_ms();
+        for (int i = 0; i < 3; i++) {
+            JsonDocument response;
+            check(bitcoin_rpc_call(calls[i].method, calls[i].params, response), "single call");
+        }
+        single_ms += now_ms() - t0;
+        t0 = now_ms();
+        Flat three;
+        check(bitcoin_rpc_batch(calls, 3, on_result, &three), "batch of 3");
+        batch_ms += now_ms() - t0;
+    }
+    w.stop();
+    check(w.node_http_requests() == (uint64_t)rounds * 4, "a batch is one HTTP request");
+    check(w.node_requests() == (uint64_t)rounds * 6, "a batch still runs every call");
+    check(w.connections() == 0 && w.node_connections() == 0, "batches reuse the open connection");
+
+    // 5. A chunked answer: the session falls back to HTTP/1.0, one connection per call
+    w.start();
+    check(node_options(true, 0), "chunked answers on");
+    w.own++;
+    client_reset();
+    check(bitcoin_rpc_test_connection(), "connection test through the chunked answer");
+    uint32_t fallback_connections = 0;
+    double fallback_ms = 0;
+    {
+        BitcoinRpcStats s;
+        bitcoin_rpc_get_stats(&s);
+        fallback_connections = s.connections;
+        fallback_ms = timed_calls("getbestblockhash", opt_calls, "getbestblockhash (HTTP/1.0)");
+        bitcoin_rpc_get_stats(&s);
+        fallback_connections = s.connections - fallback_connections;
+    }
+    check(node_options(false, 0), "chunked answers off");
+    w.own++;
+    w.stop();
+    // The chunked answer's connection, the test again on HTTP/1.0, then one per call
+    check(fallback_connections == (uint32_t)opt_calls && w.connections() == 2 + (uint32_t)opt_calls &&
+              w.node_connections() == w.connections() && w.retries() == 0,
+          "HTTP/1.0 after a chunked answer, one connection per call");
+    printf("🔌 %d calls: %u connection(s) with keep-alive, %u after the HTTP/1.0 fallback\n", opt_calls,
+           (unsigned)kept_connections, (unsigned)fallback_connections);
+
+    // 6. The node closes idle connections: noticed before sending, no retry
+    bool idle_checked = initial.idle_timeout > 0 && initial.idle_timeout <= 5;
+    if (idle_checked) {
+        printf("💤 Idle timeout %d s: waiting for the node to close the connection\n", initial.idle_timeout);
+        client_reset();
+        JsonDocument response;
+        check(bitcoin_rpc_call("getbestblockhash", NULL, response), "call before the idle close");
+        w.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(initial.idle_timeout * 1000 + 1500));
+        JsonDocument after;
+        check(bitcoin_rpc_call("getbestblockhash", NULL, after), "call after the idle close");
+        w.stop();
+        check(w.after.idle_closed == w.before.idle_closed + 1, "the node closed the idle connection");
+        check(w.connections() == 1 && w.node_connections() == 1 && w.retries() == 0,
+              "closed connection noticed before sending");
+    } else {
+        printf("💤 Idle close skipped: start node_emulator with -k 2 to check it\n");
+    }
+
+    // 7. Every 5th request on a reused connection dropped: each one retried once
+    client_reset();
+    w.start();
+    check(node_options(false, 5), "drops on");
+    w.own++;
+    timed_calls("getbestblockhash", opt_calls, "getbestblockhash (dropped and retried)");
+    check(node_options(false, 0), "drops off");
+    w.own++;
+    w.stop();
+    uint64_t dropped = w.after.dropped - w.before.dropped;
+    check(dropped > 0 && w.retries() == dropped && w.connections() == 1 + dropped &&
+              w.node_connections() == w.connections() && w.node_http_requests() == opt_calls + dropped,
+          "dropped requests retried once on a new connection");
+    printf("✂️  %d calls: %llu dropped by the node, %u retried by the client\n", opt_calls,
+           (unsigned long long)dropped, (unsigned)w.retries());
+
+    BitcoinRpcStats stats;
+    bitcoin_rpc_get_stats(&stats);
+    printf("┌─────────────────────────────────────────────────────┐\n");
+    printf("│ RPC SESSION                                         │\n");
+    printf("├─────────────────────────────────────────────────────┤\n");
+    printf("│ Calls per run:      %6d                          │\n", opt_calls);
+    printf("│ Keep-alive:         %6.3f ms/call, %6u conn.    │\n", kept_ms, (unsigned)kept_connections);
+    printf("│ HTTP/1.0 fallback:  %6.3f ms/call, %6u conn.    │\n", fallback_ms, (unsigned)fallback_connections);
+    printf("│ 3 calls one by one: %6.3f ms                       │\n", single_ms / rounds);
+    printf("│ Same in a batch:    %6.3f ms                       │\n", batch_ms / rounds);
+    printf("│ Dropped, retried:   %6llu                          │\n", (unsigned long long)dropped);
+    printf("│ Client total:       %6u calls, %6u conn.      │\n", (unsigned)stats.calls,
+           (unsigned)stats.connections);
+    printf("└─────────────────────────────────────────────────────┘\n");
+
+    if (failures) {
+        printf("❌ %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All checks passed\n");
+    return 0;
+}
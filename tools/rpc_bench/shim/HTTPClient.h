@@ -0,0 +1,263 @@
+// HTTPClient for src/bitcoin_rpc.cpp on the host. Behaves like the ESP32
+// core's where the RPC session depends on it:
+//
+// - begin(client, url) keeps the client's open connection, and the request
+//   goes out on it if it is still connected; otherwise it connects again
+// - setReuse() asks for keep-alive; a "Connection: close" or HTTP/1.0
+//   response turns it off, and end() then closes the connection
+// - useHTTP10() sends HTTP/1.0, which a server never answers chunked; on
+//   HTTP/1.1 a chunked response has getSize() -1 and getString() decodes it
+// - a connection the server closed before the response header is
+//   HTTPC_ERROR_CONNECTION_LOST, and every error closes the connection
+#pragma once
+
+#include <WiFi.h>
+
+#include <string>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM (-8)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_STREAM_WRITE (-10)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_INTERNAL_SERVER_ERROR 500
+
+class HTTPClient {
+public:
+    bool begin(WiFiClient& client, const char* url) {
+        client_ = &client;
+        headers_.clear();
+        size_ = -1;
+        chunked_ = false;
+        code_ = 0;
+
+        std::string rest = url;
+        size_t scheme = rest.find("://");
+        if (scheme == std::string::npos) {
+            return false;
+        }
+        bool https = rest.compare(0, scheme, "https") == 0;
+        rest = rest.substr(scheme + 3);
+        size_t slash = rest.find('/');
+        path_ = slash == std::string::npos ? "/" : rest.substr(slash);
+        std::string authority = rest.substr(0, slash);
+        size_t colon = authority.rfind(':');
+        host_ = authority.substr(0, colon);
+        port_ = colon == std::string::npos ? (https ? 443 : 80) : (uint16_t)atoi(authority.c_str() + colon + 1);
+        return !host_.empty();
+    }
+
+    void setReuse(bool reuse) { reuse_ = reuse; }
+    void useHTTP10(bool http10) { http10_ = http10; }
+    void setTimeout(uint16_t ms) { timeout_ms_ = ms; }
+    void addHeader(const char* name, const char* value) {
+        headers_ += name;
+        headers_ += ": ";
+        headers_ += value;
+        headers_ += "\r\n";
+    }
+
+    bool connected() { return client_ && (client_->available() > 0 || client_->connected()); }
+
+    int POST(uint8_t* payload, size_t size) { return sendRequest("POST", payload, size); }
+
+    int sendRequest(const char* type, uint8_t* payload, size_t size) {
+        int code = start(type, size);
+        if (code < 0) {
+            return code;
+        }
+        if (size > 0 && client_->write(payload, size) != size) {
+            return error(HTTPC_ERROR_SEND_PAYLOAD_FAILED);
+        }
+        return response();
+    }
+
+    int sendRequest(const char* type, Stream* stream, size_t size) {
+        int code = start(type, size);
+        if (code < 0) {
+            return code;
+        }
+        char buf[1460];
+        size_t sent = 0;
+        while (sent < size) {
+            size_t want = size - sent < sizeof(buf) ? size - sent : sizeof(buf);
+            size_t got = stream->readBytes(buf, want);
+            if (got == 0 || client_->write((const uint8_t*)buf, got) != got) {
+                return error(HTTPC_ERROR_SEND_PAYLOAD_FAILED);
+            }
+            sent += got;
+        }
+        return response();
+    }
+
+    int getSize() const { return size_; }
+    WiFiClient* getStreamPtr() { return connected() ? client_ : nullptr; }
+
+    String getString() {
+        std::string body;
+        if (chunked_) {
+            for (;;) {
+                String line = readLine();
+                long len = strtol(line.c_str(), NULL, 16);
+                if (len <= 0 || !readBody(body, len)) {
+                    readLine();    // The empty line after the last chunk
+                    break;
+                }
+                readLine();
+            }
+        } else {
+            readBody(body, size_);
+        }
+        return body;
+    }
+
+    // Like the ESP32 core: what is left of the response is read and dropped,
+    // and the connection stays open only if both sides wanted keep-alive
+    void end() {
+        if (!connected()) {
+            return;
+        }
+        while (client_->available() > 0) {
+            client_->read();
+        }
+        if (!reuse_ || !can_reuse_) {
+            client_->stop();
+        }
+    }
+
+    static String errorToString(int code) {
+        switch (code) {
+            case HTTPC_ERROR_CONNECTION_REFUSED: return "connection refused";
+            case HTTPC_ERROR_SEND_HEADER_FAILED: return "send header failed";
+            case HTTPC_ERROR_SEND_PAYLOAD_FAILED: return "send payload failed";
+            case HTTPC_ERROR_NOT_CONNECTED: return "not connected";
+            case HTTPC_ERROR_CONNECTION_LOST: return "connection lost";
+            case HTTPC_ERROR_NO_STREAM: return "no stream";
+            case HTTPC_ERROR_NO_HTTP_SERVER: return "no HTTP server";
+            case HTTPC_ERROR_TOO_LESS_RAM: return "too less ram";
+            case HTTPC_ERROR_ENCODING: return "Transfer-Encoding not supported";
+            case HTTPC_ERROR_STREAM_WRITE: return "Stream write error";
+            case HTTPC_ERROR_READ_TIMEOUT: return "read Timeout";
+            default: return String();
+        }
+    }
+
+private:
+    // Connects if needed (an open connection is reused) and sends the header
+    int start(const char* type, size_t size) {
+        if (!client_) {
+            return HTTPC_ERROR_NOT_CONNECTED;
+        }
+        if (connected()) {
+            while (client_->available() > 0) {
+                client_->read();
+            }
+        } else if (!client_->connect(host_.c_str(), port_, timeout_ms_)) {
+            return error(HTTPC_ERROR_CONNECTION_REFUSED);
+        }
+        client_->setTimeout(timeout_ms_);
+
+        std::string header = std::string(type) + " " + path_ + (http10_ ? " HTTP/1.0\r\n" : " HTTP/1.1\r\n");
+        header += "Host: " + host_ + ":" + std::to_string(port_) + "\r\n";
+        header += "User-Agent: ESP32HTTPClient\r\n";
+        header += reuse_ ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+        if (!http10_) {
+            header += "Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n";
+        }
+        header += headers_;
+        header += "Content-Length: " + std::to_string(size) + "\r\n\r\n";
+        if (client_->write((const uint8_t*)header.data(), header.size()) != header.size()) {
+            return error(HTTPC_ERROR_SEND_HEADER_FAILED);
+        }
+        return 0;
+    }
+
+    int response() {
+        can_reuse_ = reuse_;
+        size_ = -1;
+        chunked_ = false;
+        code_ = 0;
+        unsigned long last_data = millis();
+        while (connected()) {
+            if (client_->available() <= 0) {
+                if (millis() - last_data > timeout_ms_) {
+                    return error(HTTPC_ERROR_READ_TIMEOUT);
+                }
+                delay(1);
+                continue;
+            }
+            last_data = millis();
+            String line = readLine();
+            std::string lower = line.c_str();
+            for (auto& c : lower) {
+                c = (char)tolower((unsigned char)c);
+            }
+            if (lower.compare(0, 7, "http/1.") == 0) {
+                can_reuse_ = can_reuse_ && lower[7] != '0';
+                code_ = atoi(lower.c_str() + 9);
+            } else if (lower.compare(0, 15, "content-length:") == 0) {
+                size_ = atoi(lower.c_str() + 15);
+            } else if (lower.compare(0, 11, "connection:") == 0) {
+                if (lower.find("close") != std::string::npos && lower.find("keep-alive") == std::string::npos) {
+                    can_reuse_ = false;
+                }
+            } else if (lower.compare(0, 18, "transfer-encoding:") == 0) {
+                chunked_ = lower.find("chunked") != std::string::npos;
+            } else if (lower.empty()) {
+                return code_ > 0 ? code_ : error(HTTPC_ERROR_NO_HTTP_SERVER);
+            }
+        }
+        return error(HTTPC_ERROR_CONNECTION_LOST);
+    }
+
+    int error(int code) {
+        if (client_ && connected()) {
+            client_->stop();
+        }
+        return code;
+    }
+
+    String readLine() {
+        String line = client_->readStringUntil('\n');
+        line.trim();
+        return line;
+    }
+
+    // len bytes, or until the connection closes when len is -1
+    bool readBody(std::string& body, long len) {
+        char buf[1024];
+        while (len != 0 && connected()) {
+            size_t want = len > 0 && (size_t)len < sizeof(buf) ? (size_t)len : sizeof(buf);
+            size_t got = client_->readBytes(buf, want);
+            if (got == 0) {
+                break;
+            }
+            body.append(buf, got);
+            if (len > 0) {
+                len -= got;
+            }
+        }
+        return len <= 0;
+    }
+
+    WiFiClient* client_ = nullptr;
+    std::string host_;
+    std::string path_;
+    uint16_t port_ = 80;
+    std::string headers_;
+    uint16_t timeout_ms_ = 5000;
+    bool reuse_ = true;
+    bool http10_ = false;
+    bool can_reuse_ = false;
+    bool chunked_ = false;
+    int size_ = -1;
+    int code_ = 0;
+};
@@ -0,0 +1,28 @@
+// base64 of the ESP32 core, for the RPC client's Basic auth header
+#pragma once
+
+#include <Arduino.h>
+
+class base64 {
+public:
+    static String encode(const uint8_t* data, size_t length) {
+        static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        for (size_t i = 0; i < length; i += 3) {
+            uint32_t n = (uint32_t)data[i] << 16;
+            if (i + 1 < length) {
+                n |= (uint32_t)data[i + 1] << 8;
+            }
+            if (i + 2 < length) {
+                n |= data[i + 2];
+            }
+            out += table[(n >> 18) & 63];
+            out += table[(n >> 12) & 63];
+            out += i + 1 < length ? table[(n >> 6) & 63] : '=';
+            out += i + 2 < length ? table[n & 63] : '=';
+        }
+        return out;
+    }
+
+    static String encode(const String& text) { return encode((const uint8_t*)text.c_str(), text.length()); }
+};
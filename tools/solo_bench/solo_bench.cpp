@@ -0,0 +1,583 @@
+// End-to-end host test of the board's solo mining path.
+//
+// Runs the same code as the board (src/gbt_parser.cpp, src/solo_block.cpp,
+// src/btc_address.cpp, src/merkle.cpp) against a regtest node, normally the
+// local node_emulator:
+//   - address decoding (BIP173/BIP350/Base58Check vectors), BIP34 height
+//     encoding and compact target decoding are checked first
+//   - a template is streamed into the parser with a transaction store
+//   - extranonce rolls are timed (one coinbase hash + branch climb) and their
+//     merkle roots checked against a full tree rebuilt from the template JSON
+//   - blocks are mined (regtest target) and sent with submitblock:
+//       1. broken variants that the node must reject with the right reason
+//       2. a coinbase-only block, as built when the store is too small
+//       3. the full block with every template transaction
+//       4. a block on the following template
+//     then the same block again, which must be a duplicate
+//   - every submitblock body is generated in pieces as on the board
+//     (solo_submit_body_read) and must equal the block serialized in one
+//     go; the full block is read back with getblock and compared byte for byte
+//   - long-poll: a getblocktemplate with the current longpollid must wait
+//     until a block is accepted, then return the new template; the time from
+//     submitblock to the new template is the node side of the board's
+//     template refresh latency. A node without long-poll (node_emulator -L)
+//     is checked through getbestblockhash instead, the board's fallback.
+// The tool exits non-zero on any mismatch.
+//
+// Build: see README.md
+// Usage: solo_bench [-h host] [-p port] [-w address] [-n nonces_per_extranonce] [-x rolls]
+
+#include "../common/mini_json.h"
+#include "../common/sha256.h"
+#include "btc_address.h"
+#include "gbt_parser.h"
+#include "solo_block.h"
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string opt_host = "127.0.0.1";
+static int opt_port = 18443;
+static std::string opt_address = "bcrt1qw508d6qejxtdg4y5r3zarvary0c5xw7kygt080";
+static uint32_t opt_nonces = 4;         // Nonces per extranonce (the board uses all 2^32)
+static int opt_rolls = 20000;
+
+#define TX_STORE_BYTES (4 * 1024 * 1024)   // As on the board (PSRAM)
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("❌ %s\n", what);
+        failures++;
+    }
+}
+
+static std::string to_hex(const uint8_t* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(len * 2);
+    for (size_t i = 0; i < len; i++) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 15];
+    }
+    return out;
+}
+
+// POST a JSON-RPC request body, return the HTTP status and the answer's body
+static int http_post(const std::string& payload, std::string& body) {
+    struct addrinfo hints = {};
+    struct addrinfo* res = NULL;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(opt_host.c_str(), std::to_string(opt_port).c_str(), &hints, &res) != 0) {
+        return -1;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        freeaddrinfo(res);
+        close(fd);
+        return -1;
+    }
+    freeaddrinfo(res);
+
+    std::string request = "POST / HTTP/1.0\r\nHost: " + opt_host + "\r\nContent-Type: application/json\r\n"
+                          "Content-Length: " + std::to_string(payload.size()) + "\r\n\r\n" + payload;
+    size_t sent = 0;
+    while (sent < request.size()) {
+        ssize_t n = send(fd, request.data() + sent, request.size() - sent, 0);
+        if (n <= 0) {
+            close(fd);
+            return -1;
+        }
+        sent += n;
+    }
+
+    std::string response;
+    char chunk[16384];
+    ssize_t n;
+    while ((n = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+        response.append(chunk, n);
+    }
+    close(fd);
+
+    size_t split = response.find("\r\n\r\n");
+    if (split == std::string::npos || response.compare(0, 5, "HTTP/") != 0) {
+        return -1;
+    }
+    body = response.substr(split + 4);
+    return atoi(response.c_str() + response.find(' ') + 1);
+}
+
+// POST one JSON-RPC call
+static int rpc_post(const std::string& method, const std::string& params, std::string& body) {
+    return http_post("{\"jsonrpc\":\"1.0\",\"id\":\"solo_bench\",\"method\":\"" + method + "\",\"params\":" +
+                         params + "}",
+                     body);
+}
+
+// ---------------------------------------------------------------------------
+// Known-answer checks
+// ---------------------------------------------------------------------------
+
+static void check_addresses(void) {
+    struct Vector {
+        const char* address;
+        const char* script;     // NULL = must be rejected
+    };
+    static const Vector VECTORS[] = {
+        {"BC1QW508D6QEJXTDG4Y5R3ZARVARY0C5XW7KV8F3T4", "0014751e76e8199196d454941c45d1b3a323f1433bd6"},
+        {"tb1qrp33g0q5c5txsp9arysrx4k6zdkfs4nce4xj0gdcccefvpysxf3q0sl5k7",
+         "00201863143c14c5166804bd19203356da136c985678cd4d27a1b8c6329604903262"},
+        {"bc1p0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7vqzk5jj0",
+         "512079be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798"},
+        {"bcrt1qw508d6qejxtdg4y5r3zarvary0c5xw7kygt080", "0014751e76e8199196d454941c45d1b3a323f1433bd6"},
+        {"1BvBMSEYstWetqTFn5Au4m4GFg7xJaNVN2", "76a91477bff20c60e522dfaa3350c39b030a5d004e839a88ac"},
+        {"3J98t1WpEZ73CNmQviecrnyiWrnqRhWNLy", "a914b472a266d0bd89c13706a4132ccfb16f7c3b9fcb87"},
+        {"1BvBMSEYstWetqTFn5Au4m4GFg7xJaNVN3", NULL},                                  // Bad checksum
+        {"bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t5", NULL},                          // Bad checksum
+        {"bc1p0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7vqh2y7hd", NULL},       // bech32 for v1
+        {"BC1QW508D6QEJXTDG4Y5R3ZARVARY0C5XW7Kv8f3t4", NULL},                          // Mixed case
+        {"", NULL},
+    };
+    for (const Vector& v : VECTORS) {
+        uint8_t script[BTC_SCRIPT_MAX];
+        int len = btc_address_to_script(v.address, script, sizeof(script));
+        bool ok = v.script ? (len > 0 && to_hex(script, len) == v.script) : len < 0;
+        if (!ok) {
+            printf("❌ Address %s -> %s\n", v.address, len > 0 ? to_hex(script, len).c_str() : "invalid");
+            failures++;
+        }
+    }
+}
+
+static void check_heights(void) {
+    struct Vector {
+        uint32_t height;
+        const char* push;
+    };
+    static const Vector VECTORS[] = {
+        {1, "51"}, {16, "60"}, {17, "0111"}, {127, "017f"}, {128, "028000"}, {255, "02ff00"},
+        {256, "020001"}, {32768, "03008000"}, {840000, "0340d10c"}, {8388608, "0400008000"},
+    };
+    for (const Vector& v : VECTORS) {
+        static BitcoinBlockTemplate tmpl;
+        memset(&tmpl, 0, sizeof(tmpl));
+        tmpl.height = v.height;
+        tmpl.coinbasevalue = 1;
+        static const uint8_t script[1] = {0x51};
+        solo_coinbase_t cb;
+        bool ok = solo_coinbase_build(&cb, &tmpl, script, 1);
+        // version(4) + input count(1) + prevout(36) + scriptSig length(1)
+        std::string push = to_hex(cb.data + 42, strlen(v.push) / 2);
+        if (!ok || push != v.push) {
+            printf("❌ BIP34 height %u -> %s (expected %s)\n", v.height, push.c_str(), v.push);
+            failures++;
+        }
+    }
+}
+
+static void check_targets(void) {
+    uint8_t target[32];
+    solo_target_from_bits(0x1d00ffff, target);
+    check(to_hex(target, 32) == std::string(52, '0') + "ffff" + std::string(8, '0'), "target for 1d00ffff");
+    solo_target_from_bits(0x207fffff, target);
+    check(to_hex(target, 32) == std::string(58, '0') + "ffff7f", "target for 207fffff");
+    uint8_t hash[32];
+    memcpy(hash, target, 32);
+    check(solo_hash_meets_target(hash, target), "hash == target is valid");
+    hash[31]++;
+    check(!solo_hash_meets_target(hash, target), "hash > target is invalid");
+}
+
+// ---------------------------------------------------------------------------
+// Solo mining against the node
+// ---------------------------------------------------------------------------
+
+struct Job {
+    std::string body;                   // Template JSON, for the reference checks
+    BitcoinBlockTemplate tmpl;
+    std::vector<uint8_t> store;
+    uint8_t prev[32];
+    uint8_t target[32];
+};
+
+static gbt_parser_t parser;
+
+static bool fetch_template(Job& job, size_t store_size) {
+    if (rpc_post("getblocktemplate", "[{\"rules\":[\"segwit\"]}]", job.body) != 200) {
+        printf("❌ getblocktemplate from %s:%d failed\n", opt_host.c_str(), opt_port);
+        return false;
+    }
+    job.store.assign(store_size, 0);
+    gbt_parser_init(&parser, &job.tmpl);
+    gbt_parser_set_tx_store(&parser, job.store.data(), job.store.size());
+    for (size_t pos = 0; pos < job.body.size(); pos += 1024) {
+        gbt_parser_feed(&parser, job.body.data() + pos, std::min<size_t>(1024, job.body.size() - pos));
+    }
+    if (!gbt_parser_finish(&parser)) {
+        printf("❌ Template rejected: %s\n", gbt_parser_error(&parser));
+        return false;
+    }
+    gbt_hex_to_hash(job.tmpl.previousblockhash, job.prev);
+    solo_target_from_bits(job.tmpl.bits, job.target);
+    return true;
+}
+
+// Header as the board lays it out (BlockHeader in mining_task.cpp)
+static void write_header(uint8_t header[80], const Job& job, const uint8_t merkle_root[32], uint32_t nonce) {
+    uint32_t fields[3] = {job.tmpl.curtime, job.tmpl.bits, nonce};
+    memcpy(header, &job.tmpl.version, 4);
+    memcpy(header + 4, job.prev, 32);
+    memcpy(header + 36, merkle_root, 32);
+    memcpy(header + 68, fields, 12);
+}
+
+// Mine like the board: nonces first, a new extranonce when they run out.
+// Regtest blocks are too easy to need a roll, so the first extranonce is
+// always skipped: every block submitted comes from a rolled coinbase.
+static bool mine(const Job& job, solo_coinbase_t* cb, uint8_t header[80], uint64_t* rolls, bool want_valid) {
+    uint64_t extranonce = 0;
+    uint8_t root[32];
+    solo_coinbase_roll(cb, &job.tmpl, extranonce, root);
+    for (uint64_t attempt = 0; attempt < 100000; attempt++) {
+        uint32_t nonce = (uint32_t)(attempt % opt_nonces);
+        if (nonce == 0 && attempt > 0) {
+            solo_coinbase_roll(cb, &job.tmpl, ++extranonce, root);
+            (*rolls)++;
+        }
+        write_header(header, job, root, nonce);
+        uint8_t hash[32];
+        sha256d(header, 80, hash);
+        if (extranonce > 0 && solo_hash_meets_target(hash, job.target) == want_valid) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void append(const uint8_t* data, size_t len, void* arg) {
+    std::vector<uint8_t>* out = (std::vector<uint8_t>*)arg;
+    out->insert(out->end(), data, data + len);
+}
+
+// Last block submitted, as serialized in one piece (the reference for the streamed body)
+static std::string last_block_hex;
+
+// Submit like the board: the request body generated piece by piece by
+// solo_submit_body_read(), checked against the block serialized in one go.
+// Returns the node's answer ("null" when accepted).
+static std::string submit(const uint8_t header[80], const solo_coinbase_t* cb, const BitcoinBlockTemplate* tmpl,
+                          size_t* block_size) {
+    std::vector<uint8_t> block;
+    size_t written = solo_block_serialize(header, cb, tmpl, append, &block);
+    check(written == block.size() && written == solo_block_size(cb, tmpl), "serialized block size");
+    *block_size = block.size();
+    last_block_hex = to_hex(block.data(), block.size());
+
+    // Odd read sizes split hex digit pairs; 1460 is HTTPClient's write buffer
+    static const size_t read_sizes[] = {1, 7, 64, 1460, 4096};
+    solo_submit_body_t stream;
+    solo_submit_body_init(&stream, header, cb, tmpl);
+    std::string payload;
+    char chunk[4096];
+    size_t got;
+    for (int i = 0; (got = solo_submit_body_read(&stream, chunk, read_sizes[i % 5])) > 0; i++) {
+        payload.append(chunk, got);
+    }
+    std::string reference = SOLO_SUBMIT_PREFIX + last_block_hex + SOLO_SUBMIT_SUFFIX;
+    check(payload == reference && payload.size() == stream.body_len, "streamed submitblock body byte for byte");
+
+    std::string body;
+    int status = http_post(payload, body);
+    JsonValue doc;
+    if (status < 0 || !json_parse(body, doc)) {
+        return "no answer";
+    }
+    if (!doc["error"].isNull()) {
+        return "error: " + doc["error"]["message"].asString();
+    }
+    return doc["result"].isNull() ? "null" : doc["result"].asString();
+}
+
+static bool expect(const char* what, const std::string& answer, const char* expected) {
+    bool ok = answer == expected;
+    printf("%s %-34s -> %s\n", ok ? "✅" : "❌", what, answer.c_str());
+    if (!ok) {
+        failures++;
+    }
+    return ok;
+}
+
+// Merkle root of the full tree: coinbase txid + every template txid
+static void reference_root(const Job& job, const solo_coinbase_t* cb, uint8_t root[32]) {
+    JsonValue doc;
+    json_parse(job.body, doc);
+    const JsonValue& txs = doc["result"]["transactions"];
+    std::vector<std::vector<uint8_t>> level(1, std::vector<uint8_t>(32));
+    sha256d(cb->data, cb->len, level[0].data());
+    for (size_t i = 0; i < txs.size(); i++) {
+        std::vector<uint8_t> txid(32);
+        gbt_hex_to_hash(txs[(int)i]["txid"].asString().c_str(), txid.data());
+        level.push_back(txid);
+    }
+    while (level.size() > 1) {
+        if (level.size() & 1) {
+            level.push_back(level.back());
+        }
+        std::vector<std::vector<uint8_t>> next;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            std::vector<uint8_t> parent(32);
+            merkle_hash_pair(level[i].data(), level[i + 1].data(), parent.data());
+            next.push_back(parent);
+        }
+        level.swap(next);
+    }
+    memcpy(root, level[0].data(), 32);
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:w:n:x:")) != -1) {
+        switch (opt) {
+            case 'h': opt_host = optarg; break;
+            case 'p': opt_port = atoi(optarg); break;
+            case 'w': opt_address = optarg; break;
+            case 'n': opt_nonces = (uint32_t)atoi(optarg); break;
+            case 'x': opt_rolls = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-h host] [-p port] [-w address] [-n nonces_per_extranonce] [-x rolls]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+    if (opt_nonces == 0 || opt_rolls <= 0) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+
+    check_addresses();
+    check_heights();
+    check_targets();
+    printf("🧪 Address, BIP34 and target vectors: %s\n", failures ? "FAILED" : "ok");
+
+    uint8_t script[BTC_SCRIPT_MAX];
+    int script_len = btc_address_to_script(opt_address.c_str(), script, sizeof(script));
+    if (script_len < 0) {
+        fprintf(stderr, "❌ Invalid address %s\n", opt_address.c_str());
+        return 1;
+    }
+    printf("💳 Payout %s (%s)\n", opt_address.c_str(), btc_script_type(script, script_len));
+
+    static Job job;
+    if (!fetch_template(job, TX_STORE_BYTES)) {
+        return 1;
+    }
+    check(job.tmpl.tx_data_complete, "transaction store complete");
+    check(job.tmpl.witness_commitment_len == 38, "witness commitment present");
+    printf("📦 Template: height %u, %d transactions, %zu bytes of transactions, coinbasevalue %llu\n",
+           job.tmpl.height, job.tmpl.transactions_count, job.tmpl.tx_data_len,
+           (unsigned long long)job.tmpl.coinbasevalue);
+
+    // Extranonce rolls: cost, and roots against the full tree
+    solo_coinbase_t cb;
+    check(solo_coinbase_build(&cb, &job.tmpl, script, script_len), "coinbase build");
+    uint8_t root[32];
+    uint8_t expected[32];
+    for (uint64_t e = 0; e < 3; e++) {
+        solo_coinbase_roll(&cb, &job.tmpl, e * 0x0101010101ULL, root);
+        reference_root(job, &cb, expected);
+        check(memcmp(root, expected, 32) == 0, "merkle root after an extranonce roll");
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < opt_rolls; i++) {
+        solo_coinbase_roll(&cb, &job.tmpl, (uint64_t)i, root);
+    }
+    double roll_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() /
+                     opt_rolls;
+    t0 = std::chrono::steady_clock::now();
+    reference_root(job, &cb, expected);
+    double rebuild_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    // 1. Broken blocks must be rejected, with the node's reason
+    uint8_t header[80];
+    uint64_t rolls = 0;
+    size_t block_size = 0;
+    {
+        static BitcoinBlockTemplate greedy;
+        greedy = job.tmpl;
+        greedy.coinbasevalue++;
+        Job bad = job;
+        bad.tmpl = greedy;
+        bad.tmpl.tx_data = bad.store.data();
+        solo_coinbase_t bad_cb;
+        solo_coinbase_build(&bad_cb, &bad.tmpl, script, script_len);
+        mine(bad, &bad_cb, header, &rolls, true);
+        expect("coinbase pays too much", submit(header, &bad_cb, &bad.tmpl, &block_size), "bad-cb-amount");
+
+        bad.tmpl = job.tmpl;
+        bad.tmpl.tx_data = bad.store.data();
+        bad.tmpl.height++;
+        solo_coinbase_build(&bad_cb, &bad.tmpl, script, script_len);
+        mine(bad, &bad_cb, header, &rolls, true);
+        expect("wrong BIP34 height", submit(header, &bad_cb, &bad.tmpl, &block_size), "bad-cb-height");
+
+        solo_coinbase_build(&bad_cb, &job.tmpl, script, script_len);
+        mine(job, &bad_cb, header, &rolls, true);
+        bad_cb.data[bad_cb.len - 5] ^= 1;   // Coinbase no longer matches the header's merkle root
+        expect("coinbase changed after mining", submit(header, &bad_cb, &job.tmpl, &block_size), "bad-txnmrklroot");
+
+        solo_coinbase_build(&bad_cb, &job.tmpl, script, script_len);
+        mine(job, &bad_cb, header, &rolls, false);
+        expect("hash above target", submit(header, &bad_cb, &job.tmpl, &block_size), "high-hash");
+    }
+
+    // 2. Store too small: coinbase-only block, the template transactions stay in the mempool
+    static Job small;
+    if (!fetch_template(small, 1000)) {
+        return 1;
+    }
+    check(!small.tmpl.tx_data_complete || small.tmpl.transactions_count == 0, "small store overflows");
+    gbt_template_drop_transactions(&small.tmpl);
+    solo_coinbase_t small_cb;
+    check(solo_coinbase_build(&small_cb, &small.tmpl, script, script_len), "coinbase build (no transactions)");
+    mine(small, &small_cb, header, &rolls, true);
+    expect("coinbase-only block (store full)", submit(header, &small_cb, &small.tmpl, &block_size), "null");
+
+    // 3. The full block with every template transaction
+    if (!fetch_template(job, TX_STORE_BYTES)) {
+        return 1;
+    }
+    int full_txs = job.tmpl.transactions_count;
+    check(solo_coinbase_build(&cb, &job.tmpl, script, script_len), "coinbase build");
+    mine(job, &cb, header, &rolls, true);
+    size_t full_size = 0;
+    expect("full block", submit(header, &cb, &job.tmpl, &full_size), "null");
+    {
+        // The node's copy of the block must be the bytes serialized here
+        uint8_t hash[32];
+        sha256d(header, 80, hash);
+        std::string hash_hex;
+        for (int i = 31; i >= 0; i--) {
+            hash_hex += to_hex(hash + i, 1);
+        }
+        std::string answer;
+        JsonValue doc;
+        check(rpc_post("getblock", "[\"" + hash_hex + "\",0]", answer) == 200 && json_parse(answer, doc) &&
+                  doc["result"].asString() == last_block_hex,
+              "getblock returns the submitted block byte for byte");
+        printf("🔍 getblock %s...: %zu bytes, identical\n", hash_hex.substr(0, 16).c_str(), last_block_hex.size() / 2);
+    }
+    uint8_t full_header[80];
+    memcpy(full_header, header, 80);
+    solo_coinbase_t full_cb = cb;
+    static BitcoinBlockTemplate full_tmpl;
+    full_tmpl = job.tmpl;
+    std::vector<uint8_t> full_store = job.store;
+    full_tmpl.tx_data = full_store.data();
+
+    // 4. Next template: built on the new tip, nothing left in the mempool
+    static Job next;
+    if (!fetch_template(next, TX_STORE_BYTES)) {
+        return 1;
+    }
+    check(next.tmpl.height == job.tmpl.height + 1 && next.tmpl.transactions_count == 0, "template after the block");
+    solo_coinbase_t next_cb;
+    solo_coinbase_build(&next_cb, &next.tmpl, script, script_len);
+    mine(next, &next_cb, header, &rolls, true);
+    expect("next block (coinbase only)", submit(header, &next_cb, &next.tmpl, &block_size), "null");
+
+    expect("same full block again", submit(full_header, &full_cb, &full_tmpl, &block_size), "duplicate");
+
+    // 5. Template changes: long-poll, or getbestblockhash on a node without it
+    static Job tip;
+    if (!fetch_template(tip, 0)) {
+        return 1;
+    }
+    gbt_template_drop_transactions(&tip.tmpl);
+    solo_coinbase_t tip_cb;
+    solo_coinbase_build(&tip_cb, &tip.tmpl, script, script_len);
+    mine(tip, &tip_cb, header, &rolls, true);
+    uint8_t tip_hash[32];
+    sha256d(header, 80, tip_hash);
+    std::string tip_hex;
+    for (int i = 31; i >= 0; i--) {
+        tip_hex += to_hex(tip_hash + i, 1);
+    }
+
+    bool longpoll = tip.tmpl.longpollid[0] != 0;
+    double refresh_ms = 0;
+    if (longpoll) {
+        std::string params = std::string("[{\"rules\":[\"segwit\"],\"longpollid\":\"") + tip.tmpl.longpollid + "\"}]";
+        std::atomic<bool> returned(false);
+        std::string lp_body;
+        int lp_status = 0;
+        std::chrono::steady_clock::time_point lp_at;
+        std::thread waiter([&] {
+            lp_status = rpc_post("getblocktemplate", params, lp_body);
+            lp_at = std::chrono::steady_clock::now();
+            returned = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        check(!returned, "long-poll waits while the template is unchanged");
+
+        auto submit_at = std::chrono::steady_clock::now();
+        expect("block that ends the long-poll", submit(header, &tip_cb, &tip.tmpl, &block_size), "null");
+        waiter.join();
+        refresh_ms = std::chrono::duration<double, std::milli>(lp_at - submit_at).count();
+        JsonValue doc;
+        check(lp_status == 200 && json_parse(lp_body, doc) &&
+                  doc["result"]["previousblockhash"].asString() == tip_hex &&
+                  (uint32_t)doc["result"]["height"].asNumber() == tip.tmpl.height + 1,
+              "long-poll returns the template on the new tip");
+
+        // An id that is already stale is answered at once
+        t0 = std::chrono::steady_clock::now();
+        check(rpc_post("getblocktemplate", params, lp_body) == 200 &&
+                  std::chrono::steady_clock::now() - t0 < std::chrono::seconds(1),
+              "stale longpollid answered immediately");
+        printf("🔔 Long-poll: new template %.1f ms after submitblock\n", refresh_ms);
+    } else {
+        std::string best;
+        expect("block on a node without long-poll", submit(header, &tip_cb, &tip.tmpl, &block_size), "null");
+        JsonValue doc;
+        check(rpc_post("getbestblockhash", "[]", best) == 200 && json_parse(best, doc) &&
+                  doc["result"].asString() == tip_hex,
+              "getbestblockhash follows the new tip");
+        printf("🔔 No long-poll on the node: getbestblockhash fallback checked\n");
+    }
+
+    printf("┌─────────────────────────────────────────────────────┐\n");
+    printf("│ SOLO BLOCK END TO END                               │\n");
+    printf("├─────────────────────────────────────────────────────┤\n");
+    printf("│ Transactions:  %9d                            │\n", full_txs);
+    printf("│ Full block:    %9zu bytes                      │\n", full_size);
+    printf("│ Coinbase:      %9zu bytes (%-6s)             │\n", cb.len, cb.witness ? "segwit" : "legacy");
+    printf("│ Branch levels: %9d                            │\n", job.tmpl.merkle_branch_len);
+    printf("│ Extranonce roll: %7.2f us (hash + branch)         │\n", roll_us);
+    printf("│ Full tree:     %9.2f ms (per roll without it)   │\n", rebuild_ms);
+    printf("│ Rolls while mining: %6llu                          │\n", (unsigned long long)rolls);
+    if (longpoll) {
+        printf("│ Long-poll refresh: %8.1f ms (submit -> template) │\n", refresh_ms);
+    } else {
+        printf("│ Long-poll refresh:     n/a (node without long-poll) │\n");
+    }
+    printf("└─────────────────────────────────────────────────────┘\n");
+
+    if (failures) {
+        printf("❌ %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,500 @@
+// End-to-end host test of the solo bridge.
+//
+// Connects a few boards to a running solo_bridge, speaks Stratum V1 to it the
+// way src/stratum_client.cpp does, and checks the blocks on the node behind it
+// (normally the local node_emulator):
+//   - every board gets its own extranonce1 and a 4-byte extranonce2, then the
+//     same difficulty and job; the job's prevhash is the node's tip
+//   - the header is rebuilt from the notify fields exactly as a board does
+//     (coinb1 + extranonce1 + extranonce2 + coinb2, branch, swapped prevhash)
+//   - unknown jobs (21), malformed shares (20), shares under the share
+//     difficulty (23) and duplicates (22) are refused
+//   - a share that meets the network target is answered true and becomes the
+//     node's new tip; the clean notify on top of it reaches every board, and
+//     the same share sent again is stale
+//   - a second block from another board, on the new job
+// Shares below the network target need a share difficulty under the
+// network's; regtest blocks are so easy that the bridge must run with e.g.
+// -d 3e-10 for those checks, otherwise they are skipped.
+// The tool exits non-zero on any mismatch.
+//
+// Build: see README.md
+// Usage: bridge_bench [-h host] [-p stratum_port] [-r rpc_port] [-n boards]
+
+#include "../common/mini_json.h"
+#include "../common/sha256.h"
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+static std::string opt_host = "127.0.0.1";
+static int opt_port = 3333;
+static int opt_rpc_port = 18443;
+static int opt_boards = 3;
+
+#define BENCH_TIMEOUT_MS 10000
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("%s %s\n", ok ? "✅" : "❌", what);
+    if (!ok) {
+        failures++;
+    }
+}
+
+static double ms_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool hex_to_bytes(const std::string& hex, std::vector<uint8_t>& out) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        char* end = NULL;
+        std::string pair = hex.substr(i, 2);
+        unsigned long b = strtoul(pair.c_str(), &end, 16);
+        if (*end != '\0') {
+            return false;
+        }
+        out.push_back((uint8_t)b);
+    }
+    return true;
+}
+
+static std::string to_hex(const uint8_t* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < len; i++) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 15];
+    }
+    return out;
+}
+
+static void put_u32_le(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back((uint8_t)(value >> (i * 8)));
+    }
+}
+
+static int connect_to(int port) {
+    struct addrinfo hints = {};
+    struct addrinfo* res = NULL;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(opt_host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) {
+        return -1;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        freeaddrinfo(res);
+        close(fd);
+        return -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+// One JSON-RPC call to the node, the result as JSON (empty on failure)
+static JsonValue rpc_call(const std::string& method, const std::string& params) {
+    JsonValue result;
+    int fd = connect_to(opt_rpc_port);
+    if (fd < 0) {
+        return result;
+    }
+    std::string payload = "{\"jsonrpc\":\"1.0\",\"id\":\"bridge_bench\",\"method\":\"" + method + "\",\"params\":" +
+                          params + "}";
+    std::string request = "POST / HTTP/1.0\r\nHost: " + opt_host + "\r\nContent-Type: application/json\r\n"
+                          "Content-Length: " + std::to_string(payload.size()) + "\r\n\r\n" + payload;
+    send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+    std::string response;
+    char chunk[16384];
+    ssize_t n;
+    while ((n = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+        response.append(chunk, n);
+    }
+    close(fd);
+    size_t split = response.find("\r\n\r\n");
+    JsonValue doc;
+    if (split != std::string::npos && json_parse(response.substr(split + 4), doc)) {
+        result = doc["result"];
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Boards
+// ---------------------------------------------------------------------------
+
+struct Job {
+    std::string id;
+    std::string prev_hash;
+    std::string coinb1;
+    std::string coinb2;
+    std::vector<std::string> branch;
+    std::string version;
+    std::string nbits;
+    std::string ntime;
+    bool clean = false;
+};
+
+struct Board {
+    int fd = -1;
+    std::string inbuf;
+    std::string extranonce1;
+    int extranonce2_size = 0;
+    double difficulty = 0;
+    Job job;
+    int notifies = 0;
+    int next_id = 10;
+    std::chrono::steady_clock::time_point notify_at;
+};
+
+static bool send_line(Board& board, const std::string& line) {
+    std::string out = line + "\n";
+    return send(board.fd, out.data(), out.size(), MSG_NOSIGNAL) == (ssize_t)out.size();
+}
+
+// Next message from the bridge; notifications update the board's job and difficulty
+static bool read_message(Board& board, JsonValue& msg) {
+    char chunk[4096];
+    size_t nl;
+    while ((nl = board.inbuf.find('\n')) == std::string::npos) {
+        ssize_t n = recv(board.fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return false;
+        }
+        board.inbuf.append(chunk, n);
+    }
+    std::string line = board.inbuf.substr(0, nl);
+    board.inbuf.erase(0, nl + 1);
+    if (!json_parse(line, msg)) {
+        return false;
+    }
+    const std::string& method = msg["method"].asString();
+    const JsonValue& params = msg["params"];
+    if (method == "mining.set_difficulty") {
+        board.difficulty = params[0].asNumber();
+    } else if (method == "mining.notify") {
+        Job& job = board.job;
+        job.id = params[0].asString();
+        job.prev_hash = params[1].asString();
+        job.coinb1 = params[2].asString();
+        job.coinb2 = params[3].asString();
+        job.branch.clear();
+        for (size_t i = 0; i < params[4].size(); i++) {
+            job.branch.push_back(params[4][(int)i].asString());
+        }
+        job.version = params[5].asString();
+        job.nbits = params[6].asString();
+        job.ntime = params[7].asString();
+        job.clean = params[8].asBool();
+        board.notifies++;
+        board.notify_at = std::chrono::steady_clock::now();
+    }
+    return true;
+}
+
+// Send a request and wait for its answer (notifications on the way are applied)
+static JsonValue request(Board& board, const std::string& method, const std::string& params) {
+    int id = board.next_id++;
+    JsonValue msg;
+    if (!send_line(board, "{\"id\":" + std::to_string(id) + ",\"method\":\"" + method + "\",\"params\":" + params +
+                              "}")) {
+        return msg;
+    }
+    while (read_message(board, msg)) {
+        if (msg["id"].type == JsonValue::NUMBER && (int)msg["id"].asNumber() == id) {
+            return msg;
+        }
+    }
+    return JsonValue();
+}
+
+// Read until the board has seen (count) notifies in total
+static bool wait_notifies(Board& board, int count) {
+    JsonValue msg;
+    while (board.notifies < count) {
+        if (!read_message(board, msg)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read until a clean notify (mempool updates on the way are skipped)
+static bool wait_clean_notify(Board& board) {
+    do {
+        if (!wait_notifies(board, board.notifies + 1)) {
+            return false;
+        }
+    } while (!board.job.clean);
+    return true;
+}
+
+// Stratum error code of an answer, 0 when accepted
+static int error_code(const JsonValue& reply) {
+    if (reply.type != JsonValue::OBJECT) {
+        return -1;
+    }
+    if (reply["error"].isNull()) {
+        return reply["result"].asBool() ? 0 : -1;
+    }
+    return (int)reply["error"][0].asNumber();
+}
+
+// The header a board hashes for a share, as src/stratum_client.cpp builds it
+static bool board_header(const Board& board, const std::string& extranonce2, uint32_t nonce,
+                         std::vector<uint8_t>& header) {
+    const Job& job = board.job;
+    std::vector<uint8_t> coinbase;
+    if (!hex_to_bytes(job.coinb1, coinbase) || !hex_to_bytes(board.extranonce1, coinbase) ||
+        !hex_to_bytes(extranonce2, coinbase) || !hex_to_bytes(job.coinb2, coinbase)) {
+        return false;
+    }
+    uint8_t root[32];
+    sha256d(coinbase.data(), coinbase.size(), root);
+    for (const std::string& branch_hex : job.branch) {
+        std::vector<uint8_t> node(root, root + 32);
+        if (!hex_to_bytes(branch_hex, node)) {
+            return false;
+        }
+        sha256d(node.data(), node.size(), root);
+    }
+    std::vector<uint8_t> prev;
+    if (!hex_to_bytes(job.prev_hash, prev) || prev.size() != 32) {
+        return false;
+    }
+    header.clear();
+    put_u32_le(header, (uint32_t)strtoul(job.version.c_str(), NULL, 16));
+    for (int word = 0; word < 8; word++) {
+        for (int i = 3; i >= 0; i--) {
+            header.push_back(prev[word * 4 + i]);
+        }
+    }
+    header.insert(header.end(), root, root + 32);
+    put_u32_le(header, (uint32_t)strtoul(job.ntime.c_str(), NULL, 16));
+    put_u32_le(header, (uint32_t)strtoul(job.nbits.c_str(), NULL, 16));
+    put_u32_le(header, nonce);
+    return true;
+}
+
+static long double hash_value(const uint8_t hash[32]) {
+    long double value = 0;
+    for (int i = 31; i >= 0; i--) {
+        value = value * 256.0L + hash[i];
+    }
+    return value;
+}
+
+static long double diff1 = 65535.0L * powl(2.0L, 208);
+
+// Network target from nbits, as a number
+static long double bits_target(const std::string& nbits) {
+    uint32_t bits = (uint32_t)strtoul(nbits.c_str(), NULL, 16);
+    return (long double)(bits & 0x007fffff) * powl(2.0L, 8 * ((int)(bits >> 24) - 3));
+}
+
+// Display (big-endian) hex of a header hash, as the node reports it
+static std::string display_hash(const uint8_t hash[32]) {
+    uint8_t display[32];
+    for (int i = 0; i < 32; i++) {
+        display[i] = hash[31 - i];
+    }
+    return to_hex(display, 32);
+}
+
+// Stratum prevhash -> the node's display form
+static std::string display_prev(const std::string& stratum_prev) {
+    std::vector<uint8_t> prev;
+    hex_to_bytes(stratum_prev, prev);
+    uint8_t header[32];
+    for (int word = 0; word < 8; word++) {
+        for (int i = 0; i < 4; i++) {
+            header[word * 4 + i] = prev[word * 4 + 3 - i];
+        }
+    }
+    return display_hash(header);
+}
+
+enum ShareKind { SHARE_LOW, SHARE_ONLY, SHARE_BLOCK };
+
+// First nonce whose hash is of the wanted kind
+static bool find_share(const Board& board, const std::string& extranonce2, ShareKind kind, uint32_t* nonce,
+                       uint8_t hash[32]) {
+    long double share_target = diff1 / board.difficulty;
+    long double network_target = bits_target(board.job.nbits);
+    std::vector<uint8_t> header;
+    for (uint32_t n = 0; n < 100000; n++) {
+        if (!board_header(board, extranonce2, n, header)) {
+            return false;
+        }
+        sha256d(header.data(), header.size(), hash);
+        long double value = hash_value(hash);
+        ShareKind got = value <= network_target ? SHARE_BLOCK : value <= share_target ? SHARE_ONLY : SHARE_LOW;
+        if (got == kind) {
+            *nonce = n;
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::string submit_params(const Board& board, const std::string& job_id, const std::string& extranonce2,
+                                 uint32_t nonce) {
+    char nonce_hex[9];
+    snprintf(nonce_hex, sizeof(nonce_hex), "%08x", nonce);
+    return "[\"bench\",\"" + job_id + "\",\"" + extranonce2 + "\",\"" + board.job.ntime + "\",\"" + nonce_hex + "\"]";
+}
+
+// Mine a block on the board's current job and check it lands on the node.
+// Returns the block hash (empty on failure); latencies go to share_ms / notify_ms.
+static std::string mine_block(std::vector<Board>& boards, int index, const char* extranonce2, double* share_ms,
+                              double* notify_ms) {
+    Board& board = boards[index];
+    uint32_t nonce;
+    uint8_t hash[32];
+    if (!find_share(board, extranonce2, SHARE_BLOCK, &nonce, hash)) {
+        check(false, "block candidate found");
+        return "";
+    }
+    std::string job_id = board.job.id;
+    auto start = std::chrono::steady_clock::now();
+    int code = error_code(request(board, "mining.submit", submit_params(board, job_id, extranonce2, nonce)));
+    *share_ms = ms_since(start);
+    check(code == 0, "block share answered true");
+    std::string block_hash = display_hash(hash);
+    check(rpc_call("getbestblockhash", "[]").asString() == block_hash, "block is the node's new tip");
+
+    // The clean notify on the new tip, at every board
+    bool all = true;
+    for (Board& other : boards) {
+        all &= wait_clean_notify(other) && display_prev(other.job.prev_hash) == block_hash;
+    }
+    *notify_ms = std::chrono::duration<double, std::milli>(board.notify_at - start).count();
+    check(all, "clean notify on the new tip reaches every board");
+
+    // The share again, now on an old tip
+    code = error_code(request(board, "mining.submit", submit_params(board, job_id, extranonce2, nonce)));
+    check(code == 21, "block share sent again is stale (21)");
+    return block_hash;
+}
+
+static void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-h host] [-p stratum_port] [-r rpc_port] [-n boards]\n", name);
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:r:n:")) != -1) {
+        switch (opt) {
+            case 'h': opt_host = optarg; break;
+            case 'p': opt_port = atoi(optarg); break;
+            case 'r': opt_rpc_port = atoi(optarg); break;
+            case 'n': opt_boards = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (opt_boards < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    // Boards: subscribe, authorize, first difficulty and job
+    std::vector<Board> boards(opt_boards);
+    std::set<std::string> extranonces;
+    double first_job_ms = 0;
+    for (int i = 0; i < opt_boards; i++) {
+        Board& board = boards[i];
+        board.fd = connect_to(opt_port);
+        if (board.fd < 0) {
+            printf("❌ Cannot connect to the bridge at %s:%d\n", opt_host.c_str(), opt_port);
+            return 1;
+        }
+        struct timeval tv = {BENCH_TIMEOUT_MS / 1000, 0};
+        setsockopt(board.fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        auto start = std::chrono::steady_clock::now();
+        JsonValue sub = request(board, "mining.subscribe", "[\"bridge_bench/1.0\"]");
+        board.extranonce1 = sub["result"][1].asString();
+        board.extranonce2_size = (int)sub["result"][2].asNumber();
+        extranonces.insert(board.extranonce1);
+        bool authorized = error_code(request(board, "mining.authorize", "[\"bench.board\",\"x\"]")) == 0;
+        if (!authorized || !wait_notifies(board, 1)) {
+            printf("❌ Board %d: no job after authorize\n", i);
+            return 1;
+        }
+        first_job_ms = std::max(first_job_ms, ms_since(start));
+    }
+    check((int)extranonces.size() == opt_boards, "every board has its own extranonce1");
+    bool same_job = true;
+    for (Board& board : boards) {
+        same_job &= board.job.id == boards[0].job.id && board.difficulty == boards[0].difficulty &&
+                    board.extranonce2_size == 4 && board.extranonce1.size() == 8;
+    }
+    check(same_job, "4+4 byte extranonce, same difficulty and job on every board");
+    check(display_prev(boards[0].job.prev_hash) == rpc_call("getbestblockhash", "[]").asString(),
+          "job prevhash is the node's tip");
+    double network_difficulty = (double)(diff1 / bits_target(boards[0].job.nbits));
+    printf("   share difficulty %.4g, network %.4g\n", boards[0].difficulty, network_difficulty);
+    check(boards[0].difficulty <= network_difficulty * 1.000001, "share difficulty capped at the network's");
+
+    // Refused shares
+    Board& board = boards[0];
+    check(error_code(request(board, "mining.submit", submit_params(board, "deadbeef", "00000000", 0))) == 21,
+          "unknown job is stale (21)");
+    check(error_code(request(board, "mining.submit", submit_params(board, board.job.id, "0000", 0))) == 20,
+          "short extranonce2 is malformed (20)");
+    uint32_t nonce;
+    uint8_t hash[32];
+    if (find_share(board, "00000001", SHARE_LOW, &nonce, hash)) {
+        check(error_code(request(board, "mining.submit", submit_params(board, board.job.id, "00000001", nonce))) ==
+                  23,
+              "share under the share difficulty (23)");
+    } else {
+        printf("⚠️  Every hash meets the share difficulty: low difficulty check skipped\n");
+    }
+    if (find_share(board, "00000002", SHARE_ONLY, &nonce, hash)) {
+        std::string params = submit_params(board, board.job.id, "00000002", nonce);
+        check(error_code(request(board, "mining.submit", params)) == 0, "share that is not a block accepted");
+        check(error_code(request(board, "mining.submit", params)) == 22, "same share again is a duplicate (22)");
+    } else {
+        printf("⚠️  Share difficulty = network difficulty: duplicate check skipped (run the bridge with -d 3e-10)\n");
+    }
+
+    // Blocks from two different boards
+    double share_ms[2], notify_ms[2];
+    std::string first = mine_block(boards, 0, "0000000a", &share_ms[0], &notify_ms[0]);
+    std::string second = mine_block(boards, 1, "0000000b", &share_ms[1], &notify_ms[1]);
+    check(!first.empty() && !second.empty() && first != second, "two blocks from two boards");
+
+    printf("┌────────────────── Bridge bench ──────────────────┐\n");
+    printf("│ Boards: %-4d    Connect -> first job: %7.2f ms │\n", opt_boards, first_job_ms);
+    printf("│ Block share answer:   %7.2f / %7.2f ms       │\n", share_ms[0], share_ms[1]);
+    printf("│ Block -> clean notify: %7.2f / %7.2f ms      │\n", notify_ms[0], notify_ms[1]);
+    printf("└──────────────────────────────────────────────────┘\n");
+
+    for (Board& b : boards) {
+        close(b.fd);
+    }
+    if (failures) {
+        printf("❌ %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,1047 @@
+// GBT-to-Stratum solo bridge for a fleet of TzCoinMiner boards on one LAN.
+//
+// Holds the node side of solo mining once for the whole fleet: a keep-alive
+// JSON-RPC session that long-polls getblocktemplate, the template parsed with
+// the board's own streaming parser (src/gbt_parser.cpp), and the coinbase and
+// merkle branch built once per template with src/solo_block.cpp. The boards
+// speak plain Stratum V1 to the bridge through src/stratum_client.cpp and
+// never see a template:
+//   - the 8-byte extranonce of the solo coinbase is split into a 4-byte
+//     extranonce1, unique per board, and a 4-byte extranonce2 the board rolls,
+//     so coinb1/coinb2 are the solo coinbase cut around it
+//   - a new tip is a clean mining.notify, a mempool change a non-clean one
+//   - shares are rebuilt and checked like a pool does; a share that meets
+//     the network target becomes a submitblock, streamed from the template's
+//     transaction store by solo_submit_body_read() on a second keep-alive
+//     session, and the jobs on the old tip are dropped at once
+// The share difficulty is capped at the network difficulty so every block
+// candidate reaches the bridge.
+//
+// Build: see README.md
+// Usage: solo_bridge -w <payout address> [options]  (see usage() below)
+
+#include "../common/mini_json.h"
+#include "btc_address.h"
+#include "gbt_parser.h"
+#include "merkle.h"
+#include "solo_block.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BRIDGE_DEFAULT_LISTEN_PORT 3333
+#define BRIDGE_EXTRANONCE1_SIZE    4       // Per board; the rest of SOLO_EXTRANONCE_SIZE is extranonce2
+#define BRIDGE_EXTRANONCE2_SIZE    (SOLO_EXTRANONCE_SIZE - BRIDGE_EXTRANONCE1_SIZE)
+#define BRIDGE_MAX_JOBS            8       // Jobs on the current tip still accepted for submits
+#define BRIDGE_MAX_LINE            16384   // Longest accepted Stratum line
+#define BRIDGE_TX_STORE_BYTES      (4 * 1024 * 1024)   // Largest template kept with its transactions
+#define BRIDGE_RETRY_MS            2000    // Pause after a failed getblocktemplate
+#define BRIDGE_POLL_MS             5000    // Template refresh when the node has no long-poll
+#define BRIDGE_STATS_INTERVAL_MS   60000
+
+// Stratum error codes
+#define ERR_OTHER      20
+#define ERR_STALE      21
+#define ERR_DUPLICATE  22
+#define ERR_LOW_DIFF   23
+#define ERR_UNAUTH     24
+#define ERR_NOT_SUBSCRIBED 25
+
+// One keep-alive HTTP/1.1 connection to the node
+struct NodeSession {
+    int fd = -1;
+    bool reused = false;             // The connection already served a request
+};
+
+// Template as handed out to the boards: parsed once, coinbase built once
+struct Template {
+    BitcoinBlockTemplate tmpl;
+    std::vector<uint8_t> txs;        // Serialized transactions (tmpl.tx_data points here)
+    solo_coinbase_t cb;              // Extranonce bytes are filled in per share
+    uint8_t prev[32];                // Header byte order
+    uint8_t target[32];
+    double difficulty;               // Network difficulty
+};
+
+// Job as sent in mining.notify
+struct Job {
+    std::string id;
+    std::shared_ptr<Template> tpl;
+    std::string notify_line;
+    double difficulty;               // Share difficulty in force for this job
+    std::set<std::string> seen;      // Duplicate detection (en1:en2:ntime:nonce)
+};
+
+// Board session
+struct Device {
+    int fd = -1;
+    std::string address;
+    std::string inbuf;
+    std::string outbuf;
+    bool subscribed = false;
+    bool authorized = false;
+    std::string extranonce1;
+    uint32_t accepted = 0;
+    uint32_t rejected = 0;
+    uint32_t blocks = 0;
+};
+
+// Configuration
+static std::string node_host = "127.0.0.1";
+static uint16_t node_port = 18443;
+static std::string node_auth;        // "Basic ..." header value, empty = none
+static std::string payout_address;
+static uint8_t payout_script[BTC_SCRIPT_MAX];
+static int payout_script_len = 0;
+static uint16_t listen_port = BRIDGE_DEFAULT_LISTEN_PORT;
+static double opt_difficulty = 0.001;
+
+// Node side (template thread) -> Stratum side (main thread)
+static std::mutex template_mutex;
+static std::shared_ptr<Template> pending_template;
+static int wake_pipe[2] = {-1, -1};
+static std::atomic<bool> refresh_now(false);   // Our block moved the tip: skip the poll wait
+
+// Stratum state
+static std::map<int, Device> devices;
+static std::vector<Job> jobs;        // Oldest first; cleared on a new tip
+static uint32_t next_job_id = 1;
+static uint32_t next_extranonce1 = 0;
+static double current_difficulty = 0;
+static std::string difficulty_line;
+static NodeSession submit_session;
+static volatile bool running = true;
+
+// Statistics
+static uint64_t stat_templates = 0;
+static uint64_t stat_notifies = 0;
+static uint64_t stat_accepted = 0;
+static uint64_t stat_rejected = 0;
+static uint64_t stat_blocks_found = 0;
+static uint64_t stat_blocks_accepted = 0;
+static uint64_t stat_template_ms_total = 0;    // getblocktemplate answer -> parsed + coinbase built
+static uint64_t stat_submit_ms_max = 0;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static std::string to_hex(const uint8_t* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(len * 2);
+    for (size_t i = 0; i < len; i++) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 15];
+    }
+    return out;
+}
+
+static std::string u32_hex(uint32_t value) {
+    char buf[9];
+    snprintf(buf, sizeof(buf), "%08x", value);
+    return buf;
+}
+
+static bool hex_to_bytes(const std::string& hex, uint8_t* out, size_t len) {
+    if (hex.size() != len * 2) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        char* end = NULL;
+        std::string pair = hex.substr(i * 2, 2);
+        unsigned long b = strtoul(pair.c_str(), &end, 16);
+        if (*end != '\0') {
+            return false;
+        }
+        out[i] = (uint8_t)b;
+    }
+    return true;
+}
+
+static std::string base64(const std::string& in) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < in.size(); i += 3) {
+        uint32_t n = (uint8_t)in[i] << 16;
+        if (i + 1 < in.size()) n |= (uint8_t)in[i + 1] << 8;
+        if (i + 2 < in.size()) n |= (uint8_t)in[i + 2];
+        out += table[(n >> 18) & 63];
+        out += table[(n >> 12) & 63];
+        out += i + 1 < in.size() ? table[(n >> 6) & 63] : '=';
+        out += i + 2 < in.size() ? table[n & 63] : '=';
+    }
+    return out;
+}
+
+// A 256-bit little-endian number (hash or target) as a float
+static long double le256_value(const uint8_t value[32]) {
+    long double result = 0;
+    for (int i = 31; i >= 0; i--) {
+        result = result * 256.0L + value[i];
+    }
+    return result;
+}
+
+// Difficulty of a hash or target, as pools compute it (diff1 target / value)
+static double difficulty_of(const uint8_t value[32]) {
+    long double v = le256_value(value);
+    if (v == 0) {
+        return INFINITY;
+    }
+    return (double)(65535.0L * powl(2.0L, 208) / v);
+}
+
+// ---------------------------------------------------------------------------
+// Node side: keep-alive JSON-RPC over HTTP/1.1
+// ---------------------------------------------------------------------------
+
+static void node_close(NodeSession& s) {
+    if (s.fd >= 0) {
+        close(s.fd);
+        s.fd = -1;
+    }
+    s.reused = false;
+}
+
+static bool node_connect(NodeSession& s) {
+    struct addrinfo hints = {};
+    struct addrinfo* res = NULL;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(node_host.c_str(), std::to_string(node_port).c_str(), &hints, &res) != 0) {
+        return false;
+    }
+    s.fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (s.fd < 0 || connect(s.fd, res->ai_addr, res->ai_addrlen) < 0) {
+        freeaddrinfo(res);
+        node_close(s);
+        return false;
+    }
+    freeaddrinfo(res);
+    int one = 1;
+    setsockopt(s.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return true;
+}
+
+static bool send_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+// Wait for the next bytes; long-polls can take minutes, so check running twice a second
+static ssize_t recv_some(int fd, char* buf, size_t len) {
+    while (running) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, 500);
+        if (ready < 0 && errno != EINTR) {
+            return -1;
+        }
+        if (ready > 0) {
+            return recv(fd, buf, len, 0);
+        }
+    }
+    return -1;
+}
+
+// Value of an HTTP header in the response head, empty when absent
+static std::string header_value(const std::string& head, const char* name) {
+    size_t pos = 0;
+    size_t name_len = strlen(name);
+    while ((pos = head.find("\r\n", pos)) != std::string::npos) {
+        pos += 2;
+        if (strncasecmp(head.c_str() + pos, name, name_len) == 0 && head[pos + name_len] == ':') {
+            size_t start = head.find_first_not_of(' ', pos + name_len + 1);
+            size_t end = head.find("\r\n", start);
+            return head.substr(start, end - start);
+        }
+    }
+    return "";
+}
+
+// One request/response on the session. Returns the HTTP status, -1 on
+// failure; *answered tells whether the node had started to reply.
+static int node_exchange(NodeSession& s, const std::string& payload, const solo_submit_body_t* stream,
+                         std::string& reply, bool* answered) {
+    *answered = false;
+    size_t body_len = stream ? stream->body_len : payload.size();
+    std::string head = "POST / HTTP/1.1\r\nHost: " + node_host + "\r\nContent-Type: application/json\r\n"
+                       "Content-Length: " + std::to_string(body_len) + "\r\n";
+    if (!node_auth.empty()) {
+        head += "Authorization: " + node_auth + "\r\n";
+    }
+    head += "\r\n";
+    if (!send_all(s.fd, head.data(), head.size())) {
+        return -1;
+    }
+    if (stream) {
+        // The block goes out as it is generated: header, coinbase and the template's store
+        solo_submit_body_t cursor = *stream;
+        char chunk[16384];
+        size_t got;
+        while ((got = solo_submit_body_read(&cursor, chunk, sizeof(chunk))) > 0) {
+            if (!send_all(s.fd, chunk, got)) {
+                return -1;
+            }
+        }
+    } else if (!send_all(s.fd, payload.data(), payload.size())) {
+        return -1;
+    }
+
+    std::string response;
+    size_t split;
+    char chunk[16384];
+    while ((split = response.find("\r\n\r\n")) == std::string::npos) {
+        ssize_t n = recv_some(s.fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            return -1;
+        }
+        *answered = true;
+        response.append(chunk, n);
+    }
+    std::string head_in = response.substr(0, split + 2);
+    reply = response.substr(split + 4);
+    if (head_in.compare(0, 5, "HTTP/") != 0) {
+        return -1;
+    }
+    int status = atoi(head_in.c_str() + head_in.find(' ') + 1);
+
+    std::string length = header_value(head_in, "Content-Length");
+    bool keep = head_in.compare(0, 8, "HTTP/1.1") == 0 && strcasecmp(header_value(head_in, "Connection").c_str(),
+                                                                      "close") != 0;
+    if (!header_value(head_in, "Transfer-Encoding").empty()) {
+        return -1;                      // bitcoind always sends Content-Length
+    }
+    if (length.empty()) {
+        // No length: the body ends with the connection
+        ssize_t n;
+        while ((n = recv_some(s.fd, chunk, sizeof(chunk))) > 0) {
+            reply.append(chunk, n);
+        }
+        keep = false;
+    } else {
+        size_t want = strtoul(length.c_str(), NULL, 10);
+        while (reply.size() < want) {
+            ssize_t n = recv_some(s.fd, chunk, sizeof(chunk));
+            if (n <= 0) {
+                return -1;
+            }
+            reply.append(chunk, n);
+        }
+        reply.resize(want);
+    }
+    if (!keep) {
+        node_close(s);
+    } else {
+        s.reused = true;
+    }
+    return status;
+}
+
+// POST a JSON-RPC body (or a streamed submitblock body). A reused connection
+// the node closed while idle (rpcservertimeout) is reopened once and the
+// request sent again. Returns the HTTP status, -1 on failure.
+static int node_post(NodeSession& s, const std::string& payload, const solo_submit_body_t* stream,
+                     std::string& reply) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (s.fd < 0 && !node_connect(s)) {
+            return -1;
+        }
+        bool reused = s.reused;
+        bool answered = false;
+        int status = node_exchange(s, payload, stream, reply, &answered);
+        if (status >= 0) {
+            return status;
+        }
+        node_close(s);
+        if (!reused || answered || !running) {
+            return -1;
+        }
+    }
+    return -1;
+}
+
+// Parse a getblocktemplate answer and build the coinbase: the only template
+// work in the fleet. NULL (with a message) when the template is unusable.
+static std::shared_ptr<Template> build_template(const std::string& body, std::vector<uint8_t>& store) {
+    static gbt_parser_t parser;
+    std::shared_ptr<Template> tpl = std::make_shared<Template>();
+    gbt_parser_init(&parser, &tpl->tmpl);
+    gbt_parser_set_tx_store(&parser, store.data(), store.size());
+    for (size_t pos = 0; pos < body.size(); pos += 4096) {
+        if (!gbt_parser_feed(&parser, body.data() + pos, std::min<size_t>(4096, body.size() - pos))) {
+            break;
+        }
+    }
+    if (!gbt_parser_finish(&parser)) {
+        printf("❌ Template rejected: %s\n", gbt_parser_error(&parser));
+        return NULL;
+    }
+    if (!tpl->tmpl.tx_data_complete) {
+        printf("⚠️  Template transactions exceed %d MB: mining a coinbase-only block\n",
+               BRIDGE_TX_STORE_BYTES / (1024 * 1024));
+        gbt_template_drop_transactions(&tpl->tmpl);
+    }
+    tpl->txs.assign(tpl->tmpl.tx_data, tpl->tmpl.tx_data + tpl->tmpl.tx_data_len);
+    tpl->tmpl.tx_data = tpl->txs.data();
+
+    if (!solo_coinbase_build(&tpl->cb, &tpl->tmpl, payout_script, payout_script_len)) {
+        printf("❌ Coinbase does not fit in %d bytes\n", SOLO_COINBASE_MAX);
+        return NULL;
+    }
+    gbt_hex_to_hash(tpl->tmpl.previousblockhash, tpl->prev);
+    solo_target_from_bits(tpl->tmpl.bits, tpl->target);
+    tpl->difficulty = difficulty_of(tpl->target);
+    return tpl;
+}
+
+// Same work as the last template handed out: nothing to notify
+static bool same_template(const Template* a, const Template* b) {
+    if (!a || !b || strcmp(a->tmpl.previousblockhash, b->tmpl.previousblockhash) != 0) {
+        return false;
+    }
+    if (a->tmpl.longpollid[0]) {
+        return strcmp(a->tmpl.longpollid, b->tmpl.longpollid) == 0;
+    }
+    return a->tmpl.transactions_count == b->tmpl.transactions_count &&
+           a->tmpl.coinbasevalue == b->tmpl.coinbasevalue;
+}
+
+// Template thread: one session to the node, long-polling for new work
+static void template_loop(void) {
+    NodeSession session;
+    std::vector<uint8_t> store(BRIDGE_TX_STORE_BYTES);
+    std::shared_ptr<Template> last;
+    std::string longpollid;
+
+    while (running) {
+        std::string params = "[{\"rules\":[\"segwit\"]";
+        if (!longpollid.empty()) {
+            params += ",\"longpollid\":" + json_quote(longpollid);
+        }
+        params += "}]";
+        std::string body;
+        int status = node_post(session,
+                               "{\"jsonrpc\":\"1.0\",\"id\":\"bridge\",\"method\":\"getblocktemplate\",\"params\":" +
+                                   params + "}",
+                               NULL, body);
+        if (!running) {
+            break;
+        }
+        uint64_t start = now_ms();
+        std::shared_ptr<Template> tpl = status > 0 ? build_template(body, store) : NULL;
+        if (!tpl) {
+            if (status <= 0) {
+                printf("⚠️  getblocktemplate from %s:%u failed, retrying\n", node_host.c_str(), node_port);
+            }
+            longpollid.clear();
+            usleep(BRIDGE_RETRY_MS * 1000);
+            continue;
+        }
+        uint64_t elapsed = now_ms() - start;
+        longpollid = tpl->tmpl.longpollid;
+
+        if (!same_template(tpl.get(), last.get())) {
+            printf("📋 Template %u: %d transactions, %.8f BTC, %zu-byte coinbase (%llu ms)\n", tpl->tmpl.height,
+                   tpl->tmpl.transactions_count, tpl->tmpl.coinbasevalue / 1e8, tpl->cb.len,
+                   (unsigned long long)elapsed);
+            last = tpl;
+            {
+                std::lock_guard<std::mutex> lock(template_mutex);
+                pending_template = tpl;
+                stat_templates++;
+                stat_template_ms_total += elapsed;
+            }
+            char wake = 1;
+            if (write(wake_pipe[1], &wake, 1) < 0) {
+                perror("write");
+            }
+        }
+        if (longpollid.empty()) {
+            // No long-poll on this node: poll for a new tip
+            for (int waited = 0; waited < BRIDGE_POLL_MS && running; waited += 100) {
+                if (refresh_now.exchange(false)) {
+                    break;
+                }
+                usleep(100 * 1000);
+            }
+        }
+    }
+    node_close(session);
+}
+
+// ---------------------------------------------------------------------------
+// Stratum side
+// ---------------------------------------------------------------------------
+
+static void set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+// Write as much of the buffer as the socket accepts, keep the rest for POLLOUT
+static bool flush_buffer(int fd, std::string& buf) {
+    while (!buf.empty()) {
+        ssize_t n = send(fd, buf.data(), buf.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            buf.erase(0, n);
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read available bytes; false when the peer closed or errored
+static bool read_socket(int fd, std::string& buf) {
+    char chunk[4096];
+    while (true) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            buf.append(chunk, n);
+            if (buf.size() > BRIDGE_MAX_LINE * 4) {
+                return false;
+            }
+        } else if (n == 0) {
+            return false;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+// Pop the next complete line from a receive buffer
+static bool next_line(std::string& buf, std::string& line) {
+    size_t nl = buf.find('\n');
+    if (nl == std::string::npos) {
+        return false;
+    }
+    line = buf.substr(0, nl);
+    buf.erase(0, nl + 1);
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+        line.pop_back();
+    }
+    return true;
+}
+
+static void send_line(Device& device, const std::string& line) {
+    device.outbuf += line;
+    device.outbuf += "\n";
+}
+
+static void send_result(Device& device, const std::string& id, const char* result) {
+    send_line(device, "{\"id\":" + id + ",\"result\":" + result + ",\"error\":null}");
+}
+
+static void send_error(Device& device, const std::string& id, int code, const char* message) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", code);
+    send_line(device, "{\"id\":" + id + ",\"result\":null,\"error\":[" + buf + "," + json_quote(message) + ",null]}");
+}
+
+static void broadcast(const std::string& line) {
+    for (auto& entry : devices) {
+        if (entry.second.authorized) {
+            send_line(entry.second, line);
+        }
+    }
+}
+
+// mining.notify for a template: coinb1/coinb2 are the solo coinbase cut
+// around its extranonce, the branch and prevhash in Stratum byte order
+static std::string notify_line(const std::string& id, const Template& tpl, bool clean) {
+    const solo_coinbase_t& cb = tpl.cb;
+    std::string coinb1 = to_hex(cb.data, cb.extranonce_offset);
+    size_t tail = cb.extranonce_offset + SOLO_EXTRANONCE_SIZE;
+    std::string coinb2 = to_hex(cb.data + tail, cb.len - tail);
+
+    // Stratum sends prevhash as 8 words with their bytes swapped
+    uint8_t prev[32];
+    for (int word = 0; word < 8; word++) {
+        for (int i = 0; i < 4; i++) {
+            prev[word * 4 + i] = tpl.prev[word * 4 + 3 - i];
+        }
+    }
+    std::string branch = "[";
+    for (int i = 0; i < tpl.tmpl.merkle_branch_len; i++) {
+        if (i > 0) branch += ",";
+        branch += "\"" + to_hex(tpl.tmpl.merkle_branch[i], 32) + "\"";
+    }
+    branch += "]";
+    return "{\"id\":null,\"method\":\"mining.notify\",\"params\":[" + json_quote(id) + ",\"" + to_hex(prev, 32) +
+           "\",\"" + coinb1 + "\",\"" + coinb2 + "\"," + branch + ",\"" + u32_hex(tpl.tmpl.version) + "\",\"" +
+           u32_hex(tpl.tmpl.bits) + "\",\"" + u32_hex(tpl.tmpl.curtime) + "\"," + (clean ? "true" : "false") + "]}";
+}
+
+// A template from the node thread becomes the current job for every board
+static void publish_template(std::shared_ptr<Template> tpl) {
+    bool clean = jobs.empty() || strcmp(jobs.back().tpl->tmpl.previousblockhash, tpl->tmpl.previousblockhash) != 0;
+    if (clean) {
+        jobs.clear();
+    }
+
+    // Never above the network difficulty: every block candidate must come back
+    double difficulty = std::min(opt_difficulty, tpl->difficulty);
+    if (difficulty != current_difficulty) {
+        current_difficulty = difficulty;
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.10g", difficulty);
+        difficulty_line = std::string("{\"id\":null,\"method\":\"mining.set_difficulty\",\"params\":[") + buf + "]}";
+        broadcast(difficulty_line);
+    }
+
+    Job job;
+    char id_buf[16];
+    snprintf(id_buf, sizeof(id_buf), "%x", next_job_id++);
+    job.id = id_buf;
+    job.tpl = tpl;
+    job.difficulty = difficulty;
+    job.notify_line = notify_line(job.id, *tpl, clean);
+    jobs.push_back(job);
+    if (jobs.size() > BRIDGE_MAX_JOBS) {
+        jobs.erase(jobs.begin());
+    }
+
+    broadcast(job.notify_line);
+    stat_notifies++;
+    printf("📬 Notify job %s on block %u (%s, %zu boards)\n", job.id.c_str(), tpl->tmpl.height,
+           clean ? "clean" : "non-clean", devices.size());
+}
+
+static Job* find_job(const std::string& id) {
+    for (Job& job : jobs) {
+        if (job.id == id) {
+            return &job;
+        }
+    }
+    return NULL;
+}
+
+// Send a block candidate to the node. true when accepted.
+static bool submit_block(const Template& tpl, const uint8_t header[80], const solo_coinbase_t* cb,
+                         const uint8_t hash[32]) {
+    uint8_t display[32];
+    for (int i = 0; i < 32; i++) {
+        display[i] = hash[31 - i];
+    }
+    printf("🎯 Block candidate %u: %s\n", tpl.tmpl.height, to_hex(display, 32).c_str());
+    stat_blocks_found++;
+
+    solo_submit_body_t stream;
+    solo_submit_body_init(&stream, header, cb, &tpl.tmpl);
+    std::string body;
+    uint64_t start = now_ms();
+    int status = node_post(submit_session, "", &stream, body);
+    uint64_t elapsed = now_ms() - start;
+    stat_submit_ms_max = std::max(stat_submit_ms_max, elapsed);
+
+    JsonValue doc;
+    if (status < 0 || !json_parse(body, doc)) {
+        printf("❌ submitblock: no answer from the node\n");
+        return false;
+    }
+    if (!doc["error"].isNull()) {
+        printf("❌ submitblock: %s\n", doc["error"]["message"].asString().c_str());
+        return false;
+    }
+    if (!doc["result"].isNull()) {
+        printf("❌ Block rejected: %s\n", doc["result"].asString().c_str());
+        return false;
+    }
+    stat_blocks_accepted++;
+    printf("🎉 Block %u accepted (%zu bytes, %llu ms)\n", tpl.tmpl.height, stream.block_size,
+           (unsigned long long)elapsed);
+    return true;
+}
+
+static void handle_submit(Device& device, const std::string& id, const JsonValue& params) {
+    if (!device.authorized) {
+        send_error(device, id, ERR_UNAUTH, "Unauthorized worker");
+        device.rejected++;
+        stat_rejected++;
+        return;
+    }
+    if (params.size() < 5) {
+        send_error(device, id, ERR_OTHER, "Invalid params");
+        device.rejected++;
+        stat_rejected++;
+        return;
+    }
+    const std::string& job_id = params[1].asString();
+    const std::string& extranonce2 = params[2].asString();
+    const std::string& ntime = params[3].asString();
+    const std::string& nonce = params[4].asString();
+
+    Job* job = find_job(job_id);
+    if (!job) {
+        send_error(device, id, ERR_STALE, "Job not found");
+        device.rejected++;
+        stat_rejected++;
+        return;
+    }
+
+    // The board's coinbase: the template's, with its extranonce1 and extranonce2
+    solo_coinbase_t cb = job->tpl->cb;
+    uint8_t* extranonce = cb.data + cb.extranonce_offset;
+    uint8_t word[4];
+    if (!hex_to_bytes(device.extranonce1, extranonce, BRIDGE_EXTRANONCE1_SIZE) ||
+        !hex_to_bytes(extranonce2, extranonce + BRIDGE_EXTRANONCE1_SIZE, BRIDGE_EXTRANONCE2_SIZE) ||
+        !hex_to_bytes(ntime, word, 4) || !hex_to_bytes(nonce, word, 4)) {
+        send_error(device, id, ERR_OTHER, "Invalid share format");
+        device.rejected++;
+        stat_rejected++;
+        return;
+    }
+
+    const BitcoinBlockTemplate& tmpl = job->tpl->tmpl;
+    uint8_t txid[32];
+    uint8_t header[80];
+    merkle_sha256d(cb.data, cb.len, txid);
+    merkle_root_from_branch(txid, tmpl.merkle_branch, tmpl.merkle_branch_len, header + 36);
+    uint32_t fields[3] = {(uint32_t)strtoul(ntime.c_str(), NULL, 16), tmpl.bits,
+                          (uint32_t)strtoul(nonce.c_str(), NULL, 16)};
+    memcpy(header, &tmpl.version, 4);
+    memcpy(header + 4, job->tpl->prev, 32);
+    memcpy(header + 68, fields, 12);
+    uint8_t hash[32];
+    merkle_sha256d(header, 80, hash);
+
+    bool block = solo_hash_meets_target(hash, job->tpl->target);
+    double share_diff = difficulty_of(hash);
+    if (!block && share_diff < job->difficulty) {
+        send_error(device, id, ERR_LOW_DIFF, "Low difficulty share");
+        device.rejected++;
+        stat_rejected++;
+        return;
+    }
+    if (!job->seen.insert(device.extranonce1 + ":" + extranonce2 + ":" + ntime + ":" + nonce).second) {
+        send_error(device, id, ERR_DUPLICATE, "Duplicate share");
+        device.rejected++;
+        stat_rejected++;
+        return;
+    }
+
+    send_result(device, id, "true");
+    device.accepted++;
+    stat_accepted++;
+    if (!block) {
+        return;
+    }
+
+    // Keep the template alive through the submit: a new tip clears the jobs
+    std::shared_ptr<Template> tpl = job->tpl;
+    if (submit_block(*tpl, header, &cb, hash)) {
+        device.blocks++;
+        // The tip moved: work on the old one is wasted until the new template arrives
+        jobs.clear();
+        refresh_now = true;
+    }
+}
+
+static void handle_line(Device& device, const std::string& line) {
+    JsonValue msg;
+    if (!json_parse(line, msg) || msg.type != JsonValue::OBJECT) {
+        printf("⚠️  %s: invalid JSON\n", device.address.c_str());
+        return;
+    }
+    std::string id = msg["id"].dump();
+    const std::string& method = msg["method"].asString();
+
+    if (method == "mining.subscribe") {
+        device.extranonce1 = u32_hex(next_extranonce1++);
+        device.subscribed = true;
+        char size_buf[8];
+        snprintf(size_buf, sizeof(size_buf), "%d", BRIDGE_EXTRANONCE2_SIZE);
+        send_line(device, "{\"id\":" + id + ",\"result\":[[[\"mining.set_difficulty\",\"1\"],"
+                          "[\"mining.notify\",\"1\"]]," + json_quote(device.extranonce1) + "," + size_buf +
+                          "],\"error\":null}");
+    } else if (method == "mining.authorize") {
+        if (!device.subscribed) {
+            send_error(device, id, ERR_NOT_SUBSCRIBED, "Not subscribed");
+            return;
+        }
+        device.authorized = true;
+        send_result(device, id, "true");
+        printf("🔑 %s authorized as %s (extranonce1 %s)\n", device.address.c_str(),
+               msg["params"][0].asString().c_str(), device.extranonce1.c_str());
+        // Bring the board up to date with the current difficulty and job
+        if (!jobs.empty()) {
+            send_line(device, difficulty_line);
+            send_line(device, jobs.back().notify_line);
+        }
+    } else if (method == "mining.submit") {
+        handle_submit(device, id, msg["params"]);
+    } else if (!msg["id"].isNull()) {
+        send_error(device, id, ERR_OTHER, "Unsupported method");
+    }
+}
+
+static int listen_socket(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 128) < 0) {
+        close(fd);
+        return -1;
+    }
+    set_nonblocking(fd);
+    return fd;
+}
+
+static void accept_devices(int listen_fd) {
+    while (true) {
+        struct sockaddr_in addr;
+        socklen_t len = sizeof(addr);
+        int fd = accept(listen_fd, (struct sockaddr*)&addr, &len);
+        if (fd < 0) {
+            return;
+        }
+        set_nonblocking(fd);
+        Device& device = devices[fd];
+        device.fd = fd;
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
+        device.address = std::string(ip) + ":" + std::to_string(ntohs(addr.sin_port));
+        printf("➕ Board %s connected (%zu total)\n", device.address.c_str(), devices.size());
+    }
+}
+
+static void close_device(int fd) {
+    auto it = devices.find(fd);
+    if (it == devices.end()) {
+        return;
+    }
+    printf("➖ Board %s disconnected (%u accepted, %u rejected, %u blocks)\n", it->second.address.c_str(),
+           it->second.accepted, it->second.rejected, it->second.blocks);
+    close(fd);
+    devices.erase(it);
+}
+
+static void print_stats(void) {
+    uint64_t templates, template_ms;
+    {
+        std::lock_guard<std::mutex> lock(template_mutex);
+        templates = stat_templates;
+        template_ms = stat_template_ms_total;
+    }
+    printf("┌────────────────── Bridge stats ──────────────────┐\n");
+    printf("│ Boards: %-5zu Templates: %-6llu Notifies: %-6llu │\n", devices.size(),
+           (unsigned long long)templates, (unsigned long long)stat_notifies);
+    printf("│ Shares ok: %-8llu rejected: %-8llu           │\n", (unsigned long long)stat_accepted,
+           (unsigned long long)stat_rejected);
+    printf("│ Blocks found: %-5llu accepted: %-5llu              │\n", (unsigned long long)stat_blocks_found,
+           (unsigned long long)stat_blocks_accepted);
+    printf("│ Template avg: %-6llu ms  Submit max: %-6llu ms   │\n",
+           (unsigned long long)(templates ? template_ms / templates : 0), (unsigned long long)stat_submit_ms_max);
+    printf("└──────────────────────────────────────────────────┘\n");
+    fflush(stdout);
+}
+
+static void usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s -w <payout address> [options]\n"
+            "  -w <address>     address the coinbase pays (required)\n"
+            "  -o <host>        node RPC host (default 127.0.0.1)\n"
+            "  -r <port>        node RPC port (default 18443)\n"
+            "  -u <user:pass>   node RPC credentials (default none)\n"
+            "  -p <port>        Stratum listen port (default 3333)\n"
+            "  -d <difficulty>  share difficulty, capped at the network's (default 0.001)\n",
+            name);
+}
+
+static void on_signal(int) {
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "w:o:r:u:p:d:h")) != -1) {
+        switch (opt) {
+            case 'w': payout_address = optarg; break;
+            case 'o': node_host = optarg; break;
+            case 'r': node_port = (uint16_t)atoi(optarg); break;
+            case 'u': node_auth = "Basic " + base64(optarg); break;
+            case 'p': listen_port = (uint16_t)atoi(optarg); break;
+            case 'd': opt_difficulty = atof(optarg); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (payout_address.empty() || opt_difficulty <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    payout_script_len = btc_address_to_script(payout_address.c_str(), payout_script, sizeof(payout_script));
+    if (payout_script_len < 0) {
+        fprintf(stderr, "❌ Invalid payout address: %s\n", payout_address.c_str());
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    int listen_fd = listen_socket(listen_port);
+    if (listen_fd < 0) {
+        fprintf(stderr, "❌ Cannot listen on port %u: %s\n", listen_port, strerror(errno));
+        return 1;
+    }
+    if (pipe(wake_pipe) < 0) {
+        perror("pipe");
+        return 1;
+    }
+    fcntl(wake_pipe[0], F_SETFL, O_NONBLOCK);
+
+    // Boards get distinct extranonce1 values across bridge restarts too
+    next_extranonce1 = (uint32_t)std::random_device()();
+
+    printf("🌉 Solo bridge on :%u -> node %s:%u, paying %s (%s)\n", listen_port, node_host.c_str(), node_port,
+           payout_address.c_str(), btc_script_type(payout_script, payout_script_len));
+
+    std::thread node_thread(template_loop);
+    uint64_t last_stats = now_ms();
+
+    while (running) {
+        std::vector<struct pollfd> fds;
+        fds.push_back({listen_fd, POLLIN, 0});
+        fds.push_back({wake_pipe[0], POLLIN, 0});
+        for (auto& entry : devices) {
+            fds.push_back({entry.first, (short)(POLLIN | (entry.second.outbuf.empty() ? 0 : POLLOUT)), 0});
+        }
+        if (poll(fds.data(), fds.size(), 1000) < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+
+        std::vector<int> to_close;
+        for (size_t i = 0; i < fds.size(); i++) {
+            short events = fds[i].revents;
+            if (events == 0) {
+                continue;
+            }
+            if (fds[i].fd == listen_fd) {
+                accept_devices(listen_fd);
+                continue;
+            }
+            if (fds[i].fd == wake_pipe[0]) {
+                char drain[64];
+                while (read(wake_pipe[0], drain, sizeof(drain)) > 0) {
+                }
+                std::shared_ptr<Template> tpl;
+                {
+                    std::lock_guard<std::mutex> lock(template_mutex);
+                    tpl.swap(pending_template);
+                }
+                if (tpl) {
+                    publish_template(tpl);
+                }
+                continue;
+            }
+
+            auto it = devices.find(fds[i].fd);
+            if (it == devices.end()) {
+                continue;
+            }
+            bool ok = true;
+            if (events & (POLLIN | POLLHUP | POLLERR)) {
+                ok = read_socket(it->second.fd, it->second.inbuf);
+                std::string line;
+                while (next_line(it->second.inbuf, line)) {
+                    if (line.size() > BRIDGE_MAX_LINE) {
+                        ok = false;
+                        break;
+                    }
+                    if (!line.empty()) {
+                        handle_line(it->second, line);
+                    }
+                }
+            }
+            if (ok && (events & POLLOUT)) {
+                ok = flush_buffer(it->second.fd, it->second.outbuf);
+            }
+            if (!ok) {
+                to_close.push_back(it->first);
+            }
+        }
+        for (int fd : to_close) {
+            close_device(fd);
+        }
+
+        // Push out what this round queued (notify fan-out, submit answers)
+        to_close.clear();
+        for (auto& entry : devices) {
+            if (!flush_buffer(entry.second.fd, entry.second.outbuf)) {
+                to_close.push_back(entry.first);
+            }
+        }
+        for (int fd : to_close) {
+            close_device(fd);
+        }
+
+        if (now_ms() - last_stats >= BRIDGE_STATS_INTERVAL_MS) {
+            last_stats = now_ms();
+            print_stats();
+        }
+    }
+
+    node_thread.join();
+    print_stats();
+    node_close(submit_session);
+    while (!devices.empty()) {
+        close_device(devices.begin()->first);
+    }
+    close(listen_fd);
+    return 0;
+}
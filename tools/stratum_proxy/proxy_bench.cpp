@@ -0,0 +1,419 @@
+// Load test of the Stratum proxy.
+//
+// Connects many simulated boards to a running stratum_proxy whose upstream is
+// the local pool_emulator, plus one reference connection straight to the
+// emulator. Every board subscribes, authorizes and then submits shares as
+// fast as the answers come back (one share in flight per board), or at a
+// fixed rate with -r. The
+// emulator must run with a share difficulty low enough that every hash is a
+// share (-d 1e-10), so the shares need no hashing here.
+//
+// Measured:
+//   - fan-out latency: time from the reference connection receiving a
+//     mining.notify to each board receiving the same job through the proxy
+//     (the emulator sends both at the same moment). The reference is read on
+//     its own thread, and board messages are timestamped when received, not
+//     when parsed, so the bench's own work stays out of the figure.
+//   - share throughput: accepted shares per second through the proxy, and the
+//     submit round trip seen by the boards
+//   - connect -> first job for every board
+// Every board must receive every job the reference saw. The tool exits
+// non-zero if one is missing or a share is refused for another reason than a
+// stale job.
+//
+// Build: see README.md
+// Usage: proxy_bench [-h host] [-p proxy_port] [-P pool_port] [-n boards] [-t seconds] [-r shares/s]
+
+#include "../common/mini_json.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string opt_host = "127.0.0.1";
+static int opt_proxy_port = 3333;
+static int opt_pool_port = 3334;
+static int opt_boards = 200;
+static int opt_seconds = 30;
+static double opt_rate = 0;             // Shares per second per board (0 = as fast as answered)
+
+#define BENCH_SETUP_TIMEOUT_MS 10000
+#define BENCH_DRAIN_MS 500              // Wait for late notifies after the run
+
+typedef std::chrono::steady_clock Clock;
+
+static Clock::time_point start_time;
+
+static double now_ms(void) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start_time).count();
+}
+
+struct Board {
+    int fd = -1;
+    std::string inbuf;
+    std::string outbuf;
+    int next_id = 1;
+    bool authorized = false;
+    int extranonce2_size = 0;
+    std::string job_id;
+    std::string ntime;
+    double connect_ms = 0;
+    double recv_ms = 0;                      // Arrival of the data being parsed
+    double first_job_ms = -1;
+    std::map<std::string, double> job_seen;  // Job id -> arrival (ms)
+    bool submitting = false;
+    int submit_id = 0;
+    double submit_ms = 0;
+    double next_submit_ms = 0;
+    uint32_t nonce = 0;
+    uint32_t accepted = 0;
+    uint32_t stale = 0;
+    uint32_t rejected = 0;                   // Refused for another reason
+};
+
+static std::vector<double> share_rtt_ms;
+
+static int connect_to(int port) {
+    struct addrinfo hints = {};
+    struct addrinfo* res = NULL;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(opt_host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) {
+        return -1;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        freeaddrinfo(res);
+        close(fd);
+        return -1;
+    }
+    freeaddrinfo(res);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    return fd;
+}
+
+static int send_request(Board& board, const std::string& method, const std::string& params) {
+    int id = board.next_id++;
+    board.outbuf += "{\"id\":" + std::to_string(id) + ",\"method\":\"" + method + "\",\"params\":" + params + "}\n";
+    return id;
+}
+
+static void start_board(Board& board) {
+    send_request(board, "mining.subscribe", "[\"proxy_bench/1.0\"]");
+    send_request(board, "mining.authorize", "[\"bench.board\",\"x\"]");
+}
+
+static void submit_share(Board& board) {
+    if (board.submitting || board.job_id.empty()) {
+        return;
+    }
+    if (opt_rate > 0) {
+        double now = now_ms();
+        if (now < board.next_submit_ms) {
+            return;
+        }
+        board.next_submit_ms = std::max(board.next_submit_ms + 1000.0 / opt_rate, now);
+    }
+    char nonce_hex[9];
+    snprintf(nonce_hex, sizeof(nonce_hex), "%08x", board.nonce++);
+    std::string extranonce2(board.extranonce2_size * 2, '0');
+    board.submit_id = send_request(board, "mining.submit",
+                                   "[\"bench.board\",\"" + board.job_id + "\",\"" + extranonce2 + "\",\"" +
+                                       board.ntime + "\",\"" + nonce_hex + "\"]");
+    board.submit_ms = now_ms();
+    board.submitting = true;
+}
+
+static void handle_line(Board& board, const std::string& line) {
+    JsonValue msg;
+    if (!json_parse(line, msg)) {
+        return;
+    }
+    const std::string& method = msg["method"].asString();
+    if (method == "mining.notify") {
+        const JsonValue& params = msg["params"];
+        double now = board.recv_ms;
+        board.job_id = params[0].asString();
+        board.ntime = params[7].asString();
+        board.job_seen.emplace(board.job_id, now);
+        if (board.first_job_ms < 0) {
+            board.first_job_ms = now - board.connect_ms;
+        }
+        return;
+    }
+    if (!method.empty() || msg["id"].type != JsonValue::NUMBER) {
+        return;
+    }
+    int id = (int)msg["id"].asNumber();
+    if (id == 1) {
+        board.extranonce2_size = (int)msg["result"][2].asNumber();
+    } else if (id == 2) {
+        board.authorized = msg["result"].asBool();
+    } else if (board.submitting && id == board.submit_id) {
+        board.submitting = false;
+        share_rtt_ms.push_back(board.recv_ms - board.submit_ms);
+        if (msg["error"].isNull() && msg["result"].asBool()) {
+            board.accepted++;
+        } else if ((int)msg["error"][0].asNumber() == 21) {
+            board.stale++;
+        } else {
+            board.rejected++;
+        }
+    }
+}
+
+// Read what arrived on a connection. false if it was closed.
+static bool receive(Board& board) {
+    char chunk[16384];
+    ssize_t n = recv(board.fd, chunk, sizeof(chunk), 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+        return false;
+    }
+    if (n > 0) {
+        board.inbuf.append(chunk, n);
+        board.recv_ms = now_ms();
+    }
+    return true;
+}
+
+static void parse_lines(Board& board) {
+    size_t nl;
+    while ((nl = board.inbuf.find('\n')) != std::string::npos) {
+        std::string line = board.inbuf.substr(0, nl);
+        board.inbuf.erase(0, nl + 1);
+        handle_line(board, line);
+    }
+}
+
+// One poll round over every connection: send what is queued, read everything
+// that arrived, then handle the complete lines. false if a connection was closed.
+static bool pump(std::vector<Board*>& all, int timeout_ms) {
+    std::vector<struct pollfd> fds;
+    for (Board* board : all) {
+        fds.push_back({board->fd, (short)(POLLIN | (board->outbuf.empty() ? 0 : POLLOUT)), 0});
+    }
+    if (poll(fds.data(), fds.size(), timeout_ms) < 0 && errno != EINTR) {
+        perror("poll");
+        return false;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < fds.size(); i++) {
+        Board& board = *all[i];
+        if (fds[i].revents & POLLOUT) {
+            ssize_t n = send(board.fd, board.outbuf.data(), board.outbuf.size(), MSG_NOSIGNAL);
+            if (n > 0) {
+                board.outbuf.erase(0, n);
+            }
+        }
+        if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+            ok &= receive(board);
+        }
+    }
+    for (Board* board : all) {
+        parse_lines(*board);
+    }
+    return ok;
+}
+
+// The reference connection on its own thread, so its notifies are seen as soon
+// as they arrive however busy the boards are
+static std::atomic<bool> reference_running(true);
+
+static void reference_loop(Board* reference) {
+    std::vector<Board*> one = {reference};
+    while (reference_running) {
+        if (!pump(one, 50)) {
+            return;
+        }
+    }
+}
+
+static double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+static void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-h host] [-p proxy_port] [-P pool_port] [-n boards] [-t seconds] [-r shares/s]\n",
+            name);
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:P:n:t:r:")) != -1) {
+        switch (opt) {
+            case 'h': opt_host = optarg; break;
+            case 'p': opt_proxy_port = atoi(optarg); break;
+            case 'P': opt_pool_port = atoi(optarg); break;
+            case 'n': opt_boards = atoi(optarg); break;
+            case 't': opt_seconds = atoi(optarg); break;
+            case 'r': opt_rate = atof(optarg); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (opt_boards < 1 || opt_seconds < 1 || opt_rate < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    start_time = Clock::now();
+
+    // Reference connection straight to the emulator
+    Board reference;
+    reference.fd = connect_to(opt_pool_port);
+    if (reference.fd < 0) {
+        printf("❌ Cannot connect to the pool emulator at %s:%d\n", opt_host.c_str(), opt_pool_port);
+        return 1;
+    }
+    start_board(reference);
+    std::vector<Board*> one = {&reference};
+    double deadline = now_ms() + BENCH_SETUP_TIMEOUT_MS;
+    while (!reference.authorized || reference.first_job_ms < 0) {
+        if (now_ms() > deadline || !pump(one, 50)) {
+            printf("❌ No job from the pool emulator\n");
+            return 1;
+        }
+    }
+    std::thread reference_thread(reference_loop, &reference);
+
+    // Boards through the proxy
+    std::vector<Board> boards(opt_boards);
+    std::vector<Board*> all;
+    for (int i = 0; i < opt_boards; i++) {
+        boards[i].connect_ms = now_ms();
+        boards[i].fd = connect_to(opt_proxy_port);
+        if (boards[i].fd < 0) {
+            printf("❌ Cannot connect board %d to the proxy at %s:%d\n", i, opt_host.c_str(), opt_proxy_port);
+            return 1;
+        }
+        start_board(boards[i]);
+        all.push_back(&boards[i]);
+        pump(all, 0);  // Boards already connected keep going while the rest connect
+    }
+
+    // Every board authorized with a job
+    deadline = now_ms() + BENCH_SETUP_TIMEOUT_MS;
+    int ready = 0;
+    while (ready < opt_boards) {
+        if (now_ms() > deadline || !pump(all, 50)) {
+            printf("❌ Only %d of %d boards got a job\n", ready, opt_boards);
+            return 1;
+        }
+        ready = 0;
+        for (Board* board : all) {
+            ready += board->authorized && board->first_job_ms >= 0;
+        }
+    }
+    std::vector<double> first_job;
+    for (Board& board : boards) {
+        first_job.push_back(board.first_job_ms);
+    }
+    if (opt_rate > 0) {
+        printf("🚀 %d boards connected, %.4g shares/s each for %d s\n", opt_boards, opt_rate, opt_seconds);
+    } else {
+        printf("🚀 %d boards connected, shares as fast as answered for %d s\n", opt_boards, opt_seconds);
+    }
+
+    // Run: one share in flight per board
+    double run_start = now_ms();
+    double run_end = run_start + opt_seconds * 1000.0;
+    for (int i = 0; opt_rate > 0 && i < opt_boards; i++) {
+        boards[i].next_submit_ms = run_start + i * 1000.0 / opt_rate / opt_boards;  // Spread over the period
+    }
+    while (now_ms() < run_end) {
+        for (Board& board : boards) {
+            submit_share(board);
+        }
+        if (!pump(all, 10)) {
+            printf("❌ Connection closed during the run\n");
+            return 1;
+        }
+    }
+    double run_ms = now_ms() - run_start;
+
+    // Time for late copies to arrive, then the jobs the reference got during the run
+    double drain_end = now_ms() + BENCH_DRAIN_MS;
+    while (now_ms() < drain_end) {
+        pump(all, 10);
+    }
+    reference_running = false;
+    reference_thread.join();
+    std::map<std::string, double> jobs;
+    for (auto& entry : reference.job_seen) {
+        if (entry.second >= run_start && entry.second < run_end) {
+            jobs.insert(entry);
+        }
+    }
+
+    std::vector<double> fanout;
+    int missing = 0;
+    for (Board& board : boards) {
+        for (auto& job : jobs) {
+            auto seen = board.job_seen.find(job.first);
+            if (seen == board.job_seen.end()) {
+                missing++;
+            } else {
+                fanout.push_back(seen->second - job.second);
+            }
+        }
+    }
+    uint64_t accepted = 0, stale = 0, rejected = 0;
+    for (Board& board : boards) {
+        accepted += board.accepted;
+        stale += board.stale;
+        rejected += board.rejected;
+    }
+    printf("┌──────────────────── Proxy bench ────────────────────┐\n");
+    printf("│ Boards: %-6d  Jobs: %-6zu  Missing notifies: %-3d │\n", opt_boards, jobs.size(), missing);
+    printf("│ Connect -> job   p50 %8.2f ms  p99 %8.2f ms   │\n", percentile(first_job, 50),
+           percentile(first_job, 99));
+    printf("│ Fan-out          p50 %8.2f ms  p90 %8.2f ms   │\n", percentile(fanout, 50),
+           percentile(fanout, 90));
+    printf("│                  p99 %8.2f ms  max %8.2f ms   │\n", percentile(fanout, 99),
+           percentile(fanout, 100));
+    printf("│ Shares: %-10llu stale: %-7llu  refused: %-7llu │\n", (unsigned long long)accepted,
+           (unsigned long long)stale, (unsigned long long)rejected);
+    printf("│ Throughput: %9.0f shares/s                      │\n", accepted * 1000.0 / run_ms);
+    printf("│ Share RTT        p50 %8.2f ms  p99 %8.2f ms   │\n", percentile(share_rtt_ms, 50),
+           percentile(share_rtt_ms, 99));
+    printf("└─────────────────────────────────────────────────────┘\n");
+
+    close(reference.fd);
+    for (Board* board : all) {
+        close(board->fd);
+    }
+    if (jobs.empty()) {
+        printf("❌ No notify during the run: start the emulator with -n shorter than -t\n");
+        return 1;
+    }
+    if (missing || rejected) {
+        printf("❌ %d missing notifies, %llu refused shares\n", missing, (unsigned long long)rejected);
+        return 1;
+    }
+    printf("✅ Every board got every job\n");
+    return 0;
+}
@@ -0,0 +1,802 @@
+// Stratum V1 mining proxy for a fleet of TzCoinMiner boards on one LAN.
+//
+// Keeps a single upstream session (subscribe + authorize) with the pool and
+// serves any number of downstream miners speaking the same protocol as
+// src/stratum_client.cpp. Each downstream gets its own slice of the upstream
+// extranonce2 space: the proxy appends a per-device slot prefix to the
+// upstream extranonce1 and shrinks extranonce2_size accordingly, so the
+// coinbase the device builds is byte-identical to the one the pool expects.
+// Shares are forwarded upstream with the slot prefix restored.
+//
+// The upstream is resolved with getaddrinfo_a() and connected without
+// blocking, so devices keep being served while the pool is unreachable.
+//
+// Build: g++ -std=c++17 -O2 -Wall -o stratum_proxy stratum_proxy.cpp (add -lanl before glibc 2.34)
+// Usage: stratum_proxy <pool_host> <pool_port> <wallet.worker> [password] [listen_port]
+
+#include "../common/mini_json.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#define PROXY_DEFAULT_LISTEN_PORT 3333
+#define PROXY_MAX_LINE            16384   // Longest accepted Stratum line
+#define PROXY_RECONNECT_MS        5000    // Upstream reconnect backoff
+#define PROXY_CONNECT_TIMEOUT_MS  5000    // Per upstream address, then the next one is tried
+#define PROXY_RESOLVE_POLL_MS     50      // Poll timeout while the pool's name is resolved
+#define PROXY_STATS_INTERVAL_MS   60000   // Periodic stats print
+#define PROXY_MIN_DEVICE_EN2      2       // Smallest extranonce2 handed to a device (bytes)
+
+// Upstream connection progress (fd is only set once the TCP connection is up)
+enum UpstreamState {
+    UPSTREAM_IDLE,                   // Not connected, waiting for the reconnect backoff
+    UPSTREAM_RESOLVING,              // getaddrinfo_a() in flight
+    UPSTREAM_CONNECTING,             // Non-blocking connect() in flight on connecting_fd
+    UPSTREAM_CONNECTED
+};
+
+// Upstream pool session
+struct Upstream {
+    UpstreamState state = UPSTREAM_IDLE;
+    struct gaicb resolve = {};
+    struct addrinfo* addresses = NULL;
+    struct addrinfo* next_address = NULL;
+    int connecting_fd = -1;
+    uint64_t connect_started_ms = 0;
+    int fd = -1;
+    std::string inbuf;
+    std::string outbuf;
+    bool subscribed = false;
+    bool authorized = false;
+    std::string extranonce1;
+    int extranonce2_size = 0;
+    int slot_bytes = 0;              // Prefix bytes reserved per device
+    std::string difficulty_line;     // Last mining.set_difficulty, replayed to new devices
+    std::string notify_line;         // Last mining.notify, replayed to new devices
+    uint64_t last_connect_ms = 0;
+    uint32_t next_id = 100;          // Ids below 100 are used by subscribe/authorize
+};
+
+// Downstream device session
+struct Downstream {
+    int fd = -1;
+    std::string address;
+    std::string inbuf;
+    std::string outbuf;
+    bool subscribed = false;
+    bool subscribe_pending = false;  // Subscribe received before the upstream was ready
+    std::string subscribe_id;        // JSON text of the pending subscribe id
+    int slot = -1;
+    uint32_t shares_submitted = 0;
+    uint32_t shares_accepted = 0;
+    uint32_t shares_rejected = 0;
+};
+
+// Submit forwarded upstream, waiting for the pool's answer
+struct PendingSubmit {
+    uint64_t client_id;
+    std::string downstream_id;       // JSON text of the device's request id
+};
+
+// Proxy configuration
+static std::string pool_host;
+static uint16_t pool_port = 0;
+static std::string pool_user;
+static std::string pool_password = "x";
+static uint16_t listen_port = PROXY_DEFAULT_LISTEN_PORT;
+
+// Proxy state
+static Upstream upstream;
+static std::map<uint64_t, Downstream> clients;
+static std::map<uint32_t, PendingSubmit> pending_submits;
+static std::set<int> used_slots;
+static uint64_t next_client_id = 1;
+static volatile bool running = true;
+
+// Proxy statistics
+static uint64_t stat_notifies = 0;
+static uint64_t stat_fanout_messages = 0;
+static uint64_t stat_shares_forwarded = 0;
+static uint64_t stat_shares_accepted = 0;
+static uint64_t stat_shares_rejected = 0;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+// Write as much of the buffer as the socket accepts, keep the rest for POLLOUT
+static bool flush_buffer(int fd, std::string& buf) {
+    while (!buf.empty()) {
+        ssize_t n = send(fd, buf.data(), buf.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            buf.erase(0, n);
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read available bytes; false when the peer closed or errored
+static bool read_socket(int fd, std::string& buf) {
+    char chunk[4096];
+    while (true) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            buf.append(chunk, n);
+            if (buf.size() > PROXY_MAX_LINE * 4) {
+                return false;
+            }
+        } else if (n == 0) {
+            return false;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+// Pop the next complete line from a receive buffer
+static bool next_line(std::string& buf, std::string& line) {
+    size_t nl = buf.find('\n');
+    if (nl == std::string::npos) {
+        return false;
+    }
+    line = buf.substr(0, nl);
+    buf.erase(0, nl + 1);
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+        line.pop_back();
+    }
+    return true;
+}
+
+static void send_upstream(const std::string& line) {
+    upstream.outbuf += line;
+    upstream.outbuf += "\n";
+}
+
+static void send_client(Downstream& client, const std::string& line) {
+    client.outbuf += line;
+    client.outbuf += "\n";
+}
+
+static void send_error(Downstream& client, const std::string& id, int code, const char* message) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%d", code);
+    send_client(client, "{\"id\":" + id + ",\"result\":null,\"error\":[" + buf + "," +
+                        json_quote(message) + ",null]}");
+}
+
+static std::string slot_hex(int slot, int bytes) {
+    std::string hex;
+    char buf[3];
+    for (int i = bytes - 1; i >= 0; i--) {
+        snprintf(buf, sizeof(buf), "%02x", (slot >> (i * 8)) & 0xFF);
+        hex += buf;
+    }
+    return hex;
+}
+
+// Lowest free extranonce2 slot, -1 when the prefix space is exhausted
+static int allocate_slot(void) {
+    int max_slots = 1 << (upstream.slot_bytes * 8);
+    for (int slot = 0; slot < max_slots; slot++) {
+        if (used_slots.find(slot) == used_slots.end()) {
+            used_slots.insert(slot);
+            return slot;
+        }
+    }
+    return -1;
+}
+
+static void close_client(uint64_t id) {
+    auto it = clients.find(id);
+    if (it == clients.end()) {
+        return;
+    }
+    Downstream& client = it->second;
+    printf("➖ Miner %s disconnected (slot %d, %u accepted / %u rejected)\n", client.address.c_str(),
+           client.slot, client.shares_accepted, client.shares_rejected);
+    if (client.slot >= 0) {
+        used_slots.erase(client.slot);
+    }
+    close(client.fd);
+    clients.erase(it);
+}
+
+// Answer a device subscribe with its own extranonce1 (upstream en1 + slot prefix)
+static void complete_subscribe(Downstream& client) {
+    client.slot = allocate_slot();
+    if (client.slot < 0) {
+        send_error(client, client.subscribe_id, 20, "Proxy full");
+        return;
+    }
+
+    std::string extranonce1 = upstream.extranonce1 + slot_hex(client.slot, upstream.slot_bytes);
+    char size_buf[16];
+    snprintf(size_buf, sizeof(size_buf), "%d", upstream.extranonce2_size - upstream.slot_bytes);
+
+    send_client(client, "{\"id\":" + client.subscribe_id + ",\"result\":[[[\"mining.set_difficulty\",\"1\"],"
+                        "[\"mining.notify\",\"1\"]]," + json_quote(extranonce1) + "," + size_buf +
+                        "],\"error\":null}");
+    client.subscribed = true;
+    client.subscribe_pending = false;
+
+    // Bring the device up to date with the current difficulty and job
+    if (!upstream.difficulty_line.empty()) {
+        send_client(client, upstream.difficulty_line);
+    }
+    if (!upstream.notify_line.empty()) {
+        send_client(client, upstream.notify_line);
+    }
+
+    printf("✅ Miner %s subscribed (slot %d, extranonce1 %s)\n", client.address.c_str(), client.slot,
+           extranonce1.c_str());
+}
+
+static void handle_client_submit(uint64_t client_id, Downstream& client, const std::string& id,
+                                 const JsonValue& params) {
+    if (!client.subscribed || params.size() < 5) {
+        send_error(client, id, 25, "Not subscribed");
+        return;
+    }
+    if (!upstream.authorized) {
+        send_error(client, id, 24, "Upstream not ready");
+        return;
+    }
+
+    const std::string& extranonce2 = params[2].asString();
+    size_t expected = (size_t)(upstream.extranonce2_size - upstream.slot_bytes) * 2;
+    if (extranonce2.size() != expected) {
+        send_error(client, id, 20, "Invalid extranonce2 size");
+        client.shares_rejected++;
+        return;
+    }
+
+    // Restore the full upstream extranonce2 (slot prefix + device part)
+    JsonValue forwarded = params;
+    forwarded.items[0].type = JsonValue::STRING;
+    forwarded.items[0].text = pool_user;
+    forwarded.items[2].text = slot_hex(client.slot, upstream.slot_bytes) + extranonce2;
+
+    uint32_t upstream_id = upstream.next_id++;
+    pending_submits[upstream_id] = PendingSubmit{client_id, id};
+
+    char id_buf[16];
+    snprintf(id_buf, sizeof(id_buf), "%u", upstream_id);
+    send_upstream(std::string("{\"id\":") + id_buf + ",\"method\":\"mining.submit\",\"params\":" +
+                  forwarded.dump() + "}");
+
+    client.shares_submitted++;
+    stat_shares_forwarded++;
+}
+
+static void handle_client_line(uint64_t client_id, const std::string& line) {
+    Downstream& client = clients[client_id];
+    JsonValue msg;
+    if (!json_parse(line, msg) || msg.type != JsonValue::OBJECT) {
+        printf("⚠️  Invalid JSON from %s\n", client.address.c_str());
+        return;
+    }
+
+    const JsonValue& id_value = msg["id"];
+    std::string id = id_value.dump();
+    const std::string& method = msg["method"].asString();
+
+    if (method == "mining.subscribe") {
+        client.subscribe_id = id;
+        client.subscribe_pending = true;
+        if (upstream.authorized) {
+            complete_subscribe(client);
+        }
+    } else if (method == "mining.authorize") {
+        // Devices are trusted on the LAN: shares are credited to the proxy's pool account
+        send_client(client, "{\"id\":" + id + ",\"result\":true,\"error\":null}");
+    } else if (method == "mining.submit") {
+        handle_client_submit(client_id, client, id, msg["params"]);
+    } else if (!id_value.isNull()) {
+        send_error(client, id, 20, "Unsupported method");
+    }
+}
+
+// Send a notification line to every subscribed device
+static void broadcast(const std::string& line) {
+    for (auto& entry : clients) {
+        if (entry.second.subscribed) {
+            send_client(entry.second, line);
+            stat_fanout_messages++;
+        }
+    }
+}
+
+static void upstream_reset(void) {
+    if (upstream.fd >= 0) {
+        close(upstream.fd);
+    }
+    if (upstream.connecting_fd >= 0) {
+        close(upstream.connecting_fd);
+        upstream.connecting_fd = -1;
+    }
+    if (upstream.state == UPSTREAM_RESOLVING) {
+        gai_cancel(&upstream.resolve);
+    }
+    if (upstream.addresses) {
+        freeaddrinfo(upstream.addresses);
+        upstream.addresses = NULL;
+        upstream.next_address = NULL;
+    }
+    upstream.fd = -1;
+    upstream.state = UPSTREAM_IDLE;
+    upstream.inbuf.clear();
+    upstream.outbuf.clear();
+    upstream.subscribed = false;
+    upstream.authorized = false;
+    upstream.difficulty_line.clear();
+    upstream.notify_line.clear();
+    pending_submits.clear();
+
+    // A new upstream session means a new extranonce1: devices must subscribe again
+    std::vector<uint64_t> ids;
+    for (auto& entry : clients) {
+        ids.push_back(entry.first);
+    }
+    for (uint64_t id : ids) {
+        close_client(id);
+    }
+}
+
+// Start resolving the pool's name; the loop picks up the result (upstream_resolved)
+static void upstream_connect(void) {
+    upstream.last_connect_ms = now_ms();
+
+    static char port_buf[8];
+    static struct addrinfo hints;
+    snprintf(port_buf, sizeof(port_buf), "%u", pool_port);
+    hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    upstream.resolve = {};
+    upstream.resolve.ar_name = pool_host.c_str();
+    upstream.resolve.ar_service = port_buf;
+    upstream.resolve.ar_request = &hints;
+    struct gaicb* list[1] = {&upstream.resolve};
+    if (getaddrinfo_a(GAI_NOWAIT, list, 1, NULL) != 0) {
+        printf("❌ DNS failed for %s\n", pool_host.c_str());
+        return;
+    }
+    upstream.state = UPSTREAM_RESOLVING;
+}
+
+static void upstream_connect_failed(void) {
+    if (upstream.addresses) {
+        freeaddrinfo(upstream.addresses);
+    }
+    upstream.addresses = NULL;
+    upstream.next_address = NULL;
+    upstream.state = UPSTREAM_IDLE;
+    printf("❌ Cannot connect to pool %s:%u\n", pool_host.c_str(), pool_port);
+}
+
+// TCP connection up: start the Stratum session
+static void upstream_connected(int fd) {
+    freeaddrinfo(upstream.addresses);
+    upstream.addresses = NULL;
+    upstream.next_address = NULL;
+    upstream.connecting_fd = -1;
+
+    set_nonblocking(fd);
+    upstream.fd = fd;
+    upstream.state = UPSTREAM_CONNECTED;
+    upstream.next_id = 100;
+    printf("🔌 Connected to pool %s:%u\n", pool_host.c_str(), pool_port);
+
+    send_upstream("{\"id\":1,\"method\":\"mining.subscribe\",\"params\":[\"TzBtcMiner-proxy/1.0\"]}");
+}
+
+// Start a non-blocking connect to the next resolved address; POLLOUT finishes it
+static void upstream_try_next_address(void) {
+    while (upstream.next_address != NULL) {
+        struct addrinfo* ai = upstream.next_address;
+        upstream.next_address = ai->ai_next;
+
+        int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            upstream_connected(fd);
+            return;
+        }
+        if (errno == EINPROGRESS) {
+            upstream.connecting_fd = fd;
+            upstream.connect_started_ms = now_ms();
+            upstream.state = UPSTREAM_CONNECTING;
+            return;
+        }
+        close(fd);
+    }
+    upstream_connect_failed();
+}
+
+// Name resolution finished (or still running): move on to connecting
+static void upstream_poll_resolve(void) {
+    int err = gai_error(&upstream.resolve);
+    if (err == EAI_INPROGRESS) {
+        return;
+    }
+    if (err != 0) {
+        printf("❌ DNS failed for %s\n", pool_host.c_str());
+        upstream.state = UPSTREAM_IDLE;
+        return;
+    }
+    upstream.addresses = upstream.resolve.ar_result;
+    upstream.next_address = upstream.addresses;
+    upstream_try_next_address();
+}
+
+// POLLOUT (or an error) on the connecting socket, or its timeout
+static void upstream_finish_connect(bool timed_out) {
+    int fd = upstream.connecting_fd;
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (!timed_out && getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0) {
+        upstream_connected(fd);
+        return;
+    }
+    close(fd);
+    upstream.connecting_fd = -1;
+    upstream_try_next_address();
+}
+
+static void handle_upstream_line(const std::string& line) {
+    JsonValue msg;
+    if (!json_parse(line, msg) || msg.type != JsonValue::OBJECT) {
+        printf("⚠️  Invalid JSON from pool\n");
+        return;
+    }
+
+    const JsonValue& id_value = msg["id"];
+    const std::string& method = msg["method"].asString();
+
+    // Notifications from the pool
+    if (!method.empty()) {
+        if (method == "mining.notify") {
+            upstream.notify_line = line;
+            stat_notifies++;
+            broadcast(line);
+        } else if (method == "mining.set_difficulty") {
+            upstream.difficulty_line = line;
+            printf("🎯 Pool difficulty: %s\n", msg["params"][0].dump().c_str());
+            broadcast(line);
+        }
+        return;
+    }
+
+    if (id_value.type != JsonValue::NUMBER) {
+        return;
+    }
+    uint32_t id = (uint32_t)id_value.asNumber();
+
+    // Subscribe response: split the extranonce2 space
+    if (id == 1) {
+        const JsonValue& result = msg["result"];
+        if (!msg["error"].isNull() || result.size() < 3) {
+            printf("❌ Pool subscribe failed: %s\n", msg["error"].dump().c_str());
+            upstream_reset();
+            return;
+        }
+        upstream.extranonce1 = result[1].asString();
+        upstream.extranonce2_size = (int)result[2].asNumber();
+        upstream.slot_bytes = upstream.extranonce2_size - PROXY_MIN_DEVICE_EN2 >= 2 ? 2 : 1;
+        if (upstream.extranonce2_size - upstream.slot_bytes < 1) {
+            printf("❌ Pool extranonce2_size %d too small to split\n", upstream.extranonce2_size);
+            upstream_reset();
+            return;
+        }
+        upstream.subscribed = true;
+        printf("📡 Subscribed: extranonce1 %s, extranonce2_size %d (%d slot bytes, %d per device)\n",
+               upstream.extranonce1.c_str(), upstream.extranonce2_size, upstream.slot_bytes,
+               upstream.extranonce2_size - upstream.slot_bytes);
+
+        send_upstream("{\"id\":2,\"method\":\"mining.authorize\",\"params\":[" + json_quote(pool_user) + "," +
+                      json_quote(pool_password) + "]}");
+        return;
+    }
+
+    // Authorize response: serve devices that subscribed while we were connecting
+    if (id == 2) {
+        if (!msg["error"].isNull() || !msg["result"].asBool()) {
+            printf("❌ Pool authorization failed for %s\n", pool_user.c_str());
+            upstream_reset();
+            return;
+        }
+        upstream.authorized = true;
+        printf("✅ Authorized as %s\n", pool_user.c_str());
+        for (auto& entry : clients) {
+            if (entry.second.subscribe_pending) {
+                complete_subscribe(entry.second);
+            }
+        }
+        return;
+    }
+
+    // Submit response: route back to the device with its own request id
+    auto it = pending_submits.find(id);
+    if (it == pending_submits.end()) {
+        return;
+    }
+    PendingSubmit pending = it->second;
+    pending_submits.erase(it);
+
+    bool accepted = msg["error"].isNull() && msg["result"].asBool();
+    if (accepted) {
+        stat_shares_accepted++;
+    } else {
+        stat_shares_rejected++;
+    }
+
+    auto client_it = clients.find(pending.client_id);
+    if (client_it == clients.end()) {
+        return;
+    }
+    Downstream& client = client_it->second;
+    if (accepted) {
+        client.shares_accepted++;
+    } else {
+        client.shares_rejected++;
+    }
+    send_client(client, "{\"id\":" + pending.downstream_id + ",\"result\":" + msg["result"].dump() +
+                        ",\"error\":" + msg["error"].dump() + "}");
+}
+
+static int listen_socket(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 128) < 0) {
+        close(fd);
+        return -1;
+    }
+    set_nonblocking(fd);
+    return fd;
+}
+
+static void accept_clients(int listen_fd) {
+    while (true) {
+        struct sockaddr_in addr;
+        socklen_t len = sizeof(addr);
+        int fd = accept(listen_fd, (struct sockaddr*)&addr, &len);
+        if (fd < 0) {
+            return;
+        }
+        set_nonblocking(fd);
+
+        Downstream client;
+        client.fd = fd;
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%s:%u", inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
+        client.address = buf;
+        clients[next_client_id++] = client;
+        printf("➕ Miner %s connected (%zu total)\n", buf, clients.size());
+    }
+}
+
+static void print_stats(void) {
+    printf("┌──────────────── Proxy stats ────────────────┐\n");
+    printf("│ Miners: %-5zu  Upstream: %-18s │\n", clients.size(),
+           upstream.authorized ? "authorized" : "not ready");
+    printf("│ Notifies: %-8llu  Fan-out msgs: %-10llu │\n", (unsigned long long)stat_notifies,
+           (unsigned long long)stat_fanout_messages);
+    printf("│ Shares fwd: %-6llu ok: %-6llu rejected: %-5llu │\n", (unsigned long long)stat_shares_forwarded,
+           (unsigned long long)stat_shares_accepted, (unsigned long long)stat_shares_rejected);
+    printf("└─────────────────────────────────────────────┘\n");
+    fflush(stdout);
+}
+
+static void on_signal(int) {
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s <pool_host> <pool_port> <wallet.worker> [password] [listen_port]\n", argv[0]);
+        return 1;
+    }
+    pool_host = argv[1];
+    pool_port = (uint16_t)atoi(argv[2]);
+    pool_user = argv[3];
+    if (argc > 4) {
+        pool_password = argv[4];
+    }
+    if (argc > 5) {
+        listen_port = (uint16_t)atoi(argv[5]);
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    int listen_fd = listen_socket(listen_port);
+    if (listen_fd < 0) {
+        fprintf(stderr, "❌ Cannot listen on port %u: %s\n", listen_port, strerror(errno));
+        return 1;
+    }
+    printf("🏊 Stratum proxy listening on :%u -> %s:%u\n", listen_port, pool_host.c_str(), pool_port);
+
+    upstream_connect();
+    uint64_t last_stats = now_ms();
+
+    while (running) {
+        // Reconnect the upstream with backoff; resolving and connecting never block the loop
+        if (upstream.state == UPSTREAM_IDLE && now_ms() - upstream.last_connect_ms >= PROXY_RECONNECT_MS) {
+            upstream_connect();
+        }
+        if (upstream.state == UPSTREAM_RESOLVING) {
+            upstream_poll_resolve();
+        }
+        if (upstream.state == UPSTREAM_CONNECTING &&
+            now_ms() - upstream.connect_started_ms >= PROXY_CONNECT_TIMEOUT_MS) {
+            upstream_finish_connect(true);
+        }
+
+        std::vector<struct pollfd> fds;
+        std::vector<uint64_t> fd_clients;   // Client id per pollfd entry (0 = listener/upstream)
+
+        fds.push_back({listen_fd, POLLIN, 0});
+        fd_clients.push_back(0);
+        if (upstream.state == UPSTREAM_CONNECTING) {
+            fds.push_back({upstream.connecting_fd, POLLOUT, 0});
+            fd_clients.push_back(0);
+        }
+        if (upstream.fd >= 0) {
+            fds.push_back({upstream.fd, (short)(POLLIN | (upstream.outbuf.empty() ? 0 : POLLOUT)), 0});
+            fd_clients.push_back(0);
+        }
+        for (auto& entry : clients) {
+            fds.push_back({entry.second.fd, (short)(POLLIN | (entry.second.outbuf.empty() ? 0 : POLLOUT)), 0});
+            fd_clients.push_back(entry.first);
+        }
+
+        int timeout_ms = upstream.state == UPSTREAM_RESOLVING ? PROXY_RESOLVE_POLL_MS : 1000;
+        if (poll(fds.data(), fds.size(), timeout_ms) < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+
+        std::vector<uint64_t> to_close;
+        for (size_t i = 0; i < fds.size(); i++) {
+            short events = fds[i].revents;
+            if (events == 0) {
+                continue;
+            }
+
+            if (fds[i].fd == listen_fd) {
+                accept_clients(listen_fd);
+                continue;
+            }
+
+            if (upstream.state == UPSTREAM_CONNECTING && fds[i].fd == upstream.connecting_fd &&
+                fd_clients[i] == 0) {
+                upstream_finish_connect(false);
+                continue;
+            }
+
+            if (fds[i].fd == upstream.fd && fd_clients[i] == 0) {
+                bool ok = true;
+                if (events & (POLLIN | POLLHUP | POLLERR)) {
+                    ok = read_socket(upstream.fd, upstream.inbuf);
+                    std::string line;
+                    while (next_line(upstream.inbuf, line)) {
+                        if (!line.empty()) {
+                            handle_upstream_line(line);
+                        }
+                        if (upstream.fd < 0) {
+                            break;
+                        }
+                    }
+                }
+                if (ok && upstream.fd >= 0 && (events & POLLOUT)) {
+                    ok = flush_buffer(upstream.fd, upstream.outbuf);
+                }
+                if (!ok && upstream.fd >= 0) {
+                    printf("⚠️  Pool connection lost, reconnecting in %d s\n", PROXY_RECONNECT_MS / 1000);
+                    upstream_reset();
+                }
+                // Clients closed by an upstream reset are skipped below (no longer in the map)
+                continue;
+            }
+
+            uint64_t id = fd_clients[i];
+            auto it = clients.find(id);
+            if (it == clients.end()) {
+                continue;
+            }
+            bool ok = true;
+            if (events & (POLLIN | POLLHUP | POLLERR)) {
+                ok = read_socket(it->second.fd, it->second.inbuf);
+                std::string line;
+                while (next_line(it->second.inbuf, line)) {
+                    if (line.size() > PROXY_MAX_LINE) {
+                        ok = false;
+                        break;
+                    }
+                    if (!line.empty()) {
+                        handle_client_line(id, line);
+                    }
+                }
+            }
+            if (ok && (events & POLLOUT)) {
+                ok = flush_buffer(it->second.fd, it->second.outbuf);
+            }
+            if (!ok) {
+                to_close.push_back(id);
+            }
+        }
+        for (uint64_t id : to_close) {
+            close_client(id);
+        }
+
+        // Push out what this round queued (notify fan-out, submit answers)
+        if (upstream.fd >= 0 && !flush_buffer(upstream.fd, upstream.outbuf)) {
+            printf("⚠️  Pool connection lost, reconnecting in %d s\n", PROXY_RECONNECT_MS / 1000);
+            upstream_reset();
+        }
+        to_close.clear();
+        for (auto& entry : clients) {
+            if (!flush_buffer(entry.second.fd, entry.second.outbuf)) {
+                to_close.push_back(entry.first);
+            }
+        }
+        for (uint64_t id : to_close) {
+            close_client(id);
+        }
+
+        if (now_ms() - last_stats >= PROXY_STATS_INTERVAL_MS) {
+            last_stats = now_ms();
+            print_stats();
+        }
+    }
+
+    print_stats();
+    upstream_reset();
+    close(listen_fd);
+    return 0;
+}
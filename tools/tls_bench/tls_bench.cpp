@@ -0,0 +1,375 @@
+// Host model of the device's TLS session caching policy
+// (src/tls_transport.cpp) against tls_emulator in echo mode.
+//
+// The host has no mbedtls, so TlsClient itself is not run here: the client
+// reimplements its policy with OpenSSL. Whether the mbedtls code resumes is
+// checked on the board (handshake log, tls_get_stats()). The policy:
+// TLS 1.2, no certificate check (no CA set), one cached session per
+// host:port, replaced after every handshake, offered on the next connect and
+// dropped when a handshake that offered it fails. For each connection it
+// measures the handshake: wall time, the client's CPU time (the part that
+// costs seconds on the board), bytes on the wire and round trips (what the
+// handshake costs over WiFi). Checks:
+//   - the first connect is a full handshake, the next ones resume
+//   - a new host:port starts with a full handshake (sessions are per server)
+//   - after the server forgets its sessions ("forget" record), the stale
+//     session is offered, the server refuses it and the handshake completes
+//     in full; the session after that resumes again
+//   - every connection echoes 1 KB intact
+//   - a resumed handshake costs less CPU and fewer bytes than a full one
+// With -F the server does not resume (tls_emulator -m none): every handshake
+// must be full, with the offered session ignored.
+// The tool exits non-zero on any mismatch.
+//
+// Build: g++ -std=c++17 -O2 -Wall -o tls_bench tls_bench.cpp -lssl -lcrypto
+// Usage: tls_bench [-h host] [-p port] [-n connections] [-F]
+
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+
+static std::string opt_host = "127.0.0.1";
+static int opt_port = 3443;
+static int opt_connections = 20;
+static bool opt_no_resume = false;
+
+static int failures = 0;
+static SSL_CTX* ctx = nullptr;
+
+// Session cache keyed by "host:port", as in tls_transport.cpp
+static std::map<std::string, SSL_SESSION*> cache;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("❌ %s\n", what);
+        failures++;
+    }
+}
+
+static double now_ms(void) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double cpu_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// One handshake's cost
+struct Handshake {
+    bool ok = false;
+    bool offered = false;
+    bool resumed = false;
+    double wall_ms = 0;
+    double cpu_ms = 0;
+    uint64_t bytes = 0;
+    int round_trips = 0;
+};
+
+struct Totals {
+    int count = 0;
+    double wall_ms = 0;
+    double cpu_ms = 0;
+    uint64_t bytes = 0;
+    int round_trips = 0;
+
+    void add(const Handshake& h) {
+        count++;
+        wall_ms += h.wall_ms;
+        cpu_ms += h.cpu_ms;
+        bytes += h.bytes;
+        round_trips += h.round_trips;
+    }
+};
+static Totals full_totals, resumed_totals;
+
+// Socket BIO callback: data read after data written is an answer from the
+// server, so every write -> read turn is one round trip
+struct Turns {
+    bool wrote = false;
+    int round_trips = 0;
+};
+
+static long count_turns(BIO* bio, int oper, const char*, size_t, int, long, int ret, size_t* processed) {
+    Turns* turns = (Turns*)BIO_get_callback_arg(bio);
+    if (ret > 0 && processed && *processed > 0) {
+        if (oper == (BIO_CB_WRITE | BIO_CB_RETURN)) {
+            turns->wrote = true;
+        } else if (oper == (BIO_CB_READ | BIO_CB_RETURN) && turns->wrote) {
+            turns->wrote = false;
+            turns->round_trips++;
+        }
+    }
+    return ret;
+}
+
+struct Connection {
+    int fd = -1;
+    Turns turns;
+    SSL* ssl = nullptr;
+
+    ~Connection() { close_all(); }
+
+    void close_all(void) {
+        if (ssl) {
+            SSL_shutdown(ssl);
+            SSL_free(ssl);
+            ssl = nullptr;
+        }
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    // TCP connect, then the TLS handshake offering the cached session of name:port
+    Handshake open(const std::string& name) {
+        Handshake h;
+        struct addrinfo hints = {};
+        struct addrinfo* res = nullptr;
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(opt_host.c_str(), std::to_string(opt_port).c_str(), &hints, &res) != 0) {
+            return h;
+        }
+        fd = socket(res->ai_family, res->ai_socktype, 0);
+        bool connected = fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) == 0;
+        freeaddrinfo(res);
+        if (!connected) {
+            return h;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+
+        std::string key = name + ":" + std::to_string(opt_port);
+        ssl = SSL_new(ctx);
+        SSL_set_fd(ssl, fd);
+        BIO_set_callback_ex(SSL_get_rbio(ssl), count_turns);
+        BIO_set_callback_arg(SSL_get_rbio(ssl), (char*)&turns);
+        SSL_set_tlsext_host_name(ssl, name.c_str());
+        auto cached = cache.find(key);
+        if (cached != cache.end()) {
+            h.offered = SSL_set_session(ssl, cached->second) == 1;
+        }
+
+        double start = now_ms();
+        double cpu_start = cpu_ms();
+        double cpu_waiting = 0;
+        int ret;
+        while ((ret = SSL_connect(ssl)) != 1) {
+            int err = SSL_get_error(ssl, ret);
+            if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+                break;
+            }
+            double before = cpu_ms();
+            struct pollfd p = {fd, (short)(err == SSL_ERROR_WANT_READ ? POLLIN : POLLOUT), 0};
+            if (poll(&p, 1, 15000) <= 0) {
+                break;
+            }
+            cpu_waiting += cpu_ms() - before;
+        }
+        h.wall_ms = now_ms() - start;
+        h.cpu_ms = cpu_ms() - cpu_start - cpu_waiting;
+        h.round_trips = turns.round_trips;
+        h.bytes = BIO_number_read(SSL_get_rbio(ssl)) + BIO_number_written(SSL_get_wbio(ssl));
+
+        if (ret != 1) {
+            // A session the server chokes on is not offered again
+            if (h.offered) {
+                SSL_SESSION_free(cached->second);
+                cache.erase(cached);
+            }
+            return h;
+        }
+        h.ok = true;
+        h.resumed = SSL_session_reused(ssl);
+        if (cached != cache.end()) {
+            SSL_SESSION_free(cached->second);
+        }
+        cache[key] = SSL_get1_session(ssl);
+        (h.resumed ? resumed_totals : full_totals).add(h);
+        return h;
+    }
+
+    bool send_all(const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            int n = SSL_write(ssl, data.data() + sent, (int)(data.size() - sent));
+            if (n > 0) {
+                sent += n;
+                continue;
+            }
+            int err = SSL_get_error(ssl, n);
+            struct pollfd p = {fd, (short)(err == SSL_ERROR_WANT_READ ? POLLIN : POLLOUT), 0};
+            if ((err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) || poll(&p, 1, 5000) <= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string receive(size_t size) {
+        std::string data;
+        char buf[4096];
+        while (data.size() < size) {
+            int n = SSL_read(ssl, buf, (int)std::min(sizeof(buf), size - data.size()));
+            if (n > 0) {
+                data.append(buf, n);
+                continue;
+            }
+            int err = SSL_get_error(ssl, n);
+            struct pollfd p = {fd, (short)(err == SSL_ERROR_WANT_WRITE ? POLLOUT : POLLIN), 0};
+            if ((err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) || poll(&p, 1, 5000) <= 0) {
+                break;
+            }
+        }
+        return data;
+    }
+};
+
+static std::mt19937 rng(7);
+
+// Handshake with name, then 1 KB through the echo server
+static Handshake round_trip(const std::string& name) {
+    Connection conn;
+    Handshake h = conn.open(name);
+    if (!h.ok) {
+        return h;
+    }
+    std::string payload(1024, '\0');
+    for (char& c : payload) {
+        c = (char)('a' + rng() % 26);
+    }
+    check(conn.send_all(payload) && conn.receive(payload.size()) == payload, "echo mismatch");
+    return h;
+}
+
+static void print_handshake(const char* what, const Handshake& h) {
+    printf("   %-28s %-8s %7.2f ms, CPU %6.2f ms, %5llu B, %d round trip%s\n", what,
+           !h.ok ? "FAILED" : h.resumed ? "resumed" : "full", h.wall_ms, h.cpu_ms, (unsigned long long)h.bytes,
+           h.round_trips, h.round_trips == 1 ? "" : "s");
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:n:F")) != -1) {
+        switch (opt) {
+            case 'h': opt_host = optarg; break;
+            case 'p': opt_port = atoi(optarg); break;
+            case 'n': opt_connections = atoi(optarg); break;
+            case 'F': opt_no_resume = true; break;
+            default:
+                fprintf(stderr, "Usage: %s [-h host] [-p port] [-n connections] [-F]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (opt_connections < 2) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+
+    ctx = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set_max_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);    // Sessions are kept by hand, per host:port
+
+    printf("🔒 TLS bench against %s:%d, %d connections%s\n", opt_host.c_str(), opt_port, opt_connections,
+           opt_no_resume ? " (server without resumption)" : "");
+
+    // Reconnects to one server
+    for (int i = 0; i < opt_connections; i++) {
+        Handshake h = round_trip("localhost");
+        if (!h.ok) {
+            check(false, "handshake failed");
+            break;
+        }
+        if (i < 3) {
+            print_handshake(i == 0 ? "First connect:" : "Reconnect:", h);
+        }
+        if (i == 0) {
+            check(!h.offered && !h.resumed, "first connect offered or resumed a session");
+        } else {
+            check(h.offered, "cached session not offered");
+            check(h.resumed != opt_no_resume, opt_no_resume ? "server without resumption resumed"
+                                                            : "reconnect did not resume");
+        }
+    }
+
+    // Another host:port has no session yet
+    Handshake other = round_trip("127.0.0.1");
+    print_handshake("Other host name:", other);
+    check(other.ok && !other.offered && !other.resumed, "session offered to another host:port");
+
+    if (!opt_no_resume) {
+        // The server forgets: the stale session must fall back to a full handshake
+        Connection conn;
+        check(conn.open("localhost").ok && conn.send_all("forget\n") && conn.receive(7) == "forgot\n",
+              "server did not forget its sessions (echo mode needed)");
+        conn.close_all();
+
+        Handshake stale = round_trip("localhost");
+        print_handshake("Stale session:", stale);
+        check(stale.ok && stale.offered && !stale.resumed, "stale session did not fall back to a full handshake");
+        Handshake after = round_trip("localhost");
+        print_handshake("After fallback:", after);
+        check(after.ok && after.resumed, "session after the fallback did not resume");
+    }
+
+    if (full_totals.count && resumed_totals.count) {
+        check(resumed_totals.cpu_ms / resumed_totals.count < full_totals.cpu_ms / full_totals.count,
+              "resumed handshakes not cheaper in CPU");
+        check(resumed_totals.bytes / resumed_totals.count < full_totals.bytes / full_totals.count,
+              "resumed handshakes not smaller");
+    }
+
+    const Totals* rows[2] = {&full_totals, &resumed_totals};
+    const char* names[2] = {"Full:   ", "Resumed:"};
+    printf("┌─────────────────── TLS handshakes ───────────────────┐\n");
+    for (int i = 0; i < 2; i++) {
+        if (!rows[i]->count) {
+            continue;
+        }
+        int n = rows[i]->count;
+        printf("│ %s %4d x %7.2f ms, CPU %5.2f, %5llu B, %d RT │\n", names[i], rows[i]->count,
+               rows[i]->wall_ms / n, rows[i]->cpu_ms / n, (unsigned long long)(rows[i]->bytes / n),
+               rows[i]->round_trips / n);
+    }
+    if (full_totals.count && resumed_totals.count) {
+        printf("│ Resumed / full: CPU %5.1f%%, bytes %5.1f%%             │\n",
+               100.0 * (resumed_totals.cpu_ms / resumed_totals.count) / (full_totals.cpu_ms / full_totals.count),
+               100.0 * ((double)resumed_totals.bytes / resumed_totals.count) /
+                   ((double)full_totals.bytes / full_totals.count));
+    }
+    printf("└──────────────────────────────────────────────────────┘\n");
+
+    for (auto& entry : cache) {
+        SSL_SESSION_free(entry.second);
+    }
+    SSL_CTX_free(ctx);
+
+    if (failures) {
+        printf("❌ %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All checks passed\n");
+    return 0;
+}
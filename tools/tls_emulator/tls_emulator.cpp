@@ -0,0 +1,304 @@
+// Local TLS stand-in for testing the device's TLS transport (src/tls_transport.cpp).
+//
+// Terminates TLS 1.2, the version the board's mbedtls speaks, the way a pool
+// or node behind stunnel or nginx does, and forwards the plaintext to an
+// upstream server (pool_emulator, node_emulator) or, without -u, echoes it
+// back. The server key and a self-signed certificate are generated at start:
+// ECDSA P-256 or RSA 2048, the two kinds the board meets in the wild.
+//
+// Resumption is what the emulator is for: with session tickets (RFC 5077,
+// stateless), with session IDs (server-side cache) or not at all, so a client
+// can be tested against every kind of server. Each handshake is logged as
+// full or resumed with its server-side time. In echo mode a record holding
+// exactly "forget\n" flushes the session cache and rotates the ticket keys,
+// answered "forgot\n": the sessions clients hold become stale, to test that
+// they fall back to a full handshake.
+//
+// Build: g++ -std=c++17 -O2 -Wall -pthread -o tls_emulator tls_emulator.cpp -lssl -lcrypto
+// Usage: tls_emulator [-p port] [-u host:port] [-m tickets|ids|none] [-k ec|rsa]
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+// Options
+static uint16_t opt_port = 3443;
+static std::string opt_upstream;        // "host:port", empty = echo
+static std::string opt_mode = "tickets";
+static std::string opt_key = "ec";
+
+static volatile bool running = true;
+static SSL_CTX* ctx = nullptr;
+
+static std::atomic<uint64_t> stat_connections{0};
+static std::atomic<uint64_t> stat_full{0};
+static std::atomic<uint64_t> stat_resumed{0};
+static std::atomic<uint64_t> stat_failures{0};
+static std::atomic<uint64_t> stat_forgets{0};
+static std::atomic<uint64_t> stat_bytes{0};
+static std::atomic<uint64_t> stat_full_us{0};
+static std::atomic<uint64_t> stat_resumed_us{0};
+
+static double now_ms(void) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Fresh key and a self-signed certificate for it, valid for a year
+static bool make_identity(void) {
+    EVP_PKEY* key = opt_key == "rsa" ? EVP_RSA_gen(2048) : EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    if (!key || !cert) {
+        return false;
+    }
+    X509_set_version(cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 365L * 24 * 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"tls-emulator", -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    bool ok = X509_sign(cert, key, EVP_sha256()) > 0 && SSL_CTX_use_certificate(ctx, cert) == 1 &&
+              SSL_CTX_use_PrivateKey(ctx, key) == 1;
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+// New ticket keys: tickets issued so far no longer decrypt
+static void rotate_ticket_keys(void) {
+    unsigned char keys[80];
+    RAND_bytes(keys, sizeof(keys));
+    SSL_CTX_set_tlsext_ticket_keys(ctx, keys, sizeof(keys));
+}
+
+static bool setup_context(void) {
+    ctx = SSL_CTX_new(TLS_server_method());
+    if (!ctx) {
+        return false;
+    }
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set_max_proto_version(ctx, TLS1_2_VERSION);
+    static const unsigned char sid_ctx[] = "tls_emulator";
+    SSL_CTX_set_session_id_context(ctx, sid_ctx, sizeof(sid_ctx) - 1);
+    if (opt_mode == "tickets") {
+        // Stateless: a session resumes only through its ticket
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+        rotate_ticket_keys();
+    } else if (opt_mode == "ids") {
+        SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+    } else {
+        SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+    }
+    return make_identity();
+}
+
+static int connect_upstream(void) {
+    size_t colon = opt_upstream.rfind(':');
+    std::string host = opt_upstream.substr(0, colon);
+    std::string port = opt_upstream.substr(colon + 1);
+    struct addrinfo hints = {};
+    struct addrinfo* res = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) {
+        return -1;
+    }
+    int fd = socket(res->ai_family, res->ai_socktype, 0);
+    if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+// Plaintext both ways until either side closes
+static void relay(SSL* ssl, int fd, int up, const std::string& address) {
+    char buf[16384];
+    while (running) {
+        if (SSL_pending(ssl) == 0) {
+            struct pollfd fds[2] = {{fd, POLLIN, 0}, {up, POLLIN, 0}};
+            if (poll(fds, up >= 0 ? 2 : 1, 100) <= 0) {
+                continue;
+            }
+            if (up >= 0 && (fds[1].revents & (POLLIN | POLLHUP | POLLERR))) {
+                ssize_t n = recv(up, buf, sizeof(buf), 0);
+                if (n <= 0 || SSL_write(ssl, buf, (int)n) <= 0) {
+                    return;
+                }
+                stat_bytes += n;
+            }
+            if (!(fds[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+        }
+        int n = SSL_read(ssl, buf, sizeof(buf));
+        if (n <= 0) {
+            return;
+        }
+        stat_bytes += n;
+        if (up >= 0) {
+            if (send(up, buf, n, MSG_NOSIGNAL) != n) {
+                return;
+            }
+        } else if (n == 7 && memcmp(buf, "forget\n", 7) == 0) {
+            SSL_CTX_flush_sessions(ctx, LONG_MAX);
+            rotate_ticket_keys();
+            stat_forgets++;
+            printf("🧹 %s: sessions forgotten, ticket keys rotated\n", address.c_str());
+            SSL_write(ssl, "forgot\n", 7);
+        } else if (SSL_write(ssl, buf, n) <= 0) {
+            return;
+        }
+    }
+}
+
+static void serve(int fd, std::string address) {
+    SSL* ssl = SSL_new(ctx);
+    SSL_set_fd(ssl, fd);
+    double start = now_ms();
+    if (SSL_accept(ssl) != 1) {
+        stat_failures++;
+        char err[160];
+        ERR_error_string_n(ERR_get_error(), err, sizeof(err));
+        printf("❌ %s: handshake failed (%s)\n", address.c_str(), err);
+    } else {
+        double elapsed = now_ms() - start;
+        bool resumed = SSL_session_reused(ssl);
+        if (resumed) {
+            stat_resumed++;
+            stat_resumed_us += (uint64_t)(elapsed * 1000);
+        } else {
+            stat_full++;
+            stat_full_us += (uint64_t)(elapsed * 1000);
+        }
+        printf("🔐 %s: %s handshake in %.2f ms (%s)\n", address.c_str(),
+               resumed ? (opt_mode == "tickets" ? "resumed (ticket)" : "resumed (session ID)") : "full", elapsed,
+               SSL_get_cipher_name(ssl));
+
+        int up = -1;
+        if (!opt_upstream.empty() && (up = connect_upstream()) < 0) {
+            printf("❌ %s: upstream %s unreachable\n", address.c_str(), opt_upstream.c_str());
+        } else {
+            relay(ssl, fd, up, address);
+        }
+        if (up >= 0) {
+            close(up);
+        }
+        SSL_shutdown(ssl);
+    }
+    SSL_free(ssl);
+    close(fd);
+}
+
+static void print_stats(void) {
+    uint64_t full = stat_full, resumed = stat_resumed;
+    printf("┌──────────────── TLS emulator stats ─────────────────┐\n");
+    printf("│ Connections: %-8llu Failed handshakes: %-8llu   │\n", (unsigned long long)stat_connections.load(),
+           (unsigned long long)stat_failures.load());
+    printf("│ Full: %-8llu avg %8.2f ms                      │\n", (unsigned long long)full,
+           full ? stat_full_us / 1000.0 / full : 0.0);
+    printf("│ Resumed: %-8llu avg %8.2f ms                   │\n", (unsigned long long)resumed,
+           resumed ? stat_resumed_us / 1000.0 / resumed : 0.0);
+    printf("│ Forgets: %-8llu Bytes relayed: %-12llu       │\n", (unsigned long long)stat_forgets.load(),
+           (unsigned long long)stat_bytes.load());
+    printf("└─────────────────────────────────────────────────────┘\n");
+}
+
+static void on_signal(int) {
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "p:u:m:k:")) != -1) {
+        switch (opt) {
+            case 'p': opt_port = (uint16_t)atoi(optarg); break;
+            case 'u': opt_upstream = optarg; break;
+            case 'm': opt_mode = optarg; break;
+            case 'k': opt_key = optarg; break;
+            default:
+                fprintf(stderr, "Usage: %s [-p port] [-u host:port] [-m tickets|ids|none] [-k ec|rsa]\n", argv[0]);
+                return 1;
+        }
+    }
+    if ((opt_mode != "tickets" && opt_mode != "ids" && opt_mode != "none") || (opt_key != "ec" && opt_key != "rsa") ||
+        (!opt_upstream.empty() && opt_upstream.rfind(':') == std::string::npos)) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+    if (!setup_context()) {
+        fprintf(stderr, "❌ Cannot set up TLS\n");
+        ERR_print_errors_fp(stderr);
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(opt_port);
+    if (bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, 64) < 0) {
+        fprintf(stderr, "❌ Cannot listen on port %u: %s\n", opt_port, strerror(errno));
+        return 1;
+    }
+    printf("🔒 TLS emulator on :%u -> %s (%s key, %s)\n", opt_port,
+           opt_upstream.empty() ? "echo" : opt_upstream.c_str(), opt_key == "rsa" ? "RSA 2048" : "ECDSA P-256",
+           opt_mode == "tickets" ? "session tickets" : opt_mode == "ids" ? "session IDs" : "no resumption");
+
+    while (running) {
+        struct pollfd p = {listen_fd, POLLIN, 0};
+        if (poll(&p, 1, 100) <= 0) {
+            continue;
+        }
+        struct sockaddr_in peer;
+        socklen_t len = sizeof(peer);
+        int fd = accept(listen_fd, (struct sockaddr*)&peer, &len);
+        if (fd < 0) {
+            continue;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%s:%u", inet_ntoa(peer.sin_addr), ntohs(peer.sin_port));
+        stat_connections++;
+        std::thread(serve, fd, std::string(buf)).detach();
+    }
+
+    print_stats();
+    return 0;
+}